@@ -0,0 +1,29 @@
+#!/bin/bash
+# Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+#
+# App4Cam is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# App4Cam is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+
+# Motion pipes raw frames of each movie to this script, see movie_extpipe in
+# motion.conf. Arguments: width, height, frame rate and filename without
+# extension.
+
+# The backend writes the options of the selected encoding profile.
+arguments_file=/home/app4cam/app4cam-backend/movie-encoder.args
+encoder_arguments="-vcodec libx264 -preset ultrafast"
+if [ -s "$arguments_file" ]; then
+  encoder_arguments=$(cat "$arguments_file")
+fi
+
+# The options are not quoted on purpose, so that they are split.
+exec ffmpeg -y -f rawvideo -pix_fmt yuv420p -video_size "$1x$2" -framerate "$3" -i pipe:0 $encoder_arguments -f mp4 "$4.mp4"
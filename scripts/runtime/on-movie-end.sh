@@ -31,3 +31,11 @@ if [ "$type" = "RaspberryPi" ]; then
 fi
 
 "$base_dir"/write-coordinates-to-mp4-file.sh "$1"
+
+# Computed last, once all metadata has been written to the movie.
+checksum=$("$base_dir"/shot-checksums/checksum_shot "$1" | cut -d ' ' -f 1)
+if [ -n "$checksum" ]; then
+  echo "checksum: $checksum"
+  "$base_dir"/post-to-backend.sh files/checksums \
+    name="$(basename "$1")" checksum="$checksum"
+fi
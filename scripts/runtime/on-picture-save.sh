@@ -31,3 +31,22 @@ if [ "$type" = "RaspberryPi" ]; then
 fi
 
 "$base_dir"/write-coordinates-to-jpg-file.sh "$1"
+
+# Scores how much of the picture differs from the background, so that likely
+# empty shots can be sorted out.
+model_folder="$base_dir"/../../temp/background-models
+mkdir -p "$model_folder"
+score=$("$base_dir"/shot-scoring/score_shot "$1" "$model_folder")
+if [ -n "$score" ]; then
+  echo "change score: $score"
+  "$base_dir"/post-to-backend.sh files/change-scores \
+    name="$(basename "$1")" changeScore:="$score"
+fi
+
+# Computed last, once all metadata has been written to the picture.
+checksum=$("$base_dir"/shot-checksums/checksum_shot "$1" | cut -d ' ' -f 1)
+if [ -n "$checksum" ]; then
+  echo "checksum: $checksum"
+  "$base_dir"/post-to-backend.sh files/checksums \
+    name="$(basename "$1")" checksum="$checksum"
+fi
@@ -0,0 +1,38 @@
+#!/bin/bash
+# Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+#
+# App4Cam is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# App4Cam is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+
+# Posts a JSON object to the backend. jq builds it, so that any filename is
+# escaped properly. The request runs in the background, so that a slow backend
+# does not delay Motion or the lights.
+# Usage: post-to-backend.sh <path> [<field>=<string> | <field>:=<number>]...
+
+path=$1
+shift
+args=()
+for field in "$@"; do
+  if [[ "$field" == *:=* ]]; then
+    args+=(--argjson "${field%%:=*}" "${field#*:=}")
+  else
+    args+=(--arg "${field%%=*}" "${field#*=}")
+  fi
+done
+data=$(jq --null-input --compact-output '$ARGS.named' "${args[@]}") || exit 1
+
+curl --silent --max-time 2 --output /dev/null \
+  --header "Content-Type: application/json" \
+  --data "$data" \
+  "http://127.0.0.1:3000/$path" \
+  >/dev/null 2>&1 &
@@ -0,0 +1,470 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <pwd.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#ifndef SOCKET_PATH
+#define SOCKET_PATH       "/run/app4cam/helperd.sock"
+#endif
+#define DEFAULT_BASE_DIR  "/home/app4cam/app4cam-backend"
+#define MAX_REQUEST_SIZE  4096
+#define MAX_ARGUMENTS     8
+#define MAX_OUTPUT_SIZE   (1024 * 1024)
+#define STATUS_REJECTED   -1
+
+/*
+ * Every operation maps to a fixed executable. Placeholders "$1" to "$8" are
+ * replaced by the request arguments, which are passed to execv() as they
+ * are, so that no shell ever interprets them.
+ */
+struct operation {
+    const char *name;
+    int argument_count;
+    const char *argv[MAX_ARGUMENTS + 4];
+};
+
+#define ACCESS_POINT_DIR  "scripts/runtime/variscite/access-point/"
+#define WORKING_HOURS_DIR "scripts/runtime/raspberry-pi/working-hours/"
+
+static const struct operation operations[] = {
+    { "get-access-point-password", 0,
+      { ACCESS_POINT_DIR "get-access-point-password.sh", NULL } },
+    { "get-battery-voltage-raspberry-pi", 0,
+      { "scripts/runtime/raspberry-pi/get-input-voltage.sh", NULL } },
+    { "get-battery-voltage-variscite", 0,
+      { "scripts/runtime/variscite/battery-monitoring/battery_monitoring",
+        NULL } },
+    { "get-camera-controls", 1,
+      { "/usr/bin/v4l2-ctl", "-d", "$1", "-l", NULL } },
+    { "get-light-type", 0,
+      { "scripts/runtime/variscite/light-control/lightctl", "get", NULL } },
+    { "create-working-hours-schedule", 4,
+      { WORKING_HOURS_DIR "create-working-hours-schedule.sh",
+        "$1", "$2", "$3", "$4", NULL } },
+    { "remove-working-hours-schedule", 0,
+      { WORKING_HOURS_DIR "remove-working-hours-schedule.sh", NULL } },
+    { "reset-lights", 3,
+      { "scripts/runtime/reset-lights.sh", "$1", "$2", "$3", NULL } },
+    { "set-access-point-name", 1,
+      { ACCESS_POINT_DIR "change-access-point-name-or-password.sh",
+        "-n", "$1", NULL } },
+    { "set-access-point-name-and-password", 2,
+      { ACCESS_POINT_DIR "change-access-point-name-or-password.sh",
+        "-n", "$1", "-p", "$2", NULL } },
+    { "set-access-point-password", 1,
+      { ACCESS_POINT_DIR "change-access-point-name-or-password.sh",
+        "-p", "$1", NULL } },
+    { "set-alternating-lights", 1,
+      { "scripts/runtime/set-alternating-lights.sh", "$1", NULL } },
+    { "set-camera-focus", 2,
+      { "scripts/runtime/raspberry-pi/set-camera-focus.sh", "$1", "$2",
+        NULL } },
+    { "set-rtc-time-variscite", 1,
+      { "scripts/runtime/variscite/rtc/set_time", "$1", NULL } },
+    { "set-system-time", 1,
+      { "/usr/bin/timedatectl", "set-time", "$1", NULL } },
+    { "set-time-zone", 1,
+      { "/usr/bin/timedatectl", "set-timezone", "$1", NULL } },
+    { "sleep-until", 1,
+      { "scripts/runtime/variscite/rtc/sleep_until", "$1", NULL } },
+    { "trigger-upgrade", 0,
+      { "scripts/runtime/upgrade.sh", NULL } },
+    { "write-system-time-to-rtc-raspberry-pi", 0,
+      { "scripts/runtime/raspberry-pi/write-system-time-to-rtc.sh", NULL } },
+};
+
+struct output {
+    char *data;
+    size_t length;
+};
+
+static int server_fd = -1;
+static uid_t allowed_uid;
+
+static void cleanup(void)
+{
+    if (server_fd >= 0) {
+        close(server_fd);
+        unlink(SOCKET_PATH);
+    }
+}
+
+static void handle_signal(int sig)
+{
+    (void)sig;
+    cleanup();
+    exit(0);
+}
+
+static int setup_socket(void)
+{
+    struct sockaddr_un addr;
+
+    unlink(SOCKET_PATH);
+
+    server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SOCKET_PATH, sizeof(addr.sun_path) - 1);
+
+    if (bind(server_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return -1;
+    }
+
+    /* Access is restricted by the peer credentials checked per client. */
+    if (chmod(SOCKET_PATH, 0666) < 0) {
+        perror("chmod");
+        return -1;
+    }
+
+    if (listen(server_fd, 16) < 0) {
+        perror("listen");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int is_peer_allowed(int client_fd)
+{
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+
+    if (getsockopt(client_fd, SOL_SOCKET, SO_PEERCRED, &credentials,
+                   &length) < 0)
+        return 0;
+    return credentials.uid == 0 || credentials.uid == allowed_uid;
+}
+
+static const struct operation *find_operation(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+        if (strcmp(operations[i].name, name) == 0)
+            return &operations[i];
+    }
+    return NULL;
+}
+
+static int is_argument_valid(const char *argument, int is_system_binary)
+{
+    const unsigned char *c;
+
+    if (argument[0] == '\0')
+        return 0;
+    /* Options could change what a system binary does. */
+    if (is_system_binary && argument[0] == '-')
+        return 0;
+    for (c = (const unsigned char *)argument; *c; c++) {
+        if (*c < 0x20 || *c == 0x7f)
+            return 0;
+    }
+    return 1;
+}
+
+static void write_all(int fd, const char *data, size_t length)
+{
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += n;
+        length -= (size_t)n;
+    }
+}
+
+static void send_reply(int client_fd, int status, const struct output *out,
+                       const struct output *err)
+{
+    char header[64];
+    int header_length = snprintf(header, sizeof(header), "%d %zu %zu\n",
+                                 status, out->length, err->length);
+
+    write_all(client_fd, header, (size_t)header_length);
+    write_all(client_fd, out->data, out->length);
+    write_all(client_fd, err->data, err->length);
+}
+
+static void reject(int client_fd, const char *message)
+{
+    struct output out = { "", 0 };
+    struct output err = { (char *)message, strlen(message) };
+
+    send_reply(client_fd, STATUS_REJECTED, &out, &err);
+}
+
+/* Returns 0 once the pipe is closed. Output beyond the limit is dropped. */
+static int read_into(int fd, struct output *output)
+{
+    char buf[4096];
+    ssize_t n = read(fd, buf, sizeof(buf));
+
+    if (n < 0)
+        return errno == EINTR;
+    if (n == 0)
+        return 0;
+    if (output->length + (size_t)n > MAX_OUTPUT_SIZE)
+        return 1;
+    char *data = realloc(output->data, output->length + (size_t)n);
+    if (!data)
+        return 1;
+    memcpy(data + output->length, buf, (size_t)n);
+    output->data = data;
+    output->length += (size_t)n;
+    return 1;
+}
+
+static int run(char *const argv[], struct output *out, struct output *err)
+{
+    int out_pipe[2];
+    int err_pipe[2];
+    int status;
+    pid_t pid;
+
+    if (pipe(out_pipe) < 0)
+        return STATUS_REJECTED;
+    if (pipe(err_pipe) < 0) {
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        return STATUS_REJECTED;
+    }
+
+    pid = fork();
+    if (pid < 0) {
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        close(err_pipe[0]);
+        close(err_pipe[1]);
+        return STATUS_REJECTED;
+    }
+    if (pid == 0) {
+        dup2(out_pipe[1], STDOUT_FILENO);
+        dup2(err_pipe[1], STDERR_FILENO);
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        close(err_pipe[0]);
+        close(err_pipe[1]);
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+    close(out_pipe[1]);
+    close(err_pipe[1]);
+
+    struct pollfd fds[2] = {
+        { out_pipe[0], POLLIN, 0 },
+        { err_pipe[0], POLLIN, 0 },
+    };
+    int open_count = 2;
+    while (open_count > 0) {
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (int i = 0; i < 2; i++) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP)))
+                continue;
+            if (!read_into(fds[i].fd, i == 0 ? out : err)) {
+                close(fds[i].fd);
+                fds[i].fd = -1;
+                open_count--;
+            }
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        if (fds[i].fd >= 0)
+            close(fds[i].fd);
+    }
+
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR)
+            return STATUS_REJECTED;
+    }
+    if (WIFEXITED(status))
+        return WEXITSTATUS(status);
+    return 128 + WTERMSIG(status);
+}
+
+/*
+ * A request is one line: the operation name followed by its arguments, all
+ * separated by tabs. The reply starts with "<status> <stdout length>
+ * <stderr length>\n" followed by both outputs.
+ */
+static void handle_client(int client_fd)
+{
+    char request[MAX_REQUEST_SIZE];
+    size_t length = 0;
+    char *newline = NULL;
+
+    while (!newline && length < sizeof(request) - 1) {
+        ssize_t n = read(client_fd, request + length,
+                         sizeof(request) - 1 - length);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        length += (size_t)n;
+        request[length] = '\0';
+        newline = strchr(request, '\n');
+    }
+    if (!newline) {
+        reject(client_fd, "Incomplete request\n");
+        return;
+    }
+    *newline = '\0';
+
+    char *fields[MAX_ARGUMENTS + 2];
+    int field_count = 0;
+    char *field = request;
+    for (;;) {
+        if (field_count == MAX_ARGUMENTS + 1) {
+            reject(client_fd, "Too many arguments\n");
+            return;
+        }
+        fields[field_count++] = field;
+        char *tab = strchr(field, '\t');
+        if (!tab)
+            break;
+        *tab = '\0';
+        field = tab + 1;
+    }
+
+    const struct operation *operation = find_operation(fields[0]);
+    if (!operation) {
+        reject(client_fd, "Unknown operation\n");
+        return;
+    }
+    if (field_count - 1 != operation->argument_count) {
+        reject(client_fd, "Wrong number of arguments\n");
+        return;
+    }
+    int is_system_binary = operation->argv[0][0] == '/';
+    for (int i = 1; i < field_count; i++) {
+        if (!is_argument_valid(fields[i], is_system_binary)) {
+            reject(client_fd, "Invalid argument\n");
+            return;
+        }
+    }
+
+    char *argv[MAX_ARGUMENTS + 4];
+    int i;
+    for (i = 0; operation->argv[i]; i++) {
+        const char *template = operation->argv[i];
+        if (template[0] == '$')
+            argv[i] = fields[template[1] - '0'];
+        else
+            argv[i] = (char *)template;
+    }
+    argv[i] = NULL;
+
+    struct output out = { NULL, 0 };
+    struct output err = { NULL, 0 };
+    int status = run(argv, &out, &err);
+    send_reply(client_fd, status, &out, &err);
+    free(out.data);
+    free(err.data);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *base_dir = argc > 2 ? argv[2] : DEFAULT_BASE_DIR;
+    struct passwd *user;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <allowed user> [base directory]\n",
+                argv[0]);
+        return 1;
+    }
+    user = getpwnam(argv[1]);
+    if (!user) {
+        fprintf(stderr, "helperd: unknown user %s\n", argv[1]);
+        return 1;
+    }
+    allowed_uid = user->pw_uid;
+
+    /* Relative script paths are resolved against the backend folder. */
+    if (chdir(base_dir) < 0) {
+        perror("chdir");
+        return 1;
+    }
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    /* Each client is served by its own child, which is reaped automatically. */
+    signal(SIGCHLD, SIG_IGN);
+
+    if (setup_socket() < 0) {
+        cleanup();
+        return 1;
+    }
+
+    printf("helperd: listening on %s\n", SOCKET_PATH);
+    fflush(stdout);
+
+    for (;;) {
+        int client_fd = accept(server_fd, NULL, NULL);
+        if (client_fd < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("accept");
+            break;
+        }
+        if (!is_peer_allowed(client_fd)) {
+            close(client_fd);
+            continue;
+        }
+        /* A long operation such as an upgrade must not block the others. */
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(server_fd);
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGCHLD, SIG_DFL);
+            handle_client(client_fd);
+            close(client_fd);
+            _exit(0);
+        }
+        if (pid < 0)
+            reject(client_fd, "Busy\n");
+        close(client_fd);
+    }
+
+    cleanup();
+    return 0;
+}
@@ -0,0 +1,342 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <jpeglib.h>
+
+#define DEFAULT_HOST "127.0.0.1"
+#define DEFAULT_PORT 8081
+#define DEFAULT_TIMEOUT_MS 15000
+#define DEFAULT_MINIMUM_MS 500
+#define DEFAULT_TOLERANCE_PERCENTAGE 3.0
+// Frames are decoded at 1/8 of their size, which is plenty for a histogram.
+#define DECODING_SCALE_DENOMINATOR 8
+#define HISTOGRAM_BIN_COUNT 32
+// Number of consecutive frame pairs within the tolerance
+#define STABLE_FRAME_PAIR_COUNT 2
+#define BUFFER_SIZE (4 * 1024 * 1024)
+
+#define EXIT_SETTLED 0
+#define EXIT_TIMED_OUT 1
+#define EXIT_USAGE 2
+
+typedef struct {
+    double bins[HISTOGRAM_BIN_COUNT];
+    double mean;
+} luminance_t;
+
+typedef struct {
+    struct jpeg_error_mgr manager;
+    jmp_buf escape;
+} jpeg_error_t;
+
+typedef struct {
+    const char *host;
+    int port;
+    long timeout_ms;
+    long minimum_ms;
+    double tolerance_percentage;
+} options_t;
+
+static long now_ms(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000L + time.tv_nsec / 1000000L;
+}
+
+static int connect_to_stream(const options_t *options) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options->port);
+    if (inet_pton(AF_INET, options->host, &address.sin_addr) != 1) {
+        fprintf(stderr, "Invalid host: %s\n", options->host);
+        close(fd);
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+        perror("connect");
+        close(fd);
+        return -1;
+    }
+    const char *request = "GET / HTTP/1.0\r\n\r\n";
+    if (write(fd, request, strlen(request)) < 0) {
+        perror("write");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// libjpeg exits the process on errors by default, so jump back to the
+// caller instead, which then skips the frame.
+static void escape_on_jpeg_error(j_common_ptr decompressor) {
+    jpeg_error_t *error = (jpeg_error_t *)decompressor->err;
+    (*decompressor->err->output_message)(decompressor);
+    longjmp(error->escape, 1);
+}
+
+static int measure_luminance(const uint8_t *jpeg, size_t length,
+                             luminance_t *luminance) {
+    struct jpeg_decompress_struct decompressor;
+    jpeg_error_t error;
+    // Volatile, as it is assigned after setjmp and freed after longjmp
+    JSAMPLE *volatile allocated_row = NULL;
+    decompressor.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = escape_on_jpeg_error;
+    jpeg_create_decompress(&decompressor);
+    if (setjmp(error.escape)) {
+        jpeg_destroy_decompress(&decompressor);
+        free(allocated_row);
+        return -1;
+    }
+    jpeg_mem_src(&decompressor, (unsigned char *)jpeg, length);
+    if (jpeg_read_header(&decompressor, TRUE) != JPEG_HEADER_OK) {
+        jpeg_destroy_decompress(&decompressor);
+        return -1;
+    }
+    decompressor.scale_num = 1;
+    decompressor.scale_denom = DECODING_SCALE_DENOMINATOR;
+    decompressor.dct_method = JDCT_IFAST;
+    decompressor.out_color_space = JCS_GRAYSCALE;
+    jpeg_start_decompress(&decompressor);
+
+    JSAMPLE *row = malloc(decompressor.output_width);
+    allocated_row = row;
+    uint64_t counts[HISTOGRAM_BIN_COUNT] = {0};
+    uint64_t sum = 0;
+    while (row != NULL &&
+           decompressor.output_scanline < decompressor.output_height) {
+        jpeg_read_scanlines(&decompressor, &row, 1);
+        for (JDIMENSION x = 0; x < decompressor.output_width; x++) {
+            counts[row[x] * HISTOGRAM_BIN_COUNT / 256]++;
+            sum += row[x];
+        }
+    }
+    uint64_t pixel_count =
+        (uint64_t)decompressor.output_width * decompressor.output_height;
+    jpeg_finish_decompress(&decompressor);
+    jpeg_destroy_decompress(&decompressor);
+    free(row);
+    if (row == NULL || pixel_count == 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < HISTOGRAM_BIN_COUNT; i++) {
+        luminance->bins[i] = (double)counts[i] / pixel_count;
+    }
+    luminance->mean = (double)sum / pixel_count;
+    return 0;
+}
+
+// Both the share of pixels that moved to another bin and the change of the
+// mean luminance have to stay within the tolerance.
+static int is_within_tolerance(const luminance_t *previous,
+                               const luminance_t *current,
+                               double tolerance_percentage) {
+    double distance = 0;
+    for (int i = 0; i < HISTOGRAM_BIN_COUNT; i++) {
+        distance += fabs(current->bins[i] - previous->bins[i]);
+    }
+    double moved_percentage = distance / 2 * 100;
+    double mean_change_percentage =
+        fabs(current->mean - previous->mean) / 255 * 100;
+    return moved_percentage <= tolerance_percentage &&
+           mean_change_percentage <= tolerance_percentage;
+}
+
+// Finds the next complete JPEG image between its SOI and EOI markers. 0xFF
+// bytes are stuffed in entropy-coded data, so EOI cannot occur inside it.
+static int find_frame(const uint8_t *buffer, size_t length, size_t *start,
+                      size_t *end) {
+    size_t i = 0;
+    while (i + 1 < length && !(buffer[i] == 0xFF && buffer[i + 1] == 0xD8)) {
+        i++;
+    }
+    if (i + 1 >= length) {
+        return 0;
+    }
+    for (size_t j = i + 2; j + 1 < length; j++) {
+        if (buffer[j] == 0xFF && buffer[j + 1] == 0xD9) {
+            *start = i;
+            *end = j + 2;
+            return 1;
+        }
+    }
+    *start = i;
+    *end = 0;
+    return 0;
+}
+
+static void sleep_until(long deadline_ms) {
+    long remaining_ms = deadline_ms - now_ms();
+    if (remaining_ms > 0) {
+        struct timespec duration = {remaining_ms / 1000,
+                                    (remaining_ms % 1000) * 1000000L};
+        nanosleep(&duration, NULL);
+    }
+}
+
+// Returns the elapsed time in milliseconds once the scene settled, or -1 on
+// timeout. Without a stream, it waits for the whole timeout.
+static long wait_for_settled_scene(const options_t *options) {
+    long start_ms = now_ms();
+    long deadline_ms = start_ms + options->timeout_ms;
+    long minimum_deadline_ms = start_ms + options->minimum_ms;
+
+    int fd = connect_to_stream(options);
+    uint8_t *buffer = malloc(BUFFER_SIZE);
+    if (fd < 0 || buffer == NULL) {
+        fprintf(stderr, "Stream unavailable, waiting for the timeout\n");
+        if (fd >= 0) {
+            close(fd);
+        }
+        free(buffer);
+        sleep_until(deadline_ms);
+        return -1;
+    }
+
+    size_t length = 0;
+    luminance_t previous = {{0}, 0};
+    int has_previous = 0;
+    int stable_pair_count = 0;
+    long settled_ms = -1;
+    while (settled_ms < 0) {
+        long remaining_ms = deadline_ms - now_ms();
+        if (remaining_ms <= 0) {
+            break;
+        }
+        struct pollfd poll_fd = {fd, POLLIN, 0};
+        int ready = poll(&poll_fd, 1, (int)remaining_ms);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            break;
+        }
+        if (length == BUFFER_SIZE) {
+            // No complete frame fits, drop everything and resynchronise.
+            length = 0;
+        }
+        ssize_t count = read(fd, buffer + length, BUFFER_SIZE - length);
+        if (count <= 0) {
+            fprintf(stderr, "Stream closed, waiting for the timeout\n");
+            sleep_until(deadline_ms);
+            break;
+        }
+        length += (size_t)count;
+
+        size_t frame_start, frame_end;
+        while (settled_ms < 0 &&
+               find_frame(buffer, length, &frame_start, &frame_end)) {
+            luminance_t current;
+            // Frames captured before the light switch may still be buffered.
+            int is_counted =
+                now_ms() >= minimum_deadline_ms &&
+                measure_luminance(buffer + frame_start,
+                                  frame_end - frame_start, &current) == 0;
+            if (is_counted) {
+                if (has_previous &&
+                    is_within_tolerance(&previous, &current,
+                                        options->tolerance_percentage)) {
+                    stable_pair_count++;
+                } else {
+                    stable_pair_count = 0;
+                }
+                previous = current;
+                has_previous = 1;
+                if (stable_pair_count >= STABLE_FRAME_PAIR_COUNT) {
+                    settled_ms = now_ms() - start_ms;
+                }
+            }
+            memmove(buffer, buffer + frame_end, length - frame_end);
+            length -= frame_end;
+        }
+    }
+
+    close(fd);
+    free(buffer);
+    return settled_ms;
+}
+
+static int parse_options(int argc, char *argv[], options_t *options) {
+    options->host = DEFAULT_HOST;
+    options->port = DEFAULT_PORT;
+    options->timeout_ms = DEFAULT_TIMEOUT_MS;
+    options->minimum_ms = DEFAULT_MINIMUM_MS;
+    options->tolerance_percentage = DEFAULT_TOLERANCE_PERCENTAGE;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return -1;
+        }
+        const char *value = argv[i + 1];
+        if (strcmp(argv[i], "--host") == 0) {
+            options->host = value;
+        } else if (strcmp(argv[i], "--port") == 0) {
+            options->port = atoi(value);
+        } else if (strcmp(argv[i], "--timeout") == 0) {
+            options->timeout_ms = atol(value);
+        } else if (strcmp(argv[i], "--minimum") == 0) {
+            options->minimum_ms = atol(value);
+        } else if (strcmp(argv[i], "--tolerance") == 0) {
+            options->tolerance_percentage = atof(value);
+        } else {
+            return -1;
+        }
+    }
+    if (options->port <= 0 || options->timeout_ms <= 0 ||
+        options->minimum_ms < 0 || options->tolerance_percentage <= 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    options_t options;
+    if (parse_options(argc, argv, &options) != 0) {
+        fprintf(stderr,
+                "Usage: %s [--host <address>] [--port <port>] "
+                "[--timeout <ms>] [--minimum <ms>] "
+                "[--tolerance <percentage>]\n",
+                argv[0]);
+        return EXIT_USAGE;
+    }
+    long settled_ms = wait_for_settled_scene(&options);
+    if (settled_ms < 0) {
+        printf("%ld\n", options.timeout_ms);
+        return EXIT_TIMED_OUT;
+    }
+    printf("%ld\n", settled_ms);
+    return EXIT_SETTLED;
+}
@@ -0,0 +1,165 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "crc32c.h"
+
+#define BUFFER_SIZE (256 * 1024)
+#define DEFAULT_BENCHMARK_ITERATIONS 20
+#define BYTES_PER_MEGABYTE (1024.0 * 1024.0)
+
+static int checksum_file(const char *path, int is_uncached, uint8_t *buffer,
+                         uint32_t *crc) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    // A copy is only verified once read back from the storage. Writing it out
+    // first leaves no dirty pages that the kernel would keep in the cache.
+    if (is_uncached && fdatasync(fd) != 0) {
+        int sync_errno = errno;
+        close(fd);
+        errno = sync_errno;
+        return -1;
+    }
+    if (is_uncached) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    uint32_t result = 0;
+    for (;;) {
+        ssize_t count = read(fd, buffer, BUFFER_SIZE);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            int read_errno = errno;
+            close(fd);
+            errno = read_errno;
+            return -1;
+        }
+        if (count == 0) {
+            break;
+        }
+        result = crc32c_update(result, buffer, (size_t)count);
+    }
+    // Verifying the whole card must not push Motion's data out of the cache.
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    *crc = result;
+    return 0;
+}
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double)(end.tv_sec - start->tv_sec) +
+           (double)(end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int benchmark(const char *path, int iterations) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror("Failed to open shot");
+        return 1;
+    }
+    struct stat stats;
+    if (fstat(fileno(file), &stats) != 0 || stats.st_size == 0) {
+        fprintf(stderr, "Failed to read %s\n", path);
+        fclose(file);
+        return 1;
+    }
+    size_t length = (size_t)stats.st_size;
+    uint8_t *data = malloc(length);
+    if (data == NULL || fread(data, 1, length, file) != length) {
+        fprintf(stderr, "Failed to read %s\n", path);
+        free(data);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+
+    struct timespec start;
+    uint32_t hardware_crc = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++) {
+        hardware_crc = crc32c_update(0, data, length);
+    }
+    double hardware_seconds = elapsed_seconds(&start);
+    uint32_t software_crc = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++) {
+        software_crc = crc32c_update_software(0, data, length);
+    }
+    double software_seconds = elapsed_seconds(&start);
+    free(data);
+
+    double megabytes = (double)length * iterations / BYTES_PER_MEGABYTE;
+    printf("implementation: %s\n", crc32c_implementation());
+    printf("checksum: %08x%s\n", hardware_crc,
+           hardware_crc == software_crc ? "" : " (software differs)");
+    printf("MB/s: %.0f (software: %.0f)\n", megabytes / hardware_seconds,
+           megabytes / software_seconds);
+    return hardware_crc == software_crc ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    crc32c_init();
+    if (argc >= 3 && strcmp(argv[1], "--benchmark") == 0) {
+        int iterations =
+            argc >= 4 ? atoi(argv[3]) : DEFAULT_BENCHMARK_ITERATIONS;
+        return benchmark(argv[2], iterations > 0 ? iterations : 1);
+    }
+    int first_shot_index = 1;
+    int is_uncached = 0;
+    if (argc >= 2 && strcmp(argv[1], "--uncached") == 0) {
+        first_shot_index = 2;
+        is_uncached = 1;
+    }
+    if (argc <= first_shot_index) {
+        fprintf(stderr,
+                "Usage: %s [--uncached] <shot>...\n"
+                "       %s --benchmark <shot> [iterations]\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+    uint8_t *buffer = malloc(BUFFER_SIZE);
+    if (buffer == NULL) {
+        perror("Failed to allocate buffer");
+        return 1;
+    }
+    // Same format as sha256sum, so that checksums can be checked by hand.
+    int status = 0;
+    for (int i = first_shot_index; i < argc; i++) {
+        uint32_t crc;
+        if (checksum_file(argv[i], is_uncached, buffer, &crc) == 0) {
+            printf("%08x  %s\n", crc, argv[i]);
+        } else {
+            fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+            status = 1;
+        }
+    }
+    free(buffer);
+    return status;
+}
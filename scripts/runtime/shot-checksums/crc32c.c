@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "crc32c.h"
+
+#include <string.h>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+#endif
+
+// Castagnoli polynomial, reversed
+#define CRC32C_POLYNOMIAL 0x82F63B78u
+#define SLICE_COUNT 8
+
+static uint32_t tables[SLICE_COUNT][256];
+static int is_hardware_supported;
+
+void crc32c_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0u - (crc & 1)));
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int slice = 1; slice < SLICE_COUNT; slice++) {
+            uint32_t previous = tables[slice - 1][i];
+            tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+        }
+    }
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    is_hardware_supported = __builtin_cpu_supports("sse4.2");
+#elif defined(__aarch64__)
+    is_hardware_supported = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#endif
+}
+
+// Slicing-by-8: eight table lookups per 8 bytes instead of one per byte.
+uint32_t crc32c_update_software(uint32_t crc, const uint8_t *data,
+                                size_t length) {
+    crc = ~crc;
+    while (length >= 8) {
+        uint32_t low;
+        uint32_t high;
+        memcpy(&low, data, 4);
+        memcpy(&high, data + 4, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        low = __builtin_bswap32(low);
+        high = __builtin_bswap32(high);
+#endif
+        low ^= crc;
+        crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^
+              tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+              tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^
+              tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *data++) & 0xFF];
+    }
+    return ~crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) static uint32_t
+crc32c_update_hardware(uint32_t crc, const uint8_t *data, size_t length) {
+    uint64_t crc64 = ~crc;
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, data, 8);
+        crc64 = _mm_crc32_u64(crc64, value);
+        data += 8;
+        length -= 8;
+    }
+    uint32_t crc32 = (uint32_t)crc64;
+    while (length-- > 0) {
+        crc32 = _mm_crc32_u8(crc32, *data++);
+    }
+    return ~crc32;
+}
+#elif defined(__aarch64__)
+__attribute__((target("+crc"))) static uint32_t
+crc32c_update_hardware(uint32_t crc, const uint8_t *data, size_t length) {
+    crc = ~crc;
+    while (length >= 8) {
+        uint64_t value;
+        memcpy(&value, data, 8);
+        crc = __crc32cd(crc, value);
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32cb(crc, *data++);
+    }
+    return ~crc;
+}
+#endif
+
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t length) {
+#if defined(__x86_64__) || defined(__aarch64__)
+    if (is_hardware_supported) {
+        return crc32c_update_hardware(crc, data, length);
+    }
+#endif
+    return crc32c_update_software(crc, data, length);
+}
+
+const char *crc32c_implementation(void) {
+#if defined(__x86_64__)
+    return is_hardware_supported ? "SSE4.2" : "software";
+#elif defined(__aarch64__)
+    return is_hardware_supported ? "ARMv8 CRC32" : "software";
+#else
+    return "software";
+#endif
+}
@@ -0,0 +1,36 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Must be called once before computing any checksum.
+void crc32c_init(void);
+
+// Continues the checksum of the preceding data, starting with 0.
+uint32_t crc32c_update(uint32_t crc, const uint8_t *data, size_t length);
+
+// Same as crc32c_update(), but never uses the CPU's CRC instructions.
+uint32_t crc32c_update_software(uint32_t crc, const uint8_t *data,
+                                size_t length);
+
+// Name of the implementation crc32c_update() uses on this CPU.
+const char *crc32c_implementation(void);
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jpeglib.h>
+
+// libjpeg decodes directly at 1/2, 1/4 or 1/8 of the size by dropping DCT
+// coefficients, which is much cheaper than decoding at full size.
+#define MAXIMUM_DECODING_SCALE_DENOMINATOR 8
+#define MINIMUM_LONG_EDGE 16
+#define MAXIMUM_LONG_EDGE 8192
+#define EXIF_MARKER (JPEG_APP0 + 1)
+#define MAXIMUM_MARKER_LENGTH 0xFFFF
+
+typedef struct {
+    int width;
+    int height;
+} shot_size;
+
+static int parse_integer(const char *text, int minimum, int maximum,
+                         int *value) {
+    char *end;
+    long parsed = strtol(text, &end, 10);
+    if (*text == '\0' || *end != '\0' || parsed < minimum ||
+        parsed > maximum) {
+        return -1;
+    }
+    *value = (int)parsed;
+    return 0;
+}
+
+// Keeps the aspect ratio and never enlarges.
+static shot_size compute_output_size(int width, int height, int long_edge) {
+    shot_size size = {width, height};
+    int current_long_edge = width > height ? width : height;
+    if (current_long_edge <= long_edge) {
+        return size;
+    }
+    size.width = (int)(((long)width * long_edge + current_long_edge / 2) /
+                       current_long_edge);
+    size.height = (int)(((long)height * long_edge + current_long_edge / 2) /
+                        current_long_edge);
+    size.width = size.width > 0 ? size.width : 1;
+    size.height = size.height > 0 ? size.height : 1;
+    return size;
+}
+
+// Picks the smallest decoding size that is still at least the output size,
+// so that the box filter below only ever reduces.
+static int choose_scale_denominator(int width, int height,
+                                    shot_size output_size) {
+    int denominator = MAXIMUM_DECODING_SCALE_DENOMINATOR;
+    while (denominator > 1 &&
+           ((width + denominator - 1) / denominator < output_size.width ||
+            (height + denominator - 1) / denominator < output_size.height)) {
+        denominator /= 2;
+    }
+    return denominator;
+}
+
+// Decodes, reduces and encodes one scanline at a time, so that memory use
+// only depends on the width and not on the height of the picture.
+static int scale_shot(const char *path, int long_edge, int quality) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror("Failed to open shot");
+        return 1;
+    }
+
+    struct jpeg_decompress_struct decompressor;
+    struct jpeg_error_mgr decompression_error_manager;
+    decompressor.err = jpeg_std_error(&decompression_error_manager);
+    jpeg_create_decompress(&decompressor);
+    jpeg_stdio_src(&decompressor, file);
+    jpeg_save_markers(&decompressor, EXIF_MARKER, MAXIMUM_MARKER_LENGTH);
+    jpeg_read_header(&decompressor, TRUE);
+
+    shot_size output_size = compute_output_size(
+        decompressor.image_width, decompressor.image_height, long_edge);
+    decompressor.scale_num = 1;
+    decompressor.scale_denom = choose_scale_denominator(
+        decompressor.image_width, decompressor.image_height, output_size);
+    decompressor.dct_method = JDCT_IFAST;
+    if (decompressor.num_components != 1) {
+        decompressor.out_color_space = JCS_RGB;
+    }
+    jpeg_start_decompress(&decompressor);
+
+    int components = decompressor.output_components;
+    int decoded_width = decompressor.output_width;
+    int decoded_height = decompressor.output_height;
+    // Rounding may leave the decoded size a pixel short of the output size.
+    output_size.width = output_size.width < decoded_width ? output_size.width
+                                                          : decoded_width;
+    output_size.height = output_size.height < decoded_height
+                             ? output_size.height
+                             : decoded_height;
+
+    size_t output_row_length = (size_t)output_size.width * components;
+    JSAMPLE *decoded_row = malloc((size_t)decoded_width * components);
+    JSAMPLE *output_row = malloc(output_row_length);
+    uint32_t *sums = calloc(output_row_length, sizeof(uint32_t));
+    uint32_t *column_counts = calloc(output_size.width, sizeof(uint32_t));
+    int *output_columns = malloc((size_t)decoded_width * sizeof(int));
+    if (decoded_row == NULL || output_row == NULL || sums == NULL ||
+        column_counts == NULL || output_columns == NULL) {
+        fprintf(stderr, "Failed to allocate buffers for %s\n", path);
+        jpeg_abort_decompress(&decompressor);
+        jpeg_destroy_decompress(&decompressor);
+        fclose(file);
+        free(decoded_row);
+        free(output_row);
+        free(sums);
+        free(column_counts);
+        free(output_columns);
+        return 1;
+    }
+    for (int x = 0; x < decoded_width; x++) {
+        output_columns[x] = (int)((long)x * output_size.width / decoded_width);
+        column_counts[output_columns[x]]++;
+    }
+
+    struct jpeg_compress_struct compressor;
+    struct jpeg_error_mgr compression_error_manager;
+    compressor.err = jpeg_std_error(&compression_error_manager);
+    jpeg_create_compress(&compressor);
+    jpeg_stdio_dest(&compressor, stdout);
+    compressor.image_width = output_size.width;
+    compressor.image_height = output_size.height;
+    compressor.input_components = components;
+    compressor.in_color_space = decompressor.out_color_space;
+    jpeg_set_defaults(&compressor);
+    jpeg_set_quality(&compressor, quality, TRUE);
+    compressor.dct_method = JDCT_IFAST;
+    jpeg_start_compress(&compressor, TRUE);
+    // Keeps the metadata written on saving, e.g. device ID and coordinates.
+    for (jpeg_saved_marker_ptr marker = decompressor.marker_list;
+         marker != NULL; marker = marker->next) {
+        jpeg_write_marker(&compressor, marker->marker, marker->data,
+                          marker->data_length);
+    }
+
+    int current_output_y = 0;
+    uint32_t row_count = 0;
+    while (decompressor.output_scanline < decompressor.output_height) {
+        int y = decompressor.output_scanline;
+        jpeg_read_scanlines(&decompressor, &decoded_row, 1);
+        int output_y = (int)((long)y * output_size.height / decoded_height);
+        if (output_y != current_output_y) {
+            for (size_t i = 0; i < output_row_length; i++) {
+                uint32_t count = column_counts[i / components] * row_count;
+                output_row[i] = (JSAMPLE)((sums[i] + count / 2) / count);
+            }
+            jpeg_write_scanlines(&compressor, &output_row, 1);
+            memset(sums, 0, output_row_length * sizeof(uint32_t));
+            row_count = 0;
+            current_output_y = output_y;
+        }
+        for (int x = 0; x < decoded_width; x++) {
+            uint32_t *sum = sums + (size_t)output_columns[x] * components;
+            const JSAMPLE *sample = decoded_row + (size_t)x * components;
+            for (int c = 0; c < components; c++) {
+                sum[c] += sample[c];
+            }
+        }
+        row_count++;
+    }
+    for (size_t i = 0; i < output_row_length; i++) {
+        uint32_t count = column_counts[i / components] * row_count;
+        output_row[i] = (JSAMPLE)((sums[i] + count / 2) / count);
+    }
+    jpeg_write_scanlines(&compressor, &output_row, 1);
+
+    jpeg_finish_compress(&compressor);
+    jpeg_destroy_compress(&compressor);
+    jpeg_finish_decompress(&decompressor);
+    jpeg_destroy_decompress(&decompressor);
+    fclose(file);
+    free(decoded_row);
+    free(output_row);
+    free(sums);
+    free(column_counts);
+    free(output_columns);
+    return fflush(stdout) == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    int long_edge;
+    int quality;
+    if (argc != 4 ||
+        parse_integer(argv[2], MINIMUM_LONG_EDGE, MAXIMUM_LONG_EDGE,
+                      &long_edge) != 0 ||
+        parse_integer(argv[3], 1, 100, &quality) != 0) {
+        fprintf(stderr, "Usage: %s <picture> <long edge> <quality>\n",
+                argv[0]);
+        return 2;
+    }
+    return scale_shot(argv[1], long_edge, quality);
+}
@@ -0,0 +1,172 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "frame_diff.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+const char *frame_diff_implementation(void) {
+#if defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+static uint32_t abs_diff_sum_8(const uint8_t *a, const uint8_t *b) {
+    uint32_t sum = 0;
+    for (int i = 0; i < 8; i++) {
+        sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+    }
+    return sum;
+}
+
+// Adds the absolute differences of one row to the sums of its blocks.
+static void add_row_block_sums(const uint8_t *a, const uint8_t *b, int width,
+                               uint32_t *block_sums) {
+    int x = 0;
+#if defined(__SSE2__)
+    // _mm_sad_epu8 sums up each half of the 16 bytes, one block each.
+    for (; x + 16 <= width; x += 16) {
+        __m128i sad = _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(a + x)),
+                                   _mm_loadu_si128((const __m128i *)(b + x)));
+        block_sums[x / 8] += (uint32_t)_mm_cvtsi128_si32(sad);
+        block_sums[x / 8 + 1] +=
+            (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(sad, 8));
+    }
+#elif defined(__ARM_NEON)
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t diff = vabdq_u8(vld1q_u8(a + x), vld1q_u8(b + x));
+        uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(diff)));
+        block_sums[x / 8] += (uint32_t)vgetq_lane_u64(sums, 0);
+        block_sums[x / 8 + 1] += (uint32_t)vgetq_lane_u64(sums, 1);
+    }
+#endif
+    for (; x + 8 <= width; x += 8) {
+        block_sums[x / 8] += abs_diff_sum_8(a + x, b + x);
+    }
+}
+
+void frame_diff_block_sums(const uint8_t *frame, const uint8_t *background,
+                           int width, int height, uint32_t *block_sums) {
+    int columns = width / FRAME_DIFF_BLOCK_SIZE;
+    int rows = height / FRAME_DIFF_BLOCK_SIZE;
+    for (int row = 0; row < rows; row++) {
+        uint32_t *row_sums = block_sums + (size_t)row * columns;
+        for (int column = 0; column < columns; column++) {
+            row_sums[column] = 0;
+        }
+        for (int i = 0; i < FRAME_DIFF_BLOCK_SIZE; i++) {
+            size_t offset = ((size_t)row * FRAME_DIFF_BLOCK_SIZE + i) * width;
+            add_row_block_sums(frame + offset, background + offset, width,
+                               row_sums);
+        }
+    }
+}
+
+uint64_t frame_diff_sum(const uint8_t *pixels, size_t count) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i zero = _mm_setzero_si128();
+    __m128i sums = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i values = _mm_loadu_si128((const __m128i *)(pixels + i));
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(values, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, sums);
+    sum = lanes[0] + lanes[1];
+#elif defined(__ARM_NEON)
+    uint64x2_t sums = vdupq_n_u64(0);
+    for (; i + 16 <= count; i += 16) {
+        sums = vpadalq_u32(sums, vpaddlq_u16(vpaddlq_u8(vld1q_u8(pixels + i))));
+    }
+    sum = vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+#endif
+    for (; i < count; i++) {
+        sum += pixels[i];
+    }
+    return sum;
+}
+
+void frame_diff_add_offset(uint8_t *pixels, size_t count, int offset) {
+    if (offset == 0) {
+        return;
+    }
+    uint8_t magnitude = offset > 255 || offset < -255
+                            ? 255
+                            : (uint8_t)(offset < 0 ? -offset : offset);
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i delta = _mm_set1_epi8((char)magnitude);
+    for (; i + 16 <= count; i += 16) {
+        __m128i *address = (__m128i *)(pixels + i);
+        __m128i values = _mm_loadu_si128(address);
+        values = offset > 0 ? _mm_adds_epu8(values, delta)
+                            : _mm_subs_epu8(values, delta);
+        _mm_storeu_si128(address, values);
+    }
+#elif defined(__ARM_NEON)
+    uint8x16_t delta = vdupq_n_u8(magnitude);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t values = vld1q_u8(pixels + i);
+        values = offset > 0 ? vqaddq_u8(values, delta)
+                            : vqsubq_u8(values, delta);
+        vst1q_u8(pixels + i, values);
+    }
+#endif
+    for (; i < count; i++) {
+        int value = pixels[i] + (offset > 0 ? magnitude : -magnitude);
+        pixels[i] = value < 0 ? 0 : value > 255 ? 255 : (uint8_t)value;
+    }
+}
+
+// Three rounding averages weight the frame by 1/8 without widening to 16 bits.
+void frame_diff_blend(uint8_t *background, const uint8_t *frame,
+                      size_t count) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= count; i += 16) {
+        __m128i *address = (__m128i *)(background + i);
+        __m128i old = _mm_loadu_si128(address);
+        __m128i blended =
+            _mm_avg_epu8(old, _mm_loadu_si128((const __m128i *)(frame + i)));
+        blended = _mm_avg_epu8(old, blended);
+        blended = _mm_avg_epu8(old, blended);
+        _mm_storeu_si128(address, blended);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t old = vld1q_u8(background + i);
+        uint8x16_t blended = vrhaddq_u8(old, vld1q_u8(frame + i));
+        blended = vrhaddq_u8(old, blended);
+        blended = vrhaddq_u8(old, blended);
+        vst1q_u8(background + i, blended);
+    }
+#endif
+    for (; i < count; i++) {
+        unsigned blended = (background[i] + frame[i] + 1) >> 1;
+        blended = (background[i] + blended + 1) >> 1;
+        background[i] = (uint8_t)((background[i] + blended + 1) >> 1);
+    }
+}
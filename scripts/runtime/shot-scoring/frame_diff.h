@@ -0,0 +1,43 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef FRAME_DIFF_H
+#define FRAME_DIFF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Frames are 8-bit luma planes whose width is a multiple of the block size.
+#define FRAME_DIFF_BLOCK_SIZE 8
+
+// Name of the instruction set the kernels were compiled for
+const char *frame_diff_implementation(void);
+
+// Sums up the absolute differences of both frames per block. Rows below the
+// last full block row are ignored. block_sums holds one value per block.
+void frame_diff_block_sums(const uint8_t *frame, const uint8_t *background,
+                           int width, int height, uint32_t *block_sums);
+
+// Sum of all pixel values
+uint64_t frame_diff_sum(const uint8_t *pixels, size_t count);
+
+// Adds the offset to every pixel, saturating at 0 and 255.
+void frame_diff_add_offset(uint8_t *pixels, size_t count, int offset);
+
+// Moves the background an eighth of the way towards the frame.
+void frame_diff_blend(uint8_t *background, const uint8_t *frame, size_t count);
+
+#endif
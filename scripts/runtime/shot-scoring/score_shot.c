@@ -0,0 +1,352 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <jpeglib.h>
+
+#include "frame_diff.h"
+
+// Shots are decoded at 1/8 of their size, which libjpeg does by only using
+// the DC coefficients, e.g. 240x135 pixels for a 1920x1080 shot.
+#define DECODING_SCALE_DENOMINATOR 8
+// A block counts as changed above this mean absolute difference.
+#define BLOCK_CHANGE_THRESHOLD 16
+// Below this mean chroma deviation, a shot was taken with infrared light.
+#define INFRARED_CHROMA_THRESHOLD 4
+#define MAXIMUM_SCORE 1000
+#define MODEL_MAGIC "A4BG"
+#define DEFAULT_BENCHMARK_ITERATIONS 200
+#define MODEL_PATH_LENGTH 4096
+// Room for the suffixes of the lock and temporary files
+#define SUFFIXED_PATH_LENGTH (MODEL_PATH_LENGTH + 8)
+
+typedef struct {
+    uint8_t *pixels;
+    int width;
+    int height;
+    int is_infrared;
+} frame_t;
+
+typedef struct {
+    struct jpeg_error_mgr manager;
+    jmp_buf escape;
+} jpeg_error_t;
+
+typedef struct {
+    char magic[4];
+    uint32_t width;
+    uint32_t height;
+    uint32_t frame_count;
+} model_header_t;
+
+// libjpeg exits the process on errors by default, so jump back to the
+// caller instead, which then reports the shot as undecodable.
+static void escape_on_jpeg_error(j_common_ptr decompressor) {
+    jpeg_error_t *error = (jpeg_error_t *)decompressor->err;
+    (*decompressor->err->output_message)(decompressor);
+    longjmp(error->escape, 1);
+}
+
+// Decodes the luma plane of a JPEG file cropped to full blocks.
+static int decode_frame(const char *path, frame_t *frame) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror("Failed to open shot");
+        return -1;
+    }
+
+    struct jpeg_decompress_struct decompressor;
+    jpeg_error_t error;
+    // Volatile, as it is assigned after setjmp and freed after longjmp
+    JSAMPLE *volatile allocated_row = NULL;
+    frame->pixels = NULL;
+    decompressor.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = escape_on_jpeg_error;
+    jpeg_create_decompress(&decompressor);
+    if (setjmp(error.escape)) {
+        fprintf(stderr, "Failed to decode shot %s\n", path);
+        jpeg_destroy_decompress(&decompressor);
+        fclose(file);
+        free(allocated_row);
+        free(frame->pixels);
+        frame->pixels = NULL;
+        return -1;
+    }
+    jpeg_stdio_src(&decompressor, file);
+    jpeg_read_header(&decompressor, TRUE);
+    decompressor.scale_num = 1;
+    decompressor.scale_denom = DECODING_SCALE_DENOMINATOR;
+    decompressor.dct_method = JDCT_IFAST;
+    int is_colour = decompressor.num_components == 3;
+    decompressor.out_color_space = is_colour ? JCS_YCbCr : JCS_GRAYSCALE;
+    jpeg_start_decompress(&decompressor);
+
+    int components = decompressor.output_components;
+    int width = decompressor.output_width & ~(FRAME_DIFF_BLOCK_SIZE - 1);
+    int height = decompressor.output_height & ~(FRAME_DIFF_BLOCK_SIZE - 1);
+    JSAMPLE *row = malloc((size_t)decompressor.output_width * components);
+    allocated_row = row;
+    frame->pixels = malloc((size_t)width * height);
+    if (row == NULL || frame->pixels == NULL || width == 0 || height == 0) {
+        fprintf(stderr, "Failed to decode shot %s\n", path);
+        jpeg_abort_decompress(&decompressor);
+        jpeg_destroy_decompress(&decompressor);
+        fclose(file);
+        free(row);
+        free(frame->pixels);
+        return -1;
+    }
+
+    uint64_t chroma_deviation = 0;
+    while (decompressor.output_scanline < decompressor.output_height) {
+        int y = decompressor.output_scanline;
+        jpeg_read_scanlines(&decompressor, &row, 1);
+        if (y >= height) {
+            continue;
+        }
+        uint8_t *pixels = frame->pixels + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            const JSAMPLE *sample = row + (size_t)x * components;
+            pixels[x] = sample[0];
+            if (is_colour) {
+                chroma_deviation += abs(sample[1] - 128) + abs(sample[2] - 128);
+            }
+        }
+    }
+    jpeg_finish_decompress(&decompressor);
+    jpeg_destroy_decompress(&decompressor);
+    fclose(file);
+    free(row);
+
+    frame->width = width;
+    frame->height = height;
+    frame->is_infrared =
+        chroma_deviation / ((uint64_t)width * height) < INFRARED_CHROMA_THRESHOLD;
+    return 0;
+}
+
+// Shares of changed blocks in per mille, after compensating global
+// brightness changes such as clouds passing by.
+static int score_frame(const frame_t *frame, const uint8_t *background,
+                       uint8_t *scratch, uint32_t *block_sums) {
+    size_t count = (size_t)frame->width * frame->height;
+    int64_t brightness_difference =
+        ((int64_t)frame_diff_sum(background, count) -
+         (int64_t)frame_diff_sum(frame->pixels, count)) /
+        (int64_t)count;
+    memcpy(scratch, frame->pixels, count);
+    frame_diff_add_offset(scratch, count, (int)brightness_difference);
+    frame_diff_block_sums(scratch, background, frame->width, frame->height,
+                          block_sums);
+
+    int block_count = (frame->width / FRAME_DIFF_BLOCK_SIZE) *
+                      (frame->height / FRAME_DIFF_BLOCK_SIZE);
+    uint32_t changed_block_sum = BLOCK_CHANGE_THRESHOLD *
+                                 FRAME_DIFF_BLOCK_SIZE * FRAME_DIFF_BLOCK_SIZE;
+    int changed_block_count = 0;
+    for (int i = 0; i < block_count; i++) {
+        if (block_sums[i] > changed_block_sum) {
+            changed_block_count++;
+        }
+    }
+    return changed_block_count * MAXIMUM_SCORE / block_count;
+}
+
+static int read_model(const char *path, const frame_t *frame,
+                      uint8_t *background, uint32_t *frame_count) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    model_header_t header;
+    size_t count = (size_t)frame->width * frame->height;
+    int result = -1;
+    if (fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.magic, MODEL_MAGIC, sizeof(header.magic)) == 0 &&
+        header.width == (uint32_t)frame->width &&
+        header.height == (uint32_t)frame->height &&
+        fread(background, 1, count, file) == count) {
+        *frame_count = header.frame_count;
+        result = 0;
+    }
+    fclose(file);
+    return result;
+}
+
+// Writes next to the model and renames, so that a crash never leaves a
+// truncated model behind.
+static int write_model(const char *path, const frame_t *frame,
+                       const uint8_t *background, uint32_t frame_count) {
+    char temporary_path[SUFFIXED_PATH_LENGTH];
+    snprintf(temporary_path, sizeof(temporary_path), "%s.part", path);
+    FILE *file = fopen(temporary_path, "wb");
+    if (file == NULL) {
+        perror("Failed to write background model");
+        return -1;
+    }
+    model_header_t header;
+    memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+    header.width = frame->width;
+    header.height = frame->height;
+    header.frame_count = frame_count;
+    size_t count = (size_t)frame->width * frame->height;
+    int is_written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                     fwrite(background, 1, count, file) == count;
+    if (fclose(file) != 0 || !is_written) {
+        perror("Failed to write background model");
+        unlink(temporary_path);
+        return -1;
+    }
+    return rename(temporary_path, path);
+}
+
+static int score_shot(const char *shot_path, const char *model_folder_path) {
+    frame_t frame;
+    if (decode_frame(shot_path, &frame) != 0) {
+        return 1;
+    }
+
+    // One model per camera resolution and light, as infrared shots look
+    // nothing like daylight ones.
+    char model_path[MODEL_PATH_LENGTH];
+    snprintf(model_path, sizeof(model_path), "%s/background-%dx%d-%s.bin",
+             model_folder_path, frame.width, frame.height,
+             frame.is_infrared ? "infrared" : "visible");
+    char lock_path[SUFFIXED_PATH_LENGTH];
+    snprintf(lock_path, sizeof(lock_path), "%s.lock", model_path);
+    int lock = open(lock_path, O_CREAT | O_RDWR, 0644);
+    if (lock < 0 || flock(lock, LOCK_EX) != 0) {
+        perror("Failed to lock background model");
+        free(frame.pixels);
+        return 1;
+    }
+
+    size_t count = (size_t)frame.width * frame.height;
+    uint8_t *background = malloc(count);
+    uint8_t *scratch = malloc(count);
+    uint32_t *block_sums =
+        malloc(count / (FRAME_DIFF_BLOCK_SIZE * FRAME_DIFF_BLOCK_SIZE) *
+               sizeof(uint32_t));
+    int status = 1;
+    if (background != NULL && scratch != NULL && block_sums != NULL) {
+        uint32_t frame_count = 0;
+        if (read_model(model_path, &frame, background, &frame_count) == 0) {
+            printf("%d\n",
+                   score_frame(&frame, background, scratch, block_sums));
+            frame_diff_blend(background, frame.pixels, count);
+        } else {
+            // Without a background, there is nothing to score against yet.
+            memcpy(background, frame.pixels, count);
+            frame_count = 0;
+        }
+        if (write_model(model_path, &frame, background, frame_count + 1) ==
+            0) {
+            status = 0;
+        }
+    }
+
+    close(lock);
+    free(background);
+    free(scratch);
+    free(block_sums);
+    free(frame.pixels);
+    return status;
+}
+
+static double elapsed_seconds(const struct timespec *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (double)(end.tv_sec - start->tv_sec) +
+           (double)(end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int benchmark(const char *shot_path, int iterations) {
+    frame_t frame;
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++) {
+        if (decode_frame(shot_path, &frame) != 0) {
+            return 1;
+        }
+        if (i < iterations - 1) {
+            free(frame.pixels);
+        }
+    }
+    double decoding_seconds = elapsed_seconds(&start);
+
+    size_t count = (size_t)frame.width * frame.height;
+    uint8_t *background = malloc(count);
+    uint8_t *scratch = malloc(count);
+    uint32_t *block_sums =
+        malloc(count / (FRAME_DIFF_BLOCK_SIZE * FRAME_DIFF_BLOCK_SIZE) *
+               sizeof(uint32_t));
+    if (background == NULL || scratch == NULL || block_sums == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        background[i] = (uint8_t)(frame.pixels[i] ^ (i & 0x1F));
+    }
+
+    int score = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++) {
+        score += score_frame(&frame, background, scratch, block_sums);
+        frame_diff_blend(background, frame.pixels, count);
+    }
+    double scoring_seconds = elapsed_seconds(&start);
+
+    printf("Kernels: %s\n", frame_diff_implementation());
+    printf("Frame size: %dx%d (%s)\n", frame.width, frame.height,
+           frame.is_infrared ? "infrared" : "visible");
+    printf("Decoding: %.1f frames per second\n", iterations / decoding_seconds);
+    printf("Scoring: %.1f frames per second\n", iterations / scoring_seconds);
+    printf("Total: %.1f frames per second (mean score %d)\n",
+           iterations / (decoding_seconds + scoring_seconds),
+           score / iterations);
+
+    free(background);
+    free(scratch);
+    free(block_sums);
+    free(frame.pixels);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && strcmp(argv[1], "--benchmark") == 0) {
+        int iterations =
+            argc >= 4 ? atoi(argv[3]) : DEFAULT_BENCHMARK_ITERATIONS;
+        return benchmark(argv[2], iterations > 0 ? iterations : 1);
+    }
+    if (argc != 3) {
+        fprintf(stderr,
+                "Usage: %s <shot> <model folder>\n"
+                "       %s --benchmark <shot> [iterations]\n",
+                argv[0], argv[0]);
+        return 2;
+    }
+    return score_shot(argv[1], argv[2]);
+}
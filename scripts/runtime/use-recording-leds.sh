@@ -14,6 +14,8 @@
 # You should have received a copy of the GNU General Public License
 # along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
 
+"$(dirname "$0")"/post-to-backend.sh event-log/events type=triggerStart
+
 # Exit when alternating light mode is enabled because light should not change.
 is_alternating_light_mode_enabled=$(curl "http://127.0.0.1:3000/settings/isAlternatingLightModeEnabled")
 if [ "$is_alternating_light_mode_enabled" = "true" ]; then
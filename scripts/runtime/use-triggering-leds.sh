@@ -14,6 +14,11 @@
 # You should have received a copy of the GNU General Public License
 # along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
 
+# Only Motion calls this script without light type, at the end of an event.
+if [ -z "$2" ]; then
+  "$(dirname "$0")"/post-to-backend.sh event-log/events type=triggerEnd
+fi
+
 if [ "$3" ]; then
   is_alternating_light_mode_enabled="$3"
 else
@@ -52,7 +57,38 @@ fi
 # Wait until the image is not changing anymore and resume motion
 # when the light type is not passed.
 if [ ! "$2" ]; then
-  sleep 15
+  # Resume as soon as the exposure has settled to the new light, at the latest
+  # after the timeout.
+  timeout_ms=$(sed -n 's/.*SCENE_SETTLE_TIMEOUT_MS=\([0-9]*\).*/\1/p' /home/app4cam/app4cam-backend/config/production.env)
+  timeout_ms=${timeout_ms:-15000}
+  scene_settle="$(dirname "$0")"/scene-settling/scene_settle
+  settle_ms=
+  is_timed_out=
+  if [ -x "$scene_settle" ]; then
+    settle_ms=$("$scene_settle" --timeout "$timeout_ms")
+    exit_code=$?
+    # 0 if the scene settled and 1 on timeout, anything else is a failure.
+    if [ "$exit_code" -le 1 ] && [ -n "$settle_ms" ]; then
+      is_timed_out=$exit_code
+    else
+      settle_ms=
+    fi
+  fi
+  if [ -z "$settle_ms" ]; then
+    # Without a working scene_settle, wait for the whole timeout instead.
+    echo "scene_settle unavailable, waiting for the timeout"
+    sleep $((timeout_ms / 1000))
+    settle_ms=$timeout_ms
+  fi
+  echo "Scene settled after $settle_ms ms"
   echo "Resuming motion..."
   curl $url/start
+
+  if [ "$light_type" = "infrared" ]; then
+    light_code=1
+  else
+    light_code=2
+  fi
+  "$(dirname "$0")"/post-to-backend.sh event-log/events type=sceneSettled \
+    code:="$light_code" value:="$settle_ms" secondaryValue:="$is_timed_out"
 fi
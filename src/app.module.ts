@@ -21,17 +21,27 @@ import { ScheduleModule } from '@nestjs/schedule'
 import { AccessControlAllowOriginInterceptor } from './access-control-allow-origin.interceptor'
 import { AppController } from './app.controller'
 import { AppService } from './app.service'
+import { BootModule } from './boot/boot.module'
+import { DetectionMaskModule } from './detection-mask/detection-mask.module'
+import { EventLogModule } from './event-log/event-log.module'
 import { configuration } from './config/configuration'
 import { validate } from './config/validation'
 import { FilesModule } from './files/files.module'
+import { LiveStreamModule } from './live-stream/live-stream.module'
 import { LogFilesModule } from './log-files/log-files.module'
 import { LoggerMiddleware } from './logger.middleware'
+import { MetricsModule } from './metrics/metrics.module'
 import { MotionClientService } from './motion-client.service'
 import { MotionInteractorModule } from './motion-interactor/motion-interactor.module'
+import { MovieEncodingModule } from './movie-encoding/movie-encoding.module'
+import { NotificationsModule } from './notifications/notifications.module'
+import { OffloadModule } from './offload/offload.module'
 import { PropertiesModule } from './properties/properties.module'
+import { RetentionModule } from './retention/retention.module'
 import { SettingsModule } from './settings/settings.module'
 import { SnapshotsModule } from './snapshots/snapshots.module'
 import { StorageModule } from './storage/storage.module'
+import { SyncModule } from './sync/sync.module'
 import { UpgradesModule } from './upgrades/upgrades.module'
 
 @Module({
@@ -50,6 +60,16 @@ import { UpgradesModule } from './upgrades/upgrades.module'
     LogFilesModule,
     MotionInteractorModule,
     UpgradesModule,
+    RetentionModule,
+    EventLogModule,
+    MetricsModule,
+    BootModule,
+    NotificationsModule,
+    LiveStreamModule,
+    DetectionMaskModule,
+    MovieEncodingModule,
+    SyncModule,
+    OffloadModule,
   ],
   controllers: [AppController],
   providers: [
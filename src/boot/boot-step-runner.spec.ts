@@ -0,0 +1,155 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Logger } from '@nestjs/common'
+import { vi } from 'vitest'
+import { BootStepRunner } from './boot-step-runner'
+
+describe(BootStepRunner.name, () => {
+  const logger = new Logger('test')
+  let elapsedMs: number
+  const getElapsedMs = () => elapsedMs
+
+  beforeAll(() => {
+    vi.spyOn(logger, 'warn').mockImplementation(() => {})
+    vi.spyOn(logger, 'error').mockImplementation(() => {})
+  })
+
+  beforeEach(() => {
+    elapsedMs = 0
+  })
+
+  describe(BootStepRunner.run.name, () => {
+    it('starts independent steps without waiting for each other', async () => {
+      const order: string[] = []
+      let releaseFirst: () => void
+      const first = new Promise<void>((resolve) => (releaseFirst = resolve))
+      const timings = BootStepRunner.run(
+        [
+          {
+            name: 'a',
+            run: async () => {
+              order.push('a started')
+              await first
+              order.push('a done')
+            },
+          },
+          {
+            name: 'b',
+            run: () => {
+              order.push('b started')
+              releaseFirst()
+            },
+          },
+        ],
+        'critical',
+        getElapsedMs,
+        logger,
+      )
+      await timings
+      expect(order).toEqual(['a started', 'b started', 'a done'])
+    })
+
+    it('runs a step only after its dependencies', async () => {
+      const order: string[] = []
+      await BootStepRunner.run(
+        [
+          { name: 'b', dependencies: ['a'], run: () => order.push('b') },
+          {
+            name: 'a',
+            run: async () => {
+              await new Promise((resolve) => setImmediate(resolve))
+              order.push('a')
+            },
+          },
+        ],
+        'critical',
+        getElapsedMs,
+        logger,
+      )
+      expect(order).toEqual(['a', 'b'])
+    })
+
+    it('returns timings in step order', async () => {
+      const timings = await BootStepRunner.run(
+        [
+          {
+            name: 'a',
+            run: () => {
+              elapsedMs += 5
+            },
+          },
+        ],
+        'deferred',
+        getElapsedMs,
+        logger,
+      )
+      expect(timings).toEqual([
+        {
+          name: 'a',
+          phase: 'deferred',
+          startMs: 0,
+          durationMs: 5,
+          status: 'succeeded',
+        },
+      ])
+    })
+
+    it('skips dependents of a failed deferred step', async () => {
+      const dependent = vi.fn()
+      const timings = await BootStepRunner.run(
+        [
+          {
+            name: 'a',
+            run: () => {
+              throw new Error('broken')
+            },
+          },
+          { name: 'b', dependencies: ['a'], run: dependent },
+        ],
+        'deferred',
+        getElapsedMs,
+        logger,
+      )
+      expect(dependent).not.toHaveBeenCalled()
+      expect(timings.map((timing) => timing.status)).toEqual([
+        'failed',
+        'skipped',
+      ])
+      expect(timings[0].error).toBe('broken')
+    })
+
+    it('throws if a critical step fails', async () => {
+      await expect(
+        BootStepRunner.run(
+          [
+            {
+              name: 'a',
+              run: () => Promise.reject(new Error('broken')),
+            },
+          ],
+          'critical',
+          getElapsedMs,
+          logger,
+        ),
+      ).rejects.toThrow("Boot step 'a' failed: broken")
+    })
+  })
+
+  afterAll(() => {
+    vi.restoreAllMocks()
+  })
+})
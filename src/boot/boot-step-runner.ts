@@ -0,0 +1,105 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Logger } from '@nestjs/common'
+import { BootPhase, BootStepTiming } from './entities/boot-report.entity'
+
+export interface BootStep {
+  name: string
+  dependencies?: string[]
+  run: () => Promise<unknown> | unknown
+}
+
+/**
+ * Runs steps as soon as their dependencies are done, so that independent
+ * steps overlap. A failed critical step fails the whole phase, while failed
+ * deferred steps are only logged. Dependents of a failed step are skipped.
+ */
+export class BootStepRunner {
+  private readonly results = new Map<string, Promise<BootStepTiming>>()
+  private readonly stepsByName: Map<string, BootStep>
+
+  private constructor(
+    private readonly steps: BootStep[],
+    private readonly phase: BootPhase,
+    private readonly getElapsedMs: () => number,
+    private readonly logger: Logger,
+  ) {
+    this.stepsByName = new Map(steps.map((step) => [step.name, step]))
+  }
+
+  static async run(
+    steps: BootStep[],
+    phase: BootPhase,
+    getElapsedMs: () => number,
+    logger: Logger,
+  ): Promise<BootStepTiming[]> {
+    const runner = new BootStepRunner(steps, phase, getElapsedMs, logger)
+    const timings = await Promise.all(
+      steps.map((step) => runner.start(step.name)),
+    )
+    const failedTiming = timings.find((timing) => timing.status === 'failed')
+    if (phase === 'critical' && failedTiming) {
+      throw new Error(
+        `Boot step '${failedTiming.name}' failed: ${failedTiming.error}`,
+      )
+    }
+    return timings
+  }
+
+  private start(name: string): Promise<BootStepTiming> {
+    let result = this.results.get(name)
+    if (!result) {
+      const step = this.stepsByName.get(name)
+      if (!step) {
+        return Promise.reject(new Error(`Unknown boot step '${name}'`))
+      }
+      result = this.runAfterDependencies(step)
+      this.results.set(name, result)
+    }
+    return result
+  }
+
+  private async runAfterDependencies(step: BootStep): Promise<BootStepTiming> {
+    const dependencyTimings = await Promise.all(
+      (step.dependencies ?? []).map((name) => this.start(name)),
+    )
+    const startMs = this.getElapsedMs()
+    const timing: BootStepTiming = {
+      name: step.name,
+      phase: this.phase,
+      startMs,
+      durationMs: 0,
+      status: 'succeeded',
+    }
+    const isDependencyUnsuccessful = dependencyTimings.some(
+      (dependency) => dependency.status !== 'succeeded',
+    )
+    if (isDependencyUnsuccessful) {
+      this.logger.warn(`Skipping boot step '${step.name}'.`)
+      return { ...timing, status: 'skipped' }
+    }
+    try {
+      await step.run()
+    } catch (error) {
+      this.logger.error(`Boot step '${step.name}' failed: ${error.message}`)
+      timing.status = 'failed'
+      timing.error = error.message
+    }
+    timing.durationMs = this.getElapsedMs() - startMs
+    return timing
+  }
+}
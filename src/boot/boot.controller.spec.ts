@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { NotFoundException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { BootController } from './boot.controller'
+import { BootService } from './boot.service'
+
+describe(BootController.name, () => {
+  let controller: BootController
+  let service: BootService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [BootController],
+      providers: [BootService],
+    }).compile()
+
+    controller = module.get<BootController>(BootController)
+    service = module.get<BootService>(BootService)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(BootController.prototype.getReport.name, () => {
+    it('throws if the application has not finished booting', () => {
+      expect(() => controller.getReport()).toThrow(NotFoundException)
+    })
+
+    it('returns the report including deferred steps', () => {
+      service.setReport({
+        version: '1.0.0',
+        bootstrapStartMs: 500,
+        listeningAfterMs: 900,
+        finishedAfterMs: null,
+        systemUptimeAtListeningSeconds: 30,
+        steps: [
+          {
+            name: 'logVersion',
+            phase: 'critical',
+            startMs: 600,
+            durationMs: 10,
+            status: 'succeeded',
+          },
+        ],
+      })
+      service.addDeferredTimings(
+        [
+          {
+            name: 'resetLights',
+            phase: 'deferred',
+            startMs: 900,
+            durationMs: 100,
+            status: 'succeeded',
+          },
+        ],
+        1000,
+      )
+      const report = controller.getReport()
+      expect(report.finishedAfterMs).toBe(1000)
+      expect(report.steps.map((step) => step.name)).toEqual([
+        'logVersion',
+        'resetLights',
+      ])
+    })
+  })
+})
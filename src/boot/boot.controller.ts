@@ -0,0 +1,33 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Controller, Get, NotFoundException } from '@nestjs/common'
+import { BootService } from './boot.service'
+import { BootReport } from './entities/boot-report.entity'
+
+@Controller('boot')
+export class BootController {
+  constructor(private readonly bootService: BootService) {}
+
+  @Get('report')
+  getReport(): BootReport {
+    const report = this.bootService.getReport()
+    if (!report) {
+      throw new NotFoundException('The application has not finished booting.')
+    }
+    return report
+  }
+}
@@ -0,0 +1,10 @@
+import { BootReport, BootStepTiming } from './entities/boot-report.entity'
+
+export interface IBootService {
+  getReport: () => BootReport | undefined
+  setReport: (report: BootReport) => void
+  addDeferredTimings: (
+    timings: BootStepTiming[],
+    finishedAfterMs: number,
+  ) => void
+}
@@ -0,0 +1,40 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Injectable } from '@nestjs/common'
+import { BootReport, BootStepTiming } from './entities/boot-report.entity'
+import { IBootService } from './boot.service.interface'
+
+@Injectable()
+export class BootService implements IBootService {
+  private report: BootReport | undefined
+
+  getReport(): BootReport | undefined {
+    return this.report
+  }
+
+  setReport(report: BootReport): void {
+    this.report = report
+  }
+
+  addDeferredTimings(timings: BootStepTiming[], finishedAfterMs: number) {
+    if (!this.report) {
+      return
+    }
+    this.report.steps.push(...timings)
+    this.report.finishedAfterMs = finishedAfterMs
+  }
+}
@@ -27,4 +27,38 @@ export const configuration = () => ({
     (process.env.IS_CAMERA_FOCUS_FIXED &&
       process.env.IS_CAMERA_FOCUS_FIXED == 'true') ||
     false,
+  isRetentionEnabled:
+    (process.env.RETENTION_ENABLED &&
+      process.env.RETENTION_ENABLED == 'true') ||
+    false,
+  retentionLowWaterMarkPercentage: process.env
+    .RETENTION_LOW_WATER_MARK_PERCENTAGE
+    ? parseFloat(process.env.RETENTION_LOW_WATER_MARK_PERCENTAGE)
+    : 10,
+  retentionMinimumAgeHours: process.env.RETENTION_MINIMUM_AGE_HOURS
+    ? parseFloat(process.env.RETENTION_MINIMUM_AGE_HOURS)
+    : 24,
+  isOffloadEnabled:
+    (process.env.OFFLOAD_ENABLED && process.env.OFFLOAD_ENABLED == 'true') ||
+    false,
+  isOffloadMoving:
+    (process.env.OFFLOAD_MOVING_ENABLED &&
+      process.env.OFFLOAD_MOVING_ENABLED == 'true') ||
+    false,
+  offloadMaximumMegabytesPerSecond: process.env
+    .OFFLOAD_MAXIMUM_MEGABYTES_PER_SECOND
+    ? parseFloat(process.env.OFFLOAD_MAXIMUM_MEGABYTES_PER_SECOND)
+    : 4,
+  detectionGateMinimumDwellSeconds: process.env
+    .DETECTION_GATE_MINIMUM_DWELL_SECONDS
+    ? parseFloat(process.env.DETECTION_GATE_MINIMUM_DWELL_SECONDS)
+    : 60,
+  diskSpaceGateHysteresisPercentage: process.env
+    .DISK_SPACE_GATE_HYSTERESIS_PERCENTAGE
+    ? parseFloat(process.env.DISK_SPACE_GATE_HYSTERESIS_PERCENTAGE)
+    : 2,
+  temperatureGateHysteresisDegrees: process.env
+    .TEMPERATURE_GATE_HYSTERESIS_DEGREES
+    ? parseFloat(process.env.TEMPERATURE_GATE_HYSTERESIS_DEGREES)
+    : 1,
 })
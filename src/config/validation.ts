@@ -15,7 +15,15 @@
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
 import { plainToClass } from 'class-transformer'
-import { IsNotEmpty, IsPositive, IsString, validateSync } from 'class-validator'
+import {
+  IsNotEmpty,
+  IsOptional,
+  IsPositive,
+  IsString,
+  Max,
+  Min,
+  validateSync,
+} from 'class-validator'
 
 class EnvironmentVariables {
   @IsNotEmpty()
@@ -35,6 +43,39 @@ class EnvironmentVariables {
   SERVICE_NAME: string
 
   IS_CAMERA_FOCUS_FIXED: boolean
+
+  RETENTION_ENABLED: boolean
+
+  // Above 5 % so that space is freed before Motion gets paused at 95 % usage.
+  @IsOptional()
+  @Min(5)
+  @Max(50)
+  RETENTION_LOW_WATER_MARK_PERCENTAGE: number
+
+  @IsOptional()
+  @Min(0)
+  RETENTION_MINIMUM_AGE_HOURS: number
+
+  OFFLOAD_ENABLED: boolean
+
+  OFFLOAD_MOVING_ENABLED: boolean
+
+  @IsOptional()
+  @IsPositive()
+  OFFLOAD_MAXIMUM_MEGABYTES_PER_SECOND: number
+
+  @IsOptional()
+  @Min(0)
+  DETECTION_GATE_MINIMUM_DWELL_SECONDS: number
+
+  @IsOptional()
+  @Min(0)
+  @Max(50)
+  DISK_SPACE_GATE_HYSTERESIS_PERCENTAGE: number
+
+  @IsOptional()
+  @Min(0)
+  TEMPERATURE_GATE_HYSTERESIS_DEGREES: number
 }
 
 export function validate(config: Record<string, unknown>) {
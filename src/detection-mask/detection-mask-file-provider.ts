@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { copyFile, readFile, rename, rm, writeFile } from 'fs/promises'
+import { DetectionMaskDto } from './dto/detection-mask.dto'
+import { GreyscaleImage, MaskRasterizer } from './mask-rasterizer'
+
+const JSON_INDENTATION_SPACES = 2
+const TEMPORARY_FILE_SUFFIX = '.tmp'
+
+export class DetectionMaskFileProvider {
+  static async readMask(filePath: string): Promise<DetectionMaskDto> {
+    try {
+      const data = await readFile(filePath)
+      const mask = JSON.parse(data.toString())
+      return Array.isArray(mask.excludedRegions)
+        ? mask
+        : { excludedRegions: [] }
+    } catch (err) {
+      if (err.code !== 'ENOENT' && err.name !== 'SyntaxError') {
+        throw err
+      }
+      return { excludedRegions: [] }
+    }
+  }
+
+  static async writeMask(
+    mask: DetectionMaskDto,
+    filePath: string,
+  ): Promise<void> {
+    const data = JSON.stringify(mask, null, JSON_INDENTATION_SPACES)
+    await DetectionMaskFileProvider.writeFileAtomically(filePath, data)
+  }
+
+  /**
+   * Writes to a temporary file first and renames it, so that Motion never
+   * reads a partially written mask.
+   */
+  static async writeFileAtomically(
+    filePath: string,
+    data: string | Uint8Array,
+  ): Promise<void> {
+    const temporaryFilePath = filePath + TEMPORARY_FILE_SUFFIX
+    try {
+      await writeFile(temporaryFilePath, data)
+      await rename(temporaryFilePath, filePath)
+    } catch (err) {
+      await rm(temporaryFilePath, { force: true })
+      throw err
+    }
+  }
+
+  static async readImage(
+    filePath: string,
+  ): Promise<GreyscaleImage | undefined> {
+    try {
+      return MaskRasterizer.fromPgm(await readFile(filePath))
+    } catch (err) {
+      if (err.code !== 'ENOENT') {
+        throw err
+      }
+      return undefined
+    }
+  }
+
+  /**
+   * Copies the file, or removes an earlier copy if there is no file anymore.
+   */
+  static async copyFileOrRemoveCopy(
+    filePath: string,
+    copyFilePath: string,
+  ): Promise<void> {
+    try {
+      await copyFile(filePath, copyFilePath)
+    } catch (err) {
+      if (err.code !== 'ENOENT') {
+        throw err
+      }
+      await rm(copyFilePath, { force: true })
+    }
+  }
+}
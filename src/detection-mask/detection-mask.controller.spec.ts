@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { StreamableFile } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { DetectionMaskController } from './detection-mask.controller'
+import { DetectionMaskService } from './detection-mask.service'
+import { IDetectionMaskService } from './detection-mask.service.interface'
+import { DetectionMaskDto } from './dto/detection-mask.dto'
+
+describe(DetectionMaskController.name, () => {
+  const MASK: DetectionMaskDto = { excludedRegions: [] }
+  const PREVIEW = Buffer.from('p')
+
+  class MockDetectionMaskService implements Partial<IDetectionMaskService> {
+    getMask = vi.fn(() => Promise.resolve(MASK))
+    getPreview = vi.fn(() => Promise.resolve(PREVIEW))
+    updateMask = vi.fn(() => Promise.resolve(PREVIEW))
+  }
+
+  let controller: DetectionMaskController
+  let service: MockDetectionMaskService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [DetectionMaskController],
+      providers: [
+        { provide: DetectionMaskService, useClass: MockDetectionMaskService },
+      ],
+    }).compile()
+
+    controller = module.get<DetectionMaskController>(DetectionMaskController)
+    service = module.get(DetectionMaskService)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(DetectionMaskController.prototype.getMask.name, () => {
+    it('returns the mask', async () => {
+      expect(await controller.getMask()).toEqual(MASK)
+    })
+  })
+
+  describe(DetectionMaskController.prototype.updateMask.name, () => {
+    it('updates the mask and returns the preview as PNG', async () => {
+      const response = await controller.updateMask(MASK)
+      expect(service.updateMask).toHaveBeenCalledWith(MASK)
+      expect(response).toBeInstanceOf(StreamableFile)
+      expect(response.getHeaders().type).toBe('image/png')
+    })
+  })
+
+  describe(DetectionMaskController.prototype.getPreview.name, () => {
+    it('returns the preview as PNG', async () => {
+      const response = await controller.getPreview()
+      expect(response.getHeaders().type).toBe('image/png')
+    })
+  })
+})
@@ -0,0 +1,43 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Body, Controller, Get, Put, StreamableFile } from '@nestjs/common'
+import { DetectionMaskService } from './detection-mask.service'
+import { DetectionMaskDto } from './dto/detection-mask.dto'
+
+const PREVIEW_CONTENT_TYPE = 'image/png'
+
+@Controller('detection-mask')
+export class DetectionMaskController {
+  constructor(private readonly detectionMaskService: DetectionMaskService) {}
+
+  @Get()
+  getMask(): Promise<DetectionMaskDto> {
+    return this.detectionMaskService.getMask()
+  }
+
+  @Put()
+  async updateMask(@Body() mask: DetectionMaskDto): Promise<StreamableFile> {
+    const preview = await this.detectionMaskService.updateMask(mask)
+    return new StreamableFile(preview, { type: PREVIEW_CONTENT_TYPE })
+  }
+
+  @Get('preview')
+  async getPreview(): Promise<StreamableFile> {
+    const preview = await this.detectionMaskService.getPreview()
+    return new StreamableFile(preview, { type: PREVIEW_CONTENT_TYPE })
+  }
+}
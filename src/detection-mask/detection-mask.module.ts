@@ -0,0 +1,26 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Module } from '@nestjs/common'
+import { MotionClientService } from '../motion-client.service'
+import { DetectionMaskController } from './detection-mask.controller'
+import { DetectionMaskService } from './detection-mask.service'
+
+@Module({
+  controllers: [DetectionMaskController],
+  providers: [DetectionMaskService, MotionClientService],
+})
+export class DetectionMaskModule {}
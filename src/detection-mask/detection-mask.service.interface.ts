@@ -0,0 +1,7 @@
+import { DetectionMaskDto } from './dto/detection-mask.dto'
+
+export interface IDetectionMaskService {
+  getMask: () => Promise<DetectionMaskDto>
+  getPreview: () => Promise<Buffer>
+  updateMask: (mask: DetectionMaskDto) => Promise<Buffer>
+}
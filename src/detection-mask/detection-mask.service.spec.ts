@@ -0,0 +1,176 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Test, TestingModule } from '@nestjs/testing'
+import { Mock, vi } from 'vitest'
+import { MotionClientService } from '../motion-client.service'
+import { IMotionClientService } from '../motion-client.service.interface'
+import { DetectionMaskFileProvider } from './detection-mask-file-provider'
+import { DetectionMaskService } from './detection-mask.service'
+import { DetectionMaskDto } from './dto/detection-mask.dto'
+import { MASKED_PIXEL_VALUE } from './mask-rasterizer'
+
+describe(DetectionMaskService.name, () => {
+  const HEIGHT = 4
+  const WIDTH = 8
+  const MASK: DetectionMaskDto = {
+    excludedRegions: [
+      {
+        points: [
+          { x: 0, y: 0 },
+          { x: 0.5, y: 0 },
+          { x: 0.5, y: 1 },
+        ],
+      },
+    ],
+  }
+
+  const SHIPPED_MASK_FILE_PATH = '/a/b.pgm'
+
+  class MockMotionClientService implements Partial<IMotionClientService> {
+    maskFilePath = SHIPPED_MASK_FILE_PATH
+    getHeight = () => Promise.resolve(HEIGHT)
+    getMaskFile = () => Promise.resolve(this.maskFilePath)
+    getWidth = () => Promise.resolve(WIDTH)
+    restart = vi.fn(() => Promise.resolve())
+    setMaskFile = vi.fn(async (value: string) => {
+      this.maskFilePath = value
+    })
+  }
+
+  let motionClientService: MockMotionClientService
+  let service: DetectionMaskService
+  let spyCopyFileOrRemoveCopy: Mock
+  let spyReadImage: Mock
+  let spyReadMask: Mock
+  let spyWriteFileAtomically: Mock
+  let spyWriteMask: Mock
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: MotionClientService, useClass: MockMotionClientService },
+        DetectionMaskService,
+      ],
+    }).compile()
+
+    motionClientService = module.get(MotionClientService)
+    service = module.get<DetectionMaskService>(DetectionMaskService)
+    spyCopyFileOrRemoveCopy = vi
+      .spyOn(DetectionMaskFileProvider, 'copyFileOrRemoveCopy')
+      .mockResolvedValue()
+    spyReadImage = vi
+      .spyOn(DetectionMaskFileProvider, 'readImage')
+      .mockResolvedValue(undefined)
+    spyReadMask = vi
+      .spyOn(DetectionMaskFileProvider, 'readMask')
+      .mockResolvedValue(MASK)
+    spyWriteFileAtomically = vi
+      .spyOn(DetectionMaskFileProvider, 'writeFileAtomically')
+      .mockResolvedValue()
+    spyWriteMask = vi
+      .spyOn(DetectionMaskFileProvider, 'writeMask')
+      .mockResolvedValue()
+  })
+
+  it('should be defined', () => {
+    expect(service).toBeDefined()
+  })
+
+  describe(DetectionMaskService.prototype.getMask.name, () => {
+    it('returns the stored mask', async () => {
+      expect(await service.getMask()).toEqual(MASK)
+      expect(spyReadMask).toHaveBeenCalled()
+    })
+  })
+
+  describe(DetectionMaskService.prototype.updateMask.name, () => {
+    it('writes the mask image at the configured resolution', async () => {
+      await service.updateMask(MASK)
+      const image = spyWriteFileAtomically.mock.calls[0][1] as Buffer
+      const header = Buffer.from(`P5\n${WIDTH} ${HEIGHT}\n255\n`)
+      expect(image.subarray(0, header.length)).toEqual(header)
+      expect(image.length).toBe(header.length + WIDTH * HEIGHT)
+      expect(spyWriteMask).toHaveBeenCalledWith(MASK, expect.any(String))
+    })
+
+    it('reloads the mask in Motion', async () => {
+      await service.updateMask(MASK)
+      expect(motionClientService.setMaskFile).toHaveBeenCalledWith(
+        expect.stringMatching(/^\/.*\.pgm$/),
+      )
+      expect(motionClientService.restart).toHaveBeenCalledTimes(1)
+    })
+
+    it('draws the regions onto the mask Motion used before', async () => {
+      const shippedMask = {
+        pixels: new Uint8Array(WIDTH * HEIGHT).fill(255),
+        width: WIDTH,
+        height: HEIGHT,
+      }
+      shippedMask.pixels[WIDTH * HEIGHT - 1] = MASKED_PIXEL_VALUE
+      spyReadImage.mockResolvedValue(shippedMask)
+      await service.updateMask(MASK)
+      expect(spyCopyFileOrRemoveCopy).toHaveBeenCalledWith(
+        SHIPPED_MASK_FILE_PATH,
+        expect.any(String),
+      )
+      const image = spyWriteFileAtomically.mock.calls[0][1] as Buffer
+      const pixels = image.subarray(image.length - WIDTH * HEIGHT)
+      // Only masked by the region, by the shipped mask and by neither
+      expect(pixels[0]).toBe(MASKED_PIXEL_VALUE)
+      expect(pixels[WIDTH * HEIGHT - 1]).toBe(MASKED_PIXEL_VALUE)
+      expect(pixels[WIDTH - 1]).toBe(255)
+    })
+
+    it('keeps the copied mask once Motion uses the custom one', async () => {
+      await service.updateMask(MASK)
+      spyCopyFileOrRemoveCopy.mockClear()
+      await service.updateMask(MASK)
+      expect(spyCopyFileOrRemoveCopy).not.toHaveBeenCalled()
+    })
+
+    it('returns a PNG preview', async () => {
+      const preview = await service.updateMask(MASK)
+      expect(preview.subarray(1, 4).toString()).toBe('PNG')
+    })
+
+    it('applies concurrent updates one after the other', async () => {
+      const order: string[] = []
+      spyWriteFileAtomically.mockImplementation(async () => {
+        order.push('write')
+      })
+      motionClientService.restart.mockImplementation(async () => {
+        order.push('restart')
+      })
+      await Promise.all([service.updateMask(MASK), service.updateMask(MASK)])
+      expect(order).toEqual(['write', 'restart', 'write', 'restart'])
+    })
+  })
+
+  describe(DetectionMaskService.prototype.getPreview.name, () => {
+    it('returns a PNG preview of the stored mask', async () => {
+      const preview = await service.getPreview()
+      expect(preview.subarray(1, 4).toString()).toBe('PNG')
+      expect(preview.readUInt32BE(16)).toBe(WIDTH)
+      expect(preview.readUInt32BE(20)).toBe(HEIGHT)
+    })
+  })
+
+  afterEach(() => {
+    vi.restoreAllMocks()
+  })
+})
@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import path from 'path'
+import { Injectable, Logger } from '@nestjs/common'
+import { MotionClientService } from '../motion-client.service'
+import { DetectionMaskFileProvider } from './detection-mask-file-provider'
+import { IDetectionMaskService } from './detection-mask.service.interface'
+import { DetectionMaskDto } from './dto/detection-mask.dto'
+import { GreyscaleImage, MaskRasterizer } from './mask-rasterizer'
+import { PngEncoder } from './png-encoder'
+
+const MASK_FILE_PATH = 'detection-mask.json'
+const MASK_IMAGE_FILE_PATH = 'motion/mask-files/custom.pgm'
+// Copy of the mask Motion used before, onto which the regions are drawn.
+const BASE_MASK_IMAGE_FILE_PATH = 'motion/mask-files/custom-base.pgm'
+const PREVIEW_WIDTH = 320
+
+@Injectable()
+export class DetectionMaskService implements IDetectionMaskService {
+  private readonly logger = new Logger(DetectionMaskService.name)
+  private pendingUpdate: Promise<unknown> = Promise.resolve()
+
+  constructor(private readonly motionClientService: MotionClientService) {}
+
+  async getMask(): Promise<DetectionMaskDto> {
+    return DetectionMaskFileProvider.readMask(MASK_FILE_PATH)
+  }
+
+  async getPreview(): Promise<Buffer> {
+    const [mask, width, height, baseMask] = await Promise.all([
+      this.getMask(),
+      this.motionClientService.getWidth(),
+      this.motionClientService.getHeight(),
+      DetectionMaskFileProvider.readImage(BASE_MASK_IMAGE_FILE_PATH),
+    ])
+    return DetectionMaskService.createPreview(mask, width, height, baseMask)
+  }
+
+  updateMask(mask: DetectionMaskDto): Promise<Buffer> {
+    // Updates are chained so that concurrent requests do not interleave their
+    // writes or Motion restarts.
+    const update = this.pendingUpdate.then(() => this.applyMask(mask))
+    this.pendingUpdate = update.catch(() => undefined)
+    return update
+  }
+
+  static createPreview(
+    mask: DetectionMaskDto,
+    width: number,
+    height: number,
+    baseMask?: GreyscaleImage,
+  ): Buffer {
+    const previewWidth = Math.min(width, PREVIEW_WIDTH)
+    const previewHeight = Math.max(
+      1,
+      Math.round((height * previewWidth) / width),
+    )
+    const pixels = MaskRasterizer.rasterize(
+      mask.excludedRegions,
+      previewWidth,
+      previewHeight,
+      baseMask,
+    )
+    return PngEncoder.encodeGreyscale(pixels, previewWidth, previewHeight)
+  }
+
+  private async applyMask(mask: DetectionMaskDto): Promise<Buffer> {
+    const maskImageFilePath = path.resolve(MASK_IMAGE_FILE_PATH)
+    const [width, height, currentMaskImageFilePath] = await Promise.all([
+      this.motionClientService.getWidth(),
+      this.motionClientService.getHeight(),
+      this.motionClientService.getMaskFile(),
+    ])
+    // Until the first update, Motion uses the mask shipped for the device.
+    if (currentMaskImageFilePath !== maskImageFilePath) {
+      await DetectionMaskFileProvider.copyFileOrRemoveCopy(
+        currentMaskImageFilePath,
+        BASE_MASK_IMAGE_FILE_PATH,
+      )
+    }
+    const baseMask = await DetectionMaskFileProvider.readImage(
+      BASE_MASK_IMAGE_FILE_PATH,
+    )
+    const pixels = MaskRasterizer.rasterize(
+      mask.excludedRegions,
+      width,
+      height,
+      baseMask,
+    )
+    await DetectionMaskFileProvider.writeFileAtomically(
+      MASK_IMAGE_FILE_PATH,
+      MaskRasterizer.toPgm(pixels, width, height),
+    )
+    await DetectionMaskFileProvider.writeMask(mask, MASK_FILE_PATH)
+    this.logger.log(
+      `Wrote a ${width}x${height} detection mask with ${mask.excludedRegions.length} excluded regions.`,
+    )
+
+    // Setting the mask file also writes motion.conf, which the restart reads
+    // again. Motion only loads the mask file when the camera thread starts.
+    await this.motionClientService.setMaskFile(maskImageFilePath)
+    await this.motionClientService.restart()
+
+    return DetectionMaskService.createPreview(mask, width, height, baseMask)
+  }
+}
@@ -0,0 +1,59 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Type } from 'class-transformer'
+import {
+  ArrayMaxSize,
+  ArrayMinSize,
+  IsArray,
+  IsNumber,
+  Max,
+  Min,
+  ValidateNested,
+} from 'class-validator'
+
+const MAXIMUM_POINTS_PER_REGION = 256
+const MAXIMUM_REGIONS = 32
+
+export class NormalisedPointDto {
+  @IsNumber()
+  @Min(0)
+  @Max(1)
+  x: number
+
+  @IsNumber()
+  @Min(0)
+  @Max(1)
+  y: number
+}
+
+export class MaskRegionDto {
+  @IsArray()
+  @ArrayMinSize(3)
+  @ArrayMaxSize(MAXIMUM_POINTS_PER_REGION)
+  @ValidateNested({ each: true })
+  @Type(() => NormalisedPointDto)
+  points: NormalisedPointDto[]
+}
+
+export class DetectionMaskDto {
+  // Regions in which motion is not detected, e.g. waving vegetation.
+  @IsArray()
+  @ArrayMaxSize(MAXIMUM_REGIONS)
+  @ValidateNested({ each: true })
+  @Type(() => MaskRegionDto)
+  excludedRegions: MaskRegionDto[]
+}
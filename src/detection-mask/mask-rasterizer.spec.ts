@@ -0,0 +1,171 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  DETECTION_PIXEL_VALUE,
+  MASKED_PIXEL_VALUE,
+  MaskRasterizer,
+} from './mask-rasterizer'
+
+describe(MaskRasterizer.name, () => {
+  const toRows = (pixels: Uint8Array, width: number) => {
+    const rows: string[] = []
+    for (let offset = 0; offset < pixels.length; offset += width) {
+      rows.push(
+        Array.from(pixels.subarray(offset, offset + width))
+          .map((value) => (value === MASKED_PIXEL_VALUE ? '#' : '.'))
+          .join(''),
+      )
+    }
+    return rows
+  }
+
+  describe(MaskRasterizer.rasterize.name, () => {
+    it('leaves every pixel detecting without regions', () => {
+      const pixels = MaskRasterizer.rasterize([], 4, 2)
+      expect(pixels.every((value) => value === DETECTION_PIXEL_VALUE)).toBe(
+        true,
+      )
+    })
+
+    it('masks the pixels whose centres lie inside the regions', () => {
+      const pixels = MaskRasterizer.rasterize(
+        [
+          {
+            points: [
+              { x: 0, y: 0 },
+              { x: 0.5, y: 0 },
+              { x: 0.5, y: 1 },
+              { x: 0, y: 1 },
+            ],
+          },
+          {
+            points: [
+              { x: 0.5, y: 0.5 },
+              { x: 1, y: 0.5 },
+              { x: 1, y: 1 },
+            ],
+          },
+        ],
+        8,
+        4,
+      )
+      expect(toRows(pixels, 8)).toEqual([
+        '####....',
+        '####....',
+        '####.###',
+        '####...#',
+      ])
+    })
+
+    it('masks overlapping regions as their union', () => {
+      const square = {
+        points: [
+          { x: 0, y: 0 },
+          { x: 1, y: 0 },
+          { x: 1, y: 1 },
+          { x: 0, y: 1 },
+        ],
+      }
+      const pixels = MaskRasterizer.rasterize([square, square], 2, 2)
+      expect(toRows(pixels, 2)).toEqual(['##', '##'])
+    })
+
+    it('draws the regions onto a base image', () => {
+      const base = {
+        pixels: new Uint8Array([255, 255, 255, MASKED_PIXEL_VALUE]),
+        width: 2,
+        height: 2,
+      }
+      const pixels = MaskRasterizer.rasterize(
+        [
+          {
+            points: [
+              { x: 0, y: 0 },
+              { x: 0.5, y: 0 },
+              { x: 0.5, y: 0.5 },
+              { x: 0, y: 0.5 },
+            ],
+          },
+        ],
+        2,
+        2,
+        base,
+      )
+      expect(toRows(pixels, 2)).toEqual(['#.', '.#'])
+      expect(base.pixels[0]).toBe(255)
+    })
+  })
+
+  describe(MaskRasterizer.resize.name, () => {
+    it('scales with nearest-neighbour sampling', () => {
+      const image = {
+        pixels: new Uint8Array([MASKED_PIXEL_VALUE, 255]),
+        width: 2,
+        height: 1,
+      }
+      expect(toRows(MaskRasterizer.resize(image, 4, 2), 4)).toEqual([
+        '##..',
+        '##..',
+      ])
+    })
+  })
+
+  describe(MaskRasterizer.toPgm.name, () => {
+    it('prepends a binary greyscale header', () => {
+      const pgm = MaskRasterizer.toPgm(new Uint8Array([0, 255]), 2, 1)
+      expect(pgm).toEqual(
+        Buffer.concat([Buffer.from('P5\n2 1\n255\n'), Buffer.from([0, 255])]),
+      )
+    })
+  })
+
+  describe(MaskRasterizer.fromPgm.name, () => {
+    it('reads what toPgm writes', () => {
+      const pixels = new Uint8Array([0, 255, 128, 0])
+      const pgm = MaskRasterizer.toPgm(pixels, 2, 2)
+      expect(MaskRasterizer.fromPgm(pgm)).toEqual({
+        pixels,
+        width: 2,
+        height: 2,
+      })
+    })
+
+    it('skips comments in the header', () => {
+      const pgm = Buffer.concat([
+        Buffer.from('P5\n# Created by GIMP\n2 1\n255\n'),
+        Buffer.from([0, 255]),
+      ])
+      expect(MaskRasterizer.fromPgm(pgm)).toEqual({
+        pixels: new Uint8Array([0, 255]),
+        width: 2,
+        height: 1,
+      })
+    })
+
+    it('returns undefined for other formats', () => {
+      expect(MaskRasterizer.fromPgm(Buffer.from('P2\n1 1\n255\n0\n'))).toBe(
+        undefined,
+      )
+    })
+
+    it('returns undefined for truncated pixels', () => {
+      expect(MaskRasterizer.fromPgm(Buffer.from('P5\n2 2\n255\nab'))).toBe(
+        undefined,
+      )
+    })
+  })
+})
@@ -0,0 +1,201 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MaskRegionDto } from './dto/detection-mask.dto'
+
+/**
+ * Value of the pixels in which Motion detects motion
+ */
+export const DETECTION_PIXEL_VALUE = 255
+/**
+ * Value of the pixels which Motion ignores
+ */
+export const MASKED_PIXEL_VALUE = 0
+
+const PGM_MAGIC_NUMBER = 'P5'
+const PGM_MAXIMUM_SUPPORTED_VALUE = 255
+
+export interface GreyscaleImage {
+  pixels: Uint8Array
+  width: number
+  height: number
+}
+
+interface Edge {
+  yTop: number
+  yBottom: number
+  xTop: number
+  inverseSlope: number
+}
+
+export class MaskRasterizer {
+  /**
+   * Fills the given regions, in coordinates normalised to [0, 1], with a
+   * scanline pass per region. A pixel is masked when its centre lies inside a
+   * region, following the even-odd rule for self-intersecting outlines. The
+   * regions are drawn onto the base image if one is given.
+   */
+  static rasterize(
+    regions: MaskRegionDto[],
+    width: number,
+    height: number,
+    base?: GreyscaleImage,
+  ): Uint8Array {
+    const pixels = base
+      ? MaskRasterizer.resize(base, width, height)
+      : new Uint8Array(width * height).fill(DETECTION_PIXEL_VALUE)
+    const crossings: number[] = []
+    for (const region of regions) {
+      const edges = MaskRasterizer.createEdges(region, width, height)
+      let activeEdges: Edge[] = []
+      let nextEdgeIndex = 0
+      const firstRow = Math.max(0, Math.floor((edges[0]?.yTop ?? height) - 0.5))
+      for (let row = firstRow; row < height; row++) {
+        const y = row + 0.5
+        while (
+          nextEdgeIndex < edges.length &&
+          edges[nextEdgeIndex].yTop <= y
+        ) {
+          activeEdges.push(edges[nextEdgeIndex++])
+        }
+        activeEdges = activeEdges.filter((edge) => edge.yBottom > y)
+        if (activeEdges.length === 0) {
+          if (nextEdgeIndex === edges.length) {
+            break
+          }
+          continue
+        }
+
+        crossings.length = 0
+        for (const edge of activeEdges) {
+          crossings.push(edge.xTop + (y - edge.yTop) * edge.inverseSlope)
+        }
+        crossings.sort((a, b) => a - b)
+        const rowOffset = row * width
+        for (let i = 0; i + 1 < crossings.length; i += 2) {
+          const start = Math.max(0, Math.ceil(crossings[i] - 0.5))
+          const end = Math.min(width, Math.ceil(crossings[i + 1] - 0.5))
+          if (start < end) {
+            pixels.fill(MASKED_PIXEL_VALUE, rowOffset + start, rowOffset + end)
+          }
+        }
+      }
+    }
+    return pixels
+  }
+
+  /**
+   * Scales the image with nearest-neighbour sampling into a new pixel array.
+   */
+  static resize(
+    image: GreyscaleImage,
+    width: number,
+    height: number,
+  ): Uint8Array {
+    if (image.width === width && image.height === height) {
+      return Uint8Array.from(image.pixels)
+    }
+    const pixels = new Uint8Array(width * height)
+    for (let row = 0; row < height; row++) {
+      const sourceRowOffset =
+        Math.floor(((row + 0.5) * image.height) / height) * image.width
+      for (let column = 0; column < width; column++) {
+        const sourceColumn = Math.floor(((column + 0.5) * image.width) / width)
+        pixels[row * width + column] =
+          image.pixels[sourceRowOffset + sourceColumn]
+      }
+    }
+    return pixels
+  }
+
+  static toPgm(pixels: Uint8Array, width: number, height: number): Buffer {
+    const header = Buffer.from(`P5\n${width} ${height}\n255\n`, 'ascii')
+    return Buffer.concat([header, pixels])
+  }
+
+  /**
+   * Parses a binary PGM file, as written by GIMP or toPgm, and returns
+   * undefined for anything else.
+   */
+  static fromPgm(data: Buffer): GreyscaleImage | undefined {
+    const fields: string[] = []
+    let offset = 0
+    while (fields.length < 4 && offset < data.length) {
+      const character = String.fromCharCode(data[offset])
+      if (character === '#') {
+        while (offset < data.length && data[offset] !== 0x0a) {
+          offset++
+        }
+      } else if (/\s/.test(character)) {
+        offset++
+      } else {
+        let field = ''
+        while (
+          offset < data.length &&
+          !/\s/.test(String.fromCharCode(data[offset]))
+        ) {
+          field += String.fromCharCode(data[offset++])
+        }
+        fields.push(field)
+      }
+    }
+    // A single whitespace character separates the header from the pixels.
+    offset++
+    const [width, height, maximumValue] = fields
+      .slice(1)
+      .map((field) => parseInt(field))
+    if (
+      fields[0] !== PGM_MAGIC_NUMBER ||
+      !(width > 0 && height > 0) ||
+      maximumValue !== PGM_MAXIMUM_SUPPORTED_VALUE ||
+      data.length - offset < width * height
+    ) {
+      return undefined
+    }
+    return {
+      pixels: new Uint8Array(data.subarray(offset, offset + width * height)),
+      width,
+      height,
+    }
+  }
+
+  private static createEdges(
+    region: MaskRegionDto,
+    width: number,
+    height: number,
+  ): Edge[] {
+    const edges: Edge[] = []
+    const points = region.points
+    for (let i = 0; i < points.length; i++) {
+      const start = points[i]
+      const end = points[(i + 1) % points.length]
+      const x0 = start.x * width
+      const y0 = start.y * height
+      const x1 = end.x * width
+      const y1 = end.y * height
+      if (y0 === y1) {
+        continue
+      }
+      const inverseSlope = (x1 - x0) / (y1 - y0)
+      edges.push(
+        y0 < y1
+          ? { yTop: y0, yBottom: y1, xTop: x0, inverseSlope }
+          : { yTop: y1, yBottom: y0, xTop: x1, inverseSlope },
+      )
+    }
+    return edges.sort((a, b) => a.yTop - b.yTop)
+  }
+}
@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { inflateSync } from 'zlib'
+import { PngEncoder } from './png-encoder'
+
+describe(PngEncoder.name, () => {
+  describe(PngEncoder.crc32.name, () => {
+    it('returns the standard check value', () => {
+      expect(PngEncoder.crc32(Buffer.from('123456789'))).toBe(0xcbf43926)
+    })
+  })
+
+  describe(PngEncoder.encodeGreyscale.name, () => {
+    const png = PngEncoder.encodeGreyscale(
+      new Uint8Array([0, 255, 255, 0]),
+      2,
+      2,
+    )
+
+    it('starts with the PNG signature and header', () => {
+      expect(png.subarray(0, 8).toString('latin1')).toBe('\x89PNG\r\n\x1a\n')
+      expect(png.subarray(12, 16).toString()).toBe('IHDR')
+      expect(png.readUInt32BE(16)).toBe(2)
+      expect(png.readUInt32BE(20)).toBe(2)
+    })
+
+    it('stores unfiltered scanlines', () => {
+      const dataLength = png.readUInt32BE(33)
+      expect(png.subarray(37, 41).toString()).toBe('IDAT')
+      const scanlines = inflateSync(png.subarray(41, 41 + dataLength))
+      expect(Array.from(scanlines)).toEqual([0, 0, 255, 0, 255, 0])
+    })
+  })
+})
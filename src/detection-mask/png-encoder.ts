@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { deflateSync } from 'zlib'
+
+const BIT_DEPTH = 8
+const COLOUR_TYPE_GREYSCALE = 0
+const FILTER_TYPE_NONE = 0
+const PNG_SIGNATURE = Buffer.from([
+  0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a,
+])
+
+const CRC_TABLE = (() => {
+  const table = new Uint32Array(256)
+  for (let n = 0; n < 256; n++) {
+    let c = n
+    for (let k = 0; k < 8; k++) {
+      c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1
+    }
+    table[n] = c >>> 0
+  }
+  return table
+})()
+
+/**
+ * Encodes 8-bit greyscale pixels as PNG, so that browsers can display mask
+ * previews.
+ */
+export class PngEncoder {
+  static encodeGreyscale(
+    pixels: Uint8Array,
+    width: number,
+    height: number,
+  ): Buffer {
+    const header = Buffer.alloc(13)
+    header.writeUInt32BE(width, 0)
+    header.writeUInt32BE(height, 4)
+    header.writeUInt8(BIT_DEPTH, 8)
+    header.writeUInt8(COLOUR_TYPE_GREYSCALE, 9)
+
+    const scanlines = Buffer.alloc((width + 1) * height)
+    for (let row = 0; row < height; row++) {
+      const offset = row * (width + 1)
+      scanlines[offset] = FILTER_TYPE_NONE
+      scanlines.set(pixels.subarray(row * width, (row + 1) * width), offset + 1)
+    }
+
+    return Buffer.concat([
+      PNG_SIGNATURE,
+      PngEncoder.createChunk('IHDR', header),
+      PngEncoder.createChunk('IDAT', deflateSync(scanlines)),
+      PngEncoder.createChunk('IEND', Buffer.alloc(0)),
+    ])
+  }
+
+  static crc32(data: Buffer): number {
+    let crc = 0xffffffff
+    for (const byte of data) {
+      crc = CRC_TABLE[(crc ^ byte) & 0xff] ^ (crc >>> 8)
+    }
+    return (crc ^ 0xffffffff) >>> 0
+  }
+
+  private static createChunk(type: string, data: Buffer): Buffer {
+    const chunk = Buffer.alloc(data.length + 12)
+    chunk.writeUInt32BE(data.length, 0)
+    chunk.write(type, 4, 'ascii')
+    data.copy(chunk, 8)
+    chunk.writeUInt32BE(
+      PngEncoder.crc32(chunk.subarray(4, data.length + 8)),
+      data.length + 8,
+    )
+    return chunk
+  }
+}
@@ -0,0 +1,35 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { IsIn, IsInt, IsNumber, IsOptional } from 'class-validator'
+import { EVENT_TYPES, EventType } from '../entities/logged-event.entity'
+
+export class EventDto {
+  @IsIn(EVENT_TYPES)
+  type: EventType
+
+  @IsOptional()
+  @IsInt()
+  code?: number
+
+  @IsOptional()
+  @IsNumber()
+  value?: number
+
+  @IsOptional()
+  @IsNumber()
+  secondaryValue?: number
+}
@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+// The position in this list is the type identifier stored in the records,
+// so new types must only ever be appended.
+export const EVENT_TYPES = [
+  'triggerStart',
+  'triggerEnd',
+  'lightChange',
+  'sleep',
+  'boot',
+  'sensorSample',
+  'settingsChange',
+  // Code of the light, value of the settling time in milliseconds, secondary
+  // value of 1 if the scene did not settle before the timeout
+  'sceneSettled',
+] as const
+
+export type EventType = (typeof EVENT_TYPES)[number]
+
+export const LIGHT_CHANGE_CODES = {
+  alternation: 0,
+  infrared: 1,
+  visible: 2,
+}
+
+export const SENSOR_SAMPLE_CODES = {
+  batteryVoltage: 1,
+  temperature: 2,
+}
+
+export const SETTINGS_CHANGE_CODES = {
+  camera: 1,
+  general: 2,
+  triggering: 4,
+}
+
+export interface LoggedEvent {
+  time: Date
+  type: EventType
+  code: number
+  value: number
+  secondaryValue: number
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { readdir, rm, stat } from 'fs/promises'
+import path from 'path'
+import { LoggedEvent } from './entities/logged-event.entity'
+import { EVENT_RECORD_SIZE, EventLogStore } from './event-log-store'
+
+const TEST_FOLDER_PATH = path.join('src', 'event-log', 'test-event-log')
+
+function createEvent(
+  timeMs: number,
+  type: LoggedEvent['type'] = 'triggerStart',
+): LoggedEvent {
+  return { time: new Date(timeMs), type, code: 1, value: 2, secondaryValue: 3 }
+}
+
+describe(EventLogStore.name, () => {
+  let store: EventLogStore
+
+  beforeEach(async () => {
+    await rm(TEST_FOLDER_PATH, { recursive: true, force: true })
+    store = new EventLogStore(TEST_FOLDER_PATH, {
+      indexInterval: 4,
+      maximumSegmentCount: 3,
+      segmentCapacity: 10,
+    })
+    await store.open()
+  })
+
+  describe(EventLogStore.decodeRecord.name, () => {
+    it('decodes what was encoded', () => {
+      const buffer = Buffer.alloc(EVENT_RECORD_SIZE)
+      const event = createEvent(1700000000123, 'sensorSample')
+      EventLogStore.encodeRecord(event, buffer)
+      expect(EventLogStore.decodeRecord(buffer)).toEqual(event)
+    })
+
+    it('skips unknown types', () => {
+      expect(
+        EventLogStore.decodeRecord(Buffer.alloc(EVENT_RECORD_SIZE)),
+      ).toBeUndefined()
+    })
+  })
+
+  describe(EventLogStore.prototype.flush.name, () => {
+    it('writes fixed-size records', async () => {
+      store.append(createEvent(1))
+      store.append(createEvent(2))
+      await store.flush()
+      const { size } = await stat(
+        path.join(TEST_FOLDER_PATH, 'segment-00000001.bin'),
+      )
+      expect(size).toBe(2 * EVENT_RECORD_SIZE)
+      expect(store.pendingCount).toBe(0)
+    })
+
+    it('starts a new segment when the clock goes backwards', async () => {
+      store.append(createEvent(10))
+      store.append(createEvent(5))
+      await store.flush()
+      expect(await readdir(TEST_FOLDER_PATH)).toEqual([
+        'segment-00000001.bin',
+        'segment-00000002.bin',
+      ])
+    })
+
+    it('removes the oldest segments', async () => {
+      for (let i = 0; i < 35; i++) {
+        store.append(createEvent(i))
+      }
+      await store.flush()
+      expect(await readdir(TEST_FOLDER_PATH)).toEqual([
+        'segment-00000002.bin',
+        'segment-00000003.bin',
+        'segment-00000004.bin',
+      ])
+    })
+  })
+
+  describe(EventLogStore.prototype.query.name, () => {
+    beforeEach(async () => {
+      for (let i = 0; i < 25; i++) {
+        store.append(createEvent(i * 10, i % 2 ? 'triggerEnd' : 'triggerStart'))
+      }
+    })
+
+    it('returns the events within the time range', async () => {
+      const events = await store.query({
+        from: new Date(55),
+        to: new Date(120),
+        limit: 100,
+      })
+      expect(events.map((event) => event.time.getTime())).toEqual([
+        60, 70, 80, 90, 100, 110, 120,
+      ])
+    })
+
+    it('filters by type', async () => {
+      const events = await store.query({
+        from: new Date(0),
+        to: new Date(50),
+        types: ['triggerEnd'],
+        limit: 100,
+      })
+      expect(events.map((event) => event.time.getTime())).toEqual([
+        10, 30, 50,
+      ])
+    })
+
+    it('stops at the limit', async () => {
+      const events = await store.query({ limit: 3 })
+      expect(events.map((event) => event.time.getTime())).toEqual([0, 10, 20])
+    })
+
+    it('finds the events again after reopening', async () => {
+      await store.close()
+      const reopenedStore = new EventLogStore(TEST_FOLDER_PATH, {
+        indexInterval: 4,
+        maximumSegmentCount: 3,
+        segmentCapacity: 10,
+      })
+      await reopenedStore.open()
+      reopenedStore.append(createEvent(1000))
+      const events = await reopenedStore.query({
+        from: new Date(230),
+        limit: 100,
+      })
+      expect(events.map((event) => event.time.getTime())).toEqual([
+        230, 240, 1000,
+      ])
+      await reopenedStore.close()
+    })
+  })
+
+  afterEach(async () => {
+    await store.close()
+    await rm(TEST_FOLDER_PATH, { recursive: true, force: true })
+  })
+})
@@ -0,0 +1,342 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { FileHandle, mkdir, open, readdir, rm, stat } from 'fs/promises'
+import path from 'path'
+import {
+  EVENT_TYPES,
+  EventType,
+  LoggedEvent,
+} from './entities/logged-event.entity'
+
+export const EVENT_RECORD_SIZE = 32
+
+const DEFAULT_INDEX_INTERVAL = 256
+const DEFAULT_MAXIMUM_PENDING_COUNT = 10000
+const DEFAULT_MAXIMUM_SEGMENT_COUNT = 16
+const DEFAULT_SEGMENT_CAPACITY = 32768
+const SEGMENT_FILENAME_PATTERN = /^segment-(\d{8})\.bin$/
+
+export interface EventLogStoreOptions {
+  indexInterval?: number
+  maximumSegmentCount?: number
+  segmentCapacity?: number
+}
+
+export interface EventLogQuery {
+  from?: Date
+  limit: number
+  to?: Date
+  types?: EventType[]
+}
+
+interface Segment {
+  filePath: string
+  firstTime: number
+  lastTime: number
+  recordCount: number
+  sequenceNumber: number
+  // Time of every indexInterval-th record, starting with the first one.
+  sparseIndex: number[]
+}
+
+/**
+ * Append-only log of fixed-size event records, split into segment files.
+ * Records are buffered in memory and written in batches with positional
+ * writes. Every segment is in chronological order; a clock going backwards
+ * starts a new segment.
+ */
+export class EventLogStore {
+  private readonly indexInterval: number
+  private readonly maximumSegmentCount: number
+  private readonly segmentCapacity: number
+  private readonly segments: Segment[] = []
+  private activeFileHandle: FileHandle | undefined
+  private pendingEvents: LoggedEvent[] = []
+  private writing: Promise<void> = Promise.resolve()
+
+  constructor(
+    private readonly folderPath: string,
+    options: EventLogStoreOptions = {},
+  ) {
+    this.indexInterval = options.indexInterval ?? DEFAULT_INDEX_INTERVAL
+    this.maximumSegmentCount =
+      options.maximumSegmentCount ?? DEFAULT_MAXIMUM_SEGMENT_COUNT
+    this.segmentCapacity = options.segmentCapacity ?? DEFAULT_SEGMENT_CAPACITY
+  }
+
+  static encodeRecord(event: LoggedEvent, buffer: Buffer, offset = 0): void {
+    buffer.fill(0, offset, offset + EVENT_RECORD_SIZE)
+    buffer.writeDoubleLE(event.time.getTime(), offset)
+    buffer.writeUInt16LE(EVENT_TYPES.indexOf(event.type) + 1, offset + 8)
+    buffer.writeInt32LE(event.code, offset + 12)
+    buffer.writeDoubleLE(event.value, offset + 16)
+    buffer.writeDoubleLE(event.secondaryValue, offset + 24)
+  }
+
+  static decodeRecord(buffer: Buffer, offset = 0): LoggedEvent | undefined {
+    const type = EVENT_TYPES[buffer.readUInt16LE(offset + 8) - 1]
+    if (!type) {
+      return undefined
+    }
+    return {
+      time: new Date(buffer.readDoubleLE(offset)),
+      type,
+      code: buffer.readInt32LE(offset + 12),
+      value: buffer.readDoubleLE(offset + 16),
+      secondaryValue: buffer.readDoubleLE(offset + 24),
+    }
+  }
+
+  get pendingCount(): number {
+    return this.pendingEvents.length
+  }
+
+  async open(): Promise<void> {
+    await mkdir(this.folderPath, { recursive: true })
+    const filenames = (await readdir(this.folderPath))
+      .filter((filename) => SEGMENT_FILENAME_PATTERN.test(filename))
+      .sort()
+    for (const filename of filenames) {
+      const filePath = path.join(this.folderPath, filename)
+      const segment = await this.readSegment(filePath, filename)
+      if (segment.recordCount === 0) {
+        await rm(filePath, { force: true })
+        continue
+      }
+      this.segments.push(segment)
+    }
+    const activeSegment = this.segments.at(-1)
+    if (activeSegment) {
+      this.activeFileHandle = await open(activeSegment.filePath, 'r+')
+    }
+  }
+
+  append(event: LoggedEvent): void {
+    this.pendingEvents.push(event)
+    if (this.pendingEvents.length > DEFAULT_MAXIMUM_PENDING_COUNT) {
+      this.pendingEvents.shift()
+    }
+  }
+
+  flush(): Promise<void> {
+    this.writing = this.writing
+      .catch(() => undefined)
+      .then(() => this.writePendingEvents())
+    return this.writing
+  }
+
+  async close(): Promise<void> {
+    await this.flush()
+    await this.activeFileHandle?.close()
+    this.activeFileHandle = undefined
+  }
+
+  async query(query: EventLogQuery): Promise<LoggedEvent[]> {
+    await this.flush()
+    const from = query.from?.getTime() ?? -Infinity
+    const to = query.to?.getTime() ?? Infinity
+    const types = query.types ? new Set<EventType>(query.types) : undefined
+    const events: LoggedEvent[] = []
+    const buffer = Buffer.alloc(this.indexInterval * EVENT_RECORD_SIZE)
+
+    for (const segment of [...this.segments]) {
+      if (segment.lastTime < from || segment.firstTime > to) {
+        continue
+      }
+      let fileHandle: FileHandle
+      try {
+        fileHandle = await open(segment.filePath, 'r')
+      } catch (error) {
+        // The segment may have been rotated away in the meantime.
+        if (error.code === 'ENOENT') {
+          continue
+        }
+        throw error
+      }
+      try {
+        let index = this.findFirstRecordIndexToRead(segment, from)
+        let isSegmentDone = false
+        while (!isSegmentDone && index < segment.recordCount) {
+          const count = Math.min(
+            this.indexInterval,
+            segment.recordCount - index,
+          )
+          await fileHandle.read(
+            buffer,
+            0,
+            count * EVENT_RECORD_SIZE,
+            index * EVENT_RECORD_SIZE,
+          )
+          for (let i = 0; i < count; i++) {
+            const event = EventLogStore.decodeRecord(
+              buffer,
+              i * EVENT_RECORD_SIZE,
+            )
+            const time = event?.time.getTime()
+            if (!event || time < from) {
+              continue
+            }
+            if (time > to) {
+              isSegmentDone = true
+              break
+            }
+            if (types && !types.has(event.type)) {
+              continue
+            }
+            events.push(event)
+            if (events.length >= query.limit) {
+              return events
+            }
+          }
+          index += count
+        }
+      } finally {
+        await fileHandle.close()
+      }
+    }
+    return events
+  }
+
+  private findFirstRecordIndexToRead(segment: Segment, from: number): number {
+    let low = 0
+    let high = segment.sparseIndex.length - 1
+    let result = 0
+    while (low <= high) {
+      const middle = (low + high) >> 1
+      if (segment.sparseIndex[middle] < from) {
+        result = middle * this.indexInterval
+        low = middle + 1
+      } else {
+        high = middle - 1
+      }
+    }
+    return result
+  }
+
+  private async readSegment(
+    filePath: string,
+    filename: string,
+  ): Promise<Segment> {
+    const { size } = await stat(filePath)
+    // A trailing partial record from an interrupted write is overwritten.
+    const recordCount = Math.floor(size / EVENT_RECORD_SIZE)
+    const segment: Segment = {
+      filePath,
+      firstTime: 0,
+      lastTime: 0,
+      recordCount,
+      sequenceNumber: parseInt(SEGMENT_FILENAME_PATTERN.exec(filename)[1]),
+      sparseIndex: [],
+    }
+    if (recordCount === 0) {
+      return segment
+    }
+    const fileHandle = await open(filePath, 'r')
+    try {
+      const timeBuffer = Buffer.alloc(8)
+      const readTime = async (index: number) => {
+        await fileHandle.read(timeBuffer, 0, 8, index * EVENT_RECORD_SIZE)
+        return timeBuffer.readDoubleLE(0)
+      }
+      for (let index = 0; index < recordCount; index += this.indexInterval) {
+        segment.sparseIndex.push(await readTime(index))
+      }
+      segment.firstTime = segment.sparseIndex[0]
+      segment.lastTime = await readTime(recordCount - 1)
+    } finally {
+      await fileHandle.close()
+    }
+    return segment
+  }
+
+  private async writePendingEvents(): Promise<void> {
+    while (this.pendingEvents.length > 0) {
+      let segment = this.segments.at(-1)
+      const firstTime = this.pendingEvents[0].time.getTime()
+      if (
+        !segment ||
+        segment.recordCount >= this.segmentCapacity ||
+        firstTime < segment.lastTime
+      ) {
+        segment = await this.startSegment()
+      }
+
+      // Take the events that fit into the segment in chronological order.
+      let count = 0
+      let lastTime = segment.recordCount > 0 ? segment.lastTime : firstTime
+      while (
+        count < this.pendingEvents.length &&
+        segment.recordCount + count < this.segmentCapacity &&
+        this.pendingEvents[count].time.getTime() >= lastTime
+      ) {
+        lastTime = this.pendingEvents[count].time.getTime()
+        count++
+      }
+
+      const events = this.pendingEvents.splice(0, count)
+      const buffer = Buffer.alloc(count * EVENT_RECORD_SIZE)
+      events.forEach((event, i) =>
+        EventLogStore.encodeRecord(event, buffer, i * EVENT_RECORD_SIZE),
+      )
+      try {
+        await this.activeFileHandle.write(
+          buffer,
+          0,
+          buffer.length,
+          segment.recordCount * EVENT_RECORD_SIZE,
+        )
+      } catch (error) {
+        this.pendingEvents.unshift(...events)
+        throw error
+      }
+
+      events.forEach((event, i) => {
+        const index = segment.recordCount + i
+        if (index % this.indexInterval === 0) {
+          segment.sparseIndex.push(event.time.getTime())
+        }
+      })
+      if (segment.recordCount === 0) {
+        segment.firstTime = firstTime
+      }
+      segment.lastTime = lastTime
+      segment.recordCount += count
+    }
+  }
+
+  private async startSegment(): Promise<Segment> {
+    await this.activeFileHandle?.close()
+    this.activeFileHandle = undefined
+    const sequenceNumber = (this.segments.at(-1)?.sequenceNumber ?? 0) + 1
+    const filename = `segment-${sequenceNumber.toString().padStart(8, '0')}.bin`
+    const segment: Segment = {
+      filePath: path.join(this.folderPath, filename),
+      firstTime: 0,
+      lastTime: 0,
+      recordCount: 0,
+      sequenceNumber,
+      sparseIndex: [],
+    }
+    this.activeFileHandle = await open(segment.filePath, 'w+')
+    this.segments.push(segment)
+    while (this.segments.length > this.maximumSegmentCount) {
+      const oldestSegment = this.segments.shift()
+      await rm(oldestSegment.filePath, { force: true })
+    }
+    return segment
+  }
+}
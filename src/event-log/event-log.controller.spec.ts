@@ -0,0 +1,82 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { BadRequestException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { EventLogController } from './event-log.controller'
+import { EventLogService } from './event-log.service'
+import { IEventLogService } from './event-log.service.interface'
+
+describe(EventLogController.name, () => {
+  class MockEventLogService implements Partial<IEventLogService> {
+    record = vi.fn()
+    getEvents = vi.fn(() => Promise.resolve([]))
+  }
+
+  let controller: EventLogController
+  let service: EventLogService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [EventLogController],
+      providers: [{ provide: EventLogService, useClass: MockEventLogService }],
+    }).compile()
+
+    controller = module.get<EventLogController>(EventLogController)
+    service = module.get<EventLogService>(EventLogService)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(EventLogController.prototype.getEvents.name, () => {
+    it('converts the query', async () => {
+      await controller.getEvents({
+        from: '2024-01-01T00:00:00Z',
+        types: 'boot,sleep',
+        limit: '5',
+      })
+      expect(service.getEvents).toHaveBeenCalledWith({
+        from: new Date('2024-01-01T00:00:00Z'),
+        limit: 5,
+        to: undefined,
+        types: ['boot', 'sleep'],
+      })
+    })
+
+    it('uses a default limit', async () => {
+      await controller.getEvents({})
+      expect(service.getEvents).toHaveBeenCalledWith(
+        expect.objectContaining({ limit: 1000 }),
+      )
+    })
+
+    it('rejects unknown types', () => {
+      expect(() => controller.getEvents({ types: 'boot,nap' })).toThrow(
+        BadRequestException,
+      )
+    })
+  })
+
+  describe(EventLogController.prototype.recordEvent.name, () => {
+    it('records the event', () => {
+      controller.recordEvent({ type: 'triggerStart', value: 1 })
+      expect(service.record).toHaveBeenCalledWith('triggerStart', { value: 1 })
+    })
+  })
+})
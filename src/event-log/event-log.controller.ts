@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  BadRequestException,
+  Body,
+  Controller,
+  Get,
+  Post,
+  Query,
+} from '@nestjs/common'
+import { EventLogQueryDto } from './dto/event-log-query.dto'
+import { EventDto } from './dto/event.dto'
+import {
+  EVENT_TYPES,
+  EventType,
+  LoggedEvent,
+} from './entities/logged-event.entity'
+import { EventLogService } from './event-log.service'
+
+const DEFAULT_EVENTS_LIMIT = 1000
+
+@Controller('event-log')
+export class EventLogController {
+  constructor(private readonly eventLogService: EventLogService) {}
+
+  @Get('events')
+  getEvents(@Query() query: EventLogQueryDto): Promise<LoggedEvent[]> {
+    let types: EventType[]
+    if (query.types) {
+      types = query.types.split(',') as EventType[]
+      const unknownType = types.find((type) => !EVENT_TYPES.includes(type))
+      if (unknownType) {
+        throw new BadRequestException(`Unknown event type '${unknownType}'.`)
+      }
+    }
+    return this.eventLogService.getEvents({
+      from: query.from ? new Date(query.from) : undefined,
+      limit: query.limit ? parseInt(query.limit) : DEFAULT_EVENTS_LIMIT,
+      to: query.to ? new Date(query.to) : undefined,
+      types,
+    })
+  }
+
+  @Post('events')
+  recordEvent(@Body() event: EventDto): void {
+    const { type, ...details } = event
+    this.eventLogService.record(type, details)
+  }
+}
@@ -0,0 +1,28 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Module } from '@nestjs/common'
+import { NotificationsModule } from '../notifications/notifications.module'
+import { EventLogController } from './event-log.controller'
+import { EventLogService } from './event-log.service'
+
+@Module({
+  controllers: [EventLogController],
+  providers: [EventLogService],
+  imports: [NotificationsModule],
+  exports: [EventLogService],
+})
+export class EventLogModule {}
@@ -0,0 +1,9 @@
+import { EventType, LoggedEvent } from './entities/logged-event.entity'
+import { EventLogQuery } from './event-log-store'
+import { EventDetails } from './event-log.service'
+
+export interface IEventLogService {
+  record: (type: EventType, details?: EventDetails) => void
+  getEvents: (query: EventLogQuery) => Promise<LoggedEvent[]>
+  flushEvents: () => Promise<void>
+}
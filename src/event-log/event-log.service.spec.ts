@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Test, TestingModule } from '@nestjs/testing'
+import { Mock, vi } from 'vitest'
+import { EventLogStore } from './event-log-store'
+import { EventLogService } from './event-log.service'
+
+describe(EventLogService.name, () => {
+  let service: EventLogService
+  let spyAppend: Mock
+  let spyFlush: Mock
+
+  beforeEach(async () => {
+    spyAppend = vi.spyOn(EventLogStore.prototype, 'append')
+    spyFlush = vi
+      .spyOn(EventLogStore.prototype, 'flush')
+      .mockResolvedValue(undefined)
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [EventLogService],
+    }).compile()
+
+    service = module.get<EventLogService>(EventLogService)
+  })
+
+  it('should be defined', () => {
+    expect(service).toBeDefined()
+  })
+
+  describe(EventLogService.prototype.record.name, () => {
+    it('fills in the missing details', () => {
+      service.record('boot', { value: 12.5 })
+      expect(spyAppend).toHaveBeenCalledWith({
+        time: expect.any(Date),
+        type: 'boot',
+        code: 0,
+        value: 12.5,
+        secondaryValue: 0,
+      })
+    })
+
+    it('only buffers ordinary events', () => {
+      service.record('triggerStart')
+      expect(spyFlush).not.toHaveBeenCalled()
+    })
+
+    it('writes sleep events at once', () => {
+      service.record('sleep', { value: Date.now() })
+      expect(spyFlush).toHaveBeenCalled()
+    })
+  })
+
+  describe(EventLogService.prototype.flushEvents.name, () => {
+    it('does not throw when writing fails', async () => {
+      spyFlush.mockRejectedValue(new Error('disk full'))
+      await expect(service.flushEvents()).resolves.toBeUndefined()
+    })
+  })
+
+  afterEach(() => {
+    spyAppend.mockRestore()
+    spyFlush.mockRestore()
+  })
+})
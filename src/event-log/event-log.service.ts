@@ -0,0 +1,120 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  Injectable,
+  Logger,
+  OnModuleDestroy,
+  OnModuleInit,
+  Optional,
+} from '@nestjs/common'
+import { Cron, CronExpression } from '@nestjs/schedule'
+import { NotificationsService } from '../notifications/notifications.service'
+import {
+  EventType,
+  LIGHT_CHANGE_CODES,
+  LoggedEvent,
+  SENSOR_SAMPLE_CODES,
+} from './entities/logged-event.entity'
+import { EventLogQuery, EventLogStore } from './event-log-store'
+import { IEventLogService } from './event-log.service.interface'
+
+const EVENT_LOG_FOLDER_PATH = 'event-log'
+const FLUSH_THRESHOLD = 64
+
+export type EventDetails = Partial<
+  Pick<LoggedEvent, 'code' | 'secondaryValue' | 'value'>
+>
+
+@Injectable()
+export class EventLogService
+  implements IEventLogService, OnModuleInit, OnModuleDestroy
+{
+  private readonly logger = new Logger(EventLogService.name)
+  private readonly store: EventLogStore
+
+  constructor(
+    @Optional() private readonly notificationsService?: NotificationsService,
+  ) {
+    this.store = new EventLogStore(EVENT_LOG_FOLDER_PATH)
+  }
+
+  async onModuleInit(): Promise<void> {
+    try {
+      await this.store.open()
+    } catch (error) {
+      this.logger.error(`Event log could not be opened: ${error.message}`)
+    }
+  }
+
+  async onModuleDestroy(): Promise<void> {
+    await this.store.close()
+  }
+
+  record(type: EventType, details: EventDetails = {}): void {
+    this.store.append({
+      time: new Date(),
+      type,
+      code: details.code ?? 0,
+      value: details.value ?? 0,
+      secondaryValue: details.secondaryValue ?? 0,
+    })
+    // The device may power off right after going to sleep.
+    if (type === 'sleep' || this.store.pendingCount >= FLUSH_THRESHOLD) {
+      this.flushEvents()
+    }
+    this.notify(type, details)
+  }
+
+  async getEvents(query: EventLogQuery): Promise<LoggedEvent[]> {
+    return this.store.query(query)
+  }
+
+  @Cron(CronExpression.EVERY_MINUTE)
+  async flushEvents(): Promise<void> {
+    try {
+      await this.store.flush()
+    } catch (error) {
+      this.logger.error(`Events could not be written: ${error.message}`)
+    }
+  }
+
+  private notify(type: EventType, details: EventDetails): void {
+    if (!this.notificationsService) {
+      return
+    }
+    if (type === 'lightChange') {
+      this.notificationsService.publish('lightChanged', {
+        light: this.getCodeName(LIGHT_CHANGE_CODES, details.code),
+      })
+    } else if (type === 'sensorSample') {
+      this.notificationsService.publish('sensorSampled', {
+        sensor: this.getCodeName(SENSOR_SAMPLE_CODES, details.code),
+        value: details.value ?? 0,
+      })
+    } else if (type === 'triggerStart' || type === 'triggerEnd') {
+      this.notificationsService.publish('triggeringChanged', {
+        isActive: type === 'triggerStart',
+      })
+    }
+  }
+
+  private getCodeName(codes: Record<string, number>, code = 0): string {
+    return (
+      Object.keys(codes).find((name) => codes[name] === code) ?? `${code}`
+    )
+  }
+}
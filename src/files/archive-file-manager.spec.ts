@@ -15,7 +15,7 @@
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
 import { existsSync } from 'fs'
-import { mkdir, rm } from 'fs/promises'
+import { mkdir, readFile, rm } from 'fs/promises'
 import { LoggerService } from '@nestjs/common'
 import { ArchiveFileManager } from './archive-file-manager'
 
@@ -49,5 +49,19 @@ describe(ArchiveFileManager.name, () => {
       expect(existsSync(archiveFilePath)).toBeTruthy()
       await rm(testFolderPath, { recursive: true, force: true })
     })
+
+    it('adds the additional entries', async () => {
+      await mkdir(testFolderPath)
+      const archiveFilePath = testFolderPath + '/c.zip'
+      await ArchiveFileManager.createArchive(
+        archiveFilePath,
+        [FIXTURE_FOLDER_PATH + '/a.txt'],
+        new MockupLogger(),
+        [{ name: 'checksums.crc32c', content: 'e3069283  a.txt\n' }],
+      )
+      const archive = await readFile(archiveFilePath)
+      expect(archive.includes('checksums.crc32c')).toBe(true)
+      await rm(testFolderPath, { recursive: true, force: true })
+    })
   })
 })
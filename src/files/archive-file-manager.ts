@@ -20,11 +20,17 @@ import archiver from 'archiver'
 
 const COMPRESSION_LEVEL = 1 // 0 (no compression) to 9 (best compression), or -1 (default compression)
 
+export interface ArchiveEntry {
+  name: string
+  content: string
+}
+
 export class ArchiveFileManager {
   static async createArchive(
     archiveFilePath: string,
     filePaths: string[],
     logger: LoggerService,
+    additionalEntries: ArchiveEntry[] = [],
   ): Promise<void> {
     const archive = archiver('zip', {
       zlib: { level: COMPRESSION_LEVEL },
@@ -57,6 +63,9 @@ export class ArchiveFileManager {
         name,
       })
     }
+    for (const entry of additionalEntries) {
+      archive.append(entry.content, { name: entry.name })
+    }
 
     await archive.finalize()
   }
@@ -0,0 +1,85 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { spawn } from 'child_process'
+import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
+import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
+
+const CHECKSUM_SHOT_PATH = 'scripts/runtime/shot-checksums/checksum_shot'
+const UNCACHED_OPTION = '--uncached'
+// Idle I/O class and lowest CPU priority, so that capture is never delayed.
+const LOW_PRIORITY_PREFIX = ['ionice', '-c', '3', 'nice', '-n', '19']
+// checksum_shot exits with 1 if only some files could not be read.
+const PARTIAL_FAILURE_EXIT_CODE = 1
+const OUTPUT_LINE_PATTERN = /^([0-9a-f]{8}) {2}(.+)$/
+
+export class ChecksumInteractor {
+  /**
+   * Returns the CRC32C checksums by file path, leaving out files that could
+   * not be read. Uncached files are read back from the storage rather than
+   * from the page cache.
+   */
+  static async computeChecksums(
+    filePaths: string[],
+    isUncached = false,
+  ): Promise<Map<string, string>> {
+    CommandUnavailableOnWindowsException.throwIfOnWindows()
+    const [command, ...args] = [
+      ...LOW_PRIORITY_PREFIX,
+      CHECKSUM_SHOT_PATH,
+      ...(isUncached ? [UNCACHED_OPTION] : []),
+      ...filePaths,
+    ]
+    const child = spawn(command, args, { stdio: ['ignore', 'pipe', 'pipe'] })
+    let stdout = ''
+    let stderr = ''
+    child.stdout.setEncoding('utf8')
+    child.stdout.on('data', (chunk: string) => {
+      stdout += chunk
+    })
+    child.stderr.setEncoding('utf8')
+    child.stderr.on('data', (chunk: string) => {
+      stderr += chunk
+    })
+    const exitCode = await new Promise<number>((resolve, reject) => {
+      child.once('error', reject)
+      child.once('close', resolve)
+    })
+    if (exitCode !== 0 && exitCode !== PARTIAL_FAILURE_EXIT_CODE) {
+      throw new CommandExecutionException(stderr || `exit code ${exitCode}`)
+    }
+    return this.parseOutput(stdout)
+  }
+
+  /**
+   * Formats a line like checksum_shot and sha256sum: the checksum, two spaces
+   * and the filename.
+   */
+  static formatLine(filePath: string, checksum: string): string {
+    return `${checksum}  ${filePath}\n`
+  }
+
+  static parseOutput(output: string): Map<string, string> {
+    const checksums = new Map<string, string>()
+    for (const line of output.split('\n')) {
+      const match = OUTPUT_LINE_PATTERN.exec(line)
+      if (match) {
+        checksums.set(match[2], match[1])
+      }
+    }
+    return checksums
+  }
+}
@@ -0,0 +1,29 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { IsString, Matches } from 'class-validator'
+
+export class ChecksumDto {
+  // A line break would corrupt the index.
+  @IsString()
+  @Matches(/^[^/\\\n]+$/)
+  name: string
+
+  // CRC32C in hexadecimal, as printed by checksum_shot
+  @IsString()
+  @Matches(/^[0-9a-f]{8}$/)
+  checksum: string
+}
@@ -14,10 +14,31 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { ArrayNotEmpty, IsArray } from 'class-validator'
+import {
+  ArrayNotEmpty,
+  IsArray,
+  IsInt,
+  IsOptional,
+  Max,
+  Min,
+} from 'class-validator'
 
 export class FilesDto {
   @IsArray()
   @ArrayNotEmpty()
   filenames: string[]
 }
+
+export class FilesDownloadDto extends FilesDto {
+  @IsOptional()
+  @IsInt()
+  @Min(100)
+  @Max(4999)
+  longEdge?: number
+
+  @IsOptional()
+  @IsInt()
+  @Min(1)
+  @Max(100)
+  quality?: number
+}
@@ -0,0 +1,32 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { IsOptional, Matches } from 'class-validator'
+
+// Long edges of 100 to 4999 pixels.
+const LONG_EDGE_PATTERN = /^([1-9]\d{2}|[1-4]\d{3})$/
+// JPEG qualities of 1 to 100.
+const QUALITY_PATTERN = /^([1-9]|[1-9]\d|100)$/
+
+export class ShotVariantQueryDto {
+  @IsOptional()
+  @Matches(LONG_EDGE_PATTERN)
+  longEdge?: string
+
+  @IsOptional()
+  @Matches(QUALITY_PATTERN)
+  quality?: string
+}
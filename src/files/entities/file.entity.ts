@@ -17,4 +17,7 @@
 export class File {
   name: string
   creationTime: Date
+  changeScore?: number
+  // CRC32C computed when the shot was saved, in hexadecimal
+  checksum?: string
 }
@@ -16,16 +16,27 @@
  */
 import { ReadStream } from 'fs'
 import { PassThrough } from 'stream'
+import { ForbiddenException, NotFoundException } from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
 import { Test, TestingModule } from '@nestjs/testing'
 import { vi } from 'vitest'
 import { MotionClientService } from '../motion-client.service'
 import { PropertiesService } from '../properties/properties.service'
 import { SettingsService } from '../settings/settings.service'
+import { InvalidFilenameException } from './exception/InvalidFilenameException'
 import { FilesController } from './files.controller'
 import { FilesService } from './files.service'
 import { IFilesService } from './files.service.interface'
 
+const JOB = {
+  id: 'j',
+  startTime: new Date(),
+  totalCount: 2,
+  deletedCount: 1,
+  failedCount: 0,
+  isFinished: false,
+}
+
 class MockFilesService implements Partial<IFilesService> {
   findAll = vi.fn()
   getStreamableFile = vi.fn(() =>
@@ -43,6 +54,12 @@ class MockFilesService implements Partial<IFilesService> {
   )
   removeFile = vi.fn()
   removeFiles = vi.fn(() => Promise.resolve({ a: true, b: true }))
+  removeAllFiles = vi.fn(() => Promise.resolve(JOB))
+  startDeletionJob = vi.fn(() => Promise.resolve(JOB))
+  getDeletionJob = vi.fn((id: string) => (id === JOB.id ? JOB : undefined))
+  setChangeScore = vi.fn()
+  getChecksums = vi.fn(() => Promise.resolve(new Map([['a', 'e3069283']])))
+  setChecksum = vi.fn()
 }
 
 describe(FilesController.name, () => {
@@ -95,6 +112,53 @@ describe(FilesController.name, () => {
       )
       expect(result).toEqual(expectedResult)
     })
+
+    it('returns the job when removing all files', async () => {
+      const result = await controller.deleteFiles({ filenames: ['*'] })
+      expect(service.removeAllFiles).toHaveBeenCalled()
+      expect(result).toEqual(JOB)
+    })
+  })
+
+  describe(FilesController.prototype.startDeletionJob.name, () => {
+    it('asks for starting a deletion job', async () => {
+      const filenames = ['a', 'b']
+      const result = await controller.startDeletionJob({ filenames })
+      expect(service.startDeletionJob).toHaveBeenCalledWith(filenames)
+      expect(result).toEqual(JOB)
+    })
+
+    it('rejects paths outside of the folder', async () => {
+      await expect(
+        controller.startDeletionJob({ filenames: ['../a'] }),
+      ).rejects.toThrow(ForbiddenException)
+    })
+  })
+
+  describe(FilesController.prototype.getDeletionJob.name, () => {
+    it('returns the job', () => {
+      expect(controller.getDeletionJob(JOB.id)).toEqual(JOB)
+    })
+
+    it('throws if the job is unknown', () => {
+      expect(() => controller.getDeletionJob('unknown')).toThrow(
+        NotFoundException,
+      )
+    })
+  })
+
+  describe(FilesController.prototype.setChangeScore.name, () => {
+    it('asks for setting the change score', async () => {
+      await controller.setChangeScore({ name: 'a.jpg', changeScore: 42 })
+      expect(service.setChangeScore).toHaveBeenCalledWith('a.jpg', 42)
+    })
+  })
+
+  describe(FilesController.prototype.setChecksum.name, () => {
+    it('asks for setting the checksum', async () => {
+      await controller.setChecksum({ name: 'a.jpg', checksum: 'e3069283' })
+      expect(service.setChecksum).toHaveBeenCalledWith('a.jpg', 'e3069283')
+    })
   })
 
   describe(FilesController.prototype.downloadFile.name, () => {
@@ -104,8 +168,57 @@ describe(FilesController.name, () => {
         set: vi.fn(),
       }
       await controller.downloadFile(filename, mockResponse)
-      expect(service.getStreamableFile).toHaveBeenCalledWith(filename)
+      expect(service.getStreamableFile).toHaveBeenCalledWith(
+        filename,
+        undefined,
+      )
       expect(mockResponse.set).toHaveBeenCalled()
+      expect(mockResponse.set).toHaveBeenCalledWith(
+        'X-Checksum-Crc32c',
+        'e3069283',
+      )
+    })
+
+    it('asks for a downscaled variant', async () => {
+      const mockResponse = {
+        set: vi.fn(),
+      }
+      await controller.downloadFile('a.jpg', mockResponse, {
+        longEdge: '1280',
+        quality: '60',
+      })
+      expect(service.getStreamableFile).toHaveBeenCalledWith('a.jpg', {
+        longEdge: 1280,
+        quality: 60,
+      })
+    })
+
+    it('throws if the file does not exist', async () => {
+      const error = Object.assign(new Error('ENOENT'), { code: 'ENOENT' })
+      vi.mocked(service.getStreamableFile).mockRejectedValueOnce(error)
+      await expect(
+        controller.downloadFile('a.jpg', { set: vi.fn() }, { longEdge: '640' }),
+      ).rejects.toThrow(NotFoundException)
+    })
+
+    it('rejects paths outside of the folder', async () => {
+      await expect(
+        controller.downloadFile('../a.jpg', { set: vi.fn() }),
+      ).rejects.toThrow(ForbiddenException)
+      expect(service.getStreamableFile).not.toHaveBeenCalled()
+    })
+
+    it('rejects names the variant cache does not accept', async () => {
+      vi.mocked(service.getStreamableFile).mockRejectedValueOnce(
+        new InvalidFilenameException('a'),
+      )
+      await expect(
+        controller.downloadFile(
+          'a/b.jpg',
+          { set: vi.fn() },
+          { longEdge: '640' },
+        ),
+      ).rejects.toThrow(ForbiddenException)
     })
   })
 
@@ -116,8 +229,23 @@ describe(FilesController.name, () => {
         set: vi.fn(),
       }
       await controller.downloadFiles({ filenames: filenames }, mockResponse)
-      expect(service.getStreamableFiles).toHaveBeenCalledWith(filenames)
+      expect(service.getStreamableFiles).toHaveBeenCalledWith(
+        filenames,
+        undefined,
+      )
       expect(mockResponse.set).toHaveBeenCalled()
     })
+
+    it('asks for downscaled variants with the default quality', async () => {
+      const filenames = ['a.jpg', 'b.mp4']
+      const mockResponse = {
+        set: vi.fn(),
+      }
+      await controller.downloadFiles({ filenames, longEdge: 640 }, mockResponse)
+      expect(service.getStreamableFiles).toHaveBeenCalledWith(filenames, {
+        longEdge: 640,
+        quality: 75,
+      })
+    })
   })
 })
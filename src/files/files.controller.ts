@@ -23,13 +23,22 @@ import {
   NotFoundException,
   Param,
   Post,
+  Query,
   Res,
   StreamableFile,
 } from '@nestjs/common'
-import { FilesDto } from './dto/files.dto'
+import { ChangeScoreDto } from './dto/change-score.dto'
+import { ChecksumDto } from './dto/checksum.dto'
+import { FilesDownloadDto, FilesDto } from './dto/files.dto'
+import { ShotVariantQueryDto } from './dto/shot-variant-query.dto'
+import { FileDeletionJob } from './entities/file-deletion-job.entity'
 import { FileDeletionResponse } from './entities/file-deletion-response.entity'
 import { File } from './entities/file.entity'
+import { InvalidFilenameException } from './exception/InvalidFilenameException'
 import { FilesService } from './files.service'
+import { ShotVariantCache } from './shot-variant-cache'
+
+const CHECKSUM_HEADER = 'X-Checksum-Crc32c'
 
 @Controller('files')
 export class FilesController {
@@ -37,15 +46,22 @@ export class FilesController {
 
   @Post()
   async downloadFiles(
-    @Body() filesDto: FilesDto,
+    @Body() filesDto: FilesDownloadDto,
     @Res({ passthrough: true }) res,
   ) {
     if (filesDto.filenames.some((filename) => filename.includes('../'))) {
       throw new ForbiddenException()
     }
+    const variant = ShotVariantCache.createVariant(
+      filesDto.longEdge,
+      filesDto.quality,
+    )
     let archive
     try {
-      archive = await this.filesService.getStreamableFiles(filesDto.filenames)
+      archive = await this.filesService.getStreamableFiles(
+        filesDto.filenames,
+        variant,
+      )
     } catch (error) {
       if (error.message.includes('File not found')) {
         throw new NotFoundException(error.message)
@@ -66,16 +82,17 @@ export class FilesController {
   }
 
   @Delete()
-  async deleteFiles(@Body() filesDto: FilesDto): Promise<FileDeletionResponse> {
+  async deleteFiles(
+    @Body() filesDto: FilesDto,
+  ): Promise<FileDeletionResponse | FileDeletionJob> {
     if (filesDto.filenames.some((filename) => filename.includes('../'))) {
       throw new ForbiddenException()
     }
 
+    // Removing all files runs in the background, so the job is returned for
+    // polling its progress.
     if (filesDto.filenames.length === 1 && filesDto.filenames[0] === '*') {
-      await this.filesService.removeAllFiles()
-      return {
-        '*': true,
-      }
+      return this.filesService.removeAllFiles()
     }
 
     const filesWithDeletedState = await this.filesService.removeFiles(
@@ -94,16 +111,74 @@ export class FilesController {
     return filesWithDeletedState
   }
 
+  @Post('deletion-jobs')
+  async startDeletionJob(
+    @Body() filesDto: FilesDto,
+  ): Promise<FileDeletionJob> {
+    if (filesDto.filenames.some((filename) => filename.includes('../'))) {
+      throw new ForbiddenException()
+    }
+    return this.filesService.startDeletionJob(filesDto.filenames)
+  }
+
+  @Get('deletion-jobs/:id')
+  getDeletionJob(@Param('id') id: string): FileDeletionJob {
+    const job = this.filesService.getDeletionJob(id)
+    if (!job) {
+      throw new NotFoundException()
+    }
+    return job
+  }
+
+  @Post('change-scores')
+  async setChangeScore(@Body() changeScoreDto: ChangeScoreDto): Promise<void> {
+    await this.filesService.setChangeScore(
+      changeScoreDto.name,
+      changeScoreDto.changeScore,
+    )
+  }
+
+  @Post('checksums')
+  async setChecksum(@Body() checksumDto: ChecksumDto): Promise<void> {
+    await this.filesService.setChecksum(checksumDto.name, checksumDto.checksum)
+  }
+
   @Get(':id')
   async downloadFile(
     @Param('id') filename: string,
     @Res({ passthrough: true }) res,
+    @Query() query: ShotVariantQueryDto = {},
   ) {
-    const file = await this.filesService.getStreamableFile(filename)
+    if (filename.includes('../')) {
+      throw new ForbiddenException()
+    }
+    const variant = ShotVariantCache.createVariant(
+      query.longEdge ? parseInt(query.longEdge) : undefined,
+      query.quality ? parseInt(query.quality) : undefined,
+    )
+    let file
+    try {
+      file = await this.filesService.getStreamableFile(filename, variant)
+    } catch (error) {
+      if (error instanceof InvalidFilenameException) {
+        throw new ForbiddenException()
+      }
+      if (error.code !== 'ENOENT') {
+        throw error
+      }
+      throw new NotFoundException()
+    }
     res.set({
       'Content-Type': file.contentType,
       'Content-Disposition': 'attachment; filename="' + filename + '"',
     })
+    // Lets clients check the download against the shot as it was saved.
+    const checksum = variant
+      ? undefined
+      : (await this.filesService.getChecksums()).get(filename)
+    if (checksum) {
+      res.set(CHECKSUM_HEADER, checksum)
+    }
     return new StreamableFile(file.stream)
   }
 
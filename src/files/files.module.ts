@@ -17,16 +17,34 @@
 import { Module } from '@nestjs/common'
 import { ConfigModule } from '@nestjs/config'
 import { MotionClientService } from '../motion-client.service'
+import { NotificationsModule } from '../notifications/notifications.module'
 import { SettingsModule } from '../settings/settings.module'
 import { FileStatsController } from './file-stats.controller'
 import { FileStatsService } from './file-stats.service'
 import { FilesController } from './files.controller'
 import { FilesService } from './files.service'
+import { IntegrityController } from './integrity.controller'
+import { IntegrityService } from './integrity.service'
+import { ShotEventsController } from './shot-events.controller'
+import { ShotEventsService } from './shot-events.service'
+import { ShotIndex } from './shot-index'
 
 @Module({
-  controllers: [FilesController, FileStatsController],
-  providers: [FilesService, FileStatsService, MotionClientService],
-  imports: [ConfigModule, SettingsModule],
-  exports: [FilesService],
+  controllers: [
+    FilesController,
+    FileStatsController,
+    IntegrityController,
+    ShotEventsController,
+  ],
+  providers: [
+    FilesService,
+    FileStatsService,
+    IntegrityService,
+    MotionClientService,
+    ShotEventsService,
+    ShotIndex,
+  ],
+  imports: [ConfigModule, NotificationsModule, SettingsModule],
+  exports: [FilesService, ShotIndex],
 })
 export class FilesModule {}
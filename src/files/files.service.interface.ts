@@ -1,16 +1,30 @@
 import { StreamWithContentType } from '../shared/entities/stream-with-content-type'
+import { FileDeletionJob } from './entities/file-deletion-job.entity'
 import { FileDeletionResponse } from './entities/file-deletion-response.entity'
 import { File } from './entities/file.entity'
+import { ShotVariant } from './entities/shot-variant.entity'
 import { StreamWithContentTypeAndFilename } from './entities/stream-with-content-type-and-filename.entity.'
 
 export interface IFilesService {
   findAll: () => Promise<File[]>
-  getStreamableFile: (filename: string) => Promise<StreamWithContentType>
+  getStreamableFile: (
+    filename: string,
+    variant?: ShotVariant,
+  ) => Promise<StreamWithContentType>
   getStreamableFiles: (
     filenames: string[],
+    variant?: ShotVariant,
   ) => Promise<StreamWithContentTypeAndFilename>
   removeFile: (filename: string) => Promise<void>
+  getChangeScores: () => Promise<ReadonlyMap<string, number>>
+  setChangeScore: (filename: string, changeScore: number) => Promise<void>
+  getChecksums: () => Promise<ReadonlyMap<string, string>>
+  setChecksum: (filename: string, checksum: string) => Promise<void>
   removeFiles: (filenames: string[]) => Promise<FileDeletionResponse>
-  removeAllFiles: () => Promise<void>
+  removeAllFiles: () => Promise<FileDeletionJob>
+  startDeletionJob: (filenames: string[]) => Promise<FileDeletionJob>
+  getDeletionJob: (id: string) => FileDeletionJob | undefined
   removeOldArchives: () => Promise<void>
+  removeOldVariants: () => Promise<void>
+  removeFinishedDeletionJobs: () => void
 }
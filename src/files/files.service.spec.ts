@@ -24,8 +24,9 @@ import { IMotionClientService } from '../motion-client.service.interface'
 import { PropertiesService } from '../properties/properties.service'
 import { SettingsModule } from '../settings/settings.module'
 import { FileHandler } from './file-handler'
-import { FileInteractor } from './file-interactor'
 import { FilesService } from './files.service'
+import { ShotIndex } from './shot-index'
+import { ShotVariantCache } from './shot-variant-cache'
 
 const FIXTURE_FOLDER_PATH = 'src/files/fixtures'
 
@@ -46,6 +47,7 @@ describe(FilesService.name, () => {
           FilesService,
           { provide: MotionClientService, useClass: MockMotionClientService },
           PropertiesService,
+          ShotIndex,
         ],
         imports: [SettingsModule],
       }).compile()
@@ -96,6 +98,23 @@ describe(FilesService.name, () => {
         expect(files[2].creationTime).toEqual(expect.any(Object))
       })
 
+      it('returns the change scores kept in the shots folder', async () => {
+        await writeFile(testFolder + '/a.jpg', 'a')
+        await service.setChangeScore('a.jpg', 42)
+        const files = await service.findAll()
+        expect(files).toHaveLength(1)
+        expect(files[0].changeScore).toBe(42)
+        expect(await readdir(testFolder)).toContain('.change-scores')
+      })
+
+      it('returns the checksums and leaves out hidden files', async () => {
+        await writeFile(testFolder + '/a.txt', 'a')
+        await service.setChecksum('a.txt', 'e3069283')
+        const files = await service.findAll()
+        expect(files).toHaveLength(1)
+        expect(files[0].checksum).toBe('e3069283')
+      })
+
       afterEach(async () => {
         await readdir(testFolder).then((files) =>
           Promise.all(
@@ -124,6 +143,39 @@ describe(FilesService.name, () => {
         expect(spy).toHaveBeenCalled()
       })
 
+      it('streams the variant of a picture', async () => {
+        const variant = { longEdge: 640, quality: 75 }
+        const spyGetVariantPath = vi
+          .spyOn(ShotVariantCache.prototype, 'getVariantPath')
+          .mockResolvedValue('temp/variants/640-q75/a.jpg')
+        const spy = vi
+          .spyOn(FileHandler, 'createStreamWithContentType')
+          .mockReturnValueOnce(undefined)
+        await service.getStreamableFile('a.jpg', variant)
+        expect(spyGetVariantPath).toHaveBeenCalledWith(
+          FIXTURE_FOLDER_PATH,
+          'a.jpg',
+          variant,
+        )
+        expect(spy).toHaveBeenCalledWith('temp/variants/640-q75/a.jpg')
+        spyGetVariantPath.mockRestore()
+      })
+
+      it('streams other files as they are', async () => {
+        const spyGetVariantPath = vi.spyOn(
+          ShotVariantCache.prototype,
+          'getVariantPath',
+        )
+        const spy = vi.spyOn(FileHandler, 'createStreamWithContentType')
+        await service.getStreamableFile('a.txt', {
+          longEdge: 640,
+          quality: 75,
+        })
+        expect(spyGetVariantPath).not.toHaveBeenCalled()
+        expect(spy).toHaveBeenCalledWith(FIXTURE_FOLDER_PATH + '/a.txt')
+        spyGetVariantPath.mockRestore()
+      })
+
       afterAll(() => {
         spyGetTargetDir.mockRestore()
       })
@@ -191,22 +243,44 @@ describe(FilesService.name, () => {
     })
 
     describe(FilesService.prototype.removeAllFiles.name, () => {
-      beforeAll(() => {
-        spyGetTargetDir.mockResolvedValue(FIXTURE_FOLDER_PATH)
+      const testFolder = 'src/files/test-delete-all-files'
+
+      beforeAll(async () => {
+        await mkdir(testFolder + '/sub', { recursive: true })
+        spyGetTargetDir.mockResolvedValue(testFolder)
       })
 
-      it('calls method on FileInteractor with path', async () => {
-        const spy = vi
-          .spyOn(FileInteractor, 'removeAllFilesInDirectory')
-          .mockResolvedValue()
-        await service.removeAllFiles()
-        expect(spy).toHaveBeenCalledWith(FIXTURE_FOLDER_PATH)
-        spy.mockRestore()
+      it('removes all files including nested ones and reports progress', async () => {
+        const filenames = ['a.txt', 'b.txt', 'sub/c.txt']
+        for (const filename of filenames) {
+          await writeFile(testFolder + '/' + filename, 'b')
+        }
+        const startedJob = await service.removeAllFiles()
+        expect(startedJob.isFinished).toBeFalsy()
+        let job = service.getDeletionJob(startedJob.id)
+        while (!job.isFinished) {
+          await new Promise((r) => setTimeout(r, 10))
+          job = service.getDeletionJob(startedJob.id)
+        }
+        expect(job.totalCount).toBe(3)
+        expect(job.deletedCount).toBe(3)
+        expect(job.failedCount).toBe(0)
+        for (const filename of filenames) {
+          expect(existsSync(testFolder + '/' + filename)).toBeFalsy()
+        }
+        expect(existsSync(testFolder + '/sub')).toBeTruthy()
       })
 
-      afterAll(() => {
+      afterAll(async () => {
+        await rm(testFolder, { recursive: true, force: true })
         spyGetTargetDir.mockRestore()
       })
     })
+
+    describe(FilesService.prototype.getDeletionJob.name, () => {
+      it('returns undefined for an unknown job', () => {
+        expect(service.getDeletionJob('unknown')).toBeUndefined()
+      })
+    })
   })
 })
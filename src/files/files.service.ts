@@ -14,53 +14,89 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { lstat, readdir, rm } from 'fs/promises'
+import { randomUUID } from 'crypto'
+import { lstat, readdir, rm, unlink } from 'fs/promises'
 import path from 'path'
 import { Injectable, Logger } from '@nestjs/common'
 import { Cron } from '@nestjs/schedule'
+import { MetricsRegistry } from '../metrics/metrics-registry'
 import { MotionClientService } from '../motion-client.service'
 import { SettingsService } from '../settings/settings.service'
 import { StreamWithContentType } from '../shared/entities/stream-with-content-type'
-import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
 import FolderCleaner from '../shared/folder-cleaner'
+import { ParallelRunner } from '../shared/parallel-runner'
 import { ArchiveFileManager } from './archive-file-manager'
+import { CHANGE_SCORES_FILENAME, ChangeScoreIndex } from './change-score-index'
+import { CHECKSUMS_FILENAME, ChecksumIndex } from './checksum-index'
+import { ChecksumInteractor } from './checksum-interactor'
+import { FileDeletionJob } from './entities/file-deletion-job.entity'
 import { FileDeletionResponse } from './entities/file-deletion-response.entity'
 import { File } from './entities/file.entity'
+import { ShotVariant } from './entities/shot-variant.entity'
 import { StreamWithContentTypeAndFilename } from './entities/stream-with-content-type-and-filename.entity.'
 import { FileHandler } from './file-handler'
-import { FileInteractor } from './file-interactor'
 import { FileNamer } from './file-namer'
 import { IFilesService } from './files.service.interface'
+import { ShotIndex } from './shot-index'
+import { ShotVariantCache } from './shot-variant-cache'
 
 const ARCHIVE_FOLDER_PATH = 'temp/archives'
+const ARCHIVE_CHECKSUMS_FILENAME = 'checksums.crc32c'
+const FILE_DELETION_CONCURRENCY = 8
+const FINISHED_DELETION_JOB_TIME_TO_LIVE_MILLISECONDS = 3600000 // 1 hour
+const ALL_FILES_WILDCARD = '*'
+const VARIANT_FOLDER_PATH = 'temp/variants'
+const VARIANT_TIME_TO_LIVE_MILLISECONDS = 86400000 // 1 day
+// Leaves CPU time to Motion while an archive of variants is being created.
+const VARIANT_CREATION_CONCURRENCY = 2
 
 @Injectable()
 export class FilesService implements IFilesService {
   private readonly logger = new Logger(FilesService.name)
+  private readonly deletionJobs = new Map<string, FileDeletionJob>()
+  private readonly shotVariantCache = new ShotVariantCache(VARIANT_FOLDER_PATH)
+  private changeScoreIndex: ChangeScoreIndex | null = null
+  private checksumIndex: ChecksumIndex | null = null
 
   constructor(
     private readonly motionClientService: MotionClientService,
     private readonly settingsService: SettingsService,
+    private readonly shotIndex: ShotIndex,
   ) {}
 
   async findAll(): Promise<File[]> {
     const fileFolderPath = await this.motionClientService.getTargetDir()
-    const elements = await readdir(fileFolderPath)
-    const elementPromises = elements.map(async (elementName) => {
-      const filePath = path.join(fileFolderPath, elementName)
-      const stats = await lstat(filePath)
-      return {
-        name: elementName,
-        stats,
-      }
-    })
-    const elementsWithStats = await Promise.all(elementPromises)
+    const elementsWithStats = await MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'listShots'],
+      async () => {
+        const elements = await readdir(fileFolderPath)
+        const elementPromises = elements.map(async (elementName) => {
+          const filePath = path.join(fileFolderPath, elementName)
+          const stats = await lstat(filePath)
+          return {
+            name: elementName,
+            stats,
+          }
+        })
+        return Promise.all(elementPromises)
+      },
+    )
+    const changeScores =
+      await this.getChangeScoreIndex(fileFolderPath).getValues()
+    const checksums = await this.getChecksumIndex(fileFolderPath).getValues()
     return elementsWithStats
-      .filter((element) => element.stats.isFile())
+      .filter(
+        (element) =>
+          element.stats.isFile() &&
+          !FolderCleaner.isUnixHiddenPath(element.name),
+      )
       .map((file) => {
         return {
           name: file.name,
           creationTime: file.stats.mtime,
+          changeScore: changeScores.get(file.name),
+          checksum: checksums.get(file.name),
         }
       })
       .sort((a, b) =>
@@ -71,14 +107,25 @@ export class FilesService implements IFilesService {
       )
   }
 
-  async getStreamableFile(filename: string): Promise<StreamWithContentType> {
+  async getStreamableFile(
+    filename: string,
+    variant?: ShotVariant,
+  ): Promise<StreamWithContentType> {
     const fileFolderPath = await this.motionClientService.getTargetDir()
-    const filePath = path.join(fileFolderPath, filename)
+    const filePath =
+      variant && ShotVariantCache.isScalable(filename)
+        ? await this.shotVariantCache.getVariantPath(
+            fileFolderPath,
+            filename,
+            variant,
+          )
+        : path.join(fileFolderPath, filename)
     return FileHandler.createStreamWithContentType(filePath)
   }
 
   async getStreamableFiles(
     filenames: string[],
+    variant?: ShotVariant,
   ): Promise<StreamWithContentTypeAndFilename> {
     const now = new Date()
     const settings = await this.settingsService.getAllSettings()
@@ -91,11 +138,25 @@ export class FilesService implements IFilesService {
     )
     const archiveFilePath = path.join(ARCHIVE_FOLDER_PATH, archiveFilename)
     const fileFolderPath = await this.motionClientService.getTargetDir()
-    const filePaths = filenames.map((filename) =>
-      path.join(fileFolderPath, filename),
-    )
+    const filePaths = variant
+      ? await this.getVariantPaths(fileFolderPath, filenames, variant)
+      : filenames.map((filename) => path.join(fileFolderPath, filename))
+    // Checksums only apply to the shots as they were saved.
+    const additionalEntries = variant
+      ? []
+      : [
+          {
+            name: ARCHIVE_CHECKSUMS_FILENAME,
+            content: await this.formatChecksums(fileFolderPath, filenames),
+          },
+        ]
     const logger = new Logger(ArchiveFileManager.name)
-    await ArchiveFileManager.createArchive(archiveFilePath, filePaths, logger)
+    await ArchiveFileManager.createArchive(
+      archiveFilePath,
+      filePaths,
+      logger,
+      additionalEntries,
+    )
     const streamableFile =
       FileHandler.createStreamWithContentType(archiveFilePath)
     return {
@@ -108,35 +169,279 @@ export class FilesService implements IFilesService {
     const fileFolderPath = await this.motionClientService.getTargetDir()
     const filePath = path.join(fileFolderPath, filename)
     await rm(filePath)
+    this.shotIndex.removeShots(fileFolderPath, [filename])
+    await this.removeChangeScores(fileFolderPath, [filename])
+    await this.removeChecksums(fileFolderPath, [filename])
+    await this.removeVariants([filename])
+  }
+
+  async getChangeScores(): Promise<ReadonlyMap<string, number>> {
+    const fileFolderPath = await this.motionClientService.getTargetDir()
+    return this.getChangeScoreIndex(fileFolderPath).getValues()
+  }
+
+  async setChangeScore(filename: string, changeScore: number): Promise<void> {
+    const fileFolderPath = await this.motionClientService.getTargetDir()
+    await this.getChangeScoreIndex(fileFolderPath).setValue(
+      filename,
+      changeScore,
+    )
+  }
+
+  async getChecksums(): Promise<ReadonlyMap<string, string>> {
+    const fileFolderPath = await this.motionClientService.getTargetDir()
+    return this.getChecksumIndex(fileFolderPath).getValues()
+  }
+
+  async setChecksum(filename: string, checksum: string): Promise<void> {
+    const fileFolderPath = await this.motionClientService.getTargetDir()
+    await this.getChecksumIndex(fileFolderPath).setValue(filename, checksum)
   }
 
   async removeFiles(filenames: string[]): Promise<FileDeletionResponse> {
-    const result: FileDeletionResponse = {}
-    for (const filename of filenames) {
-      try {
-        await this.removeFile(filename)
-        result[filename] = true
-      } catch {
-        result[filename] = false
-      }
+    const fileFolderPath = await this.motionClientService.getTargetDir()
+    return this.removeFilesInFolder(fileFolderPath, filenames)
+  }
+
+  async removeAllFiles(): Promise<FileDeletionJob> {
+    return this.startDeletionJob([ALL_FILES_WILDCARD])
+  }
+
+  async startDeletionJob(filenames: string[]): Promise<FileDeletionJob> {
+    const fileFolderPath = await this.motionClientService.getTargetDir()
+    const job: FileDeletionJob = {
+      id: randomUUID(),
+      startTime: new Date(),
+      totalCount: 0,
+      deletedCount: 0,
+      failedCount: 0,
+      isFinished: false,
     }
+    this.deletionJobs.set(job.id, job)
+    this.runDeletionJob(job, fileFolderPath, filenames).catch((error) => {
+      this.logger.error(`Deletion job ${job.id} failed: ${error.message}`)
+      this.finishDeletionJob(job)
+    })
+    return { ...job }
+  }
+
+  getDeletionJob(id: string): FileDeletionJob | undefined {
+    const job = this.deletionJobs.get(id)
+    return job ? { ...job } : undefined
+  }
+
+  private async runDeletionJob(
+    job: FileDeletionJob,
+    fileFolderPath: string,
+    filenames: string[],
+  ): Promise<void> {
+    const isAllFiles =
+      filenames.length === 1 && filenames[0] === ALL_FILES_WILDCARD
+    const targetFilenames = isAllFiles
+      ? await this.findAllFilesRecursively(fileFolderPath)
+      : filenames
+    job.totalCount = targetFilenames.length
+    await this.removeFilesInFolder(
+      fileFolderPath,
+      targetFilenames,
+      (isDeleted) => {
+        if (isDeleted) {
+          job.deletedCount++
+        } else {
+          job.failedCount++
+        }
+      },
+    )
+    this.finishDeletionJob(job)
+    this.logger.log(
+      `Deletion job ${job.id} finished: ${job.deletedCount} deleted, ${job.failedCount} failed`,
+    )
+  }
+
+  private finishDeletionJob(job: FileDeletionJob): void {
+    job.isFinished = true
+    job.endTime = new Date()
+  }
+
+  private async findAllFilesRecursively(folderPath: string): Promise<string[]> {
+    const entries = await MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'listShotsRecursively'],
+      () => readdir(folderPath, { recursive: true, withFileTypes: true }),
+    )
+    return entries
+      .filter(
+        (entry) =>
+          entry.isFile() && !FolderCleaner.isUnixHiddenPath(entry.name),
+      )
+      .map((entry) =>
+        path.relative(folderPath, path.join(entry.parentPath, entry.name)),
+      )
+  }
+
+  private async removeFilesInFolder(
+    fileFolderPath: string,
+    filenames: string[],
+    onFileProcessed?: (isDeleted: boolean) => void,
+  ): Promise<FileDeletionResponse> {
+    const deletedStates = await ParallelRunner.run(
+      filenames,
+      FILE_DELETION_CONCURRENCY,
+      async (filename) => {
+        let isDeleted = true
+        try {
+          await unlink(path.join(fileFolderPath, filename))
+        } catch {
+          isDeleted = false
+        }
+        onFileProcessed?.(isDeleted)
+        return isDeleted
+      },
+    )
+    const result: FileDeletionResponse = {}
+    filenames.forEach((filename, index) => {
+      result[filename] = deletedStates[index]
+    })
+    const deletedFilenames = filenames.filter(
+      (_filename, index) => deletedStates[index],
+    )
+    this.shotIndex.removeShots(fileFolderPath, deletedFilenames)
+    await this.removeChangeScores(fileFolderPath, deletedFilenames)
+    await this.removeChecksums(fileFolderPath, deletedFilenames)
+    await this.removeVariants(deletedFilenames)
     return result
   }
 
-  async removeAllFiles(): Promise<void> {
-    const fileFolderPath = await this.motionClientService.getTargetDir()
+  /**
+   * Falls back to the shots themselves for files that cannot be scaled, so
+   * that the archive still contains everything that was asked for.
+   */
+  private async getVariantPaths(
+    fileFolderPath: string,
+    filenames: string[],
+    variant: ShotVariant,
+  ): Promise<string[]> {
+    return ParallelRunner.run(
+      filenames,
+      VARIANT_CREATION_CONCURRENCY,
+      async (filename) => {
+        const filePath = path.join(fileFolderPath, filename)
+        if (!ShotVariantCache.isScalable(filename)) {
+          return filePath
+        }
+        try {
+          return await this.shotVariantCache.getVariantPath(
+            fileFolderPath,
+            filename,
+            variant,
+          )
+        } catch (error) {
+          this.logger.warn(
+            `Variant of ${filename} could not be created: ${error.message}`,
+          )
+          return filePath
+        }
+      },
+    )
+  }
+
+  private getChangeScoreIndex(fileFolderPath: string): ChangeScoreIndex {
+    const filePath = path.join(fileFolderPath, CHANGE_SCORES_FILENAME)
+    if (this.changeScoreIndex?.filePath !== filePath) {
+      this.changeScoreIndex = new ChangeScoreIndex(filePath)
+    }
+    return this.changeScoreIndex
+  }
+
+  private async removeChangeScores(
+    fileFolderPath: string,
+    filenames: string[],
+  ): Promise<void> {
     try {
-      FileInteractor.removeAllFilesInDirectory(fileFolderPath)
+      await this.getChangeScoreIndex(fileFolderPath).removeValues(filenames)
     } catch (error) {
-      if (!(error instanceof CommandUnavailableOnWindowsException)) {
-        throw error
-      }
+      this.logger.warn(`Change scores could not be removed: ${error.message}`)
+    }
+  }
+
+  /**
+   * The index of each shots folder is kept in that folder, so that it moves
+   * with the card when the folder changes.
+   */
+  private getChecksumIndex(fileFolderPath: string): ChecksumIndex {
+    const filePath = path.join(fileFolderPath, CHECKSUMS_FILENAME)
+    if (this.checksumIndex?.filePath !== filePath) {
+      this.checksumIndex = new ChecksumIndex(filePath)
+    }
+    return this.checksumIndex
+  }
+
+  private async formatChecksums(
+    fileFolderPath: string,
+    filenames: string[],
+  ): Promise<string> {
+    const checksums = await this.getChecksumIndex(fileFolderPath).getValues()
+    return filenames
+      .filter((filename) => checksums.has(filename))
+      .map((filename) =>
+        ChecksumInteractor.formatLine(
+          path.basename(filename),
+          checksums.get(filename),
+        ),
+      )
+      .join('')
+  }
+
+  private async removeChecksums(
+    fileFolderPath: string,
+    filenames: string[],
+  ): Promise<void> {
+    try {
+      await this.getChecksumIndex(fileFolderPath).removeValues(filenames)
+    } catch (error) {
+      this.logger.warn(`Checksums could not be removed: ${error.message}`)
+    }
+  }
+
+  private async removeVariants(filenames: string[]): Promise<void> {
+    try {
+      await this.shotVariantCache.removeVariants(filenames)
+    } catch (error) {
+      this.logger.warn(`Variants could not be removed: ${error.message}`)
     }
   }
 
   @Cron('*/5 * * * *') // every 5 minutes
   async removeOldArchives() {
     this.logger.log('Cron job to delete old archives triggered...')
-    await FolderCleaner.removeOldFiles(ARCHIVE_FOLDER_PATH)
+    await MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'removeOldArchives'],
+      () => FolderCleaner.removeOldFiles(ARCHIVE_FOLDER_PATH),
+    )
+  }
+
+  @Cron('0 * * * *') // every hour
+  async removeOldVariants() {
+    this.logger.log('Cron job to delete old variants triggered...')
+    await MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'removeOldVariants'],
+      () =>
+        this.shotVariantCache.removeOldVariants(
+          VARIANT_TIME_TO_LIVE_MILLISECONDS,
+        ),
+    )
+  }
+
+  @Cron('*/5 * * * *') // every 5 minutes
+  removeFinishedDeletionJobs() {
+    const expiryTime =
+      Date.now() - FINISHED_DELETION_JOB_TIME_TO_LIVE_MILLISECONDS
+    for (const [id, job] of this.deletionJobs) {
+      if (job.isFinished && job.endTime.getTime() < expiryTime) {
+        this.deletionJobs.delete(id)
+      }
+    }
   }
 }
@@ -0,0 +1,78 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { NotFoundException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { IntegrityVerification } from './entities/integrity-verification.entity'
+import { IntegrityController } from './integrity.controller'
+import { IntegrityService } from './integrity.service'
+import { IIntegrityService } from './integrity.service.interface'
+
+const VERIFICATION: IntegrityVerification = {
+  id: 'v',
+  startTime: new Date(),
+  totalCount: 2,
+  verifiedCount: 1,
+  uncheckedCount: 0,
+  mismatchedFilenames: [],
+  unreadableFilenames: [],
+  missingFilenames: [],
+  isFinished: false,
+}
+
+describe(IntegrityController.name, () => {
+  let verification: IntegrityVerification | undefined
+
+  class MockIntegrityService implements IIntegrityService {
+    startVerification = vi.fn(() => Promise.resolve(VERIFICATION))
+    getVerification = vi.fn(() => verification)
+  }
+
+  let controller: IntegrityController
+  let service: IntegrityService
+
+  beforeEach(async () => {
+    verification = undefined
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [IntegrityController],
+      providers: [
+        { provide: IntegrityService, useClass: MockIntegrityService },
+      ],
+    }).compile()
+
+    controller = module.get<IntegrityController>(IntegrityController)
+    service = module.get<IntegrityService>(IntegrityService)
+  })
+
+  describe(IntegrityController.prototype.startVerification.name, () => {
+    it('asks for starting a verification', async () => {
+      expect(await controller.startVerification()).toEqual(VERIFICATION)
+      expect(service.startVerification).toHaveBeenCalled()
+    })
+  })
+
+  describe(IntegrityController.prototype.getVerification.name, () => {
+    it('returns the latest verification', () => {
+      verification = VERIFICATION
+      expect(controller.getVerification()).toEqual(VERIFICATION)
+    })
+
+    it('throws if no verification was started', () => {
+      expect(() => controller.getVerification()).toThrow(NotFoundException)
+    })
+  })
+})
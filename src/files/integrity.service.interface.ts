@@ -0,0 +1,6 @@
+import { IntegrityVerification } from './entities/integrity-verification.entity'
+
+export interface IIntegrityService {
+  startVerification: () => Promise<IntegrityVerification>
+  getVerification: () => IntegrityVerification | undefined
+}
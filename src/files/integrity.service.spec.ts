@@ -0,0 +1,153 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, rm, writeFile } from 'fs/promises'
+import path from 'path'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { MotionClientService } from '../motion-client.service'
+import { IMotionClientService } from '../motion-client.service.interface'
+import { NotificationsService } from '../notifications/notifications.service'
+import { INotificationsService } from '../notifications/notifications.service.interface'
+import { ChecksumInteractor } from './checksum-interactor'
+import { IndexedShot } from './entities/indexed-shot.entity'
+import { FilesService } from './files.service'
+import { IFilesService } from './files.service.interface'
+import { IntegrityService } from './integrity.service'
+import { ShotIndex } from './shot-index'
+
+const TEST_FOLDER = 'src/files/test-integrity-service'
+
+describe(IntegrityService.name, () => {
+  let shots: IndexedShot[]
+  let checksums: Map<string, string>
+
+  class MockMotionClientService implements Partial<IMotionClientService> {
+    getTargetDir = vi.fn(() => Promise.resolve(TEST_FOLDER))
+  }
+
+  class MockFilesService implements Partial<IFilesService> {
+    getChecksums = vi.fn(() => Promise.resolve(new Map(checksums)))
+  }
+
+  class MockShotIndex implements Partial<ShotIndex> {
+    getShotsOldestFirst = vi.fn(() => Promise.resolve([...shots]))
+  }
+
+  class MockNotificationsService implements Partial<INotificationsService> {
+    publish = vi.fn()
+  }
+
+  function shot(name: string): IndexedShot {
+    return { name, creationTime: new Date(), sizeBytes: 1 }
+  }
+
+  async function waitUntilFinished() {
+    await vi.waitFor(() => {
+      expect(service.getVerification()?.isFinished).toBe(true)
+    })
+  }
+
+  let service: IntegrityService
+  let notificationsService: NotificationsService
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+    for (const name of ['a.jpg', 'b.jpg', 'c.jpg', 'e.jpg']) {
+      await writeFile(path.join(TEST_FOLDER, name), name[0])
+    }
+    shots = ['a.jpg', 'b.jpg', 'c.jpg', 'd.jpg', 'e.jpg'].map(shot)
+    checksums = new Map([
+      ['a.jpg', 'c1d04330'],
+      ['b.jpg', 'e16dcdee'],
+      ['c.jpg', 'ffffffff'],
+      ['d.jpg', '0d0a0d0a'],
+    ])
+    vi.spyOn(ChecksumInteractor, 'computeChecksums').mockResolvedValue(
+      new Map([
+        [path.join(TEST_FOLDER, 'a.jpg'), 'c1d04330'],
+        [path.join(TEST_FOLDER, 'b.jpg'), 'e16dcdee'],
+        [path.join(TEST_FOLDER, 'c.jpg'), '6d6ef1a9'],
+      ]),
+    )
+
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: MotionClientService, useClass: MockMotionClientService },
+        { provide: FilesService, useClass: MockFilesService },
+        { provide: ShotIndex, useClass: MockShotIndex },
+        { provide: NotificationsService, useClass: MockNotificationsService },
+        IntegrityService,
+      ],
+    }).compile()
+
+    service = module.get<IntegrityService>(IntegrityService)
+    notificationsService =
+      module.get<NotificationsService>(NotificationsService)
+  })
+
+  describe(IntegrityService.prototype.startVerification.name, () => {
+    it('compares the shots with their recorded checksums', async () => {
+      await service.startVerification()
+      await waitUntilFinished()
+      expect(service.getVerification()).toMatchObject({
+        totalCount: 5,
+        verifiedCount: 2,
+        uncheckedCount: 1,
+        mismatchedFilenames: ['c.jpg'],
+        unreadableFilenames: [],
+        missingFilenames: ['d.jpg'],
+      })
+      expect(notificationsService.publish).toHaveBeenCalledWith(
+        'integrityVerified',
+        { mismatchedCount: 1, unreadableCount: 0, missingCount: 1 },
+      )
+    })
+
+    it('tells unreadable shots from deleted ones', async () => {
+      vi.mocked(ChecksumInteractor.computeChecksums).mockImplementation(
+        async () => {
+          checksums.delete('d.jpg')
+          return new Map()
+        },
+      )
+      await service.startVerification()
+      await waitUntilFinished()
+      expect(service.getVerification()).toMatchObject({
+        unreadableFilenames: ['a.jpg', 'b.jpg', 'c.jpg'],
+        missingFilenames: [],
+      })
+    })
+
+    it('returns the running verification', async () => {
+      const first = await service.startVerification()
+      const second = await service.startVerification()
+      expect(second.id).toBe(first.id)
+      await waitUntilFinished()
+    })
+  })
+
+  describe(IntegrityService.prototype.getVerification.name, () => {
+    it('returns nothing before the first verification', () => {
+      expect(service.getVerification()).toBeUndefined()
+    })
+  })
+
+  afterEach(async () => {
+    vi.restoreAllMocks()
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
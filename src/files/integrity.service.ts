@@ -0,0 +1,178 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { randomUUID } from 'crypto'
+import { lstat } from 'fs/promises'
+import path from 'path'
+import { Injectable, Logger, Optional } from '@nestjs/common'
+import { MotionClientService } from '../motion-client.service'
+import { NotificationsService } from '../notifications/notifications.service'
+import { ChecksumInteractor } from './checksum-interactor'
+import { IntegrityVerification } from './entities/integrity-verification.entity'
+import { FilesService } from './files.service'
+import { IIntegrityService } from './integrity.service.interface'
+import { ShotIndex } from './shot-index'
+
+const BATCH_SIZE = 16
+// Leaves most of the card bandwidth to capture while verifying.
+const MAXIMUM_BYTES_PER_SECOND = 4 * 1024 * 1024
+
+@Injectable()
+export class IntegrityService implements IIntegrityService {
+  private readonly logger = new Logger(IntegrityService.name)
+  private verification: IntegrityVerification | null = null
+
+  constructor(
+    private readonly motionClientService: MotionClientService,
+    private readonly filesService: FilesService,
+    private readonly shotIndex: ShotIndex,
+    @Optional() private readonly notificationsService?: NotificationsService,
+  ) {}
+
+  /**
+   * Starts reading back all shots with a recorded checksum, or returns the
+   * verification that is still running.
+   */
+  async startVerification(): Promise<IntegrityVerification> {
+    if (this.verification && !this.verification.isFinished) {
+      return this.getVerification()
+    }
+    const folderPath = await this.motionClientService.getTargetDir()
+    const verification: IntegrityVerification = {
+      id: randomUUID(),
+      startTime: new Date(),
+      totalCount: 0,
+      verifiedCount: 0,
+      uncheckedCount: 0,
+      mismatchedFilenames: [],
+      unreadableFilenames: [],
+      missingFilenames: [],
+      isFinished: false,
+    }
+    this.verification = verification
+    this.runVerification(verification, folderPath).catch((error) => {
+      this.logger.error(
+        `Integrity verification ${verification.id} failed: ${error.message}`,
+      )
+      this.finishVerification(verification)
+    })
+    return this.getVerification()
+  }
+
+  getVerification(): IntegrityVerification | undefined {
+    if (!this.verification) {
+      return undefined
+    }
+    return {
+      ...this.verification,
+      mismatchedFilenames: [...this.verification.mismatchedFilenames],
+      unreadableFilenames: [...this.verification.unreadableFilenames],
+      missingFilenames: [...this.verification.missingFilenames],
+    }
+  }
+
+  private async runVerification(
+    verification: IntegrityVerification,
+    folderPath: string,
+  ): Promise<void> {
+    const checksums = await this.filesService.getChecksums()
+    const shots = await this.shotIndex.getShotsOldestFirst()
+    const checkableShots = shots.filter((shot) => checksums.has(shot.name))
+    verification.totalCount = shots.length
+    verification.uncheckedCount = shots.length - checkableShots.length
+    for (let i = 0; i < checkableShots.length; i += BATCH_SIZE) {
+      const batch = checkableShots.slice(i, i + BATCH_SIZE)
+      const batchStartTime = Date.now()
+      const computedChecksums = await ChecksumInteractor.computeChecksums(
+        batch.map((shot) => path.join(folderPath, shot.name)),
+      )
+      for (const shot of batch) {
+        const checksum = computedChecksums.get(path.join(folderPath, shot.name))
+        if (checksum === checksums.get(shot.name)) {
+          verification.verifiedCount++
+        } else if (checksum !== undefined) {
+          verification.mismatchedFilenames.push(shot.name)
+        } else if (await this.isMissing(folderPath, shot.name)) {
+          verification.missingFilenames.push(shot.name)
+        } else if (await this.isStillRecorded(shot.name)) {
+          verification.unreadableFilenames.push(shot.name)
+        }
+      }
+      const batchSizeBytes = batch.reduce(
+        (sum, shot) => sum + shot.sizeBytes,
+        0,
+      )
+      const minimumDurationMs =
+        (batchSizeBytes / MAXIMUM_BYTES_PER_SECOND) * 1000
+      const waitingTimeMs = minimumDurationMs - (Date.now() - batchStartTime)
+      if (waitingTimeMs > 0) {
+        await new Promise((resolve) => setTimeout(resolve, waitingTimeMs))
+      }
+    }
+    this.finishVerification(verification)
+    this.report(verification)
+  }
+
+  /**
+   * Tells whether a shot is gone although its checksum is still recorded,
+   * i.e. it was not deleted through the app meanwhile.
+   */
+  private async isMissing(
+    folderPath: string,
+    filename: string,
+  ): Promise<boolean> {
+    try {
+      await lstat(path.join(folderPath, filename))
+      return false
+    } catch (error) {
+      if (error.code !== 'ENOENT') {
+        return false
+      }
+    }
+    return this.isStillRecorded(filename)
+  }
+
+  private async isStillRecorded(filename: string): Promise<boolean> {
+    const checksums = await this.filesService.getChecksums()
+    return checksums.has(filename)
+  }
+
+  private finishVerification(verification: IntegrityVerification): void {
+    verification.isFinished = true
+    verification.endTime = new Date()
+  }
+
+  private report(verification: IntegrityVerification): void {
+    const failedFilenames = [
+      ...verification.mismatchedFilenames,
+      ...verification.unreadableFilenames,
+      ...verification.missingFilenames,
+    ]
+    if (failedFilenames.length > 0) {
+      this.logger.warn(
+        `Integrity verification ${verification.id} found damaged shots: ${failedFilenames.join(', ')}`,
+      )
+    }
+    this.logger.log(
+      `Integrity verification ${verification.id} finished: ${verification.verifiedCount} verified, ${verification.uncheckedCount} unchecked, ${failedFilenames.length} damaged`,
+    )
+    this.notificationsService?.publish('integrityVerified', {
+      mismatchedCount: verification.mismatchedFilenames.length,
+      unreadableCount: verification.unreadableFilenames.length,
+      missingCount: verification.missingFilenames.length,
+    })
+  }
+}
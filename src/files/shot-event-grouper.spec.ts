@@ -0,0 +1,164 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { DateTime } from 'luxon'
+import { IndexedShot } from './entities/indexed-shot.entity'
+import { ShotEventGrouper } from './shot-event-grouper'
+
+describe(ShotEventGrouper.name, () => {
+  function at(time: string): Date {
+    return DateTime.fromFormat(time, "yyyyLLdd'T'HHmmss").toJSDate()
+  }
+
+  function shot(name: string, creationTime: string): IndexedShot {
+    return { name, creationTime: at(creationTime), sizeBytes: 10 }
+  }
+
+  function groupFilenames(grouper: ShotEventGrouper): string[][] {
+    return grouper
+      .getGroups()
+      .map((group) => group.shots.map((groupedShot) => groupedShot.name))
+  }
+
+  const BURST = [
+    shot('20240101T220000.mp4', '20240101T220005'),
+    shot('20240101T220001_01.jpg', '20240101T220001'),
+    shot('20240101T220003_01.jpg', '20240101T220003'),
+  ]
+
+  let grouper: ShotEventGrouper
+
+  beforeEach(() => {
+    grouper = new ShotEventGrouper()
+  })
+
+  describe(ShotEventGrouper.prototype.rebuild.name, () => {
+    it('groups pictures with the movie of their event', () => {
+      grouper.rebuild([
+        ...BURST,
+        shot('20240101T220008_01.jpg', '20240101T220008'),
+      ])
+      expect(groupFilenames(grouper)).toEqual([
+        [
+          '20240101T220000.mp4',
+          '20240101T220001_01.jpg',
+          '20240101T220003_01.jpg',
+        ],
+        ['20240101T220008_01.jpg'],
+      ])
+      const [event] = grouper.getGroups()
+      expect(event.id).toBe('20240101T220000')
+      expect(event.startMs).toBe(at('20240101T220000').getTime())
+      expect(event.endMs).toBe(at('20240101T220005').getTime())
+    })
+
+    it('spans the whole movie when only the best picture is kept', () => {
+      grouper.rebuild([
+        shot('20240101T220030_01.jpg', '20240101T220030'),
+        shot('20240101T220000.mp4', '20240101T220040'),
+      ])
+      expect(grouper.getGroups()).toHaveLength(1)
+    })
+
+    it('reads the time after the site and device names', () => {
+      grouper.rebuild([
+        shot(
+          'Site_Cam_20240101T220000_Europe-Luxembourg.mp4',
+          '20240101T220040',
+        ),
+        shot(
+          'Site_Cam_20240101T220030_01_Europe-Luxembourg.jpg',
+          '20240101T220030',
+        ),
+        shot('Cam_20240101T220045_01.jpg', '20240101T220045'),
+      ])
+      expect(grouper.getGroups()).toHaveLength(1)
+      const [event] = grouper.getGroups()
+      expect(event.id).toBe('20240101T220000')
+      expect(event.endMs).toBe(at('20240101T220045').getTime())
+    })
+
+    it('leaves out snapshots and other files', () => {
+      grouper.rebuild([
+        shot('20240101T220000_snapshot.jpg', '20240101T220000'),
+        shot('settings.json', '20240101T220000'),
+      ])
+      expect(grouper.getGroups()).toHaveLength(0)
+    })
+
+    it('falls back to the creation time for other filenames', () => {
+      grouper.rebuild([shot('picture.jpg', '20240101T220000')])
+      expect(grouper.getGroups()[0].startMs).toBe(
+        at('20240101T220000').getTime(),
+      )
+    })
+  })
+
+  describe(ShotEventGrouper.parseFilenameTime.name, () => {
+    it('finds the time anywhere in the name', () => {
+      const time = ShotEventGrouper.parseFilenameTime(
+        'Site_Cam_20240101T220000_Etc-GMT+1',
+      )
+      expect(time).toBe(at('20240101T220000').getTime())
+    })
+
+    it('returns NaN without a time', () => {
+      expect(ShotEventGrouper.parseFilenameTime('Site_Cam')).toBeNaN()
+    })
+  })
+
+  describe(ShotEventGrouper.prototype.add.name, () => {
+    it('extends the last event or starts a new one', () => {
+      grouper.rebuild(BURST)
+      expect(
+        grouper.add(shot('20240101T220007_01.jpg', '20240101T220007')),
+      ).toBe(true)
+      expect(
+        grouper.add(shot('20240101T220010_01.jpg', '20240101T220010')),
+      ).toBe(true)
+      const eventSizes = groupFilenames(grouper).map((names) => names.length)
+      expect(eventSizes).toEqual([4, 1])
+    })
+
+    it('refuses shots starting before the last event', () => {
+      grouper.rebuild(BURST)
+      expect(
+        grouper.add(shot('20240101T215900_01.jpg', '20240101T215900')),
+      ).toBe(false)
+    })
+  })
+
+  describe(ShotEventGrouper.prototype.update.name, () => {
+    it('extends the last event while its movie is being written', () => {
+      grouper.rebuild(BURST)
+      grouper.update(shot('20240101T220000.mp4', '20240101T220020'))
+      expect(grouper.getGroups()[0].endMs).toBe(
+        at('20240101T220020').getTime(),
+      )
+    })
+  })
+
+  describe(ShotEventGrouper.prototype.remove.name, () => {
+    it('removes events without any shot left', () => {
+      grouper.rebuild(BURST)
+      for (const burstShot of BURST) {
+        grouper.remove(burstShot.name)
+      }
+      expect(grouper.getGroups()).toHaveLength(0)
+      expect(grouper.findGroup('20240101T220000')).toBeUndefined()
+    })
+  })
+})
@@ -0,0 +1,200 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import path from 'path'
+import { DateTime } from 'luxon'
+import { IndexedShot } from './entities/indexed-shot.entity'
+import { MimeTypeDeterminer } from './mime-type-determiner'
+
+const MOTION_FILENAME_TIME_FORMAT = "yyyyLLdd'T'HHmmss"
+// Motion's picture_filename and movie_filename contain this timestamp after
+// the optional site and device names and before the optional time zone.
+const MOTION_FILENAME_TIME_PATTERN = /\d{8}T\d{6}/g
+// Same as Motion's event_gap
+const DEFAULT_EVENT_GAP_MILLISECONDS = 2000
+const SNAPSHOT_FILENAME_SUFFIX = '_snapshot'
+
+export type ShotKind = 'picture' | 'movie'
+
+export interface GroupedShot extends IndexedShot {
+  kind: ShotKind
+  startMs: number
+  endMs: number
+}
+
+export interface ShotEventGroup {
+  id: string
+  startMs: number
+  endMs: number
+  shots: GroupedShot[]
+}
+
+/**
+ * Groups pictures and movies into Motion events. A shot belongs to the
+ * previous event if it starts at most one event gap after that event ended.
+ * Shots arriving in order are added incrementally, anything else requires a
+ * rebuild.
+ */
+export class ShotEventGrouper {
+  private groups: ShotEventGroup[] = []
+  private readonly groupsById = new Map<string, ShotEventGroup>()
+  private readonly groupsByFilename = new Map<string, ShotEventGroup>()
+
+  constructor(private readonly eventGapMs = DEFAULT_EVENT_GAP_MILLISECONDS) {}
+
+  getGroups(): readonly ShotEventGroup[] {
+    return this.groups
+  }
+
+  findGroup(id: string): ShotEventGroup | undefined {
+    return this.groupsById.get(id)
+  }
+
+  rebuild(shots: IndexedShot[]): void {
+    this.groups = []
+    this.groupsById.clear()
+    this.groupsByFilename.clear()
+    const groupedShots = shots
+      .map((shot) => ShotEventGrouper.toGroupedShot(shot))
+      .filter((shot) => shot)
+      .sort((a, b) => a.startMs - b.startMs || a.name.localeCompare(b.name))
+    for (const shot of groupedShots) {
+      this.append(shot)
+    }
+  }
+
+  /**
+   * Returns false if the shot starts before the last event.
+   */
+  add(shot: IndexedShot): boolean {
+    const groupedShot = ShotEventGrouper.toGroupedShot(shot)
+    if (!groupedShot) {
+      return true
+    }
+    const lastGroup = this.groups[this.groups.length - 1]
+    if (lastGroup && groupedShot.startMs < lastGroup.startMs) {
+      return false
+    }
+    this.append(groupedShot)
+    return true
+  }
+
+  /**
+   * Returns false if the shot does not belong to the last event, as it might
+   * then need to be merged with the following one.
+   */
+  update(shot: IndexedShot): boolean {
+    const group = this.groupsByFilename.get(shot.name)
+    if (!group) {
+      return this.add(shot)
+    }
+    const groupedShot = ShotEventGrouper.toGroupedShot(shot)
+    if (group !== this.groups[this.groups.length - 1] || !groupedShot) {
+      return false
+    }
+    const index = group.shots.findIndex((s) => s.name === shot.name)
+    group.shots[index] = groupedShot
+    group.endMs = Math.max(group.endMs, groupedShot.endMs)
+    return true
+  }
+
+  remove(filename: string): void {
+    const group = this.groupsByFilename.get(filename)
+    if (!group) {
+      return
+    }
+    this.groupsByFilename.delete(filename)
+    group.shots = group.shots.filter((shot) => shot.name !== filename)
+    if (group.shots.length === 0) {
+      this.groups.splice(this.groups.indexOf(group), 1)
+      this.groupsById.delete(group.id)
+      return
+    }
+    group.startMs = Math.min(...group.shots.map((shot) => shot.startMs))
+    group.endMs = Math.max(...group.shots.map((shot) => shot.endMs))
+  }
+
+  private append(shot: GroupedShot): void {
+    let group = this.groups[this.groups.length - 1]
+    if (!group || shot.startMs > group.endMs + this.eventGapMs) {
+      group = {
+        id: DateTime.fromMillis(shot.startMs).toFormat(
+          MOTION_FILENAME_TIME_FORMAT,
+        ),
+        startMs: shot.startMs,
+        endMs: shot.endMs,
+        shots: [],
+      }
+      // Events starting within the same second share the name prefix.
+      while (this.groupsById.has(group.id)) {
+        group.id += '-'
+      }
+      this.groups.push(group)
+      this.groupsById.set(group.id, group)
+    }
+    group.shots.push(shot)
+    group.endMs = Math.max(group.endMs, shot.endMs)
+    this.groupsByFilename.set(shot.name, group)
+  }
+
+  /**
+   * Motion names a movie after the start of its event and finishes writing it
+   * at the end, so that movies span the whole event. Snapshots and files
+   * other than pictures and movies do not belong to any event.
+   */
+  static toGroupedShot(shot: IndexedShot): GroupedShot | null {
+    const extension = path.extname(shot.name)
+    const basename = path.basename(shot.name, extension)
+    if (basename.endsWith(SNAPSHOT_FILENAME_SUFFIX)) {
+      return null
+    }
+    let kind: ShotKind
+    try {
+      const contentType = MimeTypeDeterminer.getContentType(extension)
+      if (contentType.startsWith('image/')) {
+        kind = 'picture'
+      } else if (contentType.startsWith('video/')) {
+        kind = 'movie'
+      } else {
+        return null
+      }
+    } catch {
+      return null
+    }
+    const startMs = ShotEventGrouper.parseFilenameTime(basename)
+    const creationMs = shot.creationTime.getTime()
+    const validStartMs = Number.isNaN(startMs) ? creationMs : startMs
+    const endMs =
+      kind === 'movie' ? Math.max(validStartMs, creationMs) : validStartMs
+    return { ...shot, kind, startMs: validStartMs, endMs }
+  }
+
+  /**
+   * Takes the last timestamp, as the site and device names in front of it are
+   * free text.
+   */
+  static parseFilenameTime(basename: string): number {
+    const matches = basename.match(MOTION_FILENAME_TIME_PATTERN)
+    if (!matches) {
+      return NaN
+    }
+    const dateTime = DateTime.fromFormat(
+      matches[matches.length - 1],
+      MOTION_FILENAME_TIME_FORMAT,
+    )
+    return dateTime.isValid ? dateTime.toMillis() : NaN
+  }
+}
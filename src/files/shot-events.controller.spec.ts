@@ -0,0 +1,135 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { ReadStream } from 'fs'
+import { PassThrough } from 'stream'
+import { NotFoundException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { ShotEventsController } from './shot-events.controller'
+import { ShotEventsService } from './shot-events.service'
+import { IShotEventsService } from './shot-events.service.interface'
+
+const EVENT = {
+  id: '20240101T220000',
+  startTime: new Date(),
+  endTime: new Date(),
+  frameCount: 1,
+  movieCount: 1,
+  totalBytes: 20,
+  representativeFrame: '20240101T220001_01.jpg',
+  filenames: ['20240101T220000.mp4', '20240101T220001_01.jpg'],
+}
+
+class MockShotEventsService implements Partial<IShotEventsService> {
+  findAll = vi.fn(() => Promise.resolve([EVENT]))
+  findOne = vi.fn((id: string) =>
+    Promise.resolve(id === EVENT.id ? EVENT : undefined),
+  )
+  getStreamableFiles = vi.fn((id: string) =>
+    Promise.resolve(
+      id === EVENT.id
+        ? {
+            contentType: 'c',
+            filename: 'f',
+            stream: new PassThrough() as unknown as ReadStream,
+          }
+        : undefined,
+    ),
+  )
+  remove = vi.fn((id: string) =>
+    Promise.resolve(id === EVENT.id ? { a: true } : undefined),
+  )
+}
+
+describe(ShotEventsController.name, () => {
+  let controller: ShotEventsController
+  let service: ShotEventsService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [ShotEventsController],
+      providers: [
+        { provide: ShotEventsService, useClass: MockShotEventsService },
+      ],
+    }).compile()
+
+    controller = module.get<ShotEventsController>(ShotEventsController)
+    service = module.get<ShotEventsService>(ShotEventsService)
+  })
+
+  it('is defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(ShotEventsController.prototype.findAll.name, () => {
+    it('returns all events', async () => {
+      expect(await controller.findAll()).toEqual([EVENT])
+    })
+  })
+
+  describe(ShotEventsController.prototype.findOne.name, () => {
+    it('returns the event', async () => {
+      expect(await controller.findOne(EVENT.id)).toEqual(EVENT)
+    })
+
+    it('throws if the event is unknown', async () => {
+      await expect(controller.findOne('unknown')).rejects.toThrow(
+        NotFoundException,
+      )
+    })
+  })
+
+  describe(ShotEventsController.prototype.downloadEvent.name, () => {
+    it('asks for the archive and sets the response', async () => {
+      const mockResponse = {
+        set: vi.fn(),
+      }
+      await controller.downloadEvent(EVENT.id, mockResponse)
+      expect(service.getStreamableFiles).toHaveBeenCalledWith(
+        EVENT.id,
+        undefined,
+      )
+      expect(mockResponse.set).toHaveBeenCalled()
+    })
+
+    it('asks for downscaled variants', async () => {
+      const mockResponse = {
+        set: vi.fn(),
+      }
+      await controller.downloadEvent(EVENT.id, mockResponse, {
+        longEdge: '800',
+        quality: '50',
+      })
+      expect(service.getStreamableFiles).toHaveBeenCalledWith(EVENT.id, {
+        longEdge: 800,
+        quality: 50,
+      })
+    })
+  })
+
+  describe(ShotEventsController.prototype.deleteEvent.name, () => {
+    it('asks for removing the files of the event', async () => {
+      expect(await controller.deleteEvent(EVENT.id)).toEqual({ a: true })
+    })
+
+    it('throws if the event is unknown', async () => {
+      await expect(controller.deleteEvent('unknown')).rejects.toThrow(
+        NotFoundException,
+      )
+    })
+  })
+})
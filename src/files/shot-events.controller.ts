@@ -0,0 +1,83 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  Controller,
+  Delete,
+  Get,
+  NotFoundException,
+  Param,
+  Query,
+  Res,
+  StreamableFile,
+} from '@nestjs/common'
+import { ShotVariantQueryDto } from './dto/shot-variant-query.dto'
+import { FileDeletionResponse } from './entities/file-deletion-response.entity'
+import { ShotEvent, ShotEventWithFilenames } from './entities/shot-event.entity'
+import { ShotEventsService } from './shot-events.service'
+import { ShotVariantCache } from './shot-variant-cache'
+
+@Controller('shot-events')
+export class ShotEventsController {
+  constructor(private readonly shotEventsService: ShotEventsService) {}
+
+  @Get()
+  async findAll(): Promise<ShotEvent[]> {
+    return this.shotEventsService.findAll()
+  }
+
+  @Get(':id')
+  async findOne(@Param('id') id: string): Promise<ShotEventWithFilenames> {
+    const event = await this.shotEventsService.findOne(id)
+    if (!event) {
+      throw new NotFoundException()
+    }
+    return event
+  }
+
+  @Get(':id/archive')
+  async downloadEvent(
+    @Param('id') id: string,
+    @Res({ passthrough: true }) res,
+    @Query() query: ShotVariantQueryDto = {},
+  ) {
+    const variant = ShotVariantCache.createVariant(
+      query.longEdge ? parseInt(query.longEdge) : undefined,
+      query.quality ? parseInt(query.quality) : undefined,
+    )
+    const archive = await this.shotEventsService.getStreamableFiles(
+      id,
+      variant,
+    )
+    if (!archive) {
+      throw new NotFoundException()
+    }
+    res.set({
+      'Content-Type': archive.contentType,
+      'Content-Disposition': 'attachment; filename="' + archive.filename + '"',
+    })
+    return new StreamableFile(archive.stream)
+  }
+
+  @Delete(':id')
+  async deleteEvent(@Param('id') id: string): Promise<FileDeletionResponse> {
+    const result = await this.shotEventsService.remove(id)
+    if (!result) {
+      throw new NotFoundException()
+    }
+    return result
+  }
+}
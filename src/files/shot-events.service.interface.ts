@@ -0,0 +1,14 @@
+import { FileDeletionResponse } from './entities/file-deletion-response.entity'
+import { ShotEvent, ShotEventWithFilenames } from './entities/shot-event.entity'
+import { ShotVariant } from './entities/shot-variant.entity'
+import { StreamWithContentTypeAndFilename } from './entities/stream-with-content-type-and-filename.entity.'
+
+export interface IShotEventsService {
+  findAll: () => Promise<ShotEvent[]>
+  findOne: (id: string) => Promise<ShotEventWithFilenames | undefined>
+  getStreamableFiles: (
+    id: string,
+    variant?: ShotVariant,
+  ) => Promise<StreamWithContentTypeAndFilename | undefined>
+  remove: (id: string) => Promise<FileDeletionResponse | undefined>
+}
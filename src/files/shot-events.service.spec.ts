@@ -0,0 +1,121 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Test, TestingModule } from '@nestjs/testing'
+import { DateTime } from 'luxon'
+import { Subject } from 'rxjs'
+import { vi } from 'vitest'
+import { IndexedShot } from './entities/indexed-shot.entity'
+import { FilesService } from './files.service'
+import { IFilesService } from './files.service.interface'
+import { ShotEventsService } from './shot-events.service'
+import { ShotIndex, ShotIndexChange } from './shot-index'
+
+describe(ShotEventsService.name, () => {
+  function at(time: string): Date {
+    return DateTime.fromFormat(time, "yyyyLLdd'T'HHmmss").toJSDate()
+  }
+
+  function shot(name: string, creationTime: string): IndexedShot {
+    return { name, creationTime: at(creationTime), sizeBytes: 10 }
+  }
+
+  const SHOTS = [
+    shot('20240101T220000.mp4', '20240101T220004'),
+    shot('20240101T220001_01.jpg', '20240101T220001'),
+    shot('20240101T220002_01.jpg', '20240101T220002'),
+    shot('20240101T220003_01.jpg', '20240101T220003'),
+  ]
+
+  class MockShotIndex implements Partial<ShotIndex> {
+    changes$ = new Subject<ShotIndexChange>()
+    ensureUpToDate = vi.fn(() => Promise.resolve())
+    getShotsOldestFirst = vi.fn(() => Promise.resolve([...SHOTS]))
+  }
+
+  class MockFilesService implements Partial<IFilesService> {
+    getChangeScores = vi.fn(() =>
+      Promise.resolve(new Map([['20240101T220003_01.jpg', 120]])),
+    )
+    removeFiles = vi.fn(() => Promise.resolve({}))
+  }
+
+  let service: ShotEventsService
+  let shotIndex: ShotIndex
+  let filesService: FilesService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: FilesService, useClass: MockFilesService },
+        { provide: ShotIndex, useClass: MockShotIndex },
+        ShotEventsService,
+      ],
+    }).compile()
+
+    service = module.get<ShotEventsService>(ShotEventsService)
+    shotIndex = module.get<ShotIndex>(ShotIndex)
+    filesService = module.get<FilesService>(FilesService)
+    service.onModuleInit()
+  })
+
+  describe(ShotEventsService.prototype.findAll.name, () => {
+    it('summarises each event', async () => {
+      expect(await service.findAll()).toEqual([
+        {
+          id: '20240101T220000',
+          startTime: at('20240101T220000'),
+          endTime: at('20240101T220004'),
+          frameCount: 3,
+          movieCount: 1,
+          totalBytes: 40,
+          representativeFrame: '20240101T220003_01.jpg',
+        },
+      ])
+    })
+
+    it('follows new shots without reading all shots again', async () => {
+      await service.findAll()
+      shotIndex.changes$.next({
+        type: 'created',
+        shot: shot('20240101T220010_01.jpg', '20240101T220010'),
+      })
+      const events = await service.findAll()
+      expect(events.map((event) => event.id)).toEqual([
+        '20240101T220010',
+        '20240101T220000',
+      ])
+      expect(shotIndex.getShotsOldestFirst).toHaveBeenCalledTimes(1)
+    })
+  })
+
+  describe(ShotEventsService.prototype.remove.name, () => {
+    it('removes all files of the event', async () => {
+      await service.remove('20240101T220000')
+      expect(filesService.removeFiles).toHaveBeenCalledWith(
+        SHOTS.map((s) => s.name),
+      )
+    })
+
+    it('returns undefined for unknown events', async () => {
+      expect(await service.remove('unknown')).toBeUndefined()
+    })
+  })
+
+  afterEach(() => {
+    service.onModuleDestroy()
+  })
+})
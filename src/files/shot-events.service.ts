@@ -0,0 +1,170 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  Injectable,
+  Logger,
+  OnModuleDestroy,
+  OnModuleInit,
+} from '@nestjs/common'
+import { Subscription } from 'rxjs'
+import { FileDeletionResponse } from './entities/file-deletion-response.entity'
+import { ShotEvent, ShotEventWithFilenames } from './entities/shot-event.entity'
+import { ShotVariant } from './entities/shot-variant.entity'
+import { StreamWithContentTypeAndFilename } from './entities/stream-with-content-type-and-filename.entity.'
+import { FilesService } from './files.service'
+import { ShotEventGroup, ShotEventGrouper } from './shot-event-grouper'
+import { IShotEventsService } from './shot-events.service.interface'
+import { ShotIndex, ShotIndexChange } from './shot-index'
+
+@Injectable()
+export class ShotEventsService
+  implements IShotEventsService, OnModuleInit, OnModuleDestroy
+{
+  private readonly logger = new Logger(ShotEventsService.name)
+  private readonly grouper = new ShotEventGrouper()
+  private isStale = true
+  private isRebuilding = false
+  private subscription: Subscription | null = null
+
+  constructor(
+    private readonly filesService: FilesService,
+    private readonly shotIndex: ShotIndex,
+  ) {}
+
+  onModuleInit() {
+    this.subscription = this.shotIndex.changes$.subscribe((change) => {
+      this.applyChange(change)
+    })
+  }
+
+  onModuleDestroy() {
+    this.subscription?.unsubscribe()
+  }
+
+  async findAll(): Promise<ShotEvent[]> {
+    const groups = await this.getGroups()
+    const changeScores = await this.filesService.getChangeScores()
+    return groups
+      .map((group) => this.toShotEvent(group, changeScores))
+      .reverse()
+  }
+
+  async findOne(id: string): Promise<ShotEventWithFilenames | undefined> {
+    await this.getGroups()
+    const group = this.grouper.findGroup(id)
+    if (!group) {
+      return undefined
+    }
+    const changeScores = await this.filesService.getChangeScores()
+    return {
+      ...this.toShotEvent(group, changeScores),
+      filenames: group.shots.map((shot) => shot.name),
+    }
+  }
+
+  async getStreamableFiles(
+    id: string,
+    variant?: ShotVariant,
+  ): Promise<StreamWithContentTypeAndFilename | undefined> {
+    const filenames = await this.getFilenames(id)
+    if (!filenames) {
+      return undefined
+    }
+    return this.filesService.getStreamableFiles(filenames, variant)
+  }
+
+  async remove(id: string): Promise<FileDeletionResponse | undefined> {
+    const filenames = await this.getFilenames(id)
+    if (!filenames) {
+      return undefined
+    }
+    this.logger.log(`Removing event ${id} with ${filenames.length} files...`)
+    return this.filesService.removeFiles(filenames)
+  }
+
+  private async getFilenames(id: string): Promise<string[] | undefined> {
+    await this.getGroups()
+    return this.grouper.findGroup(id)?.shots.map((shot) => shot.name)
+  }
+
+  private async getGroups(): Promise<readonly ShotEventGroup[]> {
+    await this.shotIndex.ensureUpToDate()
+    // Changes seen while the shots are read make the result stale again.
+    while (this.isStale) {
+      this.isStale = false
+      this.isRebuilding = true
+      try {
+        this.grouper.rebuild(await this.shotIndex.getShotsOldestFirst())
+      } catch (error) {
+        this.isStale = true
+        throw error
+      } finally {
+        this.isRebuilding = false
+      }
+    }
+    return this.grouper.getGroups()
+  }
+
+  private applyChange(change: ShotIndexChange): void {
+    if (this.isStale || this.isRebuilding) {
+      this.isStale = true
+      return
+    }
+    switch (change.type) {
+      case 'created':
+        this.isStale = !this.grouper.add(change.shot)
+        break
+      case 'updated':
+        this.isStale = !this.grouper.update(change.shot)
+        break
+      case 'deleted':
+        this.grouper.remove(change.name)
+        break
+      case 'rebuilt':
+        this.isStale = true
+        break
+    }
+  }
+
+  private toShotEvent(
+    group: ShotEventGroup,
+    changeScores: ReadonlyMap<string, number>,
+  ): ShotEvent {
+    const pictures = group.shots.filter((shot) => shot.kind === 'picture')
+    let representativeFrame =
+      pictures.length > 0
+        ? pictures[Math.floor((pictures.length - 1) / 2)].name
+        : null
+    let highestChangeScore = -1
+    for (const picture of pictures) {
+      const changeScore = changeScores.get(picture.name)
+      if (changeScore !== undefined && changeScore > highestChangeScore) {
+        highestChangeScore = changeScore
+        representativeFrame = picture.name
+      }
+    }
+    return {
+      id: group.id,
+      startTime: new Date(group.startMs),
+      endTime: new Date(group.endMs),
+      frameCount: pictures.length,
+      movieCount: group.shots.length - pictures.length,
+      totalBytes: group.shots.reduce((sum, shot) => sum + shot.sizeBytes, 0),
+      representativeFrame,
+    }
+  }
+}
@@ -0,0 +1,115 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, rm, utimes, writeFile } from 'fs/promises'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { MotionClientService } from '../motion-client.service'
+import { IMotionClientService } from '../motion-client.service.interface'
+import { NotificationsService } from '../notifications/notifications.service'
+import { ShotIndex } from './shot-index'
+
+describe(ShotIndex.name, () => {
+  const TEST_FOLDER_PATH = 'src/files/test-shot-index'
+  const spyGetTargetDir = vi.fn().mockResolvedValue(TEST_FOLDER_PATH)
+
+  class MockMotionClientService implements Partial<IMotionClientService> {
+    getTargetDir = spyGetTargetDir
+  }
+
+  let shotIndex: ShotIndex
+  let notificationsService: NotificationsService
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER_PATH + '/sub', { recursive: true })
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: MotionClientService, useClass: MockMotionClientService },
+        NotificationsService,
+        ShotIndex,
+      ],
+    }).compile()
+
+    shotIndex = module.get<ShotIndex>(ShotIndex)
+    notificationsService =
+      module.get<NotificationsService>(NotificationsService)
+  })
+
+  describe(ShotIndex.prototype.getShotsOldestFirst.name, () => {
+    it('returns the files ordered from oldest to newest', async () => {
+      await writeFile(TEST_FOLDER_PATH + '/b.jpg', 'bb')
+      await writeFile(TEST_FOLDER_PATH + '/a.jpg', 'a')
+      await utimes(TEST_FOLDER_PATH + '/b.jpg', 1000, 1000)
+      await utimes(TEST_FOLDER_PATH + '/a.jpg', 2000, 2000)
+      const shots = await shotIndex.getShotsOldestFirst()
+      expect(shots.map((shot) => shot.name)).toEqual(['b.jpg', 'a.jpg'])
+      expect(shots[0].sizeBytes).toBe(2)
+    })
+
+    it('follows files added and removed after the first scan', async () => {
+      await writeFile(TEST_FOLDER_PATH + '/a.jpg', 'a')
+      expect(await shotIndex.getShotsOldestFirst()).toHaveLength(1)
+      await writeFile(TEST_FOLDER_PATH + '/b.jpg', 'b')
+      await rm(TEST_FOLDER_PATH + '/a.jpg')
+      await new Promise((r) => setTimeout(r, 100))
+      const shots = await shotIndex.getShotsOldestFirst()
+      expect(shots.map((shot) => shot.name)).toEqual(['b.jpg'])
+    })
+
+    it('leaves out hidden files', async () => {
+      await writeFile(TEST_FOLDER_PATH + '/a.jpg', 'a')
+      await writeFile(TEST_FOLDER_PATH + '/.checksums', '')
+      expect(await shotIndex.getShotsOldestFirst()).toHaveLength(1)
+      await writeFile(
+        TEST_FOLDER_PATH + '/.checksums',
+        '{"name":"a.jpg","value":"e3069283"}\n',
+      )
+      await new Promise((r) => setTimeout(r, 100))
+      const shots = await shotIndex.getShotsOldestFirst()
+      expect(shots.map((shot) => shot.name)).toEqual(['a.jpg'])
+    })
+
+    it('notifies about added and removed shots', async () => {
+      const spyPublish = vi.spyOn(notificationsService, 'publish')
+      await writeFile(TEST_FOLDER_PATH + '/a.jpg', 'a')
+      await shotIndex.getShotsOldestFirst()
+      await writeFile(TEST_FOLDER_PATH + '/b.jpg', 'bb')
+      await rm(TEST_FOLDER_PATH + '/a.jpg')
+      await new Promise((r) => setTimeout(r, 100))
+      await shotIndex.getShotsOldestFirst()
+      expect(spyPublish).toHaveBeenCalledWith('shotCreated', {
+        name: 'b.jpg',
+        sizeBytes: 2,
+        creationTime: expect.any(String),
+      })
+      expect(spyPublish).toHaveBeenCalledWith('shotDeleted', { name: 'a.jpg' })
+    })
+  })
+
+  describe(ShotIndex.prototype.removeShots.name, () => {
+    it('drops the shots from the index', async () => {
+      await writeFile(TEST_FOLDER_PATH + '/a.jpg', 'a')
+      await shotIndex.getShotsOldestFirst()
+      shotIndex.removeShots(TEST_FOLDER_PATH, ['a.jpg'])
+      expect(await shotIndex.getShotsOldestFirst()).toEqual([])
+    })
+  })
+
+  afterEach(async () => {
+    shotIndex.onModuleDestroy()
+    await rm(TEST_FOLDER_PATH, { recursive: true, force: true })
+  })
+})
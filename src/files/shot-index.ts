@@ -0,0 +1,253 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { FSWatcher, watch } from 'fs'
+import { lstat, readdir } from 'fs/promises'
+import path from 'path'
+import {
+  Injectable,
+  Logger,
+  OnModuleDestroy,
+  OnModuleInit,
+  Optional,
+} from '@nestjs/common'
+import { Subject, Subscription } from 'rxjs'
+import { MetricsRegistry } from '../metrics/metrics-registry'
+import { MotionClientService } from '../motion-client.service'
+import { NotificationsService } from '../notifications/notifications.service'
+import FolderCleaner from '../shared/folder-cleaner'
+import { ParallelRunner } from '../shared/parallel-runner'
+import { IndexedShot } from './entities/indexed-shot.entity'
+
+const PENDING_CHANGES_DELAY_MILLISECONDS = 500
+
+export type ShotIndexChange =
+  | { type: 'created' | 'updated'; shot: IndexedShot }
+  | { type: 'deleted'; name: string }
+  | { type: 'rebuilt' }
+const SCAN_CONCURRENCY = 16
+
+/**
+ * Keeps the shots of Motion's target folder ordered by creation time. The
+ * folder is scanned once and then followed through file system events, so
+ * that consumers never need to list the card again.
+ */
+@Injectable()
+export class ShotIndex implements OnModuleInit, OnModuleDestroy {
+  // Emits every change, so that derived indexes can follow incrementally.
+  readonly changes$ = new Subject<ShotIndexChange>()
+  private readonly logger = new Logger(ShotIndex.name)
+  private folderPath: string
+  private shots = new Map<string, IndexedShot>()
+  private sortedShots: IndexedShot[] | null = null
+  private isStale = true
+  private rebuildPromise: Promise<void> | null = null
+  private watcher: FSWatcher | null = null
+  private readonly pendingFilenames = new Set<string>()
+  private pendingChangesTimeout: NodeJS.Timeout | null = null
+  private subscription: Subscription | null = null
+
+  constructor(
+    private readonly motionClientService: MotionClientService,
+    @Optional() private readonly notificationsService?: NotificationsService,
+  ) {}
+
+  async getShotsOldestFirst(): Promise<IndexedShot[]> {
+    await this.ensureUpToDate()
+    if (!this.sortedShots) {
+      this.sortedShots = [...this.shots.values()].sort(
+        (a, b) => a.creationTime.getTime() - b.creationTime.getTime(),
+      )
+    }
+    return [...this.sortedShots]
+  }
+
+  removeShots(folderPath: string, filenames: string[]): void {
+    if (folderPath !== this.folderPath) {
+      return
+    }
+    for (const filename of filenames) {
+      if (this.shots.delete(filename)) {
+        this.notificationsService?.publish('shotDeleted', { name: filename })
+        this.changes$.next({ type: 'deleted', name: filename })
+      }
+    }
+    this.sortedShots = null
+  }
+
+  onModuleInit() {
+    // Shot notifications are only sent while the folder is being followed.
+    this.subscription =
+      this.notificationsService?.subscribed$.subscribe(() => {
+        this.ensureUpToDate().catch((error) => {
+          this.logger.warn(`Following shots failed: ${error.message}`)
+        })
+      }) ?? null
+  }
+
+  onModuleDestroy() {
+    this.subscription?.unsubscribe()
+    this.stopWatching()
+  }
+
+  /**
+   * Applies the changes seen since the last call, or scans the folder again
+   * if it cannot be followed.
+   */
+  async ensureUpToDate(): Promise<void> {
+    const folderPath = await this.motionClientService.getTargetDir()
+    if (this.rebuildPromise) {
+      await this.rebuildPromise
+    }
+    if (folderPath !== this.folderPath || this.isStale) {
+      this.rebuildPromise = this.rebuild(folderPath).finally(() => {
+        this.rebuildPromise = null
+      })
+      await this.rebuildPromise
+    } else if (this.pendingFilenames.size > 0) {
+      await this.applyPendingChanges()
+    }
+  }
+
+  private async rebuild(folderPath: string): Promise<void> {
+    this.logger.log(`Building shot index of ${folderPath}...`)
+    this.stopWatching()
+    this.folderPath = folderPath
+    this.isStale = false
+    this.pendingFilenames.clear()
+    // Watch before scanning so that no shot written meanwhile gets lost.
+    this.startWatching()
+    const shots = await MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'indexShots'],
+      async () => {
+        const entries = await readdir(folderPath, { withFileTypes: true })
+        const filenames = entries
+          .filter(
+            (entry) =>
+              entry.isFile() && !FolderCleaner.isUnixHiddenPath(entry.name),
+          )
+          .map((entry) => entry.name)
+        return ParallelRunner.run(filenames, SCAN_CONCURRENCY, (filename) =>
+          this.readShot(filename),
+        )
+      },
+    )
+    this.shots = new Map(
+      shots.filter((shot) => shot).map((shot) => [shot.name, shot]),
+    )
+    this.sortedShots = null
+    this.logger.log(`Shot index contains ${this.shots.size} shots`)
+    this.changes$.next({ type: 'rebuilt' })
+  }
+
+  private async readShot(filename: string): Promise<IndexedShot | null> {
+    try {
+      const stats = await lstat(path.join(this.folderPath, filename))
+      if (!stats.isFile()) {
+        return null
+      }
+      return {
+        name: filename,
+        creationTime: stats.mtime,
+        sizeBytes: stats.size,
+      }
+    } catch (error) {
+      if (error.code === 'ENOENT') {
+        return null
+      }
+      throw error
+    }
+  }
+
+  private startWatching(): void {
+    try {
+      this.watcher = watch(this.folderPath, (_eventType, filename) => {
+        if (!filename) {
+          this.isStale = true
+          return
+        }
+        // Hidden files, e.g. the checksum index, are no shots.
+        if (FolderCleaner.isUnixHiddenPath(filename.toString())) {
+          return
+        }
+        this.pendingFilenames.add(filename.toString())
+        this.schedulePendingChanges()
+      })
+    } catch (error) {
+      this.logger.warn(`Cannot watch ${this.folderPath}: ${error.message}`)
+      this.isStale = true
+      return
+    }
+    this.watcher.on('error', (error) => {
+      this.logger.warn(`Watching ${this.folderPath} failed: ${error.message}`)
+      this.isStale = true
+      this.stopWatching()
+    })
+    this.watcher.unref()
+  }
+
+  private stopWatching(): void {
+    this.watcher?.close()
+    this.watcher = null
+    if (this.pendingChangesTimeout) {
+      clearTimeout(this.pendingChangesTimeout)
+      this.pendingChangesTimeout = null
+    }
+  }
+
+  private schedulePendingChanges(): void {
+    if (this.pendingChangesTimeout) {
+      return
+    }
+    this.pendingChangesTimeout = setTimeout(() => {
+      this.pendingChangesTimeout = null
+      // Changes seen during a rebuild are applied on top of its result.
+      const rebuilt = this.rebuildPromise ?? Promise.resolve()
+      rebuilt
+        .then(() => this.applyPendingChanges())
+        .catch((error) => {
+          this.logger.warn(`Updating shot index failed: ${error.message}`)
+          this.isStale = true
+        })
+    }, PENDING_CHANGES_DELAY_MILLISECONDS)
+    this.pendingChangesTimeout.unref()
+  }
+
+  private async applyPendingChanges(): Promise<void> {
+    const filenames = [...this.pendingFilenames]
+    this.pendingFilenames.clear()
+    for (const filename of filenames) {
+      const shot = await this.readShot(filename)
+      if (shot) {
+        const isNew = !this.shots.has(filename)
+        this.shots.set(filename, shot)
+        if (isNew) {
+          this.notificationsService?.publish('shotCreated', {
+            name: shot.name,
+            sizeBytes: shot.sizeBytes,
+            creationTime: shot.creationTime.toISOString(),
+          })
+        }
+        this.changes$.next({ type: isNew ? 'created' : 'updated', shot })
+      } else if (this.shots.delete(filename)) {
+        this.notificationsService?.publish('shotDeleted', { name: filename })
+        this.changes$.next({ type: 'deleted', name: filename })
+      }
+    }
+    this.sortedShots = null
+  }
+}
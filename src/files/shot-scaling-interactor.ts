@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { spawn } from 'child_process'
+import { open } from 'fs/promises'
+import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
+import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
+import { ShotVariant } from './entities/shot-variant.entity'
+
+const SCALE_SHOT_PATH = 'scripts/runtime/shot-scaling/scale_shot'
+
+const MAXIMUM_ERROR_MESSAGE_LENGTH = 4096
+
+export class ShotScalingInteractor {
+  /**
+   * Lets the native scaler write straight into the output file, so that the
+   * picture is never held in memory as a whole.
+   */
+  static async scale(
+    inputPath: string,
+    variant: ShotVariant,
+    outputPath: string,
+  ): Promise<void> {
+    CommandUnavailableOnWindowsException.throwIfOnWindows()
+    const output = await open(outputPath, 'w')
+    try {
+      const child = spawn(
+        SCALE_SHOT_PATH,
+        [inputPath, variant.longEdge.toString(), variant.quality.toString()],
+        { stdio: ['ignore', output.fd, 'pipe'] },
+      )
+      let stderr = ''
+      child.stderr.setEncoding('utf8')
+      child.stderr.on('data', (chunk: string) => {
+        if (stderr.length < MAXIMUM_ERROR_MESSAGE_LENGTH) {
+          stderr += chunk
+        }
+      })
+      const exitCode = await new Promise<number>((resolve, reject) => {
+        child.once('error', reject)
+        child.once('close', resolve)
+      })
+      if (exitCode !== 0) {
+        throw new CommandExecutionException(stderr || `exit code ${exitCode}`)
+      }
+    } finally {
+      await output.close()
+    }
+  }
+}
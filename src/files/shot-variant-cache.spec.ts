@@ -0,0 +1,154 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { existsSync } from 'fs'
+import { mkdir, readFile, rm, utimes, writeFile } from 'fs/promises'
+import path from 'path'
+import { vi } from 'vitest'
+import { InvalidFilenameException } from './exception/InvalidFilenameException'
+import { ShotScalingInteractor } from './shot-scaling-interactor'
+import { ShotVariantCache } from './shot-variant-cache'
+
+describe(ShotVariantCache.name, () => {
+  const TEST_FOLDER = 'src/files/test-shot-variant-cache'
+  const SHOT_FOLDER = path.join(TEST_FOLDER, 'shots')
+  const VARIANT_FOLDER = path.join(TEST_FOLDER, 'variants')
+  const VARIANT = { longEdge: 1280, quality: 75 }
+  const VARIANT_PATH = path.join(VARIANT_FOLDER, '1280-q75', 'a.jpg')
+
+  let cache: ShotVariantCache
+  let spyScale
+
+  beforeEach(async () => {
+    await mkdir(SHOT_FOLDER, { recursive: true })
+    await writeFile(path.join(SHOT_FOLDER, 'a.jpg'), 'original')
+    cache = new ShotVariantCache(VARIANT_FOLDER)
+    spyScale = vi
+      .spyOn(ShotScalingInteractor, 'scale')
+      .mockImplementation(async (_inputPath, variant, outputPath) => {
+        await writeFile(outputPath, `scaled to ${variant.longEdge}`)
+      })
+  })
+
+  it('creates a variant only with a long edge', () => {
+    expect(ShotVariantCache.createVariant(640)).toEqual({
+      longEdge: 640,
+      quality: 75,
+    })
+    expect(ShotVariantCache.createVariant(640, 50)).toEqual({
+      longEdge: 640,
+      quality: 50,
+    })
+    expect(ShotVariantCache.createVariant(undefined, 50)).toBeUndefined()
+  })
+
+  it('recognises pictures as scalable', () => {
+    expect(ShotVariantCache.isScalable('a.jpg')).toBe(true)
+    expect(ShotVariantCache.isScalable('a.mp4')).toBe(false)
+  })
+
+  it('creates the variant once and serves it from the cache afterwards', async () => {
+    const variantPath = await cache.getVariantPath(
+      SHOT_FOLDER,
+      'a.jpg',
+      VARIANT,
+    )
+    await cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT)
+    expect(variantPath).toBe(VARIANT_PATH)
+    expect(await readFile(variantPath, 'utf8')).toBe('scaled to 1280')
+    expect(spyScale).toHaveBeenCalledTimes(1)
+  })
+
+  it('creates a variant requested concurrently only once', async () => {
+    await Promise.all([
+      cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT),
+      cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT),
+    ])
+    expect(spyScale).toHaveBeenCalledTimes(1)
+  })
+
+  it('recreates the variant once the shot is newer', async () => {
+    await cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT)
+    const past = new Date(Date.now() - 60000)
+    await utimes(VARIANT_PATH, past, past)
+    await cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT)
+    expect(spyScale).toHaveBeenCalledTimes(2)
+  })
+
+  it('removes the partial variant if scaling fails', async () => {
+    spyScale.mockRejectedValueOnce(new Error('Not a JPEG file'))
+    await expect(
+      cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT),
+    ).rejects.toThrow('Not a JPEG file')
+    expect(existsSync(VARIANT_PATH)).toBe(false)
+    expect(existsSync(VARIANT_PATH + '.part')).toBe(false)
+  })
+
+  it('fails for a missing shot without scaling', async () => {
+    await expect(
+      cache.getVariantPath(SHOT_FOLDER, 'b.jpg', VARIANT),
+    ).rejects.toHaveProperty('code', 'ENOENT')
+    expect(spyScale).not.toHaveBeenCalled()
+  })
+
+  it('rejects names with a path', async () => {
+    for (const name of ['../a.jpg', 'shots/a.jpg', '..']) {
+      await expect(
+        cache.getVariantPath(TEST_FOLDER, name, VARIANT),
+      ).rejects.toThrow(InvalidFilenameException)
+      await expect(cache.removeVariants([name])).rejects.toThrow(
+        InvalidFilenameException,
+      )
+    }
+    expect(spyScale).not.toHaveBeenCalled()
+  })
+
+  it('removes the variants of all sizes', async () => {
+    await cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT)
+    await cache.getVariantPath(SHOT_FOLDER, 'a.jpg', {
+      longEdge: 640,
+      quality: 60,
+    })
+    await cache.removeVariants(['a.jpg', 'b.jpg'])
+    expect(existsSync(VARIANT_PATH)).toBe(false)
+    expect(existsSync(path.join(VARIANT_FOLDER, '640-q60', 'a.jpg'))).toBe(
+      false,
+    )
+  })
+
+  it('removes variants that outlived their time to live', async () => {
+    await writeFile(path.join(SHOT_FOLDER, 'b.jpg'), 'original')
+    await cache.getVariantPath(SHOT_FOLDER, 'a.jpg', VARIANT)
+    await cache.getVariantPath(SHOT_FOLDER, 'b.jpg', VARIANT)
+    const past = new Date(Date.now() - 60000)
+    await utimes(VARIANT_PATH, past, past)
+    await cache.removeOldVariants(30000)
+    expect(existsSync(VARIANT_PATH)).toBe(false)
+    expect(existsSync(path.join(VARIANT_FOLDER, '1280-q75', 'b.jpg'))).toBe(
+      true,
+    )
+  })
+
+  it('tolerates a missing cache folder', async () => {
+    await expect(cache.removeOldVariants(0)).resolves.toBeUndefined()
+    await expect(cache.removeVariants(['a.jpg'])).resolves.toBeUndefined()
+  })
+
+  afterEach(async () => {
+    spyScale.mockRestore()
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
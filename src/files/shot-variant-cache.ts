@@ -0,0 +1,164 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, readdir, rename, rm, stat } from 'fs/promises'
+import path from 'path'
+import { ShotVariant } from './entities/shot-variant.entity'
+import { InvalidFilenameException } from './exception/InvalidFilenameException'
+import { ShotScalingInteractor } from './shot-scaling-interactor'
+
+const DEFAULT_QUALITY = 75
+const PARTIAL_FILE_SUFFIX = '.part'
+const SCALABLE_FILE_EXTENSION = '.jpg'
+
+/**
+ * Downscaled copies of pictures, kept in one folder per long edge and quality
+ * so that repeated downloads of the same shots do not scale them again.
+ */
+export class ShotVariantCache {
+  private readonly pendingVariants = new Map<string, Promise<string>>()
+
+  constructor(private readonly folderPath: string) {}
+
+  /**
+   * Returns no variant without a long edge, so that the shots are delivered
+   * as they are.
+   */
+  static createVariant(
+    longEdge?: number,
+    quality = DEFAULT_QUALITY,
+  ): ShotVariant | undefined {
+    return longEdge ? { longEdge, quality } : undefined
+  }
+
+  static isScalable(filename: string): boolean {
+    return filename.endsWith(SCALABLE_FILE_EXTENSION)
+  }
+
+  static getVariantFolderName(variant: ShotVariant): string {
+    return `${variant.longEdge}-q${variant.quality}`
+  }
+
+  /**
+   * Returns the path of the variant, which is created first if it does not
+   * exist yet or is older than the shot. Concurrent requests for the same
+   * variant wait for the same creation.
+   */
+  async getVariantPath(
+    shotFolderPath: string,
+    filename: string,
+    variant: ShotVariant,
+  ): Promise<string> {
+    ShotVariantCache.throwIfNotFilename(filename)
+    const variantPath = path.join(
+      this.folderPath,
+      ShotVariantCache.getVariantFolderName(variant),
+      filename,
+    )
+    const pendingVariant = this.pendingVariants.get(variantPath)
+    if (pendingVariant) {
+      return pendingVariant
+    }
+    const creation = this.createVariantIfOutdated(
+      path.join(shotFolderPath, filename),
+      variant,
+      variantPath,
+    ).finally(() => this.pendingVariants.delete(variantPath))
+    this.pendingVariants.set(variantPath, creation)
+    return creation
+  }
+
+  async removeVariants(filenames: string[]): Promise<void> {
+    filenames.forEach(ShotVariantCache.throwIfNotFilename)
+    const variantFolderPaths = await this.findVariantFolderPaths()
+    await Promise.all(
+      variantFolderPaths.flatMap((variantFolderPath) =>
+        filenames.map((filename) =>
+          rm(path.join(variantFolderPath, filename), { force: true }),
+        ),
+      ),
+    )
+  }
+
+  async removeOldVariants(timeToLive: number): Promise<void> {
+    const expiryTime = Date.now() - timeToLive
+    for (const variantFolderPath of await this.findVariantFolderPaths()) {
+      const entries = await readdir(variantFolderPath, {
+        recursive: true,
+        withFileTypes: true,
+      })
+      for (const entry of entries.filter((entry) => entry.isFile())) {
+        const filePath = path.join(entry.parentPath, entry.name)
+        if ((await stat(filePath)).mtimeMs < expiryTime) {
+          await rm(filePath, { force: true })
+        }
+      }
+    }
+  }
+
+  /**
+   * Variants are kept in flat folders, so that a name with a path could
+   * create or remove files outside of the cache.
+   */
+  private static throwIfNotFilename(name: string): void {
+    if (name !== path.basename(name) || ['', '.', '..'].includes(name)) {
+      throw new InvalidFilenameException(`'${name}' is not a filename.`)
+    }
+  }
+
+  private async createVariantIfOutdated(
+    shotPath: string,
+    variant: ShotVariant,
+    variantPath: string,
+  ): Promise<string> {
+    const shotStats = await stat(shotPath)
+    try {
+      const variantStats = await stat(variantPath)
+      if (variantStats.mtimeMs >= shotStats.mtimeMs) {
+        return variantPath
+      }
+    } catch (error) {
+      if (error.code !== 'ENOENT') {
+        throw error
+      }
+    }
+    await mkdir(path.dirname(variantPath), { recursive: true })
+    // Readers never see a variant that is still being written.
+    const partialVariantPath = variantPath + PARTIAL_FILE_SUFFIX
+    try {
+      await ShotScalingInteractor.scale(shotPath, variant, partialVariantPath)
+      await rename(partialVariantPath, variantPath)
+    } catch (error) {
+      await rm(partialVariantPath, { force: true })
+      throw error
+    }
+    return variantPath
+  }
+
+  private async findVariantFolderPaths(): Promise<string[]> {
+    try {
+      const entries = await readdir(this.folderPath, { withFileTypes: true })
+      return entries
+        .filter((entry) => entry.isDirectory())
+        .map((entry) => path.join(this.folderPath, entry.name))
+    } catch (error) {
+      if (error.code === 'ENOENT') {
+        return []
+      }
+      throw error
+    }
+  }
+}
@@ -0,0 +1,100 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { appendFile, readFile, rename, rm, writeFile } from 'fs/promises'
+
+const TEMPORARY_FILE_SUFFIX = '.tmp'
+
+interface SidecarLine<T> {
+  name: string
+  // Null for a removed shot
+  value: T | null
+}
+
+export class SidecarFileProvider {
+  /**
+   * Later lines supersede earlier ones of the same shot.
+   */
+  static async readValues<T>(filePath: string): Promise<Map<string, T>> {
+    let data: string
+    try {
+      data = (await readFile(filePath)).toString()
+    } catch (err) {
+      if (err.code !== 'ENOENT') {
+        throw err
+      }
+      return new Map()
+    }
+    const values = new Map<string, T>()
+    for (const line of data.split('\n')) {
+      if (!line) {
+        continue
+      }
+      try {
+        const { name, value }: SidecarLine<T> = JSON.parse(line)
+        if (typeof name !== 'string' || value === undefined) {
+          continue
+        }
+        if (value === null) {
+          values.delete(name)
+        } else {
+          values.set(name, value)
+        }
+      } catch {
+        // A line cut off by a power loss only loses that value.
+      }
+    }
+    return values
+  }
+
+  static async appendValue<T>(
+    name: string,
+    value: T,
+    filePath: string,
+  ): Promise<void> {
+    await appendFile(filePath, this.formatLine(name, value))
+  }
+
+  static async appendRemovals(
+    names: string[],
+    filePath: string,
+  ): Promise<void> {
+    const lines = names.map((name) => this.formatLine(name, null))
+    await appendFile(filePath, lines.join(''))
+  }
+
+  static async writeValues<T>(
+    values: Map<string, T>,
+    filePath: string,
+  ): Promise<void> {
+    const lines = [...values].map(([name, value]) =>
+      this.formatLine(name, value),
+    )
+    const temporaryFilePath = filePath + TEMPORARY_FILE_SUFFIX
+    try {
+      await writeFile(temporaryFilePath, lines.join(''))
+      await rename(temporaryFilePath, filePath)
+    } catch (err) {
+      await rm(temporaryFilePath, { force: true })
+      throw err
+    }
+  }
+
+  private static formatLine<T>(name: string, value: T | null): string {
+    const line: SidecarLine<T> = { name, value }
+    return JSON.stringify(line) + '\n'
+  }
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, readFile, rm, writeFile } from 'fs/promises'
+import path from 'path'
+import { SidecarIndex } from './sidecar-index'
+
+describe(SidecarIndex.name, () => {
+  const TEST_FOLDER = 'src/files/test-sidecar-index'
+  const FILE_PATH = path.join(TEST_FOLDER, '.checksums')
+
+  let index: SidecarIndex<string>
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+    index = new SidecarIndex(FILE_PATH)
+  })
+
+  it('starts empty without a file', async () => {
+    const values = await index.getValues()
+    expect(values.size).toBe(0)
+  })
+
+  it('keeps the latest value of each shot across restarts', async () => {
+    await index.setValue('a.jpg', '0000000a')
+    await index.setValue('b.jpg', '0000000b')
+    await index.setValue('a.jpg', '000000aa')
+    const values = await new SidecarIndex(FILE_PATH).getValues()
+    expect([...values]).toEqual([
+      ['a.jpg', '000000aa'],
+      ['b.jpg', '0000000b'],
+    ])
+  })
+
+  it('writes one JSON object per line', async () => {
+    await index.setValue('a "b".jpg', 'e3069283')
+    expect(await readFile(FILE_PATH, 'utf8')).toBe(
+      '{"name":"a \\"b\\".jpg","value":"e3069283"}\n',
+    )
+  })
+
+  it('skips lines that cannot be parsed', async () => {
+    await writeFile(
+      FILE_PATH,
+      '{"name":"a.jpg","value":"e3069283"}\n{"name":"b.jpg"}\n{"name":"c.jp',
+    )
+    const values = await index.getValues()
+    expect([...values]).toEqual([['a.jpg', 'e3069283']])
+  })
+
+  it('remembers removals across restarts', async () => {
+    await index.setValue('a.jpg', '0000000a')
+    await index.setValue('b.jpg', '0000000b')
+    await index.removeValues(['a.jpg'])
+    const values = await new SidecarIndex(FILE_PATH).getValues()
+    expect([...values]).toEqual([['b.jpg', '0000000b']])
+  })
+
+  it('rewrites the file once most values were removed', async () => {
+    await index.setValue('a.jpg', '0000000a')
+    await index.setValue('b.jpg', '0000000b')
+    await index.setValue('c.jpg', '0000000c')
+    await index.removeValues(['a.jpg'])
+    expect(await readFile(FILE_PATH, 'utf8')).toContain(
+      '{"name":"a.jpg","value":null}',
+    )
+    await index.removeValues(['b.jpg', 'd.jpg'])
+    expect(await readFile(FILE_PATH, 'utf8')).toBe(
+      '{"name":"c.jpg","value":"0000000c"}\n',
+    )
+  })
+
+  afterEach(async () => {
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
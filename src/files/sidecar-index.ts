@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { SidecarFileProvider } from './sidecar-file-provider'
+
+/**
+ * Index of one value per shot, kept in a hidden JSON lines file next to the
+ * shots, so that it moves with the card. Values and removals are appended as
+ * they come in and the file is only rewritten once more values were removed
+ * than are left.
+ */
+export class SidecarIndex<T> {
+  private values: Promise<Map<string, T>> | null = null
+  private removedValueCount = 0
+  private pendingWrite = Promise.resolve()
+
+  constructor(readonly filePath: string) {}
+
+  async getValues(): Promise<Map<string, T>> {
+    if (!this.values) {
+      this.values = SidecarFileProvider.readValues<T>(this.filePath).catch(
+        (error) => {
+          this.values = null
+          throw error
+        },
+      )
+    }
+    return this.values
+  }
+
+  async setValue(name: string, value: T): Promise<void> {
+    const values = await this.getValues()
+    values.set(name, value)
+    await this.enqueueWrite(() =>
+      SidecarFileProvider.appendValue(name, value, this.filePath),
+    )
+  }
+
+  async removeValues(names: string[]): Promise<void> {
+    const values = await this.getValues()
+    const removedNames = names.filter((name) => values.delete(name))
+    if (removedNames.length === 0) {
+      return
+    }
+    this.removedValueCount += removedNames.length
+    if (this.removedValueCount > values.size) {
+      this.removedValueCount = 0
+      await this.enqueueWrite(() =>
+        SidecarFileProvider.writeValues(new Map(values), this.filePath),
+      )
+    } else {
+      await this.enqueueWrite(() =>
+        SidecarFileProvider.appendRemovals(removedNames, this.filePath),
+      )
+    }
+  }
+
+  private enqueueWrite(write: () => Promise<void>): Promise<void> {
+    const result = this.pendingWrite.then(write)
+    this.pendingWrite = result.catch(() => undefined)
+    return result
+  }
+}
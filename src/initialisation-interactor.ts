@@ -14,16 +14,13 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
 import { lstat, readdir } from 'fs/promises'
 import path from 'path'
-import { promisify } from 'util'
+import { PrivilegedHelperClient } from './privileged-helper/privileged-helper-client'
 import { LightType } from './settings/entities/settings'
 import { CommandExecutionException } from './shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from './shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
-
 const MEDIA_BASE_PATH = '/media'
 const RASPBERRY_PI_IGNORED_MEDIA_PATH = '/media/pi'
 
@@ -61,10 +58,11 @@ export class InitialisationInteractor {
     lightType: LightType,
   ): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const currentWorkingDirectory = process.cwd()
-    const { stderr } = await exec(
-      `sudo ${currentWorkingDirectory}/scripts/runtime/reset-lights.sh ${deviceType} ${lightType} ${isAlternatingLightModeEnabled}`,
-    )
+    const { stderr } = await PrivilegedHelperClient.run('reset-lights', [
+      deviceType,
+      lightType,
+      `${isAlternatingLightModeEnabled}`,
+    ])
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
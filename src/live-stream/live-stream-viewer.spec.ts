@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { PassThrough, Writable } from 'stream'
+import { LiveStreamViewer } from './live-stream-viewer'
+
+describe(LiveStreamViewer.name, () => {
+  const FRAME_1 = Buffer.from('1')
+  const FRAME_2 = Buffer.from('2')
+  const FRAME_3 = Buffer.from('3')
+
+  function getFrames(written: Buffer[]): string[] {
+    return written.map((part) => part.toString().split('\r\n')[4])
+  }
+
+  describe(LiveStreamViewer.prototype.offer.name, () => {
+    it('writes each frame as a multipart part', () => {
+      const response = new PassThrough()
+      const viewer = new LiveStreamViewer(response)
+      viewer.offer(FRAME_1)
+      expect(response.read().toString()).toBe(
+        '--frame\r\nContent-Type: image/jpeg\r\nContent-Length: 1\r\n\r\n1\r\n',
+      )
+    })
+
+    it('only keeps the latest frame while the client is congested', () => {
+      const written: Buffer[] = []
+      let finishWrite: () => void
+      const response = new Writable({
+        highWaterMark: 1,
+        write: (chunk, _encoding, callback) => {
+          written.push(chunk)
+          finishWrite = callback
+        },
+      })
+      const viewer = new LiveStreamViewer(response)
+      viewer.offer(FRAME_1)
+      viewer.offer(FRAME_2)
+      viewer.offer(FRAME_3)
+      expect(getFrames(written)).toEqual(['1'])
+      finishWrite()
+      expect(getFrames(written)).toEqual(['1', '3'])
+    })
+
+    it('skips frames arriving faster than the maximum rate', () => {
+      let nowMs = 0
+      const response = new PassThrough()
+      const viewer = new LiveStreamViewer(response, 100, () => nowMs)
+      viewer.offer(FRAME_1)
+      nowMs = 50
+      viewer.offer(FRAME_2)
+      nowMs = 100
+      viewer.offer(FRAME_3)
+      const text = response.read().toString()
+      expect(text).toContain('\r\n1\r\n')
+      expect(text).not.toContain('\r\n2\r\n')
+      expect(text).toContain('\r\n3\r\n')
+    })
+  })
+})
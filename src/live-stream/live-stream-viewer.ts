@@ -0,0 +1,75 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Writable } from 'stream'
+
+export const LIVE_STREAM_BOUNDARY = 'frame'
+
+/**
+ * One client of the live stream. At most one frame waits while the client's
+ * connection is congested, and newer frames replace it, so that slow clients
+ * skip frames instead of falling behind.
+ */
+export class LiveStreamViewer {
+  private pendingFrame: Buffer | null = null
+  private isWaitingForDrain = false
+  private lastSentAtMs = -Infinity
+
+  constructor(
+    private readonly response: Writable,
+    private readonly minimumFrameIntervalMs = 0,
+    private readonly getNowMs = () => performance.now(),
+  ) {}
+
+  offer(frame: Buffer): void {
+    if (this.getNowMs() - this.lastSentAtMs < this.minimumFrameIntervalMs) {
+      return
+    }
+    if (this.isWaitingForDrain) {
+      this.pendingFrame = frame
+      return
+    }
+    this.send(frame)
+  }
+
+  end(): void {
+    this.pendingFrame = null
+    this.response.end()
+  }
+
+  private send(frame: Buffer): void {
+    this.lastSentAtMs = this.getNowMs()
+    const header = Buffer.from(
+      `--${LIVE_STREAM_BOUNDARY}\r\n` +
+        'Content-Type: image/jpeg\r\n' +
+        `Content-Length: ${frame.length}\r\n\r\n`,
+    )
+    const isFlushed = this.response.write(
+      Buffer.concat([header, frame, Buffer.from('\r\n')]),
+    )
+    if (!isFlushed) {
+      this.isWaitingForDrain = true
+      this.response.once('drain', () => {
+        this.isWaitingForDrain = false
+        const pendingFrame = this.pendingFrame
+        this.pendingFrame = null
+        if (pendingFrame) {
+          this.send(pendingFrame)
+        }
+      })
+    }
+  }
+}
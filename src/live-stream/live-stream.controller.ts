@@ -0,0 +1,51 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Controller, Get, Query, Res } from '@nestjs/common'
+import { Response } from 'express'
+import { LiveStreamQueryDto } from './dto/live-stream-query.dto'
+import { LIVE_STREAM_BOUNDARY, LiveStreamViewer } from './live-stream-viewer'
+import { LiveStreamService, LiveStreamVariant } from './live-stream.service'
+
+const CONTENT_TYPE = `multipart/x-mixed-replace; boundary=${LIVE_STREAM_BOUNDARY}`
+
+@Controller('live-stream')
+export class LiveStreamController {
+  constructor(private readonly liveStreamService: LiveStreamService) {}
+
+  @Get()
+  getLiveStream(
+    @Res() response: Response,
+    @Query() query: LiveStreamQueryDto = {},
+  ): void {
+    response.set({
+      'Content-Type': CONTENT_TYPE,
+      'Cache-Control': 'no-cache, no-store',
+      Pragma: 'no-cache',
+    })
+    response.flushHeaders()
+    const minimumFrameIntervalMs = query.maxFps
+      ? 1000 / parseInt(query.maxFps)
+      : 0
+    const viewer = new LiveStreamViewer(response, minimumFrameIntervalMs)
+    const removeViewer = this.liveStreamService.addViewer(
+      (query.variant ?? 'full') as LiveStreamVariant,
+      viewer,
+    )
+    // Emitted once the client disconnects.
+    response.on('close', removeViewer)
+  }
+}
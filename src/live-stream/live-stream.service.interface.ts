@@ -0,0 +1,10 @@
+import { LiveStreamViewer } from './live-stream-viewer'
+import { LiveStreamVariant } from './live-stream.service'
+
+export interface ILiveStreamService {
+  addViewer: (
+    variant: LiveStreamVariant,
+    viewer: LiveStreamViewer,
+  ) => () => void
+  getViewerCount: (variant: LiveStreamVariant) => number
+}
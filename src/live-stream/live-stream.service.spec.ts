@@ -0,0 +1,103 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { PassThrough } from 'stream'
+import { Test, TestingModule } from '@nestjs/testing'
+import { http, HttpResponse } from 'msw'
+import { vi } from 'vitest'
+import { server } from '../../test/unit/motion-server-mocks/server'
+import { LiveStreamViewer } from './live-stream-viewer'
+import { LiveStreamService } from './live-stream.service'
+
+describe(LiveStreamService.name, () => {
+  const STREAM_URL = 'http://localhost:8081/'
+  const PART = Buffer.concat([
+    Buffer.from(
+      '--BoundaryString\r\nContent-type: image/jpeg\r\nContent-Length: 4\r\n\r\n',
+    ),
+    Buffer.from([0xff, 0xd8, 0xff, 0xd9]),
+    Buffer.from('\r\n'),
+  ])
+
+  // Establish API mocking before all tests.
+  beforeAll(() => server.listen())
+
+  let service: LiveStreamService
+  let upstreamRequestCount: number
+
+  beforeEach(async () => {
+    upstreamRequestCount = 0
+    server.use(
+      http.get(STREAM_URL, () => {
+        upstreamRequestCount++
+        // Like Motion, the stream stays open.
+        const body = new ReadableStream({
+          start(controller) {
+            controller.enqueue(new Uint8Array(PART))
+          },
+        })
+        return new HttpResponse(body, {
+          headers: {
+            'Content-Type':
+              'multipart/x-mixed-replace; boundary=BoundaryString',
+          },
+        })
+      }),
+    )
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [LiveStreamService],
+    }).compile()
+
+    service = module.get<LiveStreamService>(LiveStreamService)
+  })
+
+  describe(LiveStreamService.prototype.addViewer.name, () => {
+    it('shares one connection to Motion between viewers', async () => {
+      const first = new PassThrough()
+      const second = new PassThrough()
+      const removeFirst = service.addViewer('full', new LiveStreamViewer(first))
+      const removeSecond = service.addViewer(
+        'full',
+        new LiveStreamViewer(second),
+      )
+      await vi.waitFor(() => {
+        expect(first.readableLength).toBeGreaterThan(0)
+        expect(second.readableLength).toBeGreaterThan(0)
+      })
+      expect(upstreamRequestCount).toBe(1)
+      expect(service.getViewerCount('full')).toBe(2)
+      removeFirst()
+      removeSecond()
+      expect(service.getViewerCount('full')).toBe(0)
+    })
+
+    it('ends the viewers if Motion is unavailable', async () => {
+      server.use(http.get(STREAM_URL, () => HttpResponse.error()))
+      const response = new PassThrough()
+      service.addViewer('full', new LiveStreamViewer(response))
+      await vi.waitFor(() => expect(response.writableEnded).toBe(true))
+      expect(service.getViewerCount('full')).toBe(0)
+    })
+  })
+
+  afterEach(() => {
+    service.onModuleDestroy()
+    server.resetHandlers()
+  })
+
+  // Clean up after the tests are finished.
+  afterAll(() => server.close())
+})
@@ -0,0 +1,127 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { ClientRequest, get } from 'http'
+import { Injectable, Logger, OnModuleDestroy } from '@nestjs/common'
+import { LiveStreamViewer } from './live-stream-viewer'
+import { ILiveStreamService } from './live-stream.service.interface'
+import { MjpegFrameParser } from './mjpeg-frame-parser'
+
+const STREAM_BASE_URL = 'http://localhost:8081'
+
+export const LIVE_STREAM_VARIANTS = ['full', 'half'] as const
+
+export type LiveStreamVariant = (typeof LIVE_STREAM_VARIANTS)[number]
+
+// Motion serves a substream at half the resolution next to the stream.
+const VARIANT_PATHS: Record<LiveStreamVariant, string> = {
+  full: '/',
+  half: '/substream',
+}
+
+interface Upstream {
+  request: ClientRequest
+  viewers: Set<LiveStreamViewer>
+}
+
+/**
+ * Holds a single connection to Motion's stream per variant and fans its
+ * frames out to all viewers, since Motion encodes the stream once per
+ * connection. The connection is closed when the last viewer leaves.
+ */
+@Injectable()
+export class LiveStreamService implements ILiveStreamService, OnModuleDestroy {
+  private readonly logger = new Logger(LiveStreamService.name)
+  private readonly upstreams = new Map<LiveStreamVariant, Upstream>()
+
+  addViewer(variant: LiveStreamVariant, viewer: LiveStreamViewer): () => void {
+    let upstream = this.upstreams.get(variant)
+    if (!upstream) {
+      upstream = this.connect(variant)
+      this.upstreams.set(variant, upstream)
+    }
+    upstream.viewers.add(viewer)
+    const connectedUpstream = upstream
+    return () => this.removeViewer(variant, connectedUpstream, viewer)
+  }
+
+  getViewerCount(variant: LiveStreamVariant): number {
+    return this.upstreams.get(variant)?.viewers.size ?? 0
+  }
+
+  onModuleDestroy() {
+    for (const [variant, upstream] of this.upstreams) {
+      this.disconnect(variant, upstream, 'application shutting down')
+    }
+  }
+
+  private connect(variant: LiveStreamVariant): Upstream {
+    this.logger.log(`Connecting to the ${variant} stream of Motion...`)
+    const parser = new MjpegFrameParser()
+    const upstream: Upstream = { request: null, viewers: new Set() }
+    upstream.request = get(STREAM_BASE_URL + VARIANT_PATHS[variant], (res) => {
+      if (res.statusCode !== 200) {
+        res.resume()
+        this.disconnect(variant, upstream, `status code ${res.statusCode}`)
+        return
+      }
+      res.on('data', (chunk: Buffer) => {
+        for (const frame of parser.push(chunk)) {
+          for (const viewer of upstream.viewers) {
+            viewer.offer(frame)
+          }
+        }
+      })
+      res.on('end', () => this.disconnect(variant, upstream, 'stream ended'))
+    })
+    upstream.request.on('error', (error) =>
+      this.disconnect(variant, upstream, error.message),
+    )
+    return upstream
+  }
+
+  private removeViewer(
+    variant: LiveStreamVariant,
+    upstream: Upstream,
+    viewer: LiveStreamViewer,
+  ): void {
+    upstream.viewers.delete(viewer)
+    if (upstream.viewers.size > 0 || this.upstreams.get(variant) !== upstream) {
+      return
+    }
+    this.logger.log(`Last viewer left, closing the ${variant} stream.`)
+    this.upstreams.delete(variant)
+    upstream.request.destroy()
+  }
+
+  // Ends all viewers so that their clients reconnect.
+  private disconnect(
+    variant: LiveStreamVariant,
+    upstream: Upstream,
+    reason: string,
+  ): void {
+    if (this.upstreams.get(variant) !== upstream) {
+      return
+    }
+    this.logger.warn(`The ${variant} stream stopped: ${reason}`)
+    this.upstreams.delete(variant)
+    upstream.request.destroy()
+    for (const viewer of upstream.viewers) {
+      viewer.end()
+    }
+    upstream.viewers.clear()
+  }
+}
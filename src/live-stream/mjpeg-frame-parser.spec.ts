@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MjpegFrameParser } from './mjpeg-frame-parser'
+
+describe(MjpegFrameParser.name, () => {
+  const JPEG = Buffer.from([0xff, 0xd8, 0x01, 0xff, 0xd9])
+
+  function createPart(frame: Buffer, withContentLength = true): Buffer {
+    const contentLength = withContentLength
+      ? `Content-Length: ${frame.length}\r\n`
+      : ''
+    return Buffer.concat([
+      Buffer.from(
+        `--BoundaryString\r\nContent-type: image/jpeg\r\n${contentLength}\r\n`,
+      ),
+      frame,
+      Buffer.from('\r\n'),
+    ])
+  }
+
+  describe(MjpegFrameParser.prototype.push.name, () => {
+    it('returns every complete frame', () => {
+      const parser = new MjpegFrameParser()
+      const frames = parser.push(
+        Buffer.concat([createPart(JPEG), createPart(JPEG)]),
+      )
+      expect(frames).toEqual([JPEG, JPEG])
+    })
+
+    it('joins frames split across chunks', () => {
+      const parser = new MjpegFrameParser()
+      const part = createPart(JPEG)
+      expect(parser.push(part.subarray(0, 50))).toEqual([])
+      expect(parser.push(part.subarray(50, 70))).toEqual([])
+      expect(parser.push(part.subarray(70))).toEqual([JPEG])
+    })
+
+    it('finds the end of the image without a content length', () => {
+      const parser = new MjpegFrameParser()
+      expect(parser.push(createPart(JPEG, false))).toEqual([JPEG])
+    })
+  })
+})
@@ -0,0 +1,64 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+const HEADER_END = Buffer.from('\r\n\r\n')
+const JPEG_END = Buffer.from([0xff, 0xd9])
+const CONTENT_LENGTH_PATTERN = /content-length:\s*(\d+)/i
+// Far above a 1080p JPEG, so only a broken stream gets here.
+const MAXIMUM_BUFFERED_BYTES = 8 * 1024 * 1024
+
+/**
+ * Splits a multipart MJPEG body into JPEG frames. Motion sends a
+ * Content-Length header with each part; without one, the frame ends at the
+ * JPEG end-of-image marker.
+ */
+export class MjpegFrameParser {
+  private buffer = Buffer.alloc(0)
+
+  push(chunk: Buffer): Buffer[] {
+    this.buffer =
+      this.buffer.length > 0 ? Buffer.concat([this.buffer, chunk]) : chunk
+    const frames: Buffer[] = []
+    for (;;) {
+      const headerEnd = this.buffer.indexOf(HEADER_END)
+      if (headerEnd < 0) {
+        break
+      }
+      const header = this.buffer.subarray(0, headerEnd).toString('latin1')
+      const bodyStart = headerEnd + HEADER_END.length
+      const match = CONTENT_LENGTH_PATTERN.exec(header)
+      let bodyEnd: number
+      if (match) {
+        bodyEnd = bodyStart + parseInt(match[1])
+        if (this.buffer.length < bodyEnd) {
+          break
+        }
+      } else {
+        const jpegEnd = this.buffer.indexOf(JPEG_END, bodyStart)
+        if (jpegEnd < 0) {
+          break
+        }
+        bodyEnd = jpegEnd + JPEG_END.length
+      }
+      frames.push(this.buffer.subarray(bodyStart, bodyEnd))
+      this.buffer = this.buffer.subarray(bodyEnd)
+    }
+    if (this.buffer.length > MAXIMUM_BUFFERED_BYTES) {
+      this.buffer = Buffer.alloc(0)
+    }
+    return frames
+  }
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  IsBooleanString,
+  IsIn,
+  IsOptional,
+  Matches,
+  MaxLength,
+} from 'class-validator'
+
+// Absolute ("2024-05-01 12:00:00") or relative ("2 days ago", "-1h") times.
+const JOURNAL_TIME_PATTERN = /^[\w :+.-]{1,40}$/
+
+export const JOURNAL_PRIORITIES = [
+  'emerg',
+  'alert',
+  'crit',
+  'err',
+  'warning',
+  'notice',
+  'info',
+  'debug',
+]
+
+export class LogExportQueryDto {
+  @IsOptional()
+  @Matches(JOURNAL_TIME_PATTERN)
+  since?: string
+
+  @IsOptional()
+  @Matches(JOURNAL_TIME_PATTERN)
+  until?: string
+
+  @IsOptional()
+  @IsIn(JOURNAL_PRIORITIES)
+  priority?: string
+
+  @IsOptional()
+  @MaxLength(200)
+  grep?: string
+
+  @IsOptional()
+  @Matches(/^[1-9]\d{0,5}$/)
+  lines?: string
+
+  @IsOptional()
+  @IsBooleanString()
+  gzip?: string
+}
@@ -0,0 +1,46 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { LogFileInteractor } from './log-file-interactor'
+
+describe(LogFileInteractor.name, () => {
+  describe(LogFileInteractor.buildFilterArguments.name, () => {
+    it('only disables the pager without filter', () => {
+      expect(LogFileInteractor.buildFilterArguments({})).toEqual([
+        '--no-pager',
+      ])
+    })
+
+    it('attaches all values to their options', () => {
+      expect(
+        LogFileInteractor.buildFilterArguments({
+          grep: '-error',
+          lines: 5,
+          priority: 'warning',
+          since: '2 days ago',
+          until: '2024-05-01 12:00:00',
+        }),
+      ).toEqual([
+        '--no-pager',
+        '--since=2 days ago',
+        '--until=2024-05-01 12:00:00',
+        '--priority=warning',
+        '--grep=-error',
+        '--lines=5',
+      ])
+    })
+  })
+})
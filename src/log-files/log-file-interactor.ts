@@ -14,38 +14,106 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { spawn } from 'child_process'
+import { once } from 'events'
+import { Readable } from 'stream'
 import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
-
-const exec = promisify(execSync)
+import { JournalFilter } from './entities/journal-filter.entity'
 
 const MOTION_SERVICE_NAME = 'motion'
 
-const SINCE_LOGGING_TIME = '2 weeks ago'
+const MAXIMUM_ERROR_MESSAGE_LENGTH = 4096
 
 export class LogFileInteractor {
-  static async writeAppLogFileToDisk(
+  static async getAppLogStream(
     serviceName: string,
-    logFilePath: string,
-  ): Promise<void> {
-    CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(
-      `journalctl --user -u ${serviceName} -S "${SINCE_LOGGING_TIME}" > ${logFilePath}`,
-    )
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
+    filter: JournalFilter,
+  ): Promise<Readable> {
+    return this.streamJournal('journalctl', [
+      '--user',
+      '-u',
+      serviceName,
+      ...this.buildFilterArguments(filter),
+    ])
+  }
+
+  static async getMotionLogStream(filter: JournalFilter): Promise<Readable> {
+    return this.streamJournal('sudo', [
+      'journalctl',
+      '-u',
+      MOTION_SERVICE_NAME,
+      ...this.buildFilterArguments(filter),
+    ])
+  }
+
+  static buildFilterArguments(filter: JournalFilter): string[] {
+    // Values are attached with "=", so they can never be read as options.
+    const args = ['--no-pager']
+    if (filter.since) {
+      args.push(`--since=${filter.since}`)
+    }
+    if (filter.until) {
+      args.push(`--until=${filter.until}`)
     }
+    if (filter.priority) {
+      args.push(`--priority=${filter.priority}`)
+    }
+    if (filter.grep) {
+      args.push(`--grep=${filter.grep}`)
+    }
+    if (filter.lines) {
+      args.push(`--lines=${filter.lines}`)
+    }
+    return args
   }
 
-  static async writeMotionLogFileToDisk(logFilePath: string): Promise<void> {
+  /**
+   * Resolves as soon as the command produced its first output, so that
+   * failures before that can still be reported as errors.
+   */
+  private static async streamJournal(
+    command: string,
+    args: string[],
+  ): Promise<Readable> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(
-      `sudo journalctl -u ${MOTION_SERVICE_NAME} -S "${SINCE_LOGGING_TIME}" > ${logFilePath}`,
-    )
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
+    const child = spawn(command, args, { stdio: ['ignore', 'pipe', 'pipe'] })
+    let stderr = ''
+    child.stderr.setEncoding('utf8')
+    child.stderr.on('data', (chunk: string) => {
+      if (stderr.length < MAXIMUM_ERROR_MESSAGE_LENGTH) {
+        stderr += chunk
+      }
+    })
+    const exit = new Promise<number>((resolve, reject) => {
+      child.once('error', reject)
+      child.once('close', resolve)
+    })
+    const assertSuccessfulExit = async () => {
+      const exitCode = await exit
+      if (exitCode !== 0) {
+        throw new CommandExecutionException(stderr || `exit code ${exitCode}`)
+      }
+    }
+
+    await Promise.race([once(child.stdout, 'readable'), exit])
+    const firstChunk: Buffer | null = child.stdout.read()
+    if (firstChunk === null) {
+      await assertSuccessfulExit()
+      return Readable.from([])
+    }
+
+    async function* generateOutput() {
+      try {
+        yield firstChunk
+        yield* child.stdout
+        await assertSuccessfulExit()
+      } finally {
+        if (child.exitCode === null) {
+          child.kill()
+        }
+      }
     }
+    return Readable.from(generateOutput())
   }
 }
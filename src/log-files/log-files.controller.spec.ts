@@ -69,5 +69,19 @@ describe(LogFilesController.name, () => {
       expect(service.getMotionLogFileStream).toHaveBeenCalled()
       expect(mockResponse.set).toHaveBeenCalled()
     })
+
+    it('names the file after its compression', async () => {
+      const mockResponse = {
+        set: vi.fn(),
+      }
+      await controller.downloadMotionLogFile(mockResponse, { gzip: 'true' })
+      expect(service.getMotionLogFileStream).toHaveBeenCalledWith({
+        gzip: 'true',
+      })
+      expect(mockResponse.set).toHaveBeenCalledWith({
+        'Content-Type': 'application/gzip',
+        'Content-Disposition': 'attachment; filename="motion.log.gz"',
+      })
+    })
   })
 })
@@ -14,10 +14,13 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { Controller, Get, Res, StreamableFile } from '@nestjs/common'
+import { Controller, Get, Query, Res, StreamableFile } from '@nestjs/common'
+import { LogExportQueryDto } from './dto/log-export-query.dto'
 import { LogFilesService } from './log-files.service'
 
 const APP_LOG_FILENAME = 'app.log'
+const GZIP_CONTENT_TYPE = 'application/gzip'
+const GZIP_FILE_EXTENSION = '.gz'
 const LOG_FILE_CONTENT_TYPE = 'text/plain'
 const MOTION_LOG_FILENAME = 'motion.log'
 
@@ -26,22 +29,35 @@ export class LogFilesController {
   constructor(private readonly logFilesService: LogFilesService) {}
 
   @Get('app')
-  async downloadAppLogFile(@Res({ passthrough: true }) res) {
-    const stream = await this.logFilesService.getAppLogFileStream()
-    res.set({
-      'Content-Type': LOG_FILE_CONTENT_TYPE,
-      'Content-Disposition': `attachment; filename="${APP_LOG_FILENAME}"`,
-    })
+  async downloadAppLogFile(
+    @Res({ passthrough: true }) res,
+    @Query() query: LogExportQueryDto = {},
+  ) {
+    const stream = await this.logFilesService.getAppLogFileStream(query)
+    res.set(this.getResponseHeaders(APP_LOG_FILENAME, query))
     return new StreamableFile(stream)
   }
 
   @Get('motion')
-  async downloadMotionLogFile(@Res({ passthrough: true }) res) {
-    const stream = await this.logFilesService.getMotionLogFileStream()
-    res.set({
-      'Content-Type': LOG_FILE_CONTENT_TYPE,
-      'Content-Disposition': `attachment; filename="${MOTION_LOG_FILENAME}"`,
-    })
+  async downloadMotionLogFile(
+    @Res({ passthrough: true }) res,
+    @Query() query: LogExportQueryDto = {},
+  ) {
+    const stream = await this.logFilesService.getMotionLogFileStream(query)
+    res.set(this.getResponseHeaders(MOTION_LOG_FILENAME, query))
     return new StreamableFile(stream)
   }
+
+  private getResponseHeaders(filename: string, query: LogExportQueryDto) {
+    if (query.gzip === 'true') {
+      return {
+        'Content-Type': GZIP_CONTENT_TYPE,
+        'Content-Disposition': `attachment; filename="${filename}${GZIP_FILE_EXTENSION}"`,
+      }
+    }
+    return {
+      'Content-Type': LOG_FILE_CONTENT_TYPE,
+      'Content-Disposition': `attachment; filename="${filename}"`,
+    }
+  }
 }
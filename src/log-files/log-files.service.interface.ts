@@ -1,7 +1,7 @@
 import { Readable } from 'stream'
+import { LogExportQueryDto } from './dto/log-export-query.dto'
 
 export interface ILogFilesService {
-  getAppLogFileStream: () => Promise<Readable>
-  getMotionLogFileStream: () => Promise<Readable>
-  removeOldLogs: () => Promise<void>
+  getAppLogFileStream: (query?: LogExportQueryDto) => Promise<Readable>
+  getMotionLogFileStream: (query?: LogExportQueryDto) => Promise<Readable>
 }
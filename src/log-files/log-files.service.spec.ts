@@ -14,85 +14,107 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { rm, writeFile } from 'fs/promises'
+import { Readable } from 'stream'
+import { gunzipSync } from 'zlib'
 import { ConfigService } from '@nestjs/config'
 import { Test, TestingModule } from '@nestjs/testing'
 import { Mock, vi } from 'vitest'
 import { LogFileInteractor } from './log-file-interactor'
 import { LogFilesService } from './log-files.service'
 
-const APP_LOG_FILE_PATH = 'temp/logs/app.log'
-const MOTION_LOG_FILE_PATH = 'temp/logs/motion.log'
+async function readAll(stream: Readable): Promise<Buffer> {
+  const chunks: Buffer[] = []
+  for await (const chunk of stream) {
+    chunks.push(Buffer.from(chunk))
+  }
+  return Buffer.concat(chunks)
+}
 
 describe(LogFilesService.name, () => {
   let service: LogFilesService
 
-  it('should be defined', async () => {
+  beforeEach(async () => {
     const module: TestingModule = await Test.createTestingModule({
       providers: [ConfigService, LogFilesService],
     }).compile()
 
     service = module.get<LogFilesService>(LogFilesService)
+  })
+
+  it('should be defined', () => {
     expect(service).toBeDefined()
   })
 
   describe(LogFilesService.prototype.getAppLogFileStream.name, () => {
-    let service: LogFilesService
-    let spyWriteAppLogFileToDisk: Mock
-
-    beforeAll(async () => {
-      spyWriteAppLogFileToDisk = vi
-        .spyOn(LogFileInteractor, 'writeAppLogFileToDisk')
-        .mockResolvedValue()
-      await writeFile(APP_LOG_FILE_PATH, 'b')
-    })
+    let spyGetAppLogStream: Mock
 
-    beforeEach(async () => {
-      const module: TestingModule = await Test.createTestingModule({
-        providers: [ConfigService, LogFilesService],
-      }).compile()
+    beforeEach(() => {
+      spyGetAppLogStream = vi
+        .spyOn(LogFileInteractor, 'getAppLogStream')
+        .mockImplementation(() => Promise.resolve(Readable.from(['b'])))
+    })
 
-      service = module.get<LogFilesService>(LogFilesService)
+    it('streams the journal output', async () => {
+      const stream = await service.getAppLogFileStream()
+      expect(spyGetAppLogStream).toHaveBeenCalled()
+      expect((await readAll(stream)).toString()).toBe('b')
     })
 
-    it('calls the correct method', async () => {
-      await service.getAppLogFileStream()
-      expect(spyWriteAppLogFileToDisk).toHaveBeenCalled()
+    it('compresses the journal output on request', async () => {
+      const stream = await service.getAppLogFileStream({ gzip: 'true' })
+      expect(gunzipSync(await readAll(stream)).toString()).toBe('b')
     })
 
-    afterAll(async () => {
-      spyWriteAppLogFileToDisk.mockRestore()
-      await rm(APP_LOG_FILE_PATH)
+    afterEach(() => {
+      spyGetAppLogStream.mockRestore()
     })
   })
 
   describe(LogFilesService.prototype.getMotionLogFileStream.name, () => {
-    let service: LogFilesService
-    let spyWriteMotionLogFileToDisk: Mock
-
-    beforeAll(async () => {
-      spyWriteMotionLogFileToDisk = vi
-        .spyOn(LogFileInteractor, 'writeMotionLogFileToDisk')
-        .mockResolvedValue()
-      await writeFile(MOTION_LOG_FILE_PATH, 'c')
+    let spyGetMotionLogStream: Mock
+
+    beforeEach(() => {
+      spyGetMotionLogStream = vi
+        .spyOn(LogFileInteractor, 'getMotionLogStream')
+        .mockImplementation(() => Promise.resolve(Readable.from(['c'])))
     })
 
-    beforeEach(async () => {
-      const module: TestingModule = await Test.createTestingModule({
-        providers: [ConfigService, LogFilesService],
-      }).compile()
+    it('passes the filter on', async () => {
+      await service.getMotionLogFileStream({ priority: 'err', lines: '10' })
+      expect(spyGetMotionLogStream).toHaveBeenCalledWith({
+        grep: undefined,
+        lines: 10,
+        priority: 'err',
+        since: undefined,
+        until: undefined,
+      })
+    })
+
+    afterEach(() => {
+      spyGetMotionLogStream.mockRestore()
+    })
+  })
 
-      service = module.get<LogFilesService>(LogFilesService)
+  describe(LogFilesService.convertQueryToFilter.name, () => {
+    it('falls back to a two weeks window without bounds', () => {
+      expect(LogFilesService.convertQueryToFilter({}).since).toBe(
+        '2 weeks ago',
+      )
     })
 
-    it('calls the correct method', async () => {
-      await service.getMotionLogFileStream()
-      expect(spyWriteMotionLogFileToDisk).toHaveBeenCalled()
+    it('keeps a given time window', () => {
+      const filter = LogFilesService.convertQueryToFilter({
+        since: '-1h',
+        until: 'now',
+      })
+      expect(filter.since).toBe('-1h')
+      expect(filter.until).toBe('now')
     })
 
-    afterAll(async () => {
-      spyWriteMotionLogFileToDisk.mockRestore()
-      await rm(MOTION_LOG_FILE_PATH)
+    it('does not restrict the time when tailing lines', () => {
+      const filter = LogFilesService.convertQueryToFilter({ lines: '100' })
+      expect(filter.since).toBeUndefined()
+      expect(filter.lines).toBe(100)
     })
   })
 })
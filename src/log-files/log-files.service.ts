@@ -14,20 +14,17 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { createReadStream } from 'fs'
-import path from 'path'
-import { Readable } from 'stream'
+import { pipeline, Readable } from 'stream'
+import { createGzip } from 'zlib'
 import { Injectable, Logger } from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
-import { Cron } from '@nestjs/schedule'
 import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
-import FolderCleaner from '../shared/folder-cleaner'
+import { LogExportQueryDto } from './dto/log-export-query.dto'
+import { JournalFilter } from './entities/journal-filter.entity'
 import { LogFileInteractor } from './log-file-interactor'
 import { ILogFilesService } from './log-files.service.interface'
 
-const TEMPORARY_APP_LOG_FILENAME = 'app.log'
-const TEMPORARY_MOTION_LOG_FILENAME = 'motion.log'
-const TEMPORARY_FOLDER_PATH = 'temp/logs'
+const DEFAULT_SINCE = '2 weeks ago'
 
 @Injectable()
 export class LogFilesService implements ILogFilesService {
@@ -38,44 +35,52 @@ export class LogFilesService implements ILogFilesService {
     this.serviceName = this.configService.get<string>('serviceName')
   }
 
-  async getAppLogFileStream(): Promise<Readable> {
-    const logFilePath = path.join(
-      TEMPORARY_FOLDER_PATH,
-      TEMPORARY_APP_LOG_FILENAME,
+  async getAppLogFileStream(query: LogExportQueryDto = {}): Promise<Readable> {
+    return this.getLogStream(query, (filter) =>
+      LogFileInteractor.getAppLogStream(this.serviceName, filter),
     )
-    try {
-      await LogFileInteractor.writeAppLogFileToDisk(
-        this.serviceName,
-        logFilePath,
-      )
-    } catch (error) {
-      if (!(error instanceof CommandUnavailableOnWindowsException)) {
-        throw error
-      }
-    }
-    const stream = createReadStream(logFilePath)
-    return stream
   }
 
-  async getMotionLogFileStream(): Promise<Readable> {
-    const logFilePath = path.join(
-      TEMPORARY_FOLDER_PATH,
-      TEMPORARY_MOTION_LOG_FILENAME,
+  async getMotionLogFileStream(
+    query: LogExportQueryDto = {},
+  ): Promise<Readable> {
+    return this.getLogStream(query, (filter) =>
+      LogFileInteractor.getMotionLogStream(filter),
     )
+  }
+
+  static convertQueryToFilter(query: LogExportQueryDto): JournalFilter {
+    const lines = query.lines ? parseInt(query.lines) : undefined
+    return {
+      grep: query.grep,
+      lines,
+      priority: query.priority,
+      // Only fall back to a time window if the request is not bounded at all.
+      since: query.since ?? (lines ? undefined : DEFAULT_SINCE),
+      until: query.until,
+    }
+  }
+
+  private async getLogStream(
+    query: LogExportQueryDto,
+    openStream: (filter: JournalFilter) => Promise<Readable>,
+  ): Promise<Readable> {
+    let stream: Readable
     try {
-      await LogFileInteractor.writeMotionLogFileToDisk(logFilePath)
+      stream = await openStream(LogFilesService.convertQueryToFilter(query))
     } catch (error) {
       if (!(error instanceof CommandUnavailableOnWindowsException)) {
         throw error
       }
+      stream = Readable.from([])
     }
-    const stream = createReadStream(logFilePath)
-    return stream
-  }
-
-  @Cron('*/5 * * * *') // every 5 minutes
-  async removeOldLogs() {
-    this.logger.log('Cron job to delete old logs triggered...')
-    await FolderCleaner.removeOldFiles(TEMPORARY_FOLDER_PATH)
+    if (query.gzip !== 'true') {
+      return stream
+    }
+    return pipeline(stream, createGzip(), (error) => {
+      if (error) {
+        this.logger.error(`Log export aborted: ${error.message}`)
+      }
+    })
   }
 }
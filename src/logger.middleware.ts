@@ -16,6 +16,7 @@
  */
 import { Injectable, Logger, NestMiddleware } from '@nestjs/common'
 import { Request, Response, NextFunction } from 'express'
+import { MetricsRegistry } from './metrics/metrics-registry'
 
 @Injectable()
 export class LoggerMiddleware implements NestMiddleware {
@@ -24,11 +25,15 @@ export class LoggerMiddleware implements NestMiddleware {
   use(request: Request, response: Response, next: NextFunction): void {
     const { ip, method, originalUrl } = request
     const userAgent = request.get('user-agent') || ''
+    const start = performance.now()
+    const endTimer = MetricsRegistry.startTimer('http', method)
 
     response.on('finish', () => {
       const { statusCode } = response
+      endTimer([method, this.getRouteLabel(request)], statusCode >= 500)
+      const durationMs = Math.round(performance.now() - start)
 
-      const message = `${method} ${originalUrl} ${statusCode} - ${userAgent} ${ip}`
+      const message = `${method} ${originalUrl} ${statusCode} ${durationMs}ms - ${userAgent} ${ip}`
 
       if (statusCode >= 500) {
         this.logger.error(message)
@@ -39,6 +44,19 @@ export class LoggerMiddleware implements NestMiddleware {
       }
     })
 
+    // Aborted requests never finish.
+    response.on('close', () => {
+      endTimer([method, this.getRouteLabel(request)], true)
+    })
+
     next()
   }
+
+  // Uses the route pattern, as paths contain filenames and identifiers.
+  private getRouteLabel(request: Request): string {
+    if (!request.route) {
+      return 'unmatched'
+    }
+    return request.baseUrl + request.route.path
+  }
 }
@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
+import { uptime } from 'os'
 import { Logger, ValidationPipe } from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
 import { HttpAdapterHost, NestFactory } from '@nestjs/core'
@@ -21,6 +22,9 @@ import { SwaggerModule, DocumentBuilder } from '@nestjs/swagger'
 import { json, urlencoded } from 'body-parser'
 import { AllExceptionsFilter } from './all-exceptions.filter'
 import { AppModule } from './app.module'
+import { BootStep, BootStepRunner } from './boot/boot-step-runner'
+import { BootService } from './boot/boot.service'
+import { EventLogService } from './event-log/event-log.service'
 import { InitialisationInteractor } from './initialisation-interactor'
 import { PropertiesService } from './properties/properties.service'
 import { UndefinedPathException } from './settings/exceptions/UndefinedPathException'
@@ -32,12 +36,20 @@ const PAYLOAD_LIMIT = '1mb'
 async function bootstrap() {
   const logger = new Logger('main')
   logger.log('Bootstrapping the application...')
+  // Relative to the process start, so that module loading is included.
+  const getElapsedMs = () => Math.round(process.uptime() * 1000)
+  const bootstrapStartMs = getElapsedMs()
 
   const app = await NestFactory.create(AppModule, {
     cors: {
-      exposedHeaders: ['Content-Disposition'],
+      exposedHeaders: [
+        'Content-Disposition',
+        'X-Checksum-Crc32c',
+        'X-Sync-Cursor',
+      ],
     },
   })
+  const createApplicationDurationMs = getElapsedMs() - bootstrapStartMs
   app.useGlobalPipes(new ValidationPipe())
   app.getHttpAdapter().getInstance().disable('x-powered-by')
 
@@ -48,56 +60,147 @@ async function bootstrap() {
   app.useGlobalFilters(new AllExceptionsFilter(httpAdapter))
 
   const propertiesService = app.get(PropertiesService)
-  await propertiesService.logVersion()
-  await propertiesService.saveDeviceIdToTextFile()
-
   const settingsService = app.get(SettingsService)
-
   const configService = app.get(ConfigService)
   const deviceType = configService.get<string>('deviceType')
+  let version = ''
 
   if (process.platform === 'win32') {
     logger.warn(
       'Windows environment detected. Many features are not supported!',
     )
-  } else {
-    const mountPath =
-      await InitialisationInteractor.getNewestMediaPath(deviceType)
-    try {
-      await settingsService.setShotsFolder(mountPath)
-    } catch (e) {
-      if (!(e instanceof UndefinedPathException)) {
-        throw e
-      }
-    }
-  }
-  const isAlternatingLightModeEnabled =
-    await settingsService.getIsAlternatingLightModeEnabled()
-  const lightType = await settingsService.getTriggeringLight()
-  try {
-    await InitialisationInteractor.resetLights(
-      deviceType,
-      isAlternatingLightModeEnabled,
-      lightType,
-    )
-  } catch (error) {
-    if (!(error instanceof CommandUnavailableOnWindowsException)) {
-      throw error
-    }
   }
 
-  settingsService.setNextSunsetForSleepingAndSunriseForWakingUpOnRaspberryPi()
+  // Everything the UI needs to work right after the port is open.
+  const criticalSteps: BootStep[] = [
+    {
+      name: 'logVersion',
+      run: async () => {
+        version = (await propertiesService.logVersion()).version
+      },
+    },
+    {
+      name: 'saveDeviceId',
+      run: () => propertiesService.saveDeviceIdToTextFile(),
+    },
+    {
+      name: 'setShotsFolder',
+      run: async () => {
+        if (process.platform === 'win32') {
+          return
+        }
+        const mountPath =
+          await InitialisationInteractor.getNewestMediaPath(deviceType)
+        try {
+          await settingsService.setShotsFolder(mountPath)
+        } catch (e) {
+          if (!(e instanceof UndefinedPathException)) {
+            throw e
+          }
+        }
+      },
+    },
+    {
+      name: 'warmUpSettings',
+      dependencies: ['setShotsFolder'],
+      run: async () => {
+        try {
+          // Load the in-memory settings so that the first page load is fast.
+          await settingsService.getAllSettings()
+        } catch (error) {
+          logger.warn(`Settings could not be loaded: ${error.message}`)
+        }
+      },
+    },
+  ]
+  const criticalTimings = await BootStepRunner.run(
+    criticalSteps,
+    'critical',
+    getElapsedMs,
+    logger,
+  )
 
-  const version = (await propertiesService.getVersion()).version
-  const config = new DocumentBuilder()
-    .setTitle('App4Cam API')
-    .setVersion(version)
-    .build()
-  const document = SwaggerModule.createDocument(app, config)
-  SwaggerModule.setup('api', app, document)
+  // The document is only generated when it is first requested.
+  SwaggerModule.setup('api', app, () =>
+    SwaggerModule.createDocument(
+      app,
+      new DocumentBuilder().setTitle('App4Cam API').setVersion(version).build(),
+    ),
+  )
 
   const port = configService.get('port')
   await app.listen(port)
+  const listeningAfterMs = getElapsedMs()
+  logger.log(`Listening after ${listeningAfterMs} ms since process start.`)
+
+  const bootService = app.get(BootService)
+  bootService.setReport({
+    version,
+    bootstrapStartMs,
+    listeningAfterMs,
+    finishedAfterMs: null,
+    systemUptimeAtListeningSeconds: Math.round(uptime()),
+    steps: [
+      {
+        name: 'createApplication',
+        phase: 'critical',
+        startMs: bootstrapStartMs,
+        durationMs: createApplicationDurationMs,
+        status: 'succeeded',
+      },
+      ...criticalTimings,
+    ],
+  })
+
+  const deferredSteps: BootStep[] = [
+    {
+      name: 'resetLights',
+      run: async () => {
+        const isAlternatingLightModeEnabled =
+          await settingsService.getIsAlternatingLightModeEnabled()
+        const lightType = await settingsService.getTriggeringLight()
+        try {
+          await InitialisationInteractor.resetLights(
+            deviceType,
+            isAlternatingLightModeEnabled,
+            lightType,
+          )
+        } catch (error) {
+          if (!(error instanceof CommandUnavailableOnWindowsException)) {
+            throw error
+          }
+        }
+      },
+    },
+    {
+      name: 'scheduleWittyPi',
+      run: () =>
+        settingsService.setNextSunsetForSleepingAndSunriseForWakingUpOnRaspberryPi(),
+    },
+    {
+      name: 'scheduleSleeping',
+      run: () => settingsService.scheduleSleeping(),
+    },
+    {
+      name: 'recordBootEvent',
+      run: async () => {
+        let batteryVoltage = -1
+        try {
+          batteryVoltage = await propertiesService.getBatteryVoltage()
+        } catch (error) {
+          logger.warn(`Battery voltage could not be read: ${error.message}`)
+        }
+        app.get(EventLogService).record('boot', { value: batteryVoltage })
+      },
+    },
+  ]
+  const deferredTimings = await BootStepRunner.run(
+    deferredSteps,
+    'deferred',
+    getElapsedMs,
+    logger,
+  )
+  bootService.addDeferredTimings(deferredTimings, getElapsedMs())
   logger.log('Bootstrapping the application done.')
 }
 bootstrap()
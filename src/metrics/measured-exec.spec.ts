@@ -0,0 +1,33 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { getCommandName } from './measured-exec'
+
+describe(getCommandName.name, () => {
+  it('returns the executable name', () => {
+    expect(getCommandName('timedatectl list-timezones')).toBe('timedatectl')
+  })
+
+  it('skips sudo and the folders', () => {
+    expect(
+      getCommandName('sudo /a/scripts/runtime/variscite/rtc/sleep_until "x"'),
+    ).toBe('sleep_until')
+  })
+
+  it('removes quotes', () => {
+    expect(getCommandName('"/a b/c"')).toBe('c')
+  })
+})
@@ -15,18 +15,25 @@
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
 import { exec as execSync } from 'child_process'
+import path from 'path'
 import { promisify } from 'util'
-import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
-import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
+import { MetricsRegistry } from './metrics-registry'
 
-const exec = promisify(execSync)
+const execWithoutMetrics = promisify(execSync)
 
-export class FileInteractor {
-  static async removeAllFilesInDirectory(path: string): Promise<void> {
-    CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(`find ${path} -type f -delete`)
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
-    }
-  }
+export async function exec(
+  command: string,
+): Promise<{ stdout: string; stderr: string }> {
+  return MetricsRegistry.measure(
+    'dependency',
+    ['exec', getCommandName(command)],
+    () => execWithoutMetrics(command),
+  )
+}
+
+// Keeps the label cardinality low by leaving out all arguments.
+export function getCommandName(command: string): string {
+  const words = command.trim().split(/\s+/)
+  const executable = words[0] === 'sudo' ? words[1] : words[0]
+  return path.basename((executable ?? '').replace(/["']/g, ''))
 }
@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MetricsRegistry } from './metrics-registry'
+
+describe(MetricsRegistry.name, () => {
+  beforeEach(() => {
+    MetricsRegistry.reset()
+  })
+
+  describe(MetricsRegistry.measure.name, () => {
+    it('counts successful calls', async () => {
+      await MetricsRegistry.measure('dependency', ['exec', 'a'], async () => 1)
+      const text = MetricsRegistry.render()
+      expect(text).toContain(
+        'app4cam_dependency_calls_total{dependency="exec",operation="a"} 1',
+      )
+      expect(text).toContain(
+        'app4cam_dependency_call_errors_total{dependency="exec",operation="a"} 0',
+      )
+    })
+
+    it('counts failed calls and rethrows', async () => {
+      await expect(
+        MetricsRegistry.measure('dependency', ['exec', 'a'], async () => {
+          throw new Error()
+        }),
+      ).rejects.toThrow()
+      expect(MetricsRegistry.render()).toContain(
+        'app4cam_dependency_call_errors_total{dependency="exec",operation="a"} 1',
+      )
+    })
+
+    it('fills the histogram buckets cumulatively', async () => {
+      await MetricsRegistry.measure('dependency', ['fs', 'b'], async () => 1)
+      const text = MetricsRegistry.render()
+      expect(text).toContain(
+        'app4cam_dependency_call_duration_seconds_bucket{dependency="fs",operation="b",le="10"} 1',
+      )
+      expect(text).toContain(
+        'app4cam_dependency_call_duration_seconds_bucket{dependency="fs",operation="b",le="+Inf"} 1',
+      )
+      expect(text).toContain(
+        'app4cam_dependency_call_duration_seconds_count{dependency="fs",operation="b"} 1',
+      )
+    })
+  })
+
+  describe(MetricsRegistry.startTimer.name, () => {
+    it('tracks calls in flight', () => {
+      const end = MetricsRegistry.startTimer('http', 'GET')
+      expect(MetricsRegistry.render()).toContain(
+        'app4cam_http_requests_in_flight{method="GET"} 1',
+      )
+      end(['GET', '/a'])
+      end(['GET', '/a'])
+      const text = MetricsRegistry.render()
+      expect(text).toContain('app4cam_http_requests_in_flight{method="GET"} 0')
+      expect(text).toContain(
+        'app4cam_http_requests_total{method="GET",route="/a"} 1',
+      )
+    })
+  })
+
+  describe(MetricsRegistry.render.name, () => {
+    it('escapes label values', async () => {
+      await MetricsRegistry.measure(
+        'dependency',
+        ['exec', 'a"b'],
+        async () => 1,
+      )
+      expect(MetricsRegistry.render()).toContain('operation="a\\"b"')
+    })
+
+    it('declares all metric types', () => {
+      const text = MetricsRegistry.render()
+      expect(text).toContain(
+        '# TYPE app4cam_http_request_duration_seconds histogram',
+      )
+      expect(text).toContain('# TYPE app4cam_http_requests_total counter')
+      expect(text).toContain('# TYPE app4cam_http_requests_in_flight gauge')
+    })
+  })
+})
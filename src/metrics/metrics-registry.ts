@@ -0,0 +1,234 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+export type MetricFamilyName = 'dependency' | 'http'
+
+interface MetricFamilyDefinition {
+  durationName: string
+  errorsName: string
+  inFlightName: string
+  totalName: string
+  subject: string
+  labelNames: [string, string]
+}
+
+interface Series {
+  labelValues: string[]
+  bucketCounts: number[]
+  count: number
+  errorCount: number
+  sumSeconds: number
+}
+
+interface MetricFamily {
+  definition: MetricFamilyDefinition
+  inFlight: Map<string, number>
+  series: Map<string, Series>
+}
+
+const DURATION_BUCKETS_SECONDS = [
+  0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10,
+]
+
+const FAMILY_DEFINITIONS: Record<MetricFamilyName, MetricFamilyDefinition> = {
+  dependency: {
+    durationName: 'app4cam_dependency_call_duration_seconds',
+    errorsName: 'app4cam_dependency_call_errors_total',
+    inFlightName: 'app4cam_dependency_calls_in_flight',
+    totalName: 'app4cam_dependency_calls_total',
+    subject: 'calls to commands, Motion and the file system',
+    labelNames: ['dependency', 'operation'],
+  },
+  http: {
+    durationName: 'app4cam_http_request_duration_seconds',
+    errorsName: 'app4cam_http_request_errors_total',
+    inFlightName: 'app4cam_http_requests_in_flight',
+    totalName: 'app4cam_http_requests_total',
+    subject: 'HTTP requests',
+    labelNames: ['method', 'route'],
+  },
+}
+
+/**
+ * Process-wide histograms with fixed buckets, kept static so that the static
+ * interactors can be measured without dependency injection. In-flight gauges
+ * are labelled by the first label only, as the others may only be known once
+ * a call finished.
+ */
+export class MetricsRegistry {
+  private static readonly families = new Map<MetricFamilyName, MetricFamily>(
+    Object.entries(FAMILY_DEFINITIONS).map(([name, definition]) => [
+      name as MetricFamilyName,
+      { definition, inFlight: new Map(), series: new Map() },
+    ]),
+  )
+
+  static startTimer(
+    familyName: MetricFamilyName,
+    firstLabelValue: string,
+  ): (labelValues: [string, string], isError?: boolean) => void {
+    const family = this.families.get(familyName)
+    family.inFlight.set(
+      firstLabelValue,
+      (family.inFlight.get(firstLabelValue) ?? 0) + 1,
+    )
+    const start = performance.now()
+    let isEnded = false
+    return (labelValues, isError = false) => {
+      if (isEnded) {
+        return
+      }
+      isEnded = true
+      family.inFlight.set(
+        firstLabelValue,
+        family.inFlight.get(firstLabelValue) - 1,
+      )
+      this.observe(family, labelValues, performance.now() - start, isError)
+    }
+  }
+
+  static async measure<T>(
+    familyName: MetricFamilyName,
+    labelValues: [string, string],
+    action: () => Promise<T>,
+  ): Promise<T> {
+    const end = this.startTimer(familyName, labelValues[0])
+    try {
+      const result = await action()
+      end(labelValues)
+      return result
+    } catch (error) {
+      end(labelValues, true)
+      throw error
+    }
+  }
+
+  static render(): string {
+    const lines = Array.from(this.families.values()).flatMap((family) =>
+      this.renderFamily(family),
+    )
+    return lines.join('\n') + '\n'
+  }
+
+  static reset(): void {
+    for (const family of this.families.values()) {
+      family.inFlight.clear()
+      family.series.clear()
+    }
+  }
+
+  private static observe(
+    family: MetricFamily,
+    labelValues: string[],
+    durationMs: number,
+    isError: boolean,
+  ): void {
+    const key = labelValues.join('\u0000')
+    let series = family.series.get(key)
+    if (!series) {
+      series = {
+        labelValues,
+        bucketCounts: new Array(DURATION_BUCKETS_SECONDS.length).fill(0),
+        count: 0,
+        errorCount: 0,
+        sumSeconds: 0,
+      }
+      family.series.set(key, series)
+    }
+    const durationSeconds = durationMs / 1000
+    const bucketIndex = DURATION_BUCKETS_SECONDS.findIndex(
+      (bound) => durationSeconds <= bound,
+    )
+    if (bucketIndex !== -1) {
+      series.bucketCounts[bucketIndex]++
+    }
+    series.count++
+    series.sumSeconds += durationSeconds
+    if (isError) {
+      series.errorCount++
+    }
+  }
+
+  private static renderFamily({
+    definition,
+    inFlight,
+    series,
+  }: MetricFamily): string[] {
+    const { durationName, errorsName, inFlightName, totalName } = definition
+    const allSeries = Array.from(series.values())
+    const lines = [
+      `# HELP ${durationName} Duration of ${definition.subject}.`,
+      `# TYPE ${durationName} histogram`,
+    ]
+    for (const { labelValues, bucketCounts, count, sumSeconds } of allSeries) {
+      const labels = this.formatLabels(definition.labelNames, labelValues)
+      let cumulativeCount = 0
+      DURATION_BUCKETS_SECONDS.forEach((bound, i) => {
+        cumulativeCount += bucketCounts[i]
+        const bucketLabels = labels.replace(/}$/, `,le="${bound}"}`)
+        lines.push(`${durationName}_bucket${bucketLabels} ${cumulativeCount}`)
+      })
+      const infinityLabels = labels.replace(/}$/, ',le="+Inf"}')
+      lines.push(
+        `${durationName}_bucket${infinityLabels} ${count}`,
+        `${durationName}_sum${labels} ${sumSeconds}`,
+        `${durationName}_count${labels} ${count}`,
+      )
+    }
+
+    lines.push(
+      `# HELP ${totalName} Number of ${definition.subject}.`,
+      `# TYPE ${totalName} counter`,
+    )
+    for (const { labelValues, count } of allSeries) {
+      const labels = this.formatLabels(definition.labelNames, labelValues)
+      lines.push(`${totalName}${labels} ${count}`)
+    }
+
+    lines.push(
+      `# HELP ${errorsName} Number of failed ${definition.subject}.`,
+      `# TYPE ${errorsName} counter`,
+    )
+    for (const { labelValues, errorCount } of allSeries) {
+      const labels = this.formatLabels(definition.labelNames, labelValues)
+      lines.push(`${errorsName}${labels} ${errorCount}`)
+    }
+
+    lines.push(
+      `# HELP ${inFlightName} Number of running ${definition.subject}.`,
+      `# TYPE ${inFlightName} gauge`,
+    )
+    for (const [labelValue, count] of inFlight) {
+      const labels = this.formatLabels(definition.labelNames, [labelValue])
+      lines.push(`${inFlightName}${labels} ${count}`)
+    }
+    return lines
+  }
+
+  private static formatLabels(names: string[], values: string[]): string {
+    const pairs = values.map(
+      (value, i) => `${names[i]}="${this.escapeLabelValue(value)}"`,
+    )
+    return `{${pairs.join(',')}}`
+  }
+
+  private static escapeLabelValue(value: string): string {
+    return value
+      .replace(/\\/g, '\\\\')
+      .replace(/"/g, '\\"')
+      .replace(/\n/g, '\\n')
+  }
+}
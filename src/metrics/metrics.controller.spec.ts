@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { MetricsController } from './metrics.controller'
+import { MetricsService } from './metrics.service'
+import { IMetricsService } from './metrics.service.interface'
+
+describe(MetricsController.name, () => {
+  class MockMetricsService implements IMetricsService {
+    getMetricsInPrometheusFormat = vi.fn(() => 'a 1\n')
+  }
+
+  let controller: MetricsController
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [MetricsController],
+      providers: [{ provide: MetricsService, useClass: MockMetricsService }],
+    }).compile()
+
+    controller = module.get<MetricsController>(MetricsController)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(MetricsController.prototype.getMetrics.name, () => {
+    it('returns the metrics text', () => {
+      expect(controller.getMetrics()).toBe('a 1\n')
+    })
+  })
+})
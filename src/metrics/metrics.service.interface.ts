@@ -0,0 +1,3 @@
+export interface IMetricsService {
+  getMetricsInPrometheusFormat: () => string
+}
@@ -1,8 +1,12 @@
+import { MotionConfigurationTransaction } from './motion-configuration-transaction'
+
 export type MovieOutputValue = 'on' | 'off'
 export type PictureOutputValue = 'on' | 'off' | 'first' | 'best'
 
 export interface IMotionClientService {
+  getFramerate: () => Promise<number>
   getHeight: () => Promise<number>
+  getMaskFile: () => Promise<string>
   getMovieOutput: () => Promise<MovieOutputValue>
   getMovieQuality: () => Promise<number>
   getPictureOutput: () => Promise<PictureOutputValue>
@@ -14,6 +18,7 @@ export interface IMotionClientService {
   getWidth: () => Promise<number>
   setLeftTextOnImage: (text: string) => Promise<void>
   setFilename: (filename: string) => Promise<void>
+  setMaskFile: (value: string) => Promise<void>
   setMovieOutput: (value: MovieOutputValue) => Promise<void>
   setMovieQuality: (value: number) => Promise<void>
   setPictureOutput: (value: PictureOutputValue) => Promise<void>
@@ -21,9 +26,11 @@ export interface IMotionClientService {
   setTargetDir: (value: string) => Promise<void>
   setThreshold: (value: number) => Promise<void>
   setVideoParams: (value: string) => Promise<void>
+  beginConfigurationTransaction: () => MotionConfigurationTransaction
   isCameraConnected: () => Promise<boolean>
   isDetectionStatusActive: () => Promise<boolean>
   pauseDetection: () => Promise<void>
   startDetection: () => Promise<void>
+  restart: () => Promise<void>
   takeSnapshot: () => Promise<void>
 }
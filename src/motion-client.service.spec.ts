@@ -15,6 +15,8 @@
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
 import { Test, TestingModule } from '@nestjs/testing'
+import { http, HttpResponse } from 'msw'
+import { MetricsRegistry } from './metrics/metrics-registry'
 import { server } from '../test/unit/motion-server-mocks/server'
 import { MotionClientService } from './motion-client.service'
 
@@ -25,6 +27,7 @@ describe(MotionClientService.name, () => {
   let service: MotionClientService
 
   beforeEach(async () => {
+    MotionClientService.invalidateConfigurationCache()
     const module: TestingModule = await Test.createTestingModule({
       providers: [MotionClientService],
     }).compile()
@@ -32,6 +35,13 @@ describe(MotionClientService.name, () => {
     service = module.get<MotionClientService>(MotionClientService)
   })
 
+  describe(MotionClientService.prototype.getFramerate.name, () => {
+    it('returns a value', async () => {
+      const response = await service.getFramerate()
+      expect(response).toBe(1)
+    })
+  })
+
   describe(MotionClientService.prototype.getHeight.name, () => {
     it('returns a value', async () => {
       const response = await service.getHeight()
@@ -39,6 +49,13 @@ describe(MotionClientService.name, () => {
     })
   })
 
+  describe(MotionClientService.prototype.getMaskFile.name, () => {
+    it('returns a value', async () => {
+      const response = await service.getMaskFile()
+      expect(response).toBe('/a/b.pgm')
+    })
+  })
+
   describe(MotionClientService.prototype.getMovieOutput.name, () => {
     it('returns a value', async () => {
       const response = await service.getMovieOutput()
@@ -116,6 +133,12 @@ describe(MotionClientService.name, () => {
     })
   })
 
+  describe(MotionClientService.prototype.setMaskFile.name, () => {
+    it('does not throw an error', async () => {
+      await expect(service.setMaskFile('/a/b.pgm')).resolves.not.toThrow()
+    })
+  })
+
   describe(MotionClientService.prototype.setMovieOutput.name, () => {
     it('does not throw an error', async () => {
       await expect(service.setMovieOutput('on')).resolves.not.toThrow()
@@ -188,12 +211,172 @@ describe(MotionClientService.name, () => {
     })
   })
 
+  describe(MotionClientService.prototype.restart.name, () => {
+    it('does not throw an error', async () => {
+      await expect(service.restart()).resolves.not.toThrow()
+    })
+  })
+
   describe(MotionClientService.prototype.takeSnapshot.name, () => {
     it('does not throw an error', async () => {
       await expect(service.takeSnapshot()).resolves.not.toThrow()
     })
   })
 
+  describe('configuration cache', () => {
+    const listUrl = 'http://127.0.0.1:8080/0/config/list'
+
+    it('serves several reads from one list request', async () => {
+      let listRequestCount = 0
+      server.use(
+        http.get(listUrl, () => {
+          listRequestCount++
+          return new HttpResponse('Camera 0\n  height = 2\n  width = 3\n')
+        }),
+      )
+      const [height, width] = await Promise.all([
+        service.getHeight(),
+        service.getWidth(),
+      ])
+      expect(height).toBe(2)
+      expect(width).toBe(3)
+      expect(listRequestCount).toBe(1)
+    })
+
+    it('lists again after an option was set', async () => {
+      let listRequestCount = 0
+      server.use(
+        http.get(listUrl, () => {
+          listRequestCount++
+          return new HttpResponse('Camera 0\n  threshold = 1\n')
+        }),
+      )
+      await service.getThreshold()
+      await service.setThreshold(2)
+      await service.getThreshold()
+      expect(listRequestCount).toBe(2)
+    })
+
+    it('falls back to single option reads when listing fails', async () => {
+      server.use(
+        http.get(listUrl, () => new HttpResponse(null, { status: 404 })),
+      )
+      const response = await service.getTargetDir()
+      expect(response).toBe('/a/b/c')
+    })
+  })
+
+  describe('configuration transaction', () => {
+    const setUrl = 'http://127.0.0.1:8080/0/config/set'
+    const writeUrl = 'http://127.0.0.1:8080/action/config/write'
+    let setOptions: string[]
+    let writeRequestCount: number
+
+    beforeEach(() => {
+      setOptions = []
+      writeRequestCount = 0
+      server.use(
+        http.get(setUrl, ({ request }) => {
+          const options = Array.from(new URL(request.url).searchParams.keys())
+          setOptions.push(...options)
+          const status = options.includes('height') ? 404 : 200
+          return new HttpResponse(null, { status })
+        }),
+        http.get(writeUrl, () => {
+          writeRequestCount++
+          return new HttpResponse(null, { status: 200 })
+        }),
+      )
+    })
+
+    it('sets changed options only and writes once', async () => {
+      const results = await service
+        .beginConfigurationTransaction()
+        .setThreshold(1)
+        .setMovieOutput('on')
+        .setFilename('a')
+        .commit()
+      expect(setOptions.sort()).toEqual([
+        'movie_filename',
+        'picture_filename',
+        'snapshot_filename',
+      ])
+      expect(writeRequestCount).toBe(1)
+      expect(results).toContainEqual({
+        option: 'threshold',
+        status: 'unchanged',
+      })
+      expect(results).toContainEqual({
+        option: 'movie_filename',
+        status: 'applied',
+      })
+    })
+
+    it('does not write when nothing changed', async () => {
+      const results = await service
+        .beginConfigurationTransaction()
+        .setThreshold(1)
+        .setTargetDir('/a/b/c')
+        .commit()
+      expect(setOptions).toEqual([])
+      expect(writeRequestCount).toBe(0)
+      expect(results.map((result) => result.status)).toEqual([
+        'unchanged',
+        'unchanged',
+      ])
+    })
+
+    it('reports failed options and persists the others', async () => {
+      const results = await service
+        .beginConfigurationTransaction()
+        .set('height', '5')
+        .setThreshold(2)
+        .commit()
+      expect(writeRequestCount).toBe(1)
+      expect(results[0].option).toBe('height')
+      expect(results[0].status).toBe('failed')
+      expect(results[1]).toEqual({ option: 'threshold', status: 'applied' })
+    })
+
+    it('persists a changed mask file for the next restart', async () => {
+      await service.setMaskFile('/a/c.pgm')
+      expect(setOptions).toEqual(['mask_file'])
+      expect(writeRequestCount).toBe(1)
+    })
+
+    it('lets single setters throw on failure', async () => {
+      server.use(
+        http.get(setUrl, () => new HttpResponse(null, { status: 500 })),
+      )
+      await expect(service.setThreshold(2)).rejects.toThrow()
+      expect(writeRequestCount).toBe(0)
+    })
+  })
+
+  describe(MotionClientService.parseConfigurationList.name, () => {
+    it('parses options with spaces and equal signs in values', () => {
+      const options = MotionClientService.parseConfigurationList(
+        'Camera 0\n  target_dir = /a/b c\n  video_params = "A"=0, B=1 \n',
+      )
+      expect(options).toEqual(
+        new Map([
+          ['target_dir', '/a/b c'],
+          ['video_params', '"A"=0, B=1'],
+        ]),
+      )
+    })
+  })
+
+  describe('metrics', () => {
+    it('records the calls per endpoint', async () => {
+      MetricsRegistry.reset()
+      await service.takeSnapshot()
+      expect(MetricsRegistry.render()).toContain(
+        'app4cam_dependency_calls_total{dependency="motion",operation="action/snapshot"} 1',
+      )
+    })
+  })
+
   // Reset any request handlers that we may add during the tests, so they don't affect other tests.
   afterEach(() => server.resetHandlers())
 
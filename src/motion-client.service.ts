@@ -14,32 +14,61 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
+import { Agent } from 'http'
 import { Injectable } from '@nestjs/common'
 import axios from 'axios'
+import { MetricsRegistry } from './metrics/metrics-registry'
 import {
   IMotionClientService,
   MovieOutputValue,
   PictureOutputValue,
 } from './motion-client.service.interface'
+import {
+  MotionConfigurationResult,
+  MotionConfigurationTransaction,
+} from './motion-configuration-transaction'
 
 const BASE_URL = 'http://127.0.0.1:8080/'
-const ACTION_URL = BASE_URL + '0/action/'
-const CONFIG_BASE_URL = BASE_URL + '0/config/'
-const CONFIG_GET_URL = CONFIG_BASE_URL + 'get'
-const CONFIG_SET_URL = CONFIG_BASE_URL + 'set'
-const DETECTION_URL = BASE_URL + '0/detection/'
-const WRITE_URL = BASE_URL + 'action/config/write'
+const ACTION_PATH = '0/action/'
+const CONFIG_BASE_PATH = '0/config/'
+const CONFIG_GET_PATH = CONFIG_BASE_PATH + 'get'
+const CONFIG_LIST_PATH = CONFIG_BASE_PATH + 'list'
+const CONFIG_SET_PATH = CONFIG_BASE_PATH + 'set'
+const DETECTION_PATH = '0/detection/'
+const WRITE_PATH = 'action/config/write'
+
+const CONFIGURATION_CACHE_TTL_MS = 2000
+const MAXIMUM_SOCKETS = 4
 
-const POST_PICTURE_FILENAME = '_%q'
-const POST_SNAPSHOT_FILENAME = '_snapshot'
+// Shared by all service instances, as every module provides its own one.
+const httpClient = axios.create({
+  baseURL: BASE_URL,
+  httpAgent: new Agent({ keepAlive: true, maxSockets: MAXIMUM_SOCKETS }),
+})
+
+interface ConfigurationCache {
+  expiresAt: number
+  options: Promise<Map<string, string>>
+}
+let configurationCache: ConfigurationCache | undefined
 
 @Injectable()
 export class MotionClientService implements IMotionClientService {
+  async getFramerate(): Promise<number> {
+    const value = await this.getConfigurationOption('framerate')
+    return parseInt(value)
+  }
+
   async getHeight(): Promise<number> {
     const value = await this.getConfigurationOption('height')
     return parseFloat(value)
   }
 
+  async getMaskFile(): Promise<string> {
+    const value = await this.getConfigurationOption('mask_file')
+    return value
+  }
+
   async getMovieOutput(): Promise<MovieOutputValue> {
     const value = await this.getConfigurationOption('movie_output')
     return value as MovieOutputValue
@@ -86,49 +115,73 @@ export class MotionClientService implements IMotionClientService {
   }
 
   async setLeftTextOnImage(text: string): Promise<void> {
-    await this.setConfigurationOption('text_left', text)
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setLeftTextOnImage(text),
+    )
   }
 
   async setFilename(filename: string): Promise<void> {
-    const moveFilename = filename
-    const pictureFilename = filename + POST_PICTURE_FILENAME
-    const snapshotFilename = filename + POST_SNAPSHOT_FILENAME
-    await axios.get(CONFIG_SET_URL + '?movie_filename=' + moveFilename)
-    await axios.get(CONFIG_SET_URL + '?picture_filename=' + pictureFilename)
-    await axios.get(CONFIG_SET_URL + '?snapshot_filename=' + snapshotFilename)
-    await axios.get(WRITE_URL)
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setFilename(filename),
+    )
+  }
+
+  async setMaskFile(value: string): Promise<void> {
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setMaskFile(value),
+    )
   }
 
   async setMovieOutput(value: MovieOutputValue): Promise<void> {
-    await this.setConfigurationOption('movie_output', value)
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setMovieOutput(value),
+    )
   }
 
   async setMovieQuality(value: number): Promise<void> {
-    await this.setConfigurationOption('movie_quality', value.toString())
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setMovieQuality(value),
+    )
   }
 
   async setPictureOutput(value: PictureOutputValue): Promise<void> {
-    await this.setConfigurationOption('picture_output', value)
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setPictureOutput(value),
+    )
   }
 
   async setPictureQuality(value: number): Promise<void> {
-    await this.setConfigurationOption('picture_quality', value.toString())
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setPictureQuality(value),
+    )
   }
 
   async setTargetDir(value: string): Promise<void> {
-    await this.setConfigurationOption('target_dir', value)
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setTargetDir(value),
+    )
   }
 
   async setThreshold(value: number): Promise<void> {
-    await this.setConfigurationOption('threshold', value.toString())
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setThreshold(value),
+    )
   }
 
   async setVideoParams(value: string): Promise<void> {
-    await this.setConfigurationOption('video_params', value)
+    await this.commitAndThrowOnFailure(
+      this.beginConfigurationTransaction().setVideoParams(value),
+    )
+  }
+
+  beginConfigurationTransaction(): MotionConfigurationTransaction {
+    return new MotionConfigurationTransaction((changes) =>
+      this.applyConfigurationChanges(changes),
+    )
   }
 
   async isCameraConnected(): Promise<boolean> {
-    const response = await axios.get(DETECTION_URL + 'connection')
+    const response = await this.request(DETECTION_PATH + 'connection')
     const body = response.data as string
     const lines = body.split('\n')
     const resultLine = lines[1].trim()
@@ -138,7 +191,7 @@ export class MotionClientService implements IMotionClientService {
   }
 
   async isDetectionStatusActive(): Promise<boolean> {
-    const response = await axios.get(DETECTION_URL + 'status')
+    const response = await this.request(DETECTION_PATH + 'status')
     const body = response.data as string
     const bodyTrimmed = body.trim()
     const bodyPartsSplitBySpace = bodyTrimmed.split(' ')
@@ -147,15 +200,37 @@ export class MotionClientService implements IMotionClientService {
   }
 
   async pauseDetection(): Promise<void> {
-    await axios.get(DETECTION_URL + 'pause')
+    await this.request(DETECTION_PATH + 'pause')
   }
 
   async startDetection(): Promise<void> {
-    await axios.get(DETECTION_URL + 'start')
+    await this.request(DETECTION_PATH + 'start')
+  }
+
+  async restart(): Promise<void> {
+    await this.request(ACTION_PATH + 'restart')
   }
 
   async takeSnapshot(): Promise<void> {
-    await axios.get(ACTION_URL + 'snapshot')
+    await this.request(ACTION_PATH + 'snapshot')
+  }
+
+  static invalidateConfigurationCache(): void {
+    configurationCache = undefined
+  }
+
+  static parseConfigurationList(body: string): Map<string, string> {
+    const options = new Map<string, string>()
+    for (const line of body.split('\n')) {
+      const separatorPosition = line.indexOf(' = ')
+      if (separatorPosition === -1) {
+        continue
+      }
+      const name = line.substring(0, separatorPosition).trim()
+      const value = line.substring(separatorPosition + 3).trim()
+      options.set(name, value)
+    }
+    return options
   }
 
   private extractValueFromResponseBody(body: string): string {
@@ -167,14 +242,87 @@ export class MotionClientService implements IMotionClientService {
     return value
   }
 
+  private async request(path: string) {
+    const endpoint = path.split('?')[0].replace(/^0\//, '')
+    return MetricsRegistry.measure('dependency', ['motion', endpoint], () =>
+      httpClient.get(path),
+    )
+  }
+
+  private getConfigurationOptions(): Promise<Map<string, string>> {
+    if (configurationCache && configurationCache.expiresAt > Date.now()) {
+      return configurationCache.options
+    }
+    const cache: ConfigurationCache = {
+      expiresAt: Date.now() + CONFIGURATION_CACHE_TTL_MS,
+      options: this.request(CONFIG_LIST_PATH).then((response) =>
+        MotionClientService.parseConfigurationList(response.data as string),
+      ),
+    }
+    // Do not keep failures around, so that the next call retries.
+    cache.options.catch(() => {
+      if (configurationCache === cache) {
+        configurationCache = undefined
+      }
+    })
+    configurationCache = cache
+    return cache.options
+  }
+
   private async getConfigurationOption(optionName: string): Promise<string> {
-    const response = await axios.get(`${CONFIG_GET_URL}?query=${optionName}`)
+    try {
+      const options = await this.getConfigurationOptions()
+      if (options.has(optionName)) {
+        return options.get(optionName)
+      }
+    } catch {
+      // Fall back to querying the option on its own.
+    }
+    const response = await this.request(
+      `${CONFIG_GET_PATH}?query=${optionName}`,
+    )
     return this.extractValueFromResponseBody(response.data as string)
   }
 
-  private async setConfigurationOption(optionName: string, value: string) {
-    const url = encodeURI(`${CONFIG_SET_URL}?${optionName}=${value}`)
-    await axios.get(url)
-    await axios.get(WRITE_URL)
+  private async commitAndThrowOnFailure(
+    transaction: MotionConfigurationTransaction,
+  ): Promise<void> {
+    const results = await transaction.commit()
+    MotionConfigurationTransaction.throwOnFailure(results)
+  }
+
+  private async applyConfigurationChanges(
+    changes: Map<string, string>,
+  ): Promise<MotionConfigurationResult[]> {
+    let currentOptions = new Map<string, string>()
+    try {
+      currentOptions = await this.getConfigurationOptions()
+    } catch {
+      // Without the current values, every option is set.
+    }
+    const results = await Promise.all(
+      Array.from(
+        changes,
+        async ([option, value]): Promise<MotionConfigurationResult> => {
+          if (currentOptions.get(option) === value) {
+            return { option, status: 'unchanged' }
+          }
+          try {
+            await this.request(
+              encodeURI(`${CONFIG_SET_PATH}?${option}=${value}`),
+            )
+            return { option, status: 'applied' }
+          } catch (error) {
+            return { option, status: 'failed', error }
+          }
+        },
+      ),
+    )
+    if (results.some((result) => result.status === 'applied')) {
+      configurationCache = undefined
+      // Motion rewrites its whole configuration file, so do it only once.
+      await this.request(WRITE_PATH)
+    }
+    return results
   }
 }
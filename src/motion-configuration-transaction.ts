@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  MovieOutputValue,
+  PictureOutputValue,
+} from './motion-client.service.interface'
+
+const POST_PICTURE_FILENAME = '_%q'
+const POST_SNAPSHOT_FILENAME = '_snapshot'
+
+export type MotionConfigurationStatus = 'applied' | 'failed' | 'unchanged'
+
+export interface MotionConfigurationResult {
+  option: string
+  status: MotionConfigurationStatus
+  error?: Error
+}
+
+export type MotionConfigurationApplier = (
+  changes: Map<string, string>,
+) => Promise<MotionConfigurationResult[]>
+
+/**
+ * Collects Motion configuration changes so that they can be applied in one
+ * pass, with a single write of the configuration file at the end. Setting an
+ * option twice keeps the last value.
+ */
+export class MotionConfigurationTransaction {
+  private readonly changes = new Map<string, string>()
+
+  constructor(private readonly applyChanges: MotionConfigurationApplier) {}
+
+  get isEmpty(): boolean {
+    return this.changes.size === 0
+  }
+
+  set(option: string, value: string): this {
+    this.changes.set(option, value)
+    return this
+  }
+
+  setFilename(filename: string): this {
+    return this.set('movie_filename', filename)
+      .set('picture_filename', filename + POST_PICTURE_FILENAME)
+      .set('snapshot_filename', filename + POST_SNAPSHOT_FILENAME)
+  }
+
+  setLeftTextOnImage(text: string): this {
+    return this.set('text_left', text)
+  }
+
+  setMaskFile(value: string): this {
+    return this.set('mask_file', value)
+  }
+
+  setMovieOutput(value: MovieOutputValue): this {
+    return this.set('movie_output', value)
+  }
+
+  setMovieQuality(value: number): this {
+    return this.set('movie_quality', value.toString())
+  }
+
+  setPictureOutput(value: PictureOutputValue): this {
+    return this.set('picture_output', value)
+  }
+
+  setPictureQuality(value: number): this {
+    return this.set('picture_quality', value.toString())
+  }
+
+  setTargetDir(value: string): this {
+    return this.set('target_dir', value)
+  }
+
+  setThreshold(value: number): this {
+    return this.set('threshold', value.toString())
+  }
+
+  setVideoParams(value: string): this {
+    return this.set('video_params', value)
+  }
+
+  /**
+   * Applies the collected changes and reports the outcome per option. Options
+   * that failed to be set do not prevent the others from being persisted.
+   */
+  async commit(): Promise<MotionConfigurationResult[]> {
+    const changes = new Map(this.changes)
+    this.changes.clear()
+    if (changes.size === 0) {
+      return []
+    }
+    return this.applyChanges(changes)
+  }
+
+  static throwOnFailure(results: MotionConfigurationResult[]): void {
+    const failure = results.find((result) => result.status === 'failed')
+    if (failure) {
+      throw failure.error
+    }
+  }
+}
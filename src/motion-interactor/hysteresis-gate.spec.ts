@@ -0,0 +1,74 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { HysteresisBand, HysteresisGate } from './hysteresis-gate'
+
+describe(HysteresisGate.name, () => {
+  const DISK_SPACE_BAND: HysteresisBand = {
+    engageThreshold: 95,
+    releaseThreshold: 93,
+    minimumDwellMs: 60000,
+  }
+  const TEMPERATURE_BAND: HysteresisBand = {
+    engageThreshold: 5,
+    releaseThreshold: 6,
+    minimumDwellMs: 60000,
+  }
+
+  let gate: HysteresisGate
+
+  beforeEach(() => {
+    gate = new HysteresisGate()
+  })
+
+  describe(HysteresisGate.prototype.update.name, () => {
+    it('takes the state of the first sample right away', () => {
+      expect(gate.update(96, DISK_SPACE_BAND, 0)).toBe('engaged')
+      expect(gate.isEngaged).toBe(true)
+    })
+
+    it('stays engaged within the band', () => {
+      gate.update(96, DISK_SPACE_BAND, 0)
+      expect(gate.update(94, DISK_SPACE_BAND, 120000)).toBeUndefined()
+      expect(gate.isEngaged).toBe(true)
+    })
+
+    it('releases once the value gets back past the band', () => {
+      gate.update(96, DISK_SPACE_BAND, 0)
+      expect(gate.update(92, DISK_SPACE_BAND, 120000)).toBe('released')
+      expect(gate.isEngaged).toBe(false)
+    })
+
+    it('does not change state before the minimum dwell time', () => {
+      gate.update(92, DISK_SPACE_BAND, 0)
+      expect(gate.update(96, DISK_SPACE_BAND, 30000)).toBeUndefined()
+      expect(gate.update(96, DISK_SPACE_BAND, 60000)).toBe('engaged')
+    })
+
+    it('engages on low values if configured so', () => {
+      gate = new HysteresisGate(true)
+      expect(gate.update(10, TEMPERATURE_BAND, 0)).toBe('released')
+      expect(gate.update(4, TEMPERATURE_BAND, 60000)).toBe('engaged')
+      expect(gate.update(5.5, TEMPERATURE_BAND, 120000)).toBeUndefined()
+      expect(gate.update(6, TEMPERATURE_BAND, 180000)).toBe('released')
+    })
+
+    it('ignores invalid samples', () => {
+      expect(gate.update(NaN, DISK_SPACE_BAND, 0)).toBeUndefined()
+      expect(gate.getState()).toBeUndefined()
+    })
+  })
+})
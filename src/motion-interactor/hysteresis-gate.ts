@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+export type GateState = 'engaged' | 'released'
+
+export interface HysteresisBand {
+  /**
+   * Value beyond which the gate engages
+   */
+  engageThreshold: number
+  /**
+   * Value the samples need to get back past before the gate releases again
+   */
+  releaseThreshold: number
+  minimumDwellMs: number
+}
+
+/**
+ * Two-state machine fed with samples. The band between both thresholds and
+ * the minimum time spent in a state keep it from flapping on noisy samples.
+ */
+export class HysteresisGate {
+  private state?: GateState
+  private stateEnteredAtMs = 0
+
+  constructor(private readonly isEngagedOnLowValues = false) {}
+
+  get isEngaged(): boolean {
+    return this.state === 'engaged'
+  }
+
+  getState(): GateState | undefined {
+    return this.state
+  }
+
+  /**
+   * Returns the new state when the sample made the gate change state.
+   */
+  update(
+    value: number,
+    band: HysteresisBand,
+    nowMs = Date.now(),
+  ): GateState | undefined {
+    if (Number.isNaN(value)) {
+      return undefined
+    }
+    const shouldEngage = this.isEngagedOnLowValues
+      ? value < band.engageThreshold
+      : value > band.engageThreshold
+    const shouldRelease = this.isEngagedOnLowValues
+      ? value >= band.releaseThreshold
+      : value <= band.releaseThreshold
+
+    let nextState = this.state
+    if (this.state === undefined) {
+      nextState = shouldEngage ? 'engaged' : 'released'
+    } else if (this.state === 'released' && shouldEngage) {
+      nextState = 'engaged'
+    } else if (this.state === 'engaged' && shouldRelease) {
+      nextState = 'released'
+    }
+
+    if (nextState === this.state) {
+      return undefined
+    }
+    if (
+      this.state !== undefined &&
+      nowMs - this.stateEnteredAtMs < band.minimumDwellMs
+    ) {
+      return undefined
+    }
+    this.state = nextState
+    this.stateEnteredAtMs = nowMs
+    return nextState
+  }
+}
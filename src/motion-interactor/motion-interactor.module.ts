@@ -17,12 +17,13 @@
 import { Module } from '@nestjs/common'
 import { ConfigModule } from '@nestjs/config'
 import { MotionClientService } from '../motion-client.service'
+import { NotificationsModule } from '../notifications/notifications.module'
 import { SettingsModule } from '../settings/settings.module'
 import { StorageModule } from '../storage/storage.module'
 import { MotionInteractorService } from './motion-interactor.service'
 
 @Module({
   providers: [MotionClientService, MotionInteractorService],
-  imports: [ConfigModule, SettingsModule, StorageModule],
+  imports: [ConfigModule, NotificationsModule, SettingsModule, StorageModule],
 })
 export class MotionInteractorModule {}
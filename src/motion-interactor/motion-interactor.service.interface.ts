@@ -1,5 +1,8 @@
+import { StorageSpaceDto } from '../storage/dto/storage-space.dto'
+
 export interface IMotionInteractorService {
   pauseDetectionIfActive: () => Promise<void>
   startDetectionIfNotActive: () => Promise<void>
-  pauseOrResumeDetectionDependingOnDiskSpaceUsageAndTemperature: () => Promise<void>
+  onStorageUsageSampled: (space: StorageSpaceDto) => Promise<void>
+  sampleTemperature: () => Promise<void>
 }
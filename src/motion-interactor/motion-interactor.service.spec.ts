@@ -16,12 +16,15 @@
  */
 import { ConfigService } from '@nestjs/config'
 import { Test, TestingModule } from '@nestjs/testing'
+import { Subject } from 'rxjs'
 import { vi } from 'vitest'
 import { MotionClientService } from '../motion-client.service'
 import { IMotionClientService } from '../motion-client.service.interface'
 import { PropertiesService } from '../properties/properties.service'
 import { SettingsModule } from '../settings/settings.module'
 import { SettingsService } from '../settings/settings.service'
+import { ISettingsService } from '../settings/settings.service.interface'
+import { StorageSpaceDto } from '../storage/dto/storage-space.dto'
 import { StorageModule } from '../storage/storage.module'
 import { StorageService } from '../storage/storage.service'
 import { MotionInteractorService } from './motion-interactor.service'
@@ -105,6 +108,106 @@ describe(MotionInteractorService.name, () => {
     },
   )
 
+  describe(
+    MotionInteractorService.prototype.onStorageUsageSampled.name,
+    () => {
+      const NOW = Date.now()
+
+      function sampleUsage(usedPercentage: number, timeMs: number) {
+        vi.spyOn(Date, 'now').mockReturnValue(timeMs)
+        return service.onStorageUsageSampled({
+          availableKb: 100 - usedPercentage,
+          capacityKb: 100,
+          usedPercentage,
+        })
+      }
+
+      it('pauses detection above the threshold', async () => {
+        spyIsDetectionStatusActive.mockResolvedValue(true)
+        await sampleUsage(90, NOW)
+        expect(spyPauseDetection).not.toHaveBeenCalled()
+        await sampleUsage(96, NOW + 60000)
+        expect(spyPauseDetection).toHaveBeenCalledTimes(1)
+      })
+
+      it('resumes detection only below the hysteresis band', async () => {
+        spyIsDetectionStatusActive.mockResolvedValue(false)
+        await sampleUsage(96, NOW)
+        await sampleUsage(94, NOW + 60000)
+        expect(spyStartDetection).not.toHaveBeenCalled()
+        await sampleUsage(92, NOW + 120000)
+        expect(spyStartDetection).toHaveBeenCalledTimes(1)
+      })
+
+      it('waits for the minimum dwell time', async () => {
+        spyIsDetectionStatusActive.mockResolvedValue(false)
+        await sampleUsage(96, NOW)
+        await sampleUsage(90, NOW + 30000)
+        expect(spyStartDetection).not.toHaveBeenCalled()
+      })
+
+      afterEach(() => {
+        vi.restoreAllMocks()
+        spyIsDetectionStatusActive.mockReset()
+        spyPauseDetection.mockReset()
+        spyStartDetection.mockReset()
+      })
+    },
+  )
+
+  describe('on a Raspberry Pi', () => {
+    class MockConfigService implements Partial<ConfigService> {
+      get = vi.fn((key: string, defaultValue?: unknown) =>
+        key === 'deviceType' ? 'RaspberryPi' : defaultValue,
+      )
+    }
+
+    class MockSettingsService implements Partial<ISettingsService> {
+      getTemperatureThreshold = vi.fn(() => Promise.resolve(5))
+      sampleTemperature = vi.fn(() =>
+        Promise.reject(new Error('No temperature sensor found')),
+      )
+    }
+
+    class MockStorageService implements Partial<StorageService> {
+      usageSampled$ = new Subject<StorageSpaceDto>()
+    }
+
+    let raspberryPiService: MotionInteractorService
+
+    beforeEach(async () => {
+      const module: TestingModule = await Test.createTestingModule({
+        providers: [
+          { provide: ConfigService, useClass: MockConfigService },
+          { provide: MotionClientService, useClass: MockMotionClientService },
+          { provide: SettingsService, useClass: MockSettingsService },
+          { provide: StorageService, useClass: MockStorageService },
+          MotionInteractorService,
+        ],
+      }).compile()
+
+      raspberryPiService = module.get<MotionInteractorService>(
+        MotionInteractorService,
+      )
+    })
+
+    it('pauses detection on a full disk without temperature', async () => {
+      spyIsDetectionStatusActive.mockResolvedValue(true)
+      await raspberryPiService.sampleTemperature()
+      await raspberryPiService.onStorageUsageSampled({
+        availableKb: 4,
+        capacityKb: 100,
+        usedPercentage: 96,
+      })
+      expect(spyPauseDetection).toHaveBeenCalledTimes(1)
+    })
+
+    afterEach(() => {
+      spyIsDetectionStatusActive.mockReset()
+      spyPauseDetection.mockReset()
+    })
+  })
+
   afterAll(() => {
     spyPauseDetection.mockRestore()
     spyStartDetection.mockRestore()
@@ -14,24 +14,91 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { Injectable, Logger } from '@nestjs/common'
+import {
+  Injectable,
+  Logger,
+  OnModuleDestroy,
+  OnModuleInit,
+  Optional,
+} from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
 import { Cron } from '@nestjs/schedule'
+import { Subscription } from 'rxjs'
 import { MotionClientService } from '../motion-client.service'
+import { NotificationsService } from '../notifications/notifications.service'
 import { SettingsService } from '../settings/settings.service'
-import { StorageService } from '../storage/storage.service'
+import { StorageSpaceDto } from '../storage/dto/storage-space.dto'
+import {
+  MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE,
+  StorageService,
+} from '../storage/storage.service'
+import { HysteresisBand, HysteresisGate } from './hysteresis-gate'
 import { IMotionInteractorService } from './motion-interactor.service.interface'
 
+const DEFAULT_MINIMUM_DWELL_SECONDS = 60
+const DEFAULT_DISK_SPACE_HYSTERESIS_PERCENTAGE = 2
+const DEFAULT_TEMPERATURE_HYSTERESIS_DEGREES = 1
+/**
+ * Detection can be paused or started behind the back of the gates, e.g. when
+ * Motion restarts, so the gated state is asserted again from time to time.
+ */
+const GATING_REASSERTION_INTERVAL_MS = 5 * 60 * 1000
+
+type GatingReason = 'diskSpace' | 'temperature'
+
 @Injectable()
-export class MotionInteractorService implements IMotionInteractorService {
+export class MotionInteractorService
+  implements IMotionInteractorService, OnModuleInit, OnModuleDestroy
+{
   private readonly logger = new Logger(MotionInteractorService.name)
+  private readonly gates = new Map<GatingReason, HysteresisGate>()
+  private readonly isRaspberryPi: boolean
+  private readonly minimumDwellMs: number
+  private readonly diskSpaceHysteresisPercentage: number
+  private readonly temperatureHysteresisDegrees: number
+  private gatingAppliedAtMs: number | null = null
+  private gatingUpdate = Promise.resolve()
+  private subscription: Subscription | null = null
 
   constructor(
     private readonly configService: ConfigService,
     private readonly motionClientService: MotionClientService,
     private readonly settingsService: SettingsService,
     private readonly storageService: StorageService,
-  ) {}
+    @Optional() private readonly notificationsService?: NotificationsService,
+  ) {
+    this.isRaspberryPi =
+      this.configService.get<string>('deviceType') === 'RaspberryPi'
+    this.minimumDwellMs =
+      this.configService.get<number>(
+        'detectionGateMinimumDwellSeconds',
+        DEFAULT_MINIMUM_DWELL_SECONDS,
+      ) * 1000
+    this.diskSpaceHysteresisPercentage = this.configService.get<number>(
+      'diskSpaceGateHysteresisPercentage',
+      DEFAULT_DISK_SPACE_HYSTERESIS_PERCENTAGE,
+    )
+    this.temperatureHysteresisDegrees = this.configService.get<number>(
+      'temperatureGateHysteresisDegrees',
+      DEFAULT_TEMPERATURE_HYSTERESIS_DEGREES,
+    )
+
+    this.gates.set('diskSpace', new HysteresisGate())
+    if (this.isRaspberryPi) {
+      // Reading the temperature is currently only supported on Raspberry Pi.
+      this.gates.set('temperature', new HysteresisGate(true))
+    }
+  }
+
+  onModuleInit() {
+    this.subscription = this.storageService.usageSampled$.subscribe((space) => {
+      this.onStorageUsageSampled(space)
+    })
+  }
+
+  onModuleDestroy() {
+    this.subscription?.unsubscribe()
+  }
 
   async pauseDetectionIfActive() {
     const isDetectionActive =
@@ -41,6 +108,9 @@ export class MotionInteractorService implements IMotionInteractorService {
       this.logger.log('Trying to pause detection...')
       await this.motionClientService.pauseDetection()
       this.logger.log('Detection paused!')
+      this.notificationsService?.publish('detectionChanged', {
+        isActive: false,
+      })
     }
   }
 
@@ -52,36 +122,94 @@ export class MotionInteractorService implements IMotionInteractorService {
       this.logger.log('Trying to start detection...')
       await this.motionClientService.startDetection()
       this.logger.log('Detection started!')
+      this.notificationsService?.publish('detectionChanged', {
+        isActive: true,
+      })
     }
   }
 
-  @Cron('*/5 * * * *') // every 5 minutes
-  async pauseOrResumeDetectionDependingOnDiskSpaceUsageAndTemperature() {
-    this.logger.log('Cron job to pause or resume detection triggered...')
+  onStorageUsageSampled(space: StorageSpaceDto): Promise<void> {
+    return this.updateGate('diskSpace', space.usedPercentage, {
+      engageThreshold: MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE,
+      releaseThreshold:
+        MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE -
+        this.diskSpaceHysteresisPercentage,
+      minimumDwellMs: this.minimumDwellMs,
+    })
+  }
 
-    const isDiskSpaceUsageAboveThreshold =
-      await this.storageService.isDiskSpaceUsageAboveThreshold()
-    this.logger.log(
-      `Disk space usage above threshold: ${isDiskSpaceUsageAboveThreshold}`,
+  @Cron('*/30 * * * * *') // every 30 seconds
+  async sampleTemperature(): Promise<void> {
+    if (!this.isRaspberryPi) {
+      return
+    }
+    let threshold: number
+    let temperature: number
+    try {
+      threshold = await this.settingsService.getTemperatureThreshold()
+      temperature = await this.settingsService.sampleTemperature()
+    } catch (error) {
+      this.logger.warn(`Temperature could not be sampled: ${error.message}`)
+      return
+    }
+    const isThresholdSet = typeof threshold === 'number'
+    // Without a threshold, an infinite sample releases the gate.
+    await this.updateGate(
+      'temperature',
+      isThresholdSet ? temperature : Infinity,
+      {
+        engageThreshold: isThresholdSet ? threshold : 0,
+        releaseThreshold: isThresholdSet
+          ? threshold + this.temperatureHysteresisDegrees
+          : 0,
+        minimumDwellMs: this.minimumDwellMs,
+      },
     )
+  }
 
-    const deviceType = this.configService.get<string>('deviceType')
-    let isTemperatureBelowThreshold = false
-    if (deviceType === 'RaspberryPi') {
-      // Reading the temperature is currently only supported on Raspberry Pi.
-      isTemperatureBelowThreshold =
-        await this.settingsService.isTemperatureBelowThreshold()
-      this.logger.log(
-        `Temperature below threshold: ${isTemperatureBelowThreshold}`,
-      )
+  private async updateGate(
+    reason: GatingReason,
+    value: number,
+    band: HysteresisBand,
+  ): Promise<void> {
+    const nowMs = Date.now()
+    const transition = this.gates.get(reason).update(value, band, nowMs)
+    if (transition) {
+      this.logger.log(`Detection gate ${reason} ${transition} at ${value}`)
+      this.gatingAppliedAtMs = null
     }
-
-    if (isDiskSpaceUsageAboveThreshold || isTemperatureBelowThreshold) {
-      await this.pauseDetectionIfActive()
-    } else {
-      await this.startDetectionIfNotActive()
+    if (
+      this.gatingAppliedAtMs === null ||
+      nowMs - this.gatingAppliedAtMs >= GATING_REASSERTION_INTERVAL_MS
+    ) {
+      await this.applyGates()
     }
+  }
 
-    this.logger.log('Cron job to pause or resume detection finished.')
+  /**
+   * Pauses detection as long as any gate is engaged. A gate without a sample
+   * yet, e.g. of a temperature sensor that cannot be read, counts as released
+   * so that it does not hold back the others. Calls are chained so that
+   * concurrent samples cannot interleave pausing and starting.
+   */
+  private applyGates(): Promise<void> {
+    this.gatingUpdate = this.gatingUpdate.then(async () => {
+      const gates = [...this.gates.values()]
+      if (gates.every((gate) => gate.getState() === undefined)) {
+        return
+      }
+      try {
+        if (gates.some((gate) => gate.isEngaged)) {
+          await this.pauseDetectionIfActive()
+        } else {
+          await this.startDetectionIfNotActive()
+        }
+        this.gatingAppliedAtMs = Date.now()
+      } catch (error) {
+        // Retried with the next sample.
+        this.logger.warn(`Detection gating failed: ${error.message}`)
+      }
+    })
+    return this.gatingUpdate
   }
 }
@@ -0,0 +1,37 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+export class MovieEncodingProfile {
+  name: string
+  /**
+   * x264 preset, slower ones produce smaller files for the same quality
+   */
+  preset: string
+  /**
+   * Constant rate factor of x264, higher values produce smaller files
+   */
+  crf: number
+  /**
+   * Encoder threads, 0 letting x264 use all cores
+   */
+  threads: number
+  /**
+   * Height to scale movies to, keeping the aspect ratio, or the one of Motion
+   */
+  height?: number
+}
+
+export type MovieEncodingSelection = 'auto' | string
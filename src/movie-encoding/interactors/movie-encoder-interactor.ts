@@ -0,0 +1,55 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { exec } from '../../metrics/measured-exec'
+import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
+
+/**
+ * Grain keeps the synthetic clip from compressing far better than real scenes.
+ */
+const NOISE_STRENGTH = 12
+
+export interface SyntheticClip {
+  width: number
+  height: number
+  framerate: number
+  durationSeconds: number
+}
+
+export class MovieEncoderInteractor {
+  /**
+   * Encodes a generated clip like Motion's pipe does and returns the output of
+   * ffmpeg, including the timing of its -benchmark option.
+   */
+  static async encodeSyntheticClip(
+    clip: SyntheticClip,
+    encoderArguments: string[],
+    outputPath: string,
+  ): Promise<string> {
+    CommandUnavailableOnWindowsException.throwIfOnWindows()
+    const source =
+      `testsrc2=size=${clip.width}x${clip.height}:rate=${clip.framerate}` +
+      `:duration=${clip.durationSeconds},noise=alls=${NOISE_STRENGTH}:allf=t`
+    const command = [
+      'ffmpeg -hide_banner -nostats -benchmark -y',
+      `-f lavfi -i "${source}" -pix_fmt yuv420p`,
+      ...encoderArguments,
+      `-f mp4 "${outputPath}"`,
+    ].join(' ')
+    const { stderr } = await exec(command)
+    return stderr
+  }
+}
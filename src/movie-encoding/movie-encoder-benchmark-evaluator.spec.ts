@@ -0,0 +1,101 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MovieEncoderBenchmarkResult } from './entities/movie-encoder-benchmark.entity'
+import { MovieEncoderBenchmarkEvaluator } from './movie-encoder-benchmark-evaluator'
+import { MovieEncodingProfiles } from './movie-encoding-profiles'
+
+describe(MovieEncoderBenchmarkEvaluator.name, () => {
+  const createResult = (
+    profile: string,
+    encodeSpeed: number,
+    bytesPerVideoSecond: number,
+  ): MovieEncoderBenchmarkResult => ({
+    profile,
+    encodeSpeed,
+    cpuUsagePercentage: 100,
+    bytesPerVideoSecond,
+    isRealTime: encodeSpeed >= 1.5,
+  })
+
+  describe(MovieEncoderBenchmarkEvaluator.parseTiming.name, () => {
+    it('reads CPU and wall times', () => {
+      const timing = MovieEncoderBenchmarkEvaluator.parseTiming(
+        'frame=  100 fps= 20\nbench: utime=3.500s stime=0.500s rtime=5.000s\nbench: maxrss=51200KiB\n',
+      )
+      expect(timing).toEqual({ cpuSeconds: 4, wallSeconds: 5 })
+    })
+
+    it('returns undefined without benchmark output', () => {
+      expect(MovieEncoderBenchmarkEvaluator.parseTiming('')).toBeUndefined()
+    })
+  })
+
+  describe(MovieEncoderBenchmarkEvaluator.evaluate.name, () => {
+    it('computes speed, CPU usage and bitrate', () => {
+      const result = MovieEncoderBenchmarkEvaluator.evaluate(
+        MovieEncodingProfiles.getDefault(),
+        { cpuSeconds: 8, wallSeconds: 4 },
+        2000000,
+        10,
+      )
+      expect(result).toEqual({
+        profile: 'fast',
+        encodeSpeed: 2.5,
+        cpuUsagePercentage: 200,
+        bytesPerVideoSecond: 200000,
+        isRealTime: true,
+      })
+    })
+
+    it('does not count as real time without margin', () => {
+      const result = MovieEncoderBenchmarkEvaluator.evaluate(
+        MovieEncodingProfiles.getDefault(),
+        { cpuSeconds: 8, wallSeconds: 8 },
+        2000000,
+        10,
+      )
+      expect(result.isRealTime).toBe(false)
+    })
+  })
+
+  describe(MovieEncoderBenchmarkEvaluator.recommend.name, () => {
+    it('picks the smallest output staying real time', () => {
+      const profile = MovieEncoderBenchmarkEvaluator.recommend([
+        createResult('fast', 4, 300000),
+        createResult('balanced', 2, 200000),
+        createResult('compact', 1.2, 150000),
+      ])
+      expect(profile).toBe('balanced')
+    })
+
+    it('ignores downscaling profiles', () => {
+      const profile = MovieEncoderBenchmarkEvaluator.recommend([
+        createResult('fast', 4, 300000),
+        createResult('reduced', 3, 100000),
+      ])
+      expect(profile).toBe('fast')
+    })
+
+    it('picks the fastest profile if none is real time', () => {
+      const profile = MovieEncoderBenchmarkEvaluator.recommend([
+        createResult('fast', 1.2, 300000),
+        createResult('balanced', 0.8, 200000),
+      ])
+      expect(profile).toBe('fast')
+    })
+  })
+})
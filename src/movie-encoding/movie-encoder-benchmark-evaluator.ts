@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MovieEncoderBenchmarkResult } from './entities/movie-encoder-benchmark.entity'
+import { MovieEncodingProfile } from './entities/movie-encoding-profile.entity'
+import { MovieEncodingProfiles } from './movie-encoding-profiles'
+
+/**
+ * Encoding has to be faster than real time by this factor to count as real
+ * time, so that detection keeps CPU time on busy nights.
+ */
+const REAL_TIME_SPEED_MARGIN = 1.5
+
+const BENCHMARK_LINE_REGEX =
+  /bench: utime=([\d.]+)s stime=([\d.]+)s rtime=([\d.]+)s/
+
+export interface EncoderTiming {
+  cpuSeconds: number
+  wallSeconds: number
+}
+
+export class MovieEncoderBenchmarkEvaluator {
+  /**
+   * Reads the timing that ffmpeg prints with its -benchmark option.
+   */
+  static parseTiming(output: string): EncoderTiming | undefined {
+    const match = BENCHMARK_LINE_REGEX.exec(output)
+    if (!match) {
+      return undefined
+    }
+    const [, userSeconds, systemSeconds, wallSeconds] = match.map(parseFloat)
+    return {
+      cpuSeconds: userSeconds + systemSeconds,
+      wallSeconds,
+    }
+  }
+
+  static evaluate(
+    profile: MovieEncodingProfile,
+    timing: EncoderTiming,
+    outputBytes: number,
+    durationSeconds: number,
+  ): MovieEncoderBenchmarkResult {
+    const encodeSpeed = durationSeconds / timing.wallSeconds
+    return {
+      profile: profile.name,
+      encodeSpeed: Math.round(encodeSpeed * 100) / 100,
+      cpuUsagePercentage: Math.round(
+        (timing.cpuSeconds / timing.wallSeconds) * 100,
+      ),
+      bytesPerVideoSecond: Math.round(outputBytes / durationSeconds),
+      isRealTime: encodeSpeed >= REAL_TIME_SPEED_MARGIN,
+    }
+  }
+
+  /**
+   * Picks the profile with the smallest output among those that stay real time
+   * at Motion's resolution, or the fastest one if none does. Downscaling
+   * profiles are only used when chosen explicitly.
+   */
+  static recommend(results: MovieEncoderBenchmarkResult[]): string {
+    const candidates = results.filter(
+      (result) => !MovieEncodingProfiles.find(result.profile)?.height,
+    )
+    const realTimeCandidates = candidates.filter((result) => result.isRealTime)
+    if (realTimeCandidates.length > 0) {
+      return realTimeCandidates.reduce((smallest, result) =>
+        result.bytesPerVideoSecond < smallest.bytesPerVideoSecond
+          ? result
+          : smallest,
+      ).profile
+    }
+    if (candidates.length > 0) {
+      return candidates.reduce((fastest, result) =>
+        result.encodeSpeed > fastest.encodeSpeed ? result : fastest,
+      ).profile
+    }
+    return MovieEncodingProfiles.getDefault().name
+  }
+}
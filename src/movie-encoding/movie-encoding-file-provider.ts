@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { readFile, writeFile } from 'fs/promises'
+import { MovieEncoderBenchmark } from './entities/movie-encoder-benchmark.entity'
+import { MovieEncodingSelection } from './entities/movie-encoding-profile.entity'
+import { AUTOMATIC_MOVIE_ENCODING_SELECTION } from './movie-encoding-profiles'
+
+const JSON_INDENTATION_SPACES = 2
+
+export class MovieEncodingFileProvider {
+  static async readSelection(
+    filePath: string,
+  ): Promise<MovieEncodingSelection> {
+    const data = await this.readJson(filePath)
+    return data?.selection ?? AUTOMATIC_MOVIE_ENCODING_SELECTION
+  }
+
+  static async writeSelection(
+    selection: MovieEncodingSelection,
+    filePath: string,
+  ): Promise<void> {
+    const data = JSON.stringify({ selection }, null, JSON_INDENTATION_SPACES)
+    await writeFile(filePath, data)
+  }
+
+  static async readBenchmark(
+    filePath: string,
+  ): Promise<MovieEncoderBenchmark | undefined> {
+    const data = await this.readJson(filePath)
+    if (!data) {
+      return undefined
+    }
+    return { ...data, time: new Date(data.time) }
+  }
+
+  static async writeBenchmark(
+    benchmark: MovieEncoderBenchmark,
+    filePath: string,
+  ): Promise<void> {
+    const data = JSON.stringify(benchmark, null, JSON_INDENTATION_SPACES)
+    await writeFile(filePath, data)
+  }
+
+  /**
+   * Writes the options for encode-movie.sh, which Motion runs for each movie.
+   */
+  static async writeEncoderArguments(
+    encoderArguments: string[],
+    filePath: string,
+  ): Promise<void> {
+    await writeFile(filePath, encoderArguments.join(' ') + '\n')
+  }
+
+  private static async readJson(filePath: string) {
+    try {
+      const data = await readFile(filePath)
+      return JSON.parse(data.toString())
+    } catch (err) {
+      if (err.code !== 'ENOENT' && err.name !== 'SyntaxError') {
+        throw err
+      }
+      return undefined
+    }
+  }
+}
@@ -0,0 +1,68 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  AUTOMATIC_MOVIE_ENCODING_SELECTION,
+  MOVIE_ENCODING_PROFILES,
+  MOVIE_ENCODING_SELECTIONS,
+  MovieEncodingProfiles,
+} from './movie-encoding-profiles'
+
+describe(MovieEncodingProfiles.name, () => {
+  it('offers automatic selection and every profile', () => {
+    expect(MOVIE_ENCODING_SELECTIONS).toEqual([
+      AUTOMATIC_MOVIE_ENCODING_SELECTION,
+      'fast',
+      'balanced',
+      'compact',
+      'reduced',
+    ])
+  })
+
+  describe(MovieEncodingProfiles.find.name, () => {
+    it('finds a profile by name', () => {
+      expect(MovieEncodingProfiles.find('compact')).toBe(
+        MOVIE_ENCODING_PROFILES[2],
+      )
+    })
+
+    it('returns undefined for an unknown name', () => {
+      expect(MovieEncodingProfiles.find('auto')).toBeUndefined()
+    })
+  })
+
+  describe(MovieEncodingProfiles.buildEncoderArguments.name, () => {
+    it('keeps the former pipe for the default profile', () => {
+      const encoderArguments = MovieEncodingProfiles.buildEncoderArguments(
+        MovieEncodingProfiles.getDefault(),
+      )
+      expect(encoderArguments.join(' ')).toBe(
+        '-vcodec libx264 -preset ultrafast -crf 23 -threads 0',
+      )
+    })
+
+    it('scales to the height of the profile', () => {
+      const encoderArguments = MovieEncodingProfiles.buildEncoderArguments({
+        name: 'a',
+        preset: 'veryfast',
+        crf: 25,
+        threads: 2,
+        height: 720,
+      })
+      expect(encoderArguments.slice(-2)).toEqual(['-vf', 'scale=-2:720'])
+    })
+  })
+})
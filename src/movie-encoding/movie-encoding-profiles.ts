@@ -0,0 +1,64 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MovieEncodingProfile } from './entities/movie-encoding-profile.entity'
+
+export const AUTOMATIC_MOVIE_ENCODING_SELECTION = 'auto'
+
+export const MOVIE_ENCODING_PROFILES: MovieEncodingProfile[] = [
+  // Same output as the former fixed pipe in motion.conf.
+  { name: 'fast', preset: 'ultrafast', crf: 23, threads: 0 },
+  { name: 'balanced', preset: 'superfast', crf: 25, threads: 2 },
+  { name: 'compact', preset: 'veryfast', crf: 27, threads: 2 },
+  { name: 'reduced', preset: 'veryfast', crf: 25, threads: 2, height: 720 },
+]
+
+export const MOVIE_ENCODING_SELECTIONS = [
+  AUTOMATIC_MOVIE_ENCODING_SELECTION,
+  ...MOVIE_ENCODING_PROFILES.map((profile) => profile.name),
+]
+
+export class MovieEncodingProfiles {
+  static find(name: string): MovieEncodingProfile | undefined {
+    return MOVIE_ENCODING_PROFILES.find((profile) => profile.name === name)
+  }
+
+  static getDefault(): MovieEncodingProfile {
+    return MOVIE_ENCODING_PROFILES[0]
+  }
+
+  /**
+   * Returns the output options of ffmpeg, to be placed between the raw input
+   * that Motion pipes and the MP4 output.
+   */
+  static buildEncoderArguments(profile: MovieEncodingProfile): string[] {
+    const encoderArguments = [
+      '-vcodec',
+      'libx264',
+      '-preset',
+      profile.preset,
+      '-crf',
+      profile.crf.toString(),
+      '-threads',
+      profile.threads.toString(),
+    ]
+    if (profile.height) {
+      // -2 keeps the width even, as required by yuv420p.
+      encoderArguments.push('-vf', `scale=-2:${profile.height}`)
+    }
+    return encoderArguments
+  }
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { NotFoundException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { MovieEncoderBenchmark } from './entities/movie-encoder-benchmark.entity'
+import {
+  MOVIE_ENCODING_PROFILES,
+  MovieEncodingProfiles,
+} from './movie-encoding-profiles'
+import { MovieEncodingController } from './movie-encoding.controller'
+import { MovieEncodingService } from './movie-encoding.service'
+import { IMovieEncodingService } from './movie-encoding.service.interface'
+
+describe(MovieEncodingController.name, () => {
+  const BENCHMARK = { recommendedProfile: 'fast' } as MovieEncoderBenchmark
+
+  class MockMovieEncodingService implements Partial<IMovieEncodingService> {
+    getProfiles = vi.fn(() => MOVIE_ENCODING_PROFILES)
+    getSelection = vi.fn(() => Promise.resolve('auto'))
+    getActiveProfile = vi.fn(() =>
+      Promise.resolve(MovieEncodingProfiles.getDefault()),
+    )
+    getBenchmark = vi.fn(() => Promise.resolve(BENCHMARK))
+    runBenchmark = vi.fn(() => Promise.resolve(BENCHMARK))
+  }
+
+  let controller: MovieEncodingController
+  let service: MockMovieEncodingService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [MovieEncodingController],
+      providers: [
+        { provide: MovieEncodingService, useClass: MockMovieEncodingService },
+      ],
+    }).compile()
+
+    controller = module.get<MovieEncodingController>(MovieEncodingController)
+    service = module.get(MovieEncodingService)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(MovieEncodingController.prototype.getMovieEncoding.name, () => {
+    it('returns the selection and the active profile', async () => {
+      expect(await controller.getMovieEncoding()).toEqual({
+        selection: 'auto',
+        activeProfile: MovieEncodingProfiles.getDefault(),
+      })
+    })
+  })
+
+  describe(MovieEncodingController.prototype.getProfiles.name, () => {
+    it('returns the profiles', () => {
+      expect(controller.getProfiles()).toBe(MOVIE_ENCODING_PROFILES)
+    })
+  })
+
+  describe(MovieEncodingController.prototype.getBenchmark.name, () => {
+    it('returns the last benchmark', async () => {
+      expect(await controller.getBenchmark()).toBe(BENCHMARK)
+    })
+
+    it('throws when no benchmark was run', async () => {
+      service.getBenchmark.mockResolvedValue(undefined)
+      await expect(controller.getBenchmark()).rejects.toThrow(
+        NotFoundException,
+      )
+    })
+  })
+
+  describe(MovieEncodingController.prototype.runBenchmark.name, () => {
+    it('runs the benchmark', async () => {
+      expect(await controller.runBenchmark()).toBe(BENCHMARK)
+      expect(service.runBenchmark).toHaveBeenCalled()
+    })
+  })
+})
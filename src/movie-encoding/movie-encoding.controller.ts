@@ -0,0 +1,54 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Controller, Get, NotFoundException, Post } from '@nestjs/common'
+import { MovieEncodingDto } from './dto/movie-encoding.dto'
+import { MovieEncoderBenchmark } from './entities/movie-encoder-benchmark.entity'
+import { MovieEncodingProfile } from './entities/movie-encoding-profile.entity'
+import { MovieEncodingService } from './movie-encoding.service'
+
+@Controller('movie-encoding')
+export class MovieEncodingController {
+  constructor(private readonly movieEncodingService: MovieEncodingService) {}
+
+  @Get()
+  async getMovieEncoding(): Promise<MovieEncodingDto> {
+    const [selection, activeProfile] = await Promise.all([
+      this.movieEncodingService.getSelection(),
+      this.movieEncodingService.getActiveProfile(),
+    ])
+    return { selection, activeProfile }
+  }
+
+  @Get('profiles')
+  getProfiles(): MovieEncodingProfile[] {
+    return this.movieEncodingService.getProfiles()
+  }
+
+  @Get('benchmark')
+  async getBenchmark(): Promise<MovieEncoderBenchmark> {
+    const benchmark = await this.movieEncodingService.getBenchmark()
+    if (!benchmark) {
+      throw new NotFoundException('The encoder has not been benchmarked yet.')
+    }
+    return benchmark
+  }
+
+  @Post('benchmark')
+  runBenchmark(): Promise<MovieEncoderBenchmark> {
+    return this.movieEncodingService.runBenchmark()
+  }
+}
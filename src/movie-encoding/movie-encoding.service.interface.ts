@@ -0,0 +1,14 @@
+import { MovieEncoderBenchmark } from './entities/movie-encoder-benchmark.entity'
+import {
+  MovieEncodingProfile,
+  MovieEncodingSelection,
+} from './entities/movie-encoding-profile.entity'
+
+export interface IMovieEncodingService {
+  getProfiles: () => MovieEncodingProfile[]
+  getSelection: () => Promise<MovieEncodingSelection>
+  getActiveProfile: () => Promise<MovieEncodingProfile>
+  select: (selection: MovieEncodingSelection) => Promise<void>
+  getBenchmark: () => Promise<MovieEncoderBenchmark | undefined>
+  runBenchmark: () => Promise<MovieEncoderBenchmark>
+}
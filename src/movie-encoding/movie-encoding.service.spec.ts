@@ -0,0 +1,175 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { writeFile } from 'fs/promises'
+import { Test, TestingModule } from '@nestjs/testing'
+import { Mock, vi } from 'vitest'
+import { MotionClientService } from '../motion-client.service'
+import { IMotionClientService } from '../motion-client.service.interface'
+import { MovieEncoderBenchmark } from './entities/movie-encoder-benchmark.entity'
+import { MovieEncoderInteractor } from './interactors/movie-encoder-interactor'
+import { MovieEncodingFileProvider } from './movie-encoding-file-provider'
+import { MOVIE_ENCODING_PROFILES } from './movie-encoding-profiles'
+import { MovieEncodingService } from './movie-encoding.service'
+
+describe(MovieEncodingService.name, () => {
+  // Wall seconds and output bytes of the synthetic clip per preset
+  const ENCODING_OUTCOMES = {
+    ultrafast: { wallSeconds: 2, bytes: 3000 },
+    superfast: { wallSeconds: 5, bytes: 2000 },
+    veryfast: { wallSeconds: 8, bytes: 1000 },
+  }
+
+  class MockMotionClientService implements Partial<IMotionClientService> {
+    getFramerate = () => Promise.resolve(10)
+    getHeight = () => Promise.resolve(1080)
+    getWidth = () => Promise.resolve(1920)
+  }
+
+  let service: MovieEncodingService
+  let spyEncodeSyntheticClip: Mock
+  let spyReadBenchmark: Mock
+  let spyReadSelection: Mock
+  let spyWriteBenchmark: Mock
+  let spyWriteEncoderArguments: Mock
+  let spyWriteSelection: Mock
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: MotionClientService, useClass: MockMotionClientService },
+        MovieEncodingService,
+      ],
+    }).compile()
+
+    service = module.get<MovieEncodingService>(MovieEncodingService)
+    spyEncodeSyntheticClip = vi
+      .spyOn(MovieEncoderInteractor, 'encodeSyntheticClip')
+      .mockImplementation(async (clip, encoderArguments, outputPath) => {
+        const preset = encoderArguments[encoderArguments.indexOf('-preset') + 1]
+        const { wallSeconds, bytes } = ENCODING_OUTCOMES[preset]
+        await writeFile(outputPath, Buffer.alloc(bytes))
+        return `bench: utime=${wallSeconds}.000s stime=0.000s rtime=${wallSeconds}.000s\n`
+      })
+    spyReadBenchmark = vi
+      .spyOn(MovieEncodingFileProvider, 'readBenchmark')
+      .mockResolvedValue(undefined)
+    spyReadSelection = vi
+      .spyOn(MovieEncodingFileProvider, 'readSelection')
+      .mockResolvedValue('auto')
+    spyWriteBenchmark = vi
+      .spyOn(MovieEncodingFileProvider, 'writeBenchmark')
+      .mockResolvedValue()
+    spyWriteEncoderArguments = vi
+      .spyOn(MovieEncodingFileProvider, 'writeEncoderArguments')
+      .mockResolvedValue()
+    spyWriteSelection = vi
+      .spyOn(MovieEncodingFileProvider, 'writeSelection')
+      .mockResolvedValue()
+  })
+
+  afterEach(() => {
+    vi.restoreAllMocks()
+  })
+
+  it('should be defined', () => {
+    expect(service).toBeDefined()
+  })
+
+  describe(MovieEncodingService.resolveProfile.name, () => {
+    const BENCHMARK = {
+      recommendedProfile: 'compact',
+    } as MovieEncoderBenchmark
+
+    it('uses the recommendation for automatic selection', () => {
+      const profile = MovieEncodingService.resolveProfile('auto', BENCHMARK)
+      expect(profile.name).toBe('compact')
+    })
+
+    it('uses the default profile without benchmark', () => {
+      const profile = MovieEncodingService.resolveProfile('auto', undefined)
+      expect(profile.name).toBe('fast')
+    })
+
+    it('uses a selected profile', () => {
+      const profile = MovieEncodingService.resolveProfile('reduced', BENCHMARK)
+      expect(profile.name).toBe('reduced')
+    })
+  })
+
+  describe(MovieEncodingService.prototype.select.name, () => {
+    it('stores the selection and the arguments of its profile', async () => {
+      spyReadSelection.mockResolvedValue('balanced')
+      await service.select('balanced')
+      expect(spyWriteSelection).toHaveBeenCalledWith(
+        'balanced',
+        expect.any(String),
+      )
+      expect(spyWriteEncoderArguments.mock.calls[0][0].join(' ')).toContain(
+        '-preset superfast',
+      )
+    })
+  })
+
+  describe(MovieEncodingService.prototype.runBenchmark.name, () => {
+    it('encodes with each profile and recommends one', async () => {
+      const benchmark = await service.runBenchmark()
+      expect(spyEncodeSyntheticClip).toHaveBeenCalledTimes(
+        MOVIE_ENCODING_PROFILES.length,
+      )
+      expect(spyEncodeSyntheticClip.mock.calls[0][0]).toEqual({
+        width: 1920,
+        height: 1080,
+        framerate: 10,
+        durationSeconds: 10,
+      })
+      expect(benchmark.results[0]).toEqual({
+        profile: 'fast',
+        encodeSpeed: 5,
+        cpuUsagePercentage: 100,
+        bytesPerVideoSecond: 300,
+        isRealTime: true,
+      })
+      // compact is the smallest but not fast enough, reduced is downscaled.
+      expect(benchmark.recommendedProfile).toBe('balanced')
+      expect(spyWriteBenchmark).toHaveBeenCalledWith(
+        benchmark,
+        expect.any(String),
+      )
+    })
+
+    it('applies the recommendation when selected automatically', async () => {
+      spyReadBenchmark.mockImplementation(
+        async () => spyWriteBenchmark.mock.calls[0]?.[0],
+      )
+      await service.runBenchmark()
+      expect(spyWriteEncoderArguments.mock.calls[0][0].join(' ')).toContain(
+        '-preset superfast',
+      )
+    })
+
+    it('runs only once at a time', async () => {
+      const [first, second] = await Promise.all([
+        service.runBenchmark(),
+        service.runBenchmark(),
+      ])
+      expect(first).toBe(second)
+      expect(spyEncodeSyntheticClip).toHaveBeenCalledTimes(
+        MOVIE_ENCODING_PROFILES.length,
+      )
+    })
+  })
+})
@@ -0,0 +1,183 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { rm, stat } from 'fs/promises'
+import os from 'os'
+import path from 'path'
+import { Injectable, Logger } from '@nestjs/common'
+import { MotionClientService } from '../motion-client.service'
+import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
+import {
+  MovieEncoderBenchmark,
+  MovieEncoderBenchmarkResult,
+} from './entities/movie-encoder-benchmark.entity'
+import {
+  MovieEncodingProfile,
+  MovieEncodingSelection,
+} from './entities/movie-encoding-profile.entity'
+import { MovieEncoderInteractor } from './interactors/movie-encoder-interactor'
+import { MovieEncoderBenchmarkEvaluator } from './movie-encoder-benchmark-evaluator'
+import { MovieEncodingFileProvider } from './movie-encoding-file-provider'
+import {
+  AUTOMATIC_MOVIE_ENCODING_SELECTION,
+  MOVIE_ENCODING_PROFILES,
+  MovieEncodingProfiles,
+} from './movie-encoding-profiles'
+import { IMovieEncodingService } from './movie-encoding.service.interface'
+
+const SELECTION_FILE_PATH = 'movie-encoding.json'
+const BENCHMARK_FILE_PATH = 'movie-encoder-benchmark.json'
+const ENCODER_ARGUMENTS_FILE_PATH = 'movie-encoder.args'
+const BENCHMARK_CLIP_DURATION_SECONDS = 10
+const BENCHMARK_OUTPUT_FILENAME = 'movie-encoder-benchmark.mp4'
+
+@Injectable()
+export class MovieEncodingService implements IMovieEncodingService {
+  private readonly logger = new Logger(MovieEncodingService.name)
+  private pendingUpdate: Promise<unknown> = Promise.resolve()
+  private runningBenchmark?: Promise<MovieEncoderBenchmark>
+
+  constructor(private readonly motionClientService: MotionClientService) {}
+
+  getProfiles(): MovieEncodingProfile[] {
+    return MOVIE_ENCODING_PROFILES
+  }
+
+  getSelection(): Promise<MovieEncodingSelection> {
+    return MovieEncodingFileProvider.readSelection(SELECTION_FILE_PATH)
+  }
+
+  async getActiveProfile(): Promise<MovieEncodingProfile> {
+    const [selection, benchmark] = await Promise.all([
+      this.getSelection(),
+      this.getBenchmark(),
+    ])
+    return MovieEncodingService.resolveProfile(selection, benchmark)
+  }
+
+  select(selection: MovieEncodingSelection): Promise<void> {
+    return this.chainUpdate(async () => {
+      await MovieEncodingFileProvider.writeSelection(
+        selection,
+        SELECTION_FILE_PATH,
+      )
+      await this.writeEncoderArguments()
+    })
+  }
+
+  getBenchmark(): Promise<MovieEncoderBenchmark | undefined> {
+    return MovieEncodingFileProvider.readBenchmark(BENCHMARK_FILE_PATH)
+  }
+
+  runBenchmark(): Promise<MovieEncoderBenchmark> {
+    // Concurrent runs would slow each other down and distort the results.
+    if (!this.runningBenchmark) {
+      this.runningBenchmark = this.benchmark().finally(() => {
+        this.runningBenchmark = undefined
+      })
+    }
+    return this.runningBenchmark
+  }
+
+  static resolveProfile(
+    selection: MovieEncodingSelection,
+    benchmark: MovieEncoderBenchmark | undefined,
+  ): MovieEncodingProfile {
+    const name =
+      selection === AUTOMATIC_MOVIE_ENCODING_SELECTION
+        ? benchmark?.recommendedProfile
+        : selection
+    return (
+      MovieEncodingProfiles.find(name) ?? MovieEncodingProfiles.getDefault()
+    )
+  }
+
+  private async benchmark(): Promise<MovieEncoderBenchmark> {
+    const [width, height, framerate] = await Promise.all([
+      this.motionClientService.getWidth(),
+      this.motionClientService.getHeight(),
+      this.motionClientService.getFramerate(),
+    ])
+    const clip = {
+      width,
+      height,
+      framerate,
+      durationSeconds: BENCHMARK_CLIP_DURATION_SECONDS,
+    }
+    const outputPath = path.join(os.tmpdir(), BENCHMARK_OUTPUT_FILENAME)
+    const results: MovieEncoderBenchmarkResult[] = []
+    try {
+      for (const profile of MOVIE_ENCODING_PROFILES) {
+        this.logger.log(`Benchmarking movie encoding profile ${profile.name}`)
+        const output = await MovieEncoderInteractor.encodeSyntheticClip(
+          clip,
+          MovieEncodingProfiles.buildEncoderArguments(profile),
+          outputPath,
+        )
+        const timing = MovieEncoderBenchmarkEvaluator.parseTiming(output)
+        if (!timing) {
+          throw new CommandExecutionException(
+            `No benchmark timing in the output of ffmpeg: ${output}`,
+          )
+        }
+        const { size } = await stat(outputPath)
+        results.push(
+          MovieEncoderBenchmarkEvaluator.evaluate(
+            profile,
+            timing,
+            size,
+            clip.durationSeconds,
+          ),
+        )
+      }
+    } finally {
+      await rm(outputPath, { force: true })
+    }
+
+    const benchmark: MovieEncoderBenchmark = {
+      time: new Date(),
+      ...clip,
+      results,
+      recommendedProfile: MovieEncoderBenchmarkEvaluator.recommend(results),
+    }
+    await this.chainUpdate(async () => {
+      await MovieEncodingFileProvider.writeBenchmark(
+        benchmark,
+        BENCHMARK_FILE_PATH,
+      )
+      await this.writeEncoderArguments()
+    })
+    this.logger.log(
+      `Movie encoding benchmark recommends profile ${benchmark.recommendedProfile}`,
+    )
+    return benchmark
+  }
+
+  private chainUpdate(update: () => Promise<void>): Promise<void> {
+    const chainedUpdate = this.pendingUpdate.then(update)
+    this.pendingUpdate = chainedUpdate.catch(() => undefined)
+    return chainedUpdate
+  }
+
+  private async writeEncoderArguments(): Promise<void> {
+    const profile = await this.getActiveProfile()
+    await MovieEncodingFileProvider.writeEncoderArguments(
+      MovieEncodingProfiles.buildEncoderArguments(profile),
+      ENCODER_ARGUMENTS_FILE_PATH,
+    )
+    this.logger.log(`Movies are encoded with profile ${profile.name}`)
+  }
+}
@@ -0,0 +1,46 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+export interface NotificationPayloads {
+  detectionChanged: { isActive: boolean }
+  integrityVerified: {
+    mismatchedCount: number
+    unreadableCount: number
+    missingCount: number
+  }
+  lightChanged: { light: string }
+  // Sent instead of the missed notifications when they are not buffered
+  // anymore, so that the client reloads its state.
+  resync: Record<string, never>
+  sensorSampled: { sensor: string; value: number }
+  shotCreated: { name: string; sizeBytes: number; creationTime: string }
+  shotDeleted: { name: string }
+  storageThresholdCrossed: {
+    thresholdPercentage: number
+    usedPercentage: number
+    isAbove: boolean
+  }
+  triggeringChanged: { isActive: boolean }
+}
+
+export type NotificationType = keyof NotificationPayloads
+
+export interface Notification<T extends NotificationType = NotificationType> {
+  id: string
+  type: T
+  time: string
+  data: NotificationPayloads[T]
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Test, TestingModule } from '@nestjs/testing'
+import { firstValueFrom, of } from 'rxjs'
+import { vi } from 'vitest'
+import { NotificationsController } from './notifications.controller'
+import { NotificationsService } from './notifications.service'
+import { INotificationsService } from './notifications.service.interface'
+
+describe(NotificationsController.name, () => {
+  const spyGetNotifications = vi.fn<
+    INotificationsService['getNotifications']
+  >(() =>
+    of({
+      id: 'abc-2',
+      type: 'shotDeleted',
+      time: '2024-01-01T00:00:00.000Z',
+      data: { name: 'a.jpg' },
+    }),
+  )
+
+  class MockNotificationsService implements Partial<INotificationsService> {
+    getNotifications = spyGetNotifications
+  }
+
+  let controller: NotificationsController
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [NotificationsController],
+      providers: [
+        { provide: NotificationsService, useClass: MockNotificationsService },
+      ],
+    }).compile()
+
+    controller = module.get<NotificationsController>(NotificationsController)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(NotificationsController.prototype.getNotifications.name, () => {
+    it('turns notifications into server-sent events', async () => {
+      const event = await firstValueFrom(controller.getNotifications())
+      expect(event).toEqual({
+        id: 'abc-2',
+        type: 'shotDeleted',
+        data: { time: '2024-01-01T00:00:00.000Z', name: 'a.jpg' },
+      })
+    })
+
+    it('prefers the Last-Event-ID header over the query', async () => {
+      await firstValueFrom(controller.getNotifications('abc-1', 'abc-0'))
+      expect(spyGetNotifications).toHaveBeenLastCalledWith('abc-1')
+    })
+
+    it('resumes from the query without the header', async () => {
+      await firstValueFrom(controller.getNotifications(undefined, 'abc-0'))
+      expect(spyGetNotifications).toHaveBeenLastCalledWith('abc-0')
+    })
+  })
+})
@@ -0,0 +1,49 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Controller, Headers, MessageEvent, Query, Sse } from '@nestjs/common'
+import { interval, map, merge, Observable } from 'rxjs'
+import { NotificationsService } from './notifications.service'
+
+// Keeps idle connections open through the access point and proxies.
+const HEARTBEAT_INTERVAL_MILLISECONDS = 20000
+
+@Controller('notifications')
+export class NotificationsController {
+  constructor(private readonly notificationsService: NotificationsService) {}
+
+  // Browsers send the Last-Event-ID header when reconnecting on their own,
+  // while the query parameter allows resuming after a page reload.
+  @Sse()
+  getNotifications(
+    @Headers('last-event-id') lastEventIdHeader?: string,
+    @Query('lastEventId') lastEventIdQuery?: string,
+  ): Observable<MessageEvent> {
+    const notifications = this.notificationsService
+      .getNotifications(lastEventIdHeader ?? lastEventIdQuery)
+      .pipe(
+        map((notification) => ({
+          id: notification.id,
+          type: notification.type,
+          data: { time: notification.time, ...notification.data },
+        })),
+      )
+    const heartbeats = interval(HEARTBEAT_INTERVAL_MILLISECONDS).pipe(
+      map(() => ({ type: 'heartbeat', data: {} })),
+    )
+    return merge(notifications, heartbeats)
+  }
+}
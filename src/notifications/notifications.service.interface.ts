@@ -0,0 +1,14 @@
+import { Observable } from 'rxjs'
+import {
+  Notification,
+  NotificationPayloads,
+  NotificationType,
+} from './entities/notification.entity'
+
+export interface INotificationsService {
+  publish: <T extends NotificationType>(
+    type: T,
+    data: NotificationPayloads[T],
+  ) => void
+  getNotifications: (lastEventId?: string) => Observable<Notification>
+}
@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Test, TestingModule } from '@nestjs/testing'
+import { firstValueFrom, Subscription, take, toArray } from 'rxjs'
+import { Notification } from './entities/notification.entity'
+import { NotificationsService } from './notifications.service'
+
+describe(NotificationsService.name, () => {
+  let service: NotificationsService
+  let subscription: Subscription
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [NotificationsService],
+    }).compile()
+
+    service = module.get<NotificationsService>(NotificationsService)
+  })
+
+  it('should be defined', () => {
+    expect(service).toBeDefined()
+  })
+
+  describe(NotificationsService.prototype.getNotifications.name, () => {
+    it('emits published notifications', () => {
+      const received: Notification[] = []
+      subscription = service
+        .getNotifications()
+        .subscribe((notification) => received.push(notification))
+      service.publish('shotDeleted', { name: 'a.jpg' })
+      expect(received).toEqual([
+        {
+          id: expect.stringMatching(/^\w+-1$/),
+          type: 'shotDeleted',
+          time: expect.any(String),
+          data: { name: 'a.jpg' },
+        },
+      ])
+    })
+
+    it('replays the notifications after the last seen one', async () => {
+      const ids: string[] = []
+      subscription = service
+        .getNotifications()
+        .subscribe((notification) => ids.push(notification.id))
+      service.publish('detectionChanged', { isActive: false })
+      service.publish('detectionChanged', { isActive: true })
+      service.publish('shotDeleted', { name: 'a.jpg' })
+      const replayed = await firstValueFrom(
+        service.getNotifications(ids[0]).pipe(take(2), toArray()),
+      )
+      expect(replayed.map((notification) => notification.id)).toEqual([
+        ids[1],
+        ids[2],
+      ])
+    })
+
+    it('asks to resync for an ID of another process', async () => {
+      service.publish('shotDeleted', { name: 'a.jpg' })
+      const notification = await firstValueFrom(
+        service.getNotifications('abc-1'),
+      )
+      expect(notification.type).toBe('resync')
+    })
+
+    it('asks to resync if missed notifications are not buffered', async () => {
+      const ids: string[] = []
+      subscription = service
+        .getNotifications()
+        .subscribe((notification) => ids.push(notification.id))
+      for (let i = 0; i < 300; i++) {
+        service.publish('sensorSampled', { sensor: 'temperature', value: i })
+      }
+      const notification = await firstValueFrom(
+        service.getNotifications(ids[0]),
+      )
+      expect(notification).toEqual(
+        expect.objectContaining({ id: ids[299], type: 'resync' }),
+      )
+    })
+
+    it('tells sources that a client subscribed', () => {
+      let subscribedCount = 0
+      service.subscribed$.subscribe(() => subscribedCount++)
+      subscription = service.getNotifications().subscribe()
+      expect(subscribedCount).toBe(1)
+    })
+  })
+
+  afterEach(() => {
+    subscription?.unsubscribe()
+    subscription = undefined
+  })
+})
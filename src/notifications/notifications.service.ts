@@ -0,0 +1,119 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Injectable } from '@nestjs/common'
+import { concat, defer, from, Observable, of, Subject } from 'rxjs'
+import {
+  Notification,
+  NotificationPayloads,
+  NotificationType,
+} from './entities/notification.entity'
+import { INotificationsService } from './notifications.service.interface'
+
+const BUFFERED_NOTIFICATION_COUNT = 256
+
+/**
+ * Fans notifications out to all connected clients. The latest ones are kept
+ * in a ring buffer so that a client reconnecting with the ID of the last
+ * notification it saw gets the missed ones replayed. IDs are prefixed with
+ * the start time of the process, so that IDs from before a restart are never
+ * mistaken for current ones.
+ */
+@Injectable()
+export class NotificationsService implements INotificationsService {
+  // Emits whenever a client subscribes, so that sources can start following.
+  readonly subscribed$ = new Subject<void>()
+  private readonly notifications$ = new Subject<Notification>()
+  private readonly buffer: Notification[] = new Array(
+    BUFFERED_NOTIFICATION_COUNT,
+  )
+  private readonly epoch = Date.now().toString(36)
+  private lastSequenceNumber = 0
+
+  publish<T extends NotificationType>(
+    type: T,
+    data: NotificationPayloads[T],
+  ): void {
+    this.lastSequenceNumber++
+    const notification: Notification<T> = {
+      id: this.formatId(this.lastSequenceNumber),
+      type,
+      time: new Date().toISOString(),
+      data,
+    }
+    const bufferIndex = this.lastSequenceNumber % BUFFERED_NOTIFICATION_COUNT
+    this.buffer[bufferIndex] = notification
+    this.notifications$.next(notification)
+  }
+
+  getNotifications(lastEventId?: string): Observable<Notification> {
+    // Deferred so that the replay and the live subscription happen in the
+    // same tick, without any notification published in between.
+    return defer(() => {
+      this.subscribed$.next()
+      return concat(
+        this.getMissedNotifications(lastEventId),
+        this.notifications$,
+      )
+    })
+  }
+
+  private getMissedNotifications(
+    lastEventId: string | undefined,
+  ): Observable<Notification> {
+    if (lastEventId === undefined) {
+      return from([])
+    }
+    const lastSeenSequenceNumber = this.parseId(lastEventId)
+    const oldestBufferedSequenceNumber = Math.max(
+      1,
+      this.lastSequenceNumber - BUFFERED_NOTIFICATION_COUNT + 1,
+    )
+    if (
+      lastSeenSequenceNumber === null ||
+      lastSeenSequenceNumber > this.lastSequenceNumber ||
+      lastSeenSequenceNumber + 1 < oldestBufferedSequenceNumber
+    ) {
+      return of({
+        id: this.formatId(this.lastSequenceNumber),
+        type: 'resync',
+        time: new Date().toISOString(),
+        data: {},
+      })
+    }
+    const missed: Notification[] = []
+    for (
+      let sequenceNumber = lastSeenSequenceNumber + 1;
+      sequenceNumber <= this.lastSequenceNumber;
+      sequenceNumber++
+    ) {
+      missed.push(this.buffer[sequenceNumber % BUFFERED_NOTIFICATION_COUNT])
+    }
+    return from(missed)
+  }
+
+  private formatId(sequenceNumber: number): string {
+    return `${this.epoch}-${sequenceNumber}`
+  }
+
+  private parseId(id: string): number | null {
+    const [epoch, sequenceNumber] = id.split('-')
+    if (epoch !== this.epoch || !/^\d+$/.test(sequenceNumber ?? '')) {
+      return null
+    }
+    return parseInt(sequenceNumber)
+  }
+}
@@ -0,0 +1,52 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { spawn } from 'child_process'
+import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
+import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
+
+// Idle I/O class and lowest CPU priority, so that capture is never delayed.
+const LOW_PRIORITY_PREFIX = ['ionice', '-c', '3', 'nice', '-n', '19']
+
+export class ShotCopyInteractor {
+  /**
+   * Copies a shot with its modification time, which stands for its creation
+   * time.
+   */
+  static async copyShot(sourcePath: string, targetPath: string): Promise<void> {
+    CommandUnavailableOnWindowsException.throwIfOnWindows()
+    const [command, ...args] = [
+      ...LOW_PRIORITY_PREFIX,
+      'cp',
+      '--preserve=timestamps',
+      sourcePath,
+      targetPath,
+    ]
+    const child = spawn(command, args, { stdio: ['ignore', 'ignore', 'pipe'] })
+    let stderr = ''
+    child.stderr.setEncoding('utf8')
+    child.stderr.on('data', (chunk: string) => {
+      stderr += chunk
+    })
+    const exitCode = await new Promise<number>((resolve, reject) => {
+      child.once('error', reject)
+      child.once('close', resolve)
+    })
+    if (exitCode !== 0) {
+      throw new CommandExecutionException(stderr || `exit code ${exitCode}`)
+    }
+  }
+}
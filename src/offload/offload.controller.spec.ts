@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { NotFoundException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { OffloadJob } from './entities/offload-job.entity'
+import { OffloadController } from './offload.controller'
+import { OffloadService } from './offload.service'
+import { IOffloadService } from './offload.service.interface'
+
+const JOB: OffloadJob = {
+  id: 'j',
+  sourceFolderPath: '/media/card',
+  targetFolderPath: '/media/usb',
+  isMoving: false,
+  startTime: new Date(),
+  totalCount: 2,
+  offloadedCount: 1,
+  failedFilenames: [],
+  isCancelled: false,
+  isFinished: false,
+}
+
+describe(OffloadController.name, () => {
+  let job: OffloadJob | undefined
+
+  class MockOffloadService implements IOffloadService {
+    getJob = vi.fn(() => job)
+    cancelJob = vi.fn(() => job && { ...job, isCancelled: true })
+    getLocations = vi.fn(() =>
+      Promise.resolve([
+        { name: 'a.jpg', folderPaths: ['/media/usb'] },
+        { name: 'b.jpg', folderPaths: ['/media/card', '/media/usb'] },
+      ]),
+    )
+  }
+
+  let controller: OffloadController
+
+  beforeEach(async () => {
+    job = undefined
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [OffloadController],
+      providers: [{ provide: OffloadService, useClass: MockOffloadService }],
+    }).compile()
+
+    controller = module.get<OffloadController>(OffloadController)
+  })
+
+  describe(OffloadController.prototype.getJob.name, () => {
+    it('returns the latest job', () => {
+      job = JOB
+      expect(controller.getJob()).toEqual(JOB)
+    })
+
+    it('throws if no job was started', () => {
+      expect(() => controller.getJob()).toThrow(NotFoundException)
+    })
+  })
+
+  describe(OffloadController.prototype.cancelJob.name, () => {
+    it('returns the cancelled job', () => {
+      job = JOB
+      expect(controller.cancelJob().isCancelled).toBe(true)
+    })
+
+    it('throws if no job was started', () => {
+      expect(() => controller.cancelJob()).toThrow(NotFoundException)
+    })
+  })
+
+  describe(OffloadController.prototype.getLocations.name, () => {
+    it('returns the locations of all shots', async () => {
+      expect(await controller.getLocations()).toHaveLength(2)
+    })
+
+    it('returns the locations of the given shot', async () => {
+      expect(await controller.getLocations('b.jpg')).toEqual([
+        { name: 'b.jpg', folderPaths: ['/media/card', '/media/usb'] },
+      ])
+    })
+  })
+})
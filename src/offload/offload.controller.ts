@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  Controller,
+  Delete,
+  Get,
+  NotFoundException,
+  Query,
+} from '@nestjs/common'
+import { OffloadJob } from './entities/offload-job.entity'
+import { ShotLocation } from './entities/shot-location.entity'
+import { OffloadService } from './offload.service'
+
+@Controller('offload')
+export class OffloadController {
+  constructor(private readonly offloadService: OffloadService) {}
+
+  @Get('job')
+  getJob(): OffloadJob {
+    const job = this.offloadService.getJob()
+    if (!job) {
+      throw new NotFoundException()
+    }
+    return job
+  }
+
+  @Delete('job')
+  cancelJob(): OffloadJob {
+    const job = this.offloadService.cancelJob()
+    if (!job) {
+      throw new NotFoundException()
+    }
+    return job
+  }
+
+  @Get('locations')
+  async getLocations(@Query('name') name?: string): Promise<ShotLocation[]> {
+    const locations = await this.offloadService.getLocations()
+    return name
+      ? locations.filter((location) => location.name === name)
+      : locations
+  }
+}
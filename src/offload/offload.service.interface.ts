@@ -0,0 +1,8 @@
+import { OffloadJob } from './entities/offload-job.entity'
+import { ShotLocation } from './entities/shot-location.entity'
+
+export interface IOffloadService {
+  getJob: () => OffloadJob | undefined
+  cancelJob: () => OffloadJob | undefined
+  getLocations: () => Promise<ShotLocation[]>
+}
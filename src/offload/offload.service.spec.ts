@@ -0,0 +1,237 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { copyFile, mkdir, readdir, readFile, rm, writeFile } from 'fs/promises'
+import path from 'path'
+import { ConfigService } from '@nestjs/config'
+import { Test, TestingModule } from '@nestjs/testing'
+import { Subject } from 'rxjs'
+import { vi } from 'vitest'
+import { ChecksumInteractor } from '../files/checksum-interactor'
+import { FilesService } from '../files/files.service'
+import { IFilesService } from '../files/files.service.interface'
+import { ShotIndex, ShotIndexChange } from '../files/shot-index'
+import {
+  SettingsService,
+  ShotsFolderChange,
+} from '../settings/settings.service'
+import { ShotCopyInteractor } from './interactors/shot-copy-interactor'
+import { OffloadService } from './offload.service'
+import { ShotLocationFileProvider } from './shot-location-file-provider'
+
+const TEST_FOLDER = 'src/offload/test-offload-service'
+const SOURCE_FOLDER = path.join(TEST_FOLDER, 'card')
+const TARGET_FOLDER = path.join(TEST_FOLDER, 'usb')
+
+// Stands in for CRC32C, readable in the expectations.
+function fakeChecksum(content: string): string {
+  return Buffer.from(content).toString('hex').padStart(8, '0')
+}
+
+describe(OffloadService.name, () => {
+  let config: Record<string, unknown>
+
+  class MockConfigService implements Partial<ConfigService> {
+    get = vi.fn((key: string) => config[key])
+  }
+
+  class MockFilesService implements Partial<IFilesService> {
+    setChecksum = vi.fn(() => Promise.resolve())
+  }
+
+  class MockSettingsService implements Partial<SettingsService> {
+    shotsFolderChanges$ = new Subject<ShotsFolderChange>()
+    getShotsFolder = vi.fn(() => Promise.resolve(TARGET_FOLDER))
+  }
+
+  class MockShotIndex implements Partial<ShotIndex> {
+    changes$ = new Subject<ShotIndexChange>()
+  }
+
+  let service: OffloadService
+  let filesService: FilesService
+  let settingsService: SettingsService
+  let shotIndex: ShotIndex
+
+  async function changeShotsFolder() {
+    settingsService.shotsFolderChanges$.next({
+      previousFolderPath: SOURCE_FOLDER,
+      folderPath: TARGET_FOLDER,
+    })
+    await vi.waitFor(() => {
+      expect(service.getJob()?.isFinished).toBe(true)
+    })
+  }
+
+  beforeEach(async () => {
+    await mkdir(SOURCE_FOLDER, { recursive: true })
+    await mkdir(TARGET_FOLDER)
+    await writeFile(path.join(SOURCE_FOLDER, 'a.jpg'), 'a')
+    await writeFile(path.join(SOURCE_FOLDER, 'b.jpg'), 'b')
+    await writeFile(path.join(SOURCE_FOLDER, 'c.jpg'), 'c')
+    // The checksum of c.jpg no longer matches, e.g. after a card fault.
+    await writeFile(
+      path.join(SOURCE_FOLDER, '.checksums'),
+      [
+        { name: 'a.jpg', value: fakeChecksum('a') },
+        { name: 'c.jpg', value: fakeChecksum('x') },
+      ]
+        .map((line) => JSON.stringify(line) + '\n')
+        .join(''),
+    )
+    config = {
+      isOffloadEnabled: true,
+      isOffloadMoving: false,
+      offloadMaximumMegabytesPerSecond: 4,
+    }
+    vi.spyOn(ShotCopyInteractor, 'copyShot').mockImplementation(
+      (sourcePath, targetPath) => copyFile(sourcePath, targetPath),
+    )
+    vi.spyOn(ChecksumInteractor, 'computeChecksums').mockImplementation(
+      async (filePaths) => {
+        const checksums = new Map<string, string>()
+        for (const filePath of filePaths) {
+          const content = await readFile(filePath, 'utf8')
+          checksums.set(filePath, fakeChecksum(content))
+        }
+        return checksums
+      },
+    )
+    vi.spyOn(ShotLocationFileProvider, 'readLocations').mockResolvedValue(
+      new Map(),
+    )
+    vi.spyOn(ShotLocationFileProvider, 'appendChanges').mockResolvedValue()
+    vi.spyOn(ShotLocationFileProvider, 'writeLocations').mockResolvedValue()
+
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: ConfigService, useClass: MockConfigService },
+        { provide: FilesService, useClass: MockFilesService },
+        { provide: SettingsService, useClass: MockSettingsService },
+        { provide: ShotIndex, useClass: MockShotIndex },
+        OffloadService,
+      ],
+    }).compile()
+
+    service = module.get<OffloadService>(OffloadService)
+    filesService = module.get<FilesService>(FilesService)
+    settingsService = module.get<SettingsService>(SettingsService)
+    shotIndex = module.get<ShotIndex>(ShotIndex)
+    service.onModuleInit()
+  })
+
+  it('copies and verifies the shots left on the previous storage', async () => {
+    await changeShotsFolder()
+    expect(service.getJob()).toMatchObject({
+      totalCount: 3,
+      offloadedCount: 2,
+      failedFilenames: ['c.jpg'],
+      isCancelled: false,
+    })
+    expect((await readdir(TARGET_FOLDER)).sort()).toEqual(['a.jpg', 'b.jpg'])
+    expect(await readdir(SOURCE_FOLDER)).toHaveLength(4)
+    expect(filesService.setChecksum).toHaveBeenCalledWith(
+      'b.jpg',
+      fakeChecksum('b'),
+    )
+    expect(await service.getLocations()).toContainEqual({
+      name: 'a.jpg',
+      folderPaths: [SOURCE_FOLDER, TARGET_FOLDER],
+    })
+  })
+
+  it('deletes the verified shots from the previous storage', async () => {
+    config.isOffloadMoving = true
+    await changeShotsFolder()
+    expect((await readdir(SOURCE_FOLDER)).sort()).toEqual([
+      '.checksums',
+      'c.jpg',
+    ])
+    expect(await service.getLocations()).toContainEqual({
+      name: 'a.jpg',
+      folderPaths: [TARGET_FOLDER],
+    })
+  })
+
+  it('keeps a copy the target already has', async () => {
+    await writeFile(path.join(TARGET_FOLDER, 'b.jpg'), 'b')
+    await changeShotsFolder()
+    expect(ShotCopyInteractor.copyShot).toHaveBeenCalledTimes(2)
+    expect(service.getJob().offloadedCount).toBe(2)
+  })
+
+  it('reads the copies back from the storage to verify them', async () => {
+    await changeShotsFolder()
+    expect(ChecksumInteractor.computeChecksums).toHaveBeenCalledWith(
+      [path.join(TARGET_FOLDER, '.b.jpg.part')],
+      true,
+    )
+  })
+
+  it('skips the shots already offloaded to the target', async () => {
+    await writeFile(path.join(TARGET_FOLDER, 'a.jpg'), 'a')
+    vi.mocked(ShotLocationFileProvider.readLocations).mockResolvedValue(
+      new Map([['a.jpg', new Set([TARGET_FOLDER])]]),
+    )
+    config.isOffloadMoving = true
+    await changeShotsFolder()
+    expect(service.getJob().offloadedCount).toBe(2)
+    expect(ChecksumInteractor.computeChecksums).not.toHaveBeenCalledWith(
+      [path.join(TARGET_FOLDER, 'a.jpg')],
+      true,
+    )
+    expect(await readdir(SOURCE_FOLDER)).not.toContain('a.jpg')
+  })
+
+  it('stops after the shot being copied when cancelled', async () => {
+    settingsService.shotsFolderChanges$.next({
+      previousFolderPath: SOURCE_FOLDER,
+      folderPath: TARGET_FOLDER,
+    })
+    expect(service.cancelJob().isCancelled).toBe(true)
+    await vi.waitFor(() => {
+      expect(service.getJob().isFinished).toBe(true)
+    })
+    expect(service.getJob().offloadedCount).toBe(0)
+  })
+
+  it('leaves the shots alone when disabled', async () => {
+    config.isOffloadEnabled = false
+    settingsService.shotsFolderChanges$.next({
+      previousFolderPath: SOURCE_FOLDER,
+      folderPath: TARGET_FOLDER,
+    })
+    expect(service.getJob()).toBeUndefined()
+  })
+
+  it('follows the shots of the current folder', async () => {
+    shotIndex.changes$.next({
+      type: 'created',
+      shot: { name: 'd.jpg', creationTime: new Date(), sizeBytes: 1 },
+    })
+    await vi.waitFor(async () => {
+      expect(await service.getLocations()).toEqual([
+        { name: 'd.jpg', folderPaths: [TARGET_FOLDER] },
+      ])
+    })
+  })
+
+  afterEach(async () => {
+    service.onModuleDestroy()
+    vi.restoreAllMocks()
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
@@ -0,0 +1,379 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { randomUUID } from 'crypto'
+import { lstat, open, readdir, rename, rm, unlink } from 'fs/promises'
+import path from 'path'
+import {
+  Injectable,
+  Logger,
+  OnModuleDestroy,
+  OnModuleInit,
+} from '@nestjs/common'
+import { ConfigService } from '@nestjs/config'
+import { Subscription } from 'rxjs'
+import { CHECKSUMS_FILENAME, ChecksumIndex } from '../files/checksum-index'
+import { ChecksumInteractor } from '../files/checksum-interactor'
+import { IndexedShot } from '../files/entities/indexed-shot.entity'
+import { FilesService } from '../files/files.service'
+import { ShotIndex, ShotIndexChange } from '../files/shot-index'
+import {
+  SettingsService,
+  ShotsFolderChange,
+} from '../settings/settings.service'
+import FolderCleaner from '../shared/folder-cleaner'
+import { OffloadJob } from './entities/offload-job.entity'
+import { ShotLocation } from './entities/shot-location.entity'
+import { ShotCopyInteractor } from './interactors/shot-copy-interactor'
+import { IOffloadService } from './offload.service.interface'
+import { ShotLocationIndex } from './shot-location-index'
+
+const LOCATIONS_FILE_PATH = 'shot-locations.jsonl'
+const BYTES_PER_MEGABYTE = 1000000
+
+interface ShotCopy {
+  // Undefined if the copy could not be verified
+  checksum?: string
+  // Including the reads to verify the copy
+  readByteCount: number
+}
+
+/**
+ * Offloads the shots left on the previous storage once the shots folder moved
+ * to another one, e.g. after udiskie mounted a USB drive.
+ */
+@Injectable()
+export class OffloadService
+  implements IOffloadService, OnModuleInit, OnModuleDestroy
+{
+  private readonly logger = new Logger(OffloadService.name)
+  private readonly locationIndex = new ShotLocationIndex(LOCATIONS_FILE_PATH)
+  private job: OffloadJob | null = null
+  private subscriptions: Subscription[] = []
+
+  constructor(
+    private readonly configService: ConfigService,
+    private readonly filesService: FilesService,
+    private readonly settingsService: SettingsService,
+    private readonly shotIndex: ShotIndex,
+  ) {}
+
+  onModuleInit() {
+    this.subscriptions = [
+      this.settingsService.shotsFolderChanges$.subscribe((change) => {
+        this.cancelJob()
+        if (this.configService.get<boolean>('isOffloadEnabled')) {
+          this.startJob(change)
+        }
+      }),
+      this.shotIndex.changes$.subscribe((change) => {
+        this.followShotIndex(change).catch((error) => {
+          this.logger.warn(`Shot location not updated: ${error.message}`)
+        })
+      }),
+    ]
+  }
+
+  onModuleDestroy() {
+    this.cancelJob()
+    for (const subscription of this.subscriptions) {
+      subscription.unsubscribe()
+    }
+  }
+
+  getJob(): OffloadJob | undefined {
+    return this.job ? this.copyJob(this.job) : undefined
+  }
+
+  /**
+   * Stops the running job after the shot being copied.
+   */
+  cancelJob(): OffloadJob | undefined {
+    if (this.job && !this.job.isFinished) {
+      this.job.isCancelled = true
+    }
+    return this.getJob()
+  }
+
+  async getLocations(): Promise<ShotLocation[]> {
+    return this.locationIndex.getLocations()
+  }
+
+  private startJob(change: ShotsFolderChange): void {
+    const job: OffloadJob = {
+      id: randomUUID(),
+      sourceFolderPath: change.previousFolderPath,
+      targetFolderPath: change.folderPath,
+      isMoving: this.configService.get<boolean>('isOffloadMoving'),
+      startTime: new Date(),
+      totalCount: 0,
+      offloadedCount: 0,
+      failedFilenames: [],
+      isCancelled: false,
+      isFinished: false,
+    }
+    this.job = job
+    this.runJob(job).catch((error) => {
+      this.logger.error(`Offload job ${job.id} failed: ${error.message}`)
+      this.finishJob(job)
+    })
+  }
+
+  private async runJob(job: OffloadJob): Promise<void> {
+    const shots = await this.listShots(job.sourceFolderPath)
+    job.totalCount = shots.length
+    if (shots.length === 0) {
+      this.finishJob(job)
+      return
+    }
+    this.logger.log(
+      `Offload job ${job.id} started: ${shots.length} shots from ${job.sourceFolderPath} to ${job.targetFolderPath}`,
+    )
+    const sourceChecksumIndex = new ChecksumIndex(
+      path.join(job.sourceFolderPath, CHECKSUMS_FILENAME),
+    )
+    const recordedChecksums = await sourceChecksumIndex.getValues()
+    await this.locationIndex.addLocations(
+      job.sourceFolderPath,
+      shots.map((shot) => shot.name),
+    )
+    const maximumBytesPerSecond =
+      this.configService.get<number>('offloadMaximumMegabytesPerSecond') *
+      BYTES_PER_MEGABYTE
+    const startTimeMs = Date.now()
+    let readBytes = 0
+    for (const shot of shots) {
+      if (job.isCancelled) {
+        break
+      }
+      try {
+        if (await this.isOffloaded(job, shot)) {
+          if (job.isMoving) {
+            await this.removeSource(job, shot.name, sourceChecksumIndex)
+          }
+          job.offloadedCount++
+          continue
+        }
+        const copy = await this.copyShot(
+          job,
+          shot,
+          recordedChecksums.get(shot.name),
+        )
+        readBytes += copy.readByteCount
+        if (copy.checksum) {
+          await this.recordCopy(
+            job,
+            shot.name,
+            copy.checksum,
+            sourceChecksumIndex,
+          )
+          job.offloadedCount++
+        } else {
+          job.failedFilenames.push(shot.name)
+        }
+      } catch (error) {
+        this.logger.warn(`Offloading ${shot.name} failed: ${error.message}`)
+        job.failedFilenames.push(shot.name)
+        readBytes += shot.sizeBytes
+      }
+      // Paced per shot, the idle I/O class keeps a long movie from delaying
+      // Motion in between.
+      const waitingTimeMs =
+        (readBytes / maximumBytesPerSecond) * 1000 - (Date.now() - startTimeMs)
+      if (waitingTimeMs > 0 && !job.isCancelled) {
+        await new Promise((resolve) => setTimeout(resolve, waitingTimeMs))
+      }
+    }
+    this.finishJob(job)
+    if (job.failedFilenames.length > 0) {
+      this.logger.warn(
+        `Offload job ${job.id} could not verify: ${job.failedFilenames.join(', ')}`,
+      )
+    }
+    this.logger.log(
+      `Offload job ${job.id} ${job.isCancelled ? 'cancelled' : 'finished'}: ${job.offloadedCount} offloaded, ${job.failedFilenames.length} failed`,
+    )
+  }
+
+  private async listShots(folderPath: string): Promise<IndexedShot[]> {
+    let entries: string[]
+    try {
+      entries = await readdir(folderPath)
+    } catch (error) {
+      // The previous storage may have been unplugged meanwhile.
+      if (error.code === 'ENOENT') {
+        return []
+      }
+      throw error
+    }
+    const shots: IndexedShot[] = []
+    for (const name of entries) {
+      if (FolderCleaner.isUnixHiddenPath(name)) {
+        continue
+      }
+      const stats = await lstat(path.join(folderPath, name))
+      if (stats.isFile()) {
+        shots.push({ name, creationTime: stats.mtime, sizeBytes: stats.size })
+      }
+    }
+    return shots.sort(
+      (a, b) => a.creationTime.getTime() - b.creationTime.getTime(),
+    )
+  }
+
+  /**
+   * Tells whether a verified copy of the shot was recorded in the target
+   * before, e.g. by the job replayed when the shots folder is set at boot,
+   * and is still there.
+   */
+  private async isOffloaded(
+    job: OffloadJob,
+    shot: IndexedShot,
+  ): Promise<boolean> {
+    const isRecorded = await this.locationIndex.hasLocation(
+      shot.name,
+      job.targetFolderPath,
+    )
+    if (!isRecorded) {
+      return false
+    }
+    try {
+      const stats = await lstat(path.join(job.targetFolderPath, shot.name))
+      return stats.size === shot.sizeBytes
+    } catch (error) {
+      if (error.code === 'ENOENT') {
+        return false
+      }
+      throw error
+    }
+  }
+
+  /**
+   * Copies a shot unless the target already has it and returns its checksum
+   * if the copy matches the checksum recorded at save time or, without one,
+   * the source.
+   */
+  private async copyShot(
+    job: OffloadJob,
+    shot: IndexedShot,
+    recordedChecksum?: string,
+  ): Promise<ShotCopy> {
+    const sourcePath = path.join(job.sourceFolderPath, shot.name)
+    const targetPath = path.join(job.targetFolderPath, shot.name)
+    // Hidden, so that the shot index skips the copy until it is verified.
+    const partPath = path.join(job.targetFolderPath, `.${shot.name}.part`)
+    const isCopied = await this.exists(targetPath)
+    const copyPath = isCopied ? targetPath : partPath
+    let readByteCount = 0
+    if (!isCopied) {
+      await ShotCopyInteractor.copyShot(sourcePath, partPath)
+      readByteCount += shot.sizeBytes
+    }
+    let expectedChecksum = recordedChecksum
+    if (!expectedChecksum) {
+      const sourceChecksums = await ChecksumInteractor.computeChecksums([
+        sourcePath,
+      ])
+      expectedChecksum = sourceChecksums.get(sourcePath)
+      readByteCount += shot.sizeBytes
+    }
+    // Synced and read back from the storage, as the copy in the page cache
+    // tells nothing about what was written.
+    const copyChecksums = await ChecksumInteractor.computeChecksums(
+      [copyPath],
+      true,
+    )
+    readByteCount += shot.sizeBytes
+    if (!expectedChecksum || copyChecksums.get(copyPath) !== expectedChecksum) {
+      await rm(partPath, { force: true })
+      return { readByteCount }
+    }
+    if (!isCopied) {
+      await rename(partPath, targetPath)
+      // The new name must be stored before the source may be deleted.
+      await this.syncFolder(job.targetFolderPath)
+    }
+    return { checksum: expectedChecksum, readByteCount }
+  }
+
+  private async recordCopy(
+    job: OffloadJob,
+    name: string,
+    checksum: string,
+    sourceChecksumIndex: ChecksumIndex,
+  ): Promise<void> {
+    // The target is the current shots folder until the job is cancelled.
+    if (!job.isCancelled) {
+      await this.filesService.setChecksum(name, checksum)
+    }
+    await this.locationIndex.addLocations(job.targetFolderPath, [name])
+    if (job.isMoving) {
+      await this.removeSource(job, name, sourceChecksumIndex)
+    }
+  }
+
+  private async removeSource(
+    job: OffloadJob,
+    name: string,
+    sourceChecksumIndex: ChecksumIndex,
+  ): Promise<void> {
+    await unlink(path.join(job.sourceFolderPath, name))
+    await sourceChecksumIndex.removeValues([name])
+    await this.locationIndex.removeLocations(job.sourceFolderPath, [name])
+  }
+
+  private async followShotIndex(change: ShotIndexChange): Promise<void> {
+    if (change.type !== 'created' && change.type !== 'deleted') {
+      return
+    }
+    const folderPath = await this.settingsService.getShotsFolder()
+    if (change.type === 'created') {
+      await this.locationIndex.addLocations(folderPath, [change.shot.name])
+    } else {
+      await this.locationIndex.removeLocations(folderPath, [change.name])
+    }
+  }
+
+  private async syncFolder(folderPath: string): Promise<void> {
+    const folder = await open(folderPath, 'r')
+    try {
+      await folder.sync()
+    } finally {
+      await folder.close()
+    }
+  }
+
+  private async exists(filePath: string): Promise<boolean> {
+    try {
+      await lstat(filePath)
+      return true
+    } catch (error) {
+      if (error.code === 'ENOENT') {
+        return false
+      }
+      throw error
+    }
+  }
+
+  private finishJob(job: OffloadJob): void {
+    job.isFinished = true
+    job.endTime = new Date()
+  }
+
+  private copyJob(job: OffloadJob): OffloadJob {
+    return { ...job, failedFilenames: [...job.failedFilenames] }
+  }
+}
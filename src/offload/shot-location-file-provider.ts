@@ -0,0 +1,95 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { appendFile, readFile, rename, rm, writeFile } from 'fs/promises'
+
+const TEMPORARY_FILE_SUFFIX = '.tmp'
+
+export interface ShotLocationChange {
+  name: string
+  folderPath: string
+  isRemoved?: boolean
+}
+
+export class ShotLocationFileProvider {
+  /**
+   * Replays the changes, one JSON object per line, into the folders of each
+   * shot.
+   */
+  static async readLocations(
+    filePath: string,
+  ): Promise<Map<string, Set<string>>> {
+    let data: string
+    try {
+      data = (await readFile(filePath)).toString()
+    } catch (err) {
+      if (err.code !== 'ENOENT') {
+        throw err
+      }
+      return new Map()
+    }
+    const locations = new Map<string, Set<string>>()
+    for (const line of data.split('\n')) {
+      let change: ShotLocationChange
+      try {
+        change = JSON.parse(line)
+      } catch {
+        // A line cut off by a power loss only loses that change.
+        continue
+      }
+      const folderPaths = locations.get(change.name) ?? new Set<string>()
+      if (change.isRemoved) {
+        folderPaths.delete(change.folderPath)
+      } else {
+        folderPaths.add(change.folderPath)
+      }
+      if (folderPaths.size > 0) {
+        locations.set(change.name, folderPaths)
+      } else {
+        locations.delete(change.name)
+      }
+    }
+    return locations
+  }
+
+  static async appendChanges(
+    changes: ShotLocationChange[],
+    filePath: string,
+  ): Promise<void> {
+    const lines = changes.map((change) => JSON.stringify(change) + '\n')
+    await appendFile(filePath, lines.join(''))
+  }
+
+  static async writeLocations(
+    locations: Map<string, Set<string>>,
+    filePath: string,
+  ): Promise<void> {
+    const lines: string[] = []
+    for (const [name, folderPaths] of locations) {
+      for (const folderPath of folderPaths) {
+        lines.push(JSON.stringify({ name, folderPath }) + '\n')
+      }
+    }
+    const temporaryFilePath = filePath + TEMPORARY_FILE_SUFFIX
+    try {
+      await writeFile(temporaryFilePath, lines.join(''))
+      await rename(temporaryFilePath, filePath)
+    } catch (err) {
+      await rm(temporaryFilePath, { force: true })
+      throw err
+    }
+  }
+}
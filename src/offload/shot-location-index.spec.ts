@@ -0,0 +1,71 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, readFile, rm, writeFile } from 'fs/promises'
+import path from 'path'
+import { ShotLocationIndex } from './shot-location-index'
+
+describe(ShotLocationIndex.name, () => {
+  const TEST_FOLDER = 'src/offload/test-shot-location-index'
+  const FILE_PATH = path.join(TEST_FOLDER, 'shot-locations.jsonl')
+
+  let index: ShotLocationIndex
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+    index = new ShotLocationIndex(FILE_PATH)
+  })
+
+  it('starts empty without a file', async () => {
+    expect(await index.getLocations()).toEqual([])
+  })
+
+  it('keeps the folders of each shot across restarts', async () => {
+    await index.addLocations('/media/card', ['a.jpg', 'b.jpg'])
+    await index.addLocations('/media/usb', ['a.jpg'])
+    await index.removeLocations('/media/card', ['a.jpg'])
+    const locations = await new ShotLocationIndex(FILE_PATH).getLocations()
+    expect(locations).toEqual([
+      { name: 'a.jpg', folderPaths: ['/media/usb'] },
+      { name: 'b.jpg', folderPaths: ['/media/card'] },
+    ])
+  })
+
+  it('skips lines that cannot be parsed', async () => {
+    await writeFile(
+      FILE_PATH,
+      '{"name":"a.jpg","folderPath":"/media/card"}\n{"name":"b.j',
+    )
+    expect(await index.getLocations()).toEqual([
+      { name: 'a.jpg', folderPaths: ['/media/card'] },
+    ])
+  })
+
+  it('rewrites the file once most locations were removed', async () => {
+    await index.addLocations('/media/card', ['a.jpg', 'b.jpg', 'c.jpg'])
+    await index.addLocations('/media/card', ['a.jpg'])
+    await index.removeLocations('/media/card', ['a.jpg'])
+    expect(await readFile(FILE_PATH, 'utf8')).toContain('"isRemoved":true')
+    await index.removeLocations('/media/card', ['b.jpg', 'd.jpg'])
+    expect(await readFile(FILE_PATH, 'utf8')).toBe(
+      '{"name":"c.jpg","folderPath":"/media/card"}\n',
+    )
+  })
+
+  afterEach(async () => {
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { ShotLocation } from './entities/shot-location.entity'
+import {
+  ShotLocationChange,
+  ShotLocationFileProvider,
+} from './shot-location-file-provider'
+
+/**
+ * Index of the folders holding a copy of each shot, so that shots left on a
+ * card or offloaded to a USB drive can still be found after the storage was
+ * swapped. Changes are appended and the file is only rewritten once more
+ * locations were removed than are left.
+ */
+export class ShotLocationIndex {
+  private locations: Promise<Map<string, Set<string>>> | null = null
+  private locationCount = 0
+  private removedLocationCount = 0
+  private pendingWrite = Promise.resolve()
+
+  constructor(readonly filePath: string) {}
+
+  async getLocations(): Promise<ShotLocation[]> {
+    const locations = await this.load()
+    return [...locations].map(([name, folderPaths]) => ({
+      name,
+      folderPaths: [...folderPaths],
+    }))
+  }
+
+  async hasLocation(name: string, folderPath: string): Promise<boolean> {
+    const locations = await this.load()
+    return locations.get(name)?.has(folderPath) ?? false
+  }
+
+  async addLocations(folderPath: string, names: string[]): Promise<void> {
+    const locations = await this.load()
+    const changes: ShotLocationChange[] = []
+    for (const name of names) {
+      const folderPaths = locations.get(name) ?? new Set<string>()
+      if (!folderPaths.has(folderPath)) {
+        folderPaths.add(folderPath)
+        locations.set(name, folderPaths)
+        changes.push({ name, folderPath })
+      }
+    }
+    if (changes.length === 0) {
+      return
+    }
+    this.locationCount += changes.length
+    await this.enqueueWrite(() =>
+      ShotLocationFileProvider.appendChanges(changes, this.filePath),
+    )
+  }
+
+  async removeLocations(folderPath: string, names: string[]): Promise<void> {
+    const locations = await this.load()
+    const changes: ShotLocationChange[] = []
+    for (const name of names) {
+      const folderPaths = locations.get(name)
+      if (folderPaths?.delete(folderPath)) {
+        if (folderPaths.size === 0) {
+          locations.delete(name)
+        }
+        changes.push({ name, folderPath, isRemoved: true })
+      }
+    }
+    if (changes.length === 0) {
+      return
+    }
+    this.locationCount -= changes.length
+    this.removedLocationCount += changes.length
+    if (this.removedLocationCount > this.locationCount) {
+      this.removedLocationCount = 0
+      const snapshot = new Map(
+        [...locations].map(([name, paths]) => [name, new Set(paths)]),
+      )
+      await this.enqueueWrite(() =>
+        ShotLocationFileProvider.writeLocations(snapshot, this.filePath),
+      )
+    } else {
+      await this.enqueueWrite(() =>
+        ShotLocationFileProvider.appendChanges(changes, this.filePath),
+      )
+    }
+  }
+
+  private async load(): Promise<Map<string, Set<string>>> {
+    if (!this.locations) {
+      this.locations = ShotLocationFileProvider.readLocations(this.filePath)
+        .then((locations) => {
+          this.locationCount = [...locations.values()].reduce(
+            (sum, folderPaths) => sum + folderPaths.size,
+            0,
+          )
+          return locations
+        })
+        .catch((error) => {
+          this.locations = null
+          throw error
+        })
+    }
+    return this.locations
+  }
+
+  private enqueueWrite(write: () => Promise<void>): Promise<void> {
+    const result = this.pendingWrite.then(write)
+    this.pendingWrite = result.catch(() => undefined)
+    return result
+  }
+}
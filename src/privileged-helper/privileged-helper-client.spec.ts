@@ -0,0 +1,139 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { unlink } from 'fs/promises'
+import { createServer, Server } from 'net'
+import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
+import { PrivilegedHelperClient } from './privileged-helper-client'
+
+describe(PrivilegedHelperClient.name, () => {
+  const SOCKET_PATH = 'src/privileged-helper/test-helper.sock'
+  let server: Server
+  let requests: string[]
+  let reply: string
+
+  beforeAll(async () => {
+    server = createServer((socket) => {
+      let request = ''
+      socket.on('data', (chunk) => {
+        request += chunk
+        if (request.endsWith('\n')) {
+          requests.push(request)
+          socket.end(reply)
+        }
+      })
+    })
+    await new Promise<void>((resolve) => server.listen(SOCKET_PATH, resolve))
+  })
+
+  beforeEach(() => {
+    requests = []
+  })
+
+  describe(PrivilegedHelperClient.run.name, () => {
+    it('sends the operation and its arguments as one line', async () => {
+      reply = '0 4 0\nok\n\n'
+      const output = await PrivilegedHelperClient.run(
+        'reset-lights',
+        ['Variscite', 'visible', 'false'],
+        SOCKET_PATH,
+      )
+      expect(requests).toEqual(['reset-lights\tVariscite\tvisible\tfalse\n'])
+      expect(output).toEqual({ stdout: 'ok\n\n', stderr: '' })
+    })
+
+    it('returns the error output of a successful operation', async () => {
+      reply = '0 0 5\nwarn\n'
+      const output = await PrivilegedHelperClient.run(
+        'trigger-upgrade',
+        [],
+        SOCKET_PATH,
+      )
+      expect(output).toEqual({ stdout: '', stderr: 'warn\n' })
+    })
+
+    it('throws if the operation fails', async () => {
+      reply = '2 0 7\nbroken\n'
+      await expect(
+        PrivilegedHelperClient.run('trigger-upgrade', [], SOCKET_PATH),
+      ).rejects.toThrow(new CommandExecutionException('broken\n'))
+    })
+
+    it('throws if the helper rejects the request', async () => {
+      reply = '-1 0 17\nInvalid argument\n'
+      await expect(
+        PrivilegedHelperClient.run('set-time-zone', ['-x'], SOCKET_PATH),
+      ).rejects.toThrow(
+        'Privileged helper rejected set-time-zone: Invalid argument',
+      )
+    })
+
+    it('refuses arguments that would break the request line', async () => {
+      await expect(
+        PrivilegedHelperClient.run('sleep-until', ['a\nb'], SOCKET_PATH),
+      ).rejects.toThrow(CommandExecutionException)
+      expect(requests).toEqual([])
+    })
+  })
+
+  describe(PrivilegedHelperClient.parseReply.name, () => {
+    it('splits the outputs by their lengths', () => {
+      expect(
+        PrivilegedHelperClient.parseReply(Buffer.from('3 3 2\na\nbc\n')),
+      ).toEqual({ status: 3, stdout: 'a\nb', stderr: 'c\n' })
+    })
+
+    it('throws if the reply is truncated', () => {
+      expect(() =>
+        PrivilegedHelperClient.parseReply(Buffer.from('0 10 0\nabc')),
+      ).toThrow(CommandExecutionException)
+    })
+
+    it('throws if the header is malformed', () => {
+      expect(() =>
+        PrivilegedHelperClient.parseReply(Buffer.from('OK\n')),
+      ).toThrow(CommandExecutionException)
+    })
+  })
+
+  describe(PrivilegedHelperClient.buildFallbackCommand.name, () => {
+    it('quotes every word and resolves relative paths', () => {
+      expect(
+        PrivilegedHelperClient.buildFallbackCommand('set-access-point-name', [
+          "it's",
+        ]),
+      ).toBe(
+        `sudo '${process.cwd()}/scripts/runtime/variscite/access-point/` +
+          `change-access-point-name-or-password.sh' '-n' 'it'\\''s'`,
+      )
+    })
+
+    it('keeps absolute paths', () => {
+      expect(
+        PrivilegedHelperClient.buildFallbackCommand('set-time-zone', [
+          'Europe/Luxembourg',
+        ]),
+      ).toBe(
+        `sudo '/usr/bin/timedatectl' 'set-timezone' 'Europe/Luxembourg'`,
+      )
+    })
+  })
+
+  afterAll(async () => {
+    await new Promise((resolve) => server.close(resolve))
+    await unlink(SOCKET_PATH).catch(() => {})
+  })
+})
@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { connect } from 'net'
+import path from 'path'
+import { Logger } from '@nestjs/common'
+import { exec } from '../metrics/measured-exec'
+import { MetricsRegistry } from '../metrics/metrics-registry'
+import { CommandExecutionException } from '../shared/exceptions/CommandExecutionException'
+import {
+  PRIVILEGED_OPERATIONS,
+  PrivilegedOperation,
+} from './privileged-operations'
+
+export const PRIVILEGED_HELPER_SOCKET_PATH = '/run/app4cam/helperd.sock'
+const STATUS_REJECTED = -1
+// The helper is not installed or not running.
+const UNAVAILABLE_ERROR_CODES = ['ECONNREFUSED', 'ENOENT']
+const FORBIDDEN_ARGUMENT_CHARACTERS = /[\t\n]/
+
+export interface CommandOutput {
+  stdout: string
+  stderr: string
+}
+
+interface HelperReply extends CommandOutput {
+  status: number
+}
+
+/**
+ * Runs allow-listed privileged operations through the resident helper daemon,
+ * which saves the sudo and shell start-up of each call. Falls back to sudo if
+ * the helper is not available.
+ */
+export class PrivilegedHelperClient {
+  private static readonly logger = new Logger(PrivilegedHelperClient.name)
+  private static isFallbackLogged = false
+
+  static async run(
+    operation: PrivilegedOperation,
+    args: string[] = [],
+    socketPath = PRIVILEGED_HELPER_SOCKET_PATH,
+  ): Promise<CommandOutput> {
+    const invalidArgument = args.find((arg) =>
+      FORBIDDEN_ARGUMENT_CHARACTERS.test(arg),
+    )
+    if (invalidArgument !== undefined) {
+      throw new CommandExecutionException(
+        `Invalid argument for operation ${operation}: ${invalidArgument}`,
+      )
+    }
+    let reply: Buffer
+    try {
+      reply = await MetricsRegistry.measure(
+        'dependency',
+        ['helper', operation],
+        () => this.request(socketPath, [operation, ...args].join('\t')),
+      )
+    } catch (error) {
+      if (!UNAVAILABLE_ERROR_CODES.includes(error.code)) {
+        throw error
+      }
+      if (!this.isFallbackLogged) {
+        this.logger.warn(
+          `Privileged helper unavailable at ${socketPath}, using sudo instead.`,
+        )
+        this.isFallbackLogged = true
+      }
+      return exec(this.buildFallbackCommand(operation, args))
+    }
+    const { status, stdout, stderr } = this.parseReply(reply)
+    if (status === STATUS_REJECTED) {
+      throw new CommandExecutionException(
+        `Privileged helper rejected ${operation}: ${stderr.trim()}`,
+      )
+    }
+    if (status !== 0) {
+      throw new CommandExecutionException(
+        stderr || `Operation ${operation} failed with exit code ${status}.`,
+      )
+    }
+    return { stdout, stderr }
+  }
+
+  static parseReply(reply: Buffer): HelperReply {
+    const headerEnd = reply.indexOf('\n')
+    const header =
+      headerEnd < 0
+        ? []
+        : reply.subarray(0, headerEnd).toString().split(' ').map(Number)
+    if (header.length !== 3 || header.some((value) => isNaN(value))) {
+      throw new CommandExecutionException(
+        'Malformed reply from the privileged helper.',
+      )
+    }
+    const [status, stdoutLength, stderrLength] = header
+    const stdoutStart = headerEnd + 1
+    const stderrStart = stdoutStart + stdoutLength
+    if (reply.length !== stderrStart + stderrLength) {
+      throw new CommandExecutionException(
+        'Truncated reply from the privileged helper.',
+      )
+    }
+    return {
+      status,
+      stdout: reply.subarray(stdoutStart, stderrStart).toString(),
+      stderr: reply.subarray(stderrStart).toString(),
+    }
+  }
+
+  static buildFallbackCommand(
+    operation: PrivilegedOperation,
+    args: string[],
+  ): string {
+    const words = PRIVILEGED_OPERATIONS[operation].map((word, index) => {
+      if (index === 0) {
+        return path.resolve(process.cwd(), word)
+      }
+      if (/^\$\d$/.test(word)) {
+        return args[parseInt(word.substring(1)) - 1]
+      }
+      return word
+    })
+    const quotedWords = words.map((word) => `'${word.replace(/'/g, `'\\''`)}'`)
+    return `sudo ${quotedWords.join(' ')}`
+  }
+
+  private static request(socketPath: string, line: string): Promise<Buffer> {
+    return new Promise((resolve, reject) => {
+      const chunks: Buffer[] = []
+      const socket = connect(socketPath)
+      socket.on('connect', () => socket.end(`${line}\n`))
+      socket.on('data', (chunk) => chunks.push(chunk))
+      socket.on('end', () => resolve(Buffer.concat(chunks)))
+      socket.on('error', reject)
+    })
+  }
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+const ACCESS_POINT_FOLDER = 'scripts/runtime/variscite/access-point'
+const WORKING_HOURS_FOLDER = 'scripts/runtime/raspberry-pi/working-hours'
+
+// Mirrors the allow-list in scripts/runtime/privileged-helper/helperd.c.
+// Relative paths are resolved against the backend folder.
+export const PRIVILEGED_OPERATIONS = {
+  'get-access-point-password': [
+    `${ACCESS_POINT_FOLDER}/get-access-point-password.sh`,
+  ],
+  'get-battery-voltage-raspberry-pi': [
+    'scripts/runtime/raspberry-pi/get-input-voltage.sh',
+  ],
+  'get-battery-voltage-variscite': [
+    'scripts/runtime/variscite/battery-monitoring/battery_monitoring',
+  ],
+  'get-camera-controls': ['/usr/bin/v4l2-ctl', '-d', '$1', '-l'],
+  'get-light-type': [
+    'scripts/runtime/variscite/light-control/lightctl',
+    'get',
+  ],
+  'create-working-hours-schedule': [
+    `${WORKING_HOURS_FOLDER}/create-working-hours-schedule.sh`,
+    '$1',
+    '$2',
+    '$3',
+    '$4',
+  ],
+  'remove-working-hours-schedule': [
+    `${WORKING_HOURS_FOLDER}/remove-working-hours-schedule.sh`,
+  ],
+  'reset-lights': ['scripts/runtime/reset-lights.sh', '$1', '$2', '$3'],
+  'set-access-point-name': [
+    `${ACCESS_POINT_FOLDER}/change-access-point-name-or-password.sh`,
+    '-n',
+    '$1',
+  ],
+  'set-access-point-name-and-password': [
+    `${ACCESS_POINT_FOLDER}/change-access-point-name-or-password.sh`,
+    '-n',
+    '$1',
+    '-p',
+    '$2',
+  ],
+  'set-access-point-password': [
+    `${ACCESS_POINT_FOLDER}/change-access-point-name-or-password.sh`,
+    '-p',
+    '$1',
+  ],
+  'set-alternating-lights': ['scripts/runtime/set-alternating-lights.sh', '$1'],
+  'set-camera-focus': [
+    'scripts/runtime/raspberry-pi/set-camera-focus.sh',
+    '$1',
+    '$2',
+  ],
+  'set-rtc-time-variscite': ['scripts/runtime/variscite/rtc/set_time', '$1'],
+  'set-system-time': ['/usr/bin/timedatectl', 'set-time', '$1'],
+  'set-time-zone': ['/usr/bin/timedatectl', 'set-timezone', '$1'],
+  'sleep-until': ['scripts/runtime/variscite/rtc/sleep_until', '$1'],
+  'trigger-upgrade': ['scripts/runtime/upgrade.sh'],
+  'write-system-time-to-rtc-raspberry-pi': [
+    'scripts/runtime/raspberry-pi/write-system-time-to-rtc.sh',
+  ],
+} as const
+
+export type PrivilegedOperation = keyof typeof PRIVILEGED_OPERATIONS
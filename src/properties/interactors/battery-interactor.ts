@@ -14,29 +14,24 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { PrivilegedHelperClient } from '../../privileged-helper/privileged-helper-client'
+import { PrivilegedOperation } from '../../privileged-helper/privileged-operations'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 import { UnsupportedDeviceTypeException } from '../exceptions/UnsupportedDeviceTypeException'
 
-const exec = promisify(execSync)
-
 export class BatteryInteractor {
   static async getBatteryVoltage(deviceType: string): Promise<number> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    let relativeCommandPath = 'scripts/runtime/'
+    let operation: PrivilegedOperation
     if (deviceType === 'RaspberryPi') {
-      relativeCommandPath += 'raspberry-pi/get-input-voltage.sh'
+      operation = 'get-battery-voltage-raspberry-pi'
     } else if (deviceType === 'Variscite') {
-      relativeCommandPath += 'variscite/battery-monitoring/battery_monitoring'
+      operation = 'get-battery-voltage-variscite'
     } else {
       throw new UnsupportedDeviceTypeException(deviceType)
     }
-    const currentWorkingDirectory = process.cwd()
-    const { stdout, stderr } = await exec(
-      `sudo ${currentWorkingDirectory}/${relativeCommandPath}`,
-    )
+    const { stdout, stderr } = await PrivilegedHelperClient.run(operation)
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
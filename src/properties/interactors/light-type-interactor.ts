@@ -14,24 +14,19 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { PrivilegedHelperClient } from '../../privileged-helper/privileged-helper-client'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 import { UnsupportedDeviceTypeException } from '../exceptions/UnsupportedDeviceTypeException'
 
-const exec = promisify(execSync)
-
 export class LightTypeInteractor {
   static async getLightType(deviceType: string): Promise<string> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
     if (deviceType !== 'Variscite') {
       throw new UnsupportedDeviceTypeException(deviceType)
     }
-    const currentWorkingDirectory = process.cwd()
-    const { stdout, stderr } = await exec(
-      `sudo ${currentWorkingDirectory}/scripts/runtime/variscite/light-control/lightctl get`,
-    )
+    const { stdout, stderr } =
+      await PrivilegedHelperClient.run('get-light-type')
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
@@ -14,13 +14,10 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { exec } from '../../metrics/measured-exec'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
-
 export class MacAddressInteractor {
   static async getFirstMacAddress(): Promise<string> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
@@ -14,16 +14,26 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { exec } from '../../metrics/measured-exec'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
+// The list only changes with the tzdata package, so it is read once.
+let timeZonesPromise: Promise<string[]> | undefined
 
 export class SystemTimeZonesInteractor {
   static async getAvailableTimeZones(): Promise<string[]> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
+    if (!timeZonesPromise) {
+      timeZonesPromise = this.listTimeZones().catch((error) => {
+        timeZonesPromise = undefined
+        throw error
+      })
+    }
+    return [...(await timeZonesPromise)]
+  }
+
+  private static async listTimeZones(): Promise<string[]> {
     const { stdout, stderr } = await exec('timedatectl list-timezones')
     if (stderr) {
       throw new CommandExecutionException(stderr)
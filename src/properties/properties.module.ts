@@ -16,21 +16,20 @@
  */
 import { forwardRef, Module } from '@nestjs/common'
 import { ConfigModule, ConfigService } from '@nestjs/config'
+import { EventLogModule } from '../event-log/event-log.module'
 import { MotionClientService } from '../motion-client.service'
 import { SettingsModule } from '../settings/settings.module'
-import { SettingsService } from '../settings/settings.service'
 import { PropertiesController } from './properties.controller'
 import { PropertiesService } from './properties.service'
 
 @Module({
   controllers: [PropertiesController],
-  providers: [
-    ConfigService,
-    MotionClientService,
-    PropertiesService,
-    SettingsService,
+  providers: [ConfigService, MotionClientService, PropertiesService],
+  imports: [
+    ConfigModule,
+    EventLogModule,
+    forwardRef(() => SettingsModule),
   ],
-  imports: [ConfigModule, forwardRef(() => SettingsModule)],
   exports: [PropertiesService],
 })
 export class PropertiesModule {}
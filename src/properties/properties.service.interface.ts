@@ -5,9 +5,9 @@ export interface IPropertiesService {
   getAvailableTimeZones: () => Promise<string[]>
   getDeviceId: () => Promise<string>
   getLightType: () => Promise<string>
-  getNextSunsetAndSunrise()
+  getNextSunsetAndSunrise(date?: Date)
   getVersion: () => Promise<VersionDto>
   isCameraConnected: () => Promise<boolean>
   saveDeviceIdToTextFile: () => Promise<void>
-  logVersion: () => Promise<void>
+  logVersion: () => Promise<VersionDto>
 }
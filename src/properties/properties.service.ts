@@ -15,8 +15,16 @@
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
 import { writeFile } from 'fs/promises'
-import { forwardRef, Inject, Injectable, Logger } from '@nestjs/common'
+import {
+  forwardRef,
+  Inject,
+  Injectable,
+  Logger,
+  Optional,
+} from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
+import { SENSOR_SAMPLE_CODES } from '../event-log/entities/logged-event.entity'
+import { EventLogService } from '../event-log/event-log.service'
 import { MotionClientService } from '../motion-client.service'
 import { SettingsService } from '../settings/settings.service'
 import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
@@ -42,6 +50,7 @@ export class PropertiesService implements IPropertiesService {
     private readonly motionClientService: MotionClientService,
     @Inject(forwardRef(() => SettingsService))
     private readonly settingsService: SettingsService,
+    @Optional() private readonly eventLogService?: EventLogService,
   ) {}
 
   async getBatteryVoltage(): Promise<number> {
@@ -49,6 +58,10 @@ export class PropertiesService implements IPropertiesService {
     try {
       const batteryVoltage =
         await BatteryInteractor.getBatteryVoltage(deviceType)
+      this.eventLogService?.record('sensorSample', {
+        code: SENSOR_SAMPLE_CODES.batteryVoltage,
+        value: batteryVoltage,
+      })
       return batteryVoltage
     } catch (error) {
       if (error instanceof CommandUnavailableOnWindowsException) {
@@ -98,16 +111,17 @@ export class PropertiesService implements IPropertiesService {
     }
   }
 
-  async getNextSunsetAndSunrise(): Promise<SunriseAndSunsetDto> {
+  async getNextSunsetAndSunrise(
+    date: Date = new Date(),
+  ): Promise<SunriseAndSunsetDto> {
     const coordinates = await this.settingsService.getLatitudeAndLongitude()
-    const today = new Date()
     const todaysTwilights = SunriseSunsetCalculator.calculateSunriseAndSunset(
-      today,
+      date,
       coordinates.latitude,
       coordinates.longitude,
     )
-    const tomorrow = new Date()
-    tomorrow.setDate(today.getDate() + 1)
+    const tomorrow = new Date(date)
+    tomorrow.setDate(date.getDate() + 1)
     const tomorrowsTwilights =
       SunriseSunsetCalculator.calculateSunriseAndSunset(
         tomorrow,
@@ -145,10 +159,11 @@ export class PropertiesService implements IPropertiesService {
     )
   }
 
-  async logVersion() {
+  async logVersion(): Promise<VersionDto> {
     const version = await this.getVersion()
     this.logger.log(
       `App4Cam version ${version.version} - ${version.commitHash}`,
     )
+    return version
   }
 }
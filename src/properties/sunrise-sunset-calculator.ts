@@ -18,14 +18,9 @@
 import { DateTime } from 'luxon'
 import TriggeringTime from '../shared/entities/triggering-time'
 import { SunriseAndSunsetDto } from './dto/sunrise-and-sunset.dto'
+import { SunriseSunsetTable } from './sunrise-sunset-table'
 
-const DAYS_PER_ORDINARY_YEAR = 365
-const DAYS_PER_LEAP_YEAR = 366
 const MINUTES_PER_HOUR = 60
-/**
- * Approximate correction for atmospheric refraction at sunrise and sunset and the size of the solar disk, in degree
- */
-const SUNRISE_AND_SUNSET_ZENITH = 90.833
 
 export class SunriseSunsetCalculator {
   static calculateSunriseAndSunset(
@@ -34,43 +29,13 @@ export class SunriseSunsetCalculator {
     longitude: number,
   ): SunriseAndSunsetDto {
     const dateTime = DateTime.fromJSDate(date)
-    const daysPerYear = dateTime.isInLeapYear
-      ? DAYS_PER_LEAP_YEAR
-      : DAYS_PER_ORDINARY_YEAR
-
-    const fractionalYearInRad = (dateTime.ordinal / daysPerYear) * 2 * Math.PI
-
-    const timeEquationInMin =
-      229.18 *
-      (0.000075 +
-        0.001868 * Math.cos(fractionalYearInRad) -
-        0.032077 * Math.sin(fractionalYearInRad) -
-        0.014615 * Math.cos(2 * fractionalYearInRad) -
-        0.040849 * Math.sin(2 * fractionalYearInRad))
-
-    const solarDeclinationAngleInRad =
-      0.006918 -
-      0.399912 * Math.cos(fractionalYearInRad) +
-      0.070257 * Math.sin(fractionalYearInRad) -
-      0.006758 * Math.cos(2 * fractionalYearInRad) +
-      0.000907 * Math.sin(2 * fractionalYearInRad) -
-      0.002697 * Math.cos(3 * fractionalYearInRad) +
-      0.00148 * Math.sin(3 * fractionalYearInRad)
-
-    const latitudeInRad = (latitude * Math.PI) / 180
-    const hourAngleInRad = Math.acos(
-      Math.cos((SUNRISE_AND_SUNSET_ZENITH * Math.PI) / 180) /
-        (Math.cos(latitudeInRad) * Math.cos(solarDeclinationAngleInRad)) -
-        Math.tan(latitudeInRad) * Math.tan(solarDeclinationAngleInRad),
-    )
-
-    const hourAngleInDeg = (hourAngleInRad * 180) / Math.PI
-    const sunriseMinutes =
-      720 - 4 * (longitude + hourAngleInDeg) - timeEquationInMin
-    const sunsetMinutes =
-      720 - 4 * (longitude - hourAngleInDeg) - timeEquationInMin
+    const { sunriseMinutes, sunsetMinutes } = SunriseSunsetTable.forLocation(
+      latitude,
+      longitude,
+      dateTime.year,
+    ).getUtcMinutes(dateTime.ordinal)
 
-    const offsetHours = DateTime.fromJSDate(date).offset / 60
+    const offsetHours = dateTime.offset / 60
 
     const sunrise: TriggeringTime = {
       hour: Math.floor(sunriseMinutes / MINUTES_PER_HOUR) + offsetHours,
@@ -0,0 +1,61 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+import { SunriseSunsetTable } from './sunrise-sunset-table'
+
+const LATITUDE = 49.50564
+const LONGITUDE = 5.94365
+
+describe(SunriseSunsetTable.name, () => {
+  afterEach(() => {
+    SunriseSunsetTable.clearCache()
+  })
+
+  describe(SunriseSunsetTable.forLocation.name, () => {
+    it('holds one entry per day of an ordinary year', () => {
+      const table = SunriseSunsetTable.forLocation(LATITUDE, LONGITUDE, 2023)
+      expect(table.length).toBe(365)
+    })
+
+    it('holds one entry per day of a leap year', () => {
+      const table = SunriseSunsetTable.forLocation(LATITUDE, LONGITUDE, 2024)
+      expect(table.length).toBe(366)
+    })
+
+    it('reuses the table of the same location and year', () => {
+      const table = SunriseSunsetTable.forLocation(LATITUDE, LONGITUDE, 2024)
+      expect(SunriseSunsetTable.forLocation(LATITUDE, LONGITUDE, 2024)).toBe(
+        table,
+      )
+      expect(
+        SunriseSunsetTable.forLocation(LATITUDE, LONGITUDE, 2025),
+      ).not.toBe(table)
+    })
+  })
+
+  describe(SunriseSunsetTable.prototype.getUtcMinutes.name, () => {
+    it('returns the precomputed minutes of the given day', () => {
+      const table = SunriseSunsetTable.forLocation(LATITUDE, LONGITUDE, 2024)
+      const minutes = table.getUtcMinutes(201)
+      expect(minutes).toEqual(
+        SunriseSunsetTable.calculateUtcMinutes(201, 366, LATITUDE, LONGITUDE),
+      )
+      expect(Math.floor(minutes.sunriseMinutes / 60)).toBe(3)
+      expect(Math.floor(minutes.sunsetMinutes / 60)).toBe(19)
+    })
+  })
+})
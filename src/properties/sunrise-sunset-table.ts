@@ -0,0 +1,135 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+const DAYS_PER_ORDINARY_YEAR = 365
+const DAYS_PER_LEAP_YEAR = 366
+const MAXIMUM_CACHED_TABLES = 4
+/**
+ * Approximate correction for atmospheric refraction at sunrise and sunset and the size of the solar disk, in degree
+ */
+const SUNRISE_AND_SUNSET_ZENITH = 90.833
+
+export interface UtcSunriseAndSunsetMinutes {
+  sunriseMinutes: number
+  sunsetMinutes: number
+}
+
+/**
+ * Sunrise and sunset of every day of a year at a given location, in minutes
+ * since midnight UTC, computed once so that lookups are constant-time.
+ */
+export class SunriseSunsetTable {
+  private static readonly cache = new Map<string, SunriseSunsetTable>()
+
+  private readonly sunriseMinutes: Float64Array
+  private readonly sunsetMinutes: Float64Array
+
+  private constructor(latitude: number, longitude: number, year: number) {
+    const daysPerYear = SunriseSunsetTable.isLeapYear(year)
+      ? DAYS_PER_LEAP_YEAR
+      : DAYS_PER_ORDINARY_YEAR
+    this.sunriseMinutes = new Float64Array(daysPerYear)
+    this.sunsetMinutes = new Float64Array(daysPerYear)
+    for (let ordinal = 1; ordinal <= daysPerYear; ordinal++) {
+      const minutes = SunriseSunsetTable.calculateUtcMinutes(
+        ordinal,
+        daysPerYear,
+        latitude,
+        longitude,
+      )
+      this.sunriseMinutes[ordinal - 1] = minutes.sunriseMinutes
+      this.sunsetMinutes[ordinal - 1] = minutes.sunsetMinutes
+    }
+  }
+
+  static forLocation(
+    latitude: number,
+    longitude: number,
+    year: number,
+  ): SunriseSunsetTable {
+    const key = `${latitude},${longitude},${year}`
+    let table = SunriseSunsetTable.cache.get(key)
+    if (!table) {
+      if (SunriseSunsetTable.cache.size >= MAXIMUM_CACHED_TABLES) {
+        const oldestKey = SunriseSunsetTable.cache.keys().next().value
+        SunriseSunsetTable.cache.delete(oldestKey)
+      }
+      table = new SunriseSunsetTable(latitude, longitude, year)
+      SunriseSunsetTable.cache.set(key, table)
+    }
+    return table
+  }
+
+  static clearCache(): void {
+    SunriseSunsetTable.cache.clear()
+  }
+
+  get length(): number {
+    return this.sunriseMinutes.length
+  }
+
+  getUtcMinutes(ordinal: number): UtcSunriseAndSunsetMinutes {
+    return {
+      sunriseMinutes: this.sunriseMinutes[ordinal - 1],
+      sunsetMinutes: this.sunsetMinutes[ordinal - 1],
+    }
+  }
+
+  static calculateUtcMinutes(
+    ordinal: number,
+    daysPerYear: number,
+    latitude: number,
+    longitude: number,
+  ): UtcSunriseAndSunsetMinutes {
+    const fractionalYearInRad = (ordinal / daysPerYear) * 2 * Math.PI
+
+    const timeEquationInMin =
+      229.18 *
+      (0.000075 +
+        0.001868 * Math.cos(fractionalYearInRad) -
+        0.032077 * Math.sin(fractionalYearInRad) -
+        0.014615 * Math.cos(2 * fractionalYearInRad) -
+        0.040849 * Math.sin(2 * fractionalYearInRad))
+
+    const solarDeclinationAngleInRad =
+      0.006918 -
+      0.399912 * Math.cos(fractionalYearInRad) +
+      0.070257 * Math.sin(fractionalYearInRad) -
+      0.006758 * Math.cos(2 * fractionalYearInRad) +
+      0.000907 * Math.sin(2 * fractionalYearInRad) -
+      0.002697 * Math.cos(3 * fractionalYearInRad) +
+      0.00148 * Math.sin(3 * fractionalYearInRad)
+
+    const latitudeInRad = (latitude * Math.PI) / 180
+    const hourAngleInRad = Math.acos(
+      Math.cos((SUNRISE_AND_SUNSET_ZENITH * Math.PI) / 180) /
+        (Math.cos(latitudeInRad) * Math.cos(solarDeclinationAngleInRad)) -
+        Math.tan(latitudeInRad) * Math.tan(solarDeclinationAngleInRad),
+    )
+
+    const hourAngleInDeg = (hourAngleInRad * 180) / Math.PI
+    return {
+      sunriseMinutes:
+        720 - 4 * (longitude + hourAngleInDeg) - timeEquationInMin,
+      sunsetMinutes: 720 - 4 * (longitude - hourAngleInDeg) - timeEquationInMin,
+    }
+  }
+
+  private static isLeapYear(year: number): boolean {
+    return (year % 4 === 0 && year % 100 !== 0) || year % 400 === 0
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, readdir, rm } from 'fs/promises'
+import { RetentionFileProvider } from './retention-file-provider'
+
+const TEST_FOLDER_PATH = 'src/retention/test'
+const EVICTIONS_FILE_PATH = TEST_FOLDER_PATH + '/evictions.jsonl'
+
+describe(RetentionFileProvider.name, () => {
+  const createEviction = (index: number) => ({
+    time: new Date(index),
+    filename: index + '.jpg',
+    creationTime: new Date(index),
+    sizeBytes: 2048,
+  })
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER_PATH, { recursive: true })
+  })
+
+  afterEach(async () => {
+    await rm(TEST_FOLDER_PATH, { recursive: true, force: true })
+  })
+
+  describe(RetentionFileProvider.readEvictions.name, () => {
+    it('returns nothing without a file', async () => {
+      expect(
+        await RetentionFileProvider.readEvictions(EVICTIONS_FILE_PATH, 10),
+      ).toEqual([])
+    })
+
+    it('returns the latest evictions up to the limit', async () => {
+      const evictions = [1, 2, 3].map(createEviction)
+      await RetentionFileProvider.appendEvictions(
+        evictions,
+        EVICTIONS_FILE_PATH,
+      )
+      expect(
+        await RetentionFileProvider.readEvictions(EVICTIONS_FILE_PATH, 2),
+      ).toEqual(evictions.slice(1))
+    })
+  })
+
+  describe(RetentionFileProvider.appendEvictions.name, () => {
+    it('keeps a single rotated file once the file grew too large', async () => {
+      const maximumFileSizeBytes = 300
+      for (let index = 1; index <= 5; index++) {
+        await RetentionFileProvider.appendEvictions(
+          [createEviction(index)],
+          EVICTIONS_FILE_PATH,
+          maximumFileSizeBytes,
+        )
+      }
+      expect((await readdir(TEST_FOLDER_PATH)).sort()).toEqual([
+        'evictions.jsonl',
+        'evictions.jsonl.1',
+      ])
+      const evictions = await RetentionFileProvider.readEvictions(
+        EVICTIONS_FILE_PATH,
+        3,
+      )
+      expect(evictions).toEqual([3, 4, 5].map(createEviction))
+    })
+  })
+})
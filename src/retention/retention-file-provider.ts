@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { appendFile, readFile, rename, stat, writeFile } from 'fs/promises'
+import { RetentionEviction } from './entities/retention-eviction.entity'
+
+const JSON_INDENTATION_SPACES = 2
+// Holds well above the maximum number of evictions asked for at once.
+const MAXIMUM_EVICTIONS_FILE_SIZE_BYTES = 256 * 1024
+const ROTATED_FILE_SUFFIX = '.1'
+
+export class RetentionFileProvider {
+  static async readPins(filePath: string): Promise<string[]> {
+    try {
+      const data = await readFile(filePath)
+      const pins = JSON.parse(data.toString())
+      return Array.isArray(pins) ? pins : []
+    } catch (err) {
+      if (err.code !== 'ENOENT' && err.name !== 'SyntaxError') {
+        throw err
+      }
+      return []
+    }
+  }
+
+  static async writePins(pins: string[], filePath: string): Promise<void> {
+    const data = JSON.stringify(pins, null, JSON_INDENTATION_SPACES)
+    await writeFile(filePath, data)
+  }
+
+  /**
+   * Appends to the file and rotates it once it grew too large, so that only
+   * the file and its single predecessor are ever kept.
+   */
+  static async appendEvictions(
+    evictions: RetentionEviction[],
+    filePath: string,
+    maximumFileSizeBytes = MAXIMUM_EVICTIONS_FILE_SIZE_BYTES,
+  ): Promise<void> {
+    if (evictions.length === 0) {
+      return
+    }
+    const lines = evictions.map((eviction) => JSON.stringify(eviction) + '\n')
+    await appendFile(filePath, lines.join(''))
+    const { size } = await stat(filePath)
+    if (size > maximumFileSizeBytes) {
+      await rename(filePath, filePath + ROTATED_FILE_SUFFIX)
+    }
+  }
+
+  static async readEvictions(
+    filePath: string,
+    limit: number,
+  ): Promise<RetentionEviction[]> {
+    let lines = await RetentionFileProvider.readLines(filePath)
+    if (lines.length < limit) {
+      const rotatedLines = await RetentionFileProvider.readLines(
+        filePath + ROTATED_FILE_SUFFIX,
+      )
+      lines = rotatedLines.concat(lines)
+    }
+    return lines.slice(-limit).map((line) => {
+      const eviction = JSON.parse(line)
+      return {
+        ...eviction,
+        time: new Date(eviction.time),
+        creationTime: new Date(eviction.creationTime),
+      }
+    })
+  }
+
+  private static async readLines(filePath: string): Promise<string[]> {
+    let data: string
+    try {
+      data = (await readFile(filePath)).toString()
+    } catch (err) {
+      if (err.code !== 'ENOENT') {
+        throw err
+      }
+      return []
+    }
+    return data.split('\n').filter((line) => line)
+  }
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { BadRequestException, ForbiddenException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { RetentionController } from './retention.controller'
+import { RetentionService } from './retention.service'
+import { IRetentionService } from './retention.service.interface'
+
+describe(RetentionController.name, () => {
+  class MockRetentionService implements Partial<IRetentionService> {
+    getPins = vi.fn(() => Promise.resolve(['a.jpg']))
+    pinShot = vi.fn(() => Promise.resolve())
+    unpinShot = vi.fn(() => Promise.resolve())
+    getEvictions = vi.fn(() => Promise.resolve([]))
+  }
+
+  let controller: RetentionController
+  let service: RetentionService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [RetentionController],
+      providers: [{ provide: RetentionService, useClass: MockRetentionService }],
+    }).compile()
+
+    controller = module.get<RetentionController>(RetentionController)
+    service = module.get<RetentionService>(RetentionService)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(RetentionController.prototype.getPins.name, () => {
+    it('returns the pins', async () => {
+      expect(await controller.getPins()).toEqual(['a.jpg'])
+    })
+  })
+
+  describe(RetentionController.prototype.pinShot.name, () => {
+    it('asks for pinning the shot', async () => {
+      await controller.pinShot('a.jpg')
+      expect(service.pinShot).toHaveBeenCalledWith('a.jpg')
+    })
+
+    it('rejects paths', () => {
+      expect(() => controller.pinShot('../a.jpg')).toThrow(ForbiddenException)
+    })
+  })
+
+  describe(RetentionController.prototype.unpinShot.name, () => {
+    it('asks for unpinning the shot', async () => {
+      await controller.unpinShot('a.jpg')
+      expect(service.unpinShot).toHaveBeenCalledWith('a.jpg')
+    })
+
+    it('rejects paths', () => {
+      expect(() => controller.unpinShot('../a.jpg')).toThrow(ForbiddenException)
+    })
+  })
+
+  describe(RetentionController.prototype.getEvictions.name, () => {
+    it('asks for the evictions with the limit', async () => {
+      await controller.getEvictions(5)
+      expect(service.getEvictions).toHaveBeenCalledWith(5)
+    })
+
+    it('rejects a limit below one', () => {
+      expect(() => controller.getEvictions(0)).toThrow(BadRequestException)
+      expect(() => controller.getEvictions(-1)).toThrow(BadRequestException)
+      expect(service.getEvictions).not.toHaveBeenCalled()
+    })
+
+    it('rejects a limit above the maximum', () => {
+      expect(() => controller.getEvictions(1001)).toThrow(BadRequestException)
+    })
+  })
+})
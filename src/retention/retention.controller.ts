@@ -0,0 +1,70 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  BadRequestException,
+  Controller,
+  DefaultValuePipe,
+  Delete,
+  ForbiddenException,
+  Get,
+  Param,
+  ParseIntPipe,
+  Put,
+  Query,
+} from '@nestjs/common'
+import { RetentionEviction } from './entities/retention-eviction.entity'
+import { RetentionService } from './retention.service'
+
+const DEFAULT_EVICTIONS_LIMIT = 100
+const MAXIMUM_EVICTIONS_LIMIT = 1000
+
+@Controller('retention')
+export class RetentionController {
+  constructor(private readonly retentionService: RetentionService) {}
+
+  @Get('pins')
+  getPins(): Promise<string[]> {
+    return this.retentionService.getPins()
+  }
+
+  @Put('pins/:filename')
+  pinShot(@Param('filename') filename: string): Promise<void> {
+    if (filename.includes('/')) {
+      throw new ForbiddenException()
+    }
+    return this.retentionService.pinShot(filename)
+  }
+
+  @Delete('pins/:filename')
+  unpinShot(@Param('filename') filename: string): Promise<void> {
+    if (filename.includes('/')) {
+      throw new ForbiddenException()
+    }
+    return this.retentionService.unpinShot(filename)
+  }
+
+  @Get('evictions')
+  getEvictions(
+    @Query('limit', new DefaultValuePipe(DEFAULT_EVICTIONS_LIMIT), ParseIntPipe)
+    limit: number,
+  ): Promise<RetentionEviction[]> {
+    if (limit < 1 || limit > MAXIMUM_EVICTIONS_LIMIT) {
+      throw new BadRequestException()
+    }
+    return this.retentionService.getEvictions(limit)
+  }
+}
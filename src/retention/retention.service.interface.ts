@@ -0,0 +1,10 @@
+import { RetentionEviction } from './entities/retention-eviction.entity'
+
+export interface IRetentionService {
+  enforceRetention: () => Promise<void>
+  evictUntilLowWaterMark: () => Promise<RetentionEviction[]>
+  getPins: () => Promise<string[]>
+  pinShot: (filename: string) => Promise<void>
+  unpinShot: (filename: string) => Promise<void>
+  getEvictions: (limit: number) => Promise<RetentionEviction[]>
+}
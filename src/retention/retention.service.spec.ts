@@ -0,0 +1,176 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { ConfigService } from '@nestjs/config'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { IndexedShot } from '../files/entities/indexed-shot.entity'
+import { FilesService } from '../files/files.service'
+import { IFilesService } from '../files/files.service.interface'
+import { ShotIndex } from '../files/shot-index'
+import { StorageService } from '../storage/storage.service'
+import { IStorageService } from '../storage/storage.service.interface'
+import { RetentionFileProvider } from './retention-file-provider'
+import { RetentionService } from './retention.service'
+
+const HOUR_MILLISECONDS = 3600000
+
+describe(RetentionService.name, () => {
+  const now = Date.now()
+  const SHOTS: IndexedShot[] = [
+    {
+      name: 'a.jpg',
+      creationTime: new Date(now - 50 * HOUR_MILLISECONDS),
+      sizeBytes: 2048,
+    },
+    {
+      name: 'b.jpg',
+      creationTime: new Date(now - 40 * HOUR_MILLISECONDS),
+      sizeBytes: 2048,
+    },
+    {
+      name: 'c.jpg',
+      creationTime: new Date(now - 30 * HOUR_MILLISECONDS),
+      sizeBytes: 2048,
+    },
+    {
+      name: 'd.jpg',
+      creationTime: new Date(now - 1 * HOUR_MILLISECONDS),
+      sizeBytes: 2048,
+    },
+  ]
+  const CONFIG = {
+    isRetentionEnabled: true,
+    retentionLowWaterMarkPercentage: 10,
+    retentionMinimumAgeHours: 24,
+  }
+
+  let availableKb: number
+  const spyRemoveFiles = vi.fn(async (filenames: string[]) => {
+    availableKb += filenames.length * 2
+    return Object.assign({}, ...filenames.map((name) => ({ [name]: true })))
+  })
+
+  class MockConfigService implements Partial<ConfigService> {
+    get = vi.fn((key: string) => CONFIG[key])
+  }
+
+  class MockFilesService implements Partial<IFilesService> {
+    removeFiles = spyRemoveFiles
+  }
+
+  class MockShotIndex implements Partial<ShotIndex> {
+    getShotsOldestFirst = async () => SHOTS
+  }
+
+  class MockStorageService implements Partial<IStorageService> {
+    getStorageUsage = async () => ({
+      availableKb,
+      capacityKb: 100,
+      usedPercentage: 100 - availableKb,
+      writeRateKbPerSecond: null,
+      secondsUntilFull: null,
+      secondsUntilMotionPause: null,
+    })
+  }
+
+  let service: RetentionService
+  let spyReadPins
+  let spyAppendEvictions
+
+  beforeEach(async () => {
+    spyRemoveFiles.mockClear()
+    spyReadPins = vi
+      .spyOn(RetentionFileProvider, 'readPins')
+      .mockResolvedValue([])
+    spyAppendEvictions = vi
+      .spyOn(RetentionFileProvider, 'appendEvictions')
+      .mockResolvedValue()
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: ConfigService, useClass: MockConfigService },
+        { provide: FilesService, useClass: MockFilesService },
+        { provide: ShotIndex, useClass: MockShotIndex },
+        { provide: StorageService, useClass: MockStorageService },
+        RetentionService,
+      ],
+    }).compile()
+
+    service = module.get<RetentionService>(RetentionService)
+  })
+
+  describe(RetentionService.prototype.evictUntilLowWaterMark.name, () => {
+    it('does nothing above the low-water mark', async () => {
+      availableKb = 20
+      const evictions = await service.evictUntilLowWaterMark()
+      expect(evictions).toEqual([])
+      expect(spyRemoveFiles).not.toHaveBeenCalled()
+    })
+
+    it('evicts the oldest shots until the low-water mark is reached', async () => {
+      availableKb = 7
+      const evictions = await service.evictUntilLowWaterMark()
+      expect(evictions.map((eviction) => eviction.filename)).toEqual([
+        'a.jpg',
+        'b.jpg',
+      ])
+      expect(spyAppendEvictions).toHaveBeenCalledWith(
+        evictions,
+        expect.any(String),
+      )
+    })
+
+    it('skips pinned shots and never evicts shots below the minimum age', async () => {
+      availableKb = 0
+      spyReadPins.mockResolvedValue(['b.jpg'])
+      const evictions = await service.evictUntilLowWaterMark()
+      expect(evictions.map((eviction) => eviction.filename)).toEqual([
+        'a.jpg',
+        'c.jpg',
+      ])
+    })
+  })
+
+  describe(RetentionService.prototype.enforceRetention.name, () => {
+    it('does nothing when disabled', async () => {
+      availableKb = 0
+      CONFIG.isRetentionEnabled = false
+      await service.enforceRetention()
+      expect(spyRemoveFiles).not.toHaveBeenCalled()
+      CONFIG.isRetentionEnabled = true
+    })
+  })
+
+  describe(RetentionService.prototype.pinShot.name, () => {
+    it('adds the filename to the pins', async () => {
+      const spyWritePins = vi
+        .spyOn(RetentionFileProvider, 'writePins')
+        .mockResolvedValue()
+      spyReadPins.mockResolvedValue(['a.jpg'])
+      await service.pinShot('b.jpg')
+      expect(spyWritePins).toHaveBeenCalledWith(
+        ['a.jpg', 'b.jpg'],
+        expect.any(String),
+      )
+      spyWritePins.mockRestore()
+    })
+  })
+
+  afterEach(() => {
+    spyReadPins.mockRestore()
+    spyAppendEvictions.mockRestore()
+  })
+})
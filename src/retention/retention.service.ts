@@ -0,0 +1,160 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { Injectable, Logger } from '@nestjs/common'
+import { ConfigService } from '@nestjs/config'
+import { Cron } from '@nestjs/schedule'
+import { IndexedShot } from '../files/entities/indexed-shot.entity'
+import { FilesService } from '../files/files.service'
+import { ShotIndex } from '../files/shot-index'
+import { StorageService } from '../storage/storage.service'
+import { RetentionEviction } from './entities/retention-eviction.entity'
+import { RetentionFileProvider } from './retention-file-provider'
+import { IRetentionService } from './retention.service.interface'
+
+const PINS_FILE_PATH = 'retention-pins.json'
+const EVICTIONS_FILE_PATH = 'retention-evictions.jsonl'
+const EVICTION_BATCH_SIZE = 50
+const BYTES_PER_KB = 1024
+const MILLISECONDS_PER_HOUR = 3600000
+
+@Injectable()
+export class RetentionService implements IRetentionService {
+  private readonly logger = new Logger(RetentionService.name)
+  private isEnforcing = false
+
+  constructor(
+    private readonly configService: ConfigService,
+    private readonly filesService: FilesService,
+    private readonly shotIndex: ShotIndex,
+    private readonly storageService: StorageService,
+  ) {}
+
+  @Cron('* * * * *') // every minute
+  async enforceRetention(): Promise<void> {
+    if (!this.configService.get<boolean>('isRetentionEnabled')) {
+      return
+    }
+    if (this.isEnforcing) {
+      return
+    }
+    this.isEnforcing = true
+    try {
+      await this.evictUntilLowWaterMark()
+    } catch (error) {
+      this.logger.error(`Enforcing retention failed: ${error.message}`)
+    } finally {
+      this.isEnforcing = false
+    }
+  }
+
+  async evictUntilLowWaterMark(): Promise<RetentionEviction[]> {
+    let kbToFree = await this.getKbToFree()
+    if (kbToFree <= 0) {
+      return []
+    }
+
+    const pins = new Set(await this.getPins())
+    const minimumAgeHours = this.configService.get<number>(
+      'retentionMinimumAgeHours',
+    )
+    const youngestEvictableTime =
+      Date.now() - minimumAgeHours * MILLISECONDS_PER_HOUR
+    const candidates = (await this.shotIndex.getShotsOldestFirst()).filter(
+      (shot) =>
+        !pins.has(shot.name) &&
+        shot.creationTime.getTime() < youngestEvictableTime,
+    )
+
+    const evictions: RetentionEviction[] = []
+    let candidateIndex = 0
+    while (kbToFree > 0 && candidateIndex < candidates.length) {
+      const batch: IndexedShot[] = []
+      let batchKb = 0
+      while (
+        candidateIndex < candidates.length &&
+        batch.length < EVICTION_BATCH_SIZE &&
+        batchKb < kbToFree
+      ) {
+        const shot = candidates[candidateIndex++]
+        batch.push(shot)
+        batchKb += shot.sizeBytes / BYTES_PER_KB
+      }
+      const batchEvictions = await this.evictShots(batch)
+      evictions.push(...batchEvictions)
+      kbToFree = await this.getKbToFree()
+    }
+
+    if (evictions.length > 0) {
+      this.logger.log(`Evicted ${evictions.length} shots`)
+    }
+    if (kbToFree > 0) {
+      this.logger.warn(
+        `Low-water mark not reached, ${Math.round(kbToFree)} KB still missing as remaining shots are pinned or too young`,
+      )
+    }
+    return evictions
+  }
+
+  async getPins(): Promise<string[]> {
+    return RetentionFileProvider.readPins(PINS_FILE_PATH)
+  }
+
+  async pinShot(filename: string): Promise<void> {
+    const pins = await this.getPins()
+    if (!pins.includes(filename)) {
+      pins.push(filename)
+      await RetentionFileProvider.writePins(pins, PINS_FILE_PATH)
+    }
+  }
+
+  async unpinShot(filename: string): Promise<void> {
+    const pins = await this.getPins()
+    const remainingPins = pins.filter((pin) => pin !== filename)
+    if (remainingPins.length !== pins.length) {
+      await RetentionFileProvider.writePins(remainingPins, PINS_FILE_PATH)
+    }
+  }
+
+  async getEvictions(limit: number): Promise<RetentionEviction[]> {
+    return RetentionFileProvider.readEvictions(EVICTIONS_FILE_PATH, limit)
+  }
+
+  private async getKbToFree(): Promise<number> {
+    const lowWaterMarkPercentage = this.configService.get<number>(
+      'retentionLowWaterMarkPercentage',
+    )
+    const usage = await this.storageService.getStorageUsage()
+    return (usage.capacityKb * lowWaterMarkPercentage) / 100 - usage.availableKb
+  }
+
+  private async evictShots(shots: IndexedShot[]): Promise<RetentionEviction[]> {
+    const result = await this.filesService.removeFiles(
+      shots.map((shot) => shot.name),
+    )
+    const time = new Date()
+    const evictions = shots
+      .filter((shot) => result[shot.name])
+      .map((shot) => ({
+        time,
+        filename: shot.name,
+        creationTime: shot.creationTime,
+        sizeBytes: shot.sizeBytes,
+      }))
+    await RetentionFileProvider.appendEvictions(evictions, EVICTIONS_FILE_PATH)
+    return evictions
+  }
+}
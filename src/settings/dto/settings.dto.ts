@@ -31,10 +31,16 @@ import {
   Min,
   ValidateNested,
 } from 'class-validator'
+import { MovieEncodingSelection } from '../../movie-encoding/entities/movie-encoding-profile.entity'
+import { MOVIE_ENCODING_SELECTIONS } from '../../movie-encoding/movie-encoding-profiles'
 import { LightType } from '../entities/settings'
 
 type ShotType = 'pictures' | 'videos'
 
+const MOVIE_ENCODING_SELECTION_REGEX = new RegExp(
+  `^(${MOVIE_ENCODING_SELECTIONS.join('|')})$`,
+)
+
 export class TriggeringTimeDto {
   @IsNotEmpty()
   @Min(0)
@@ -57,6 +63,10 @@ class CameraSettingsPatchDto {
   @Min(0)
   focus?: number
 
+  @IsOptional()
+  @Matches(MOVIE_ENCODING_SELECTION_REGEX)
+  movieEncodingProfile?: MovieEncodingSelection
+
   @IsOptional()
   @IsInt()
   @Min(0)
@@ -172,6 +182,11 @@ export class CameraSettingsPutDto {
   @Min(0)
   focus: number
 
+  // Optional for clients that do not know about encoding profiles yet
+  @IsOptional()
+  @Matches(MOVIE_ENCODING_SELECTION_REGEX)
+  movieEncodingProfile?: MovieEncodingSelection
+
   @IsNotEmpty()
   @IsInt()
   @Min(0)
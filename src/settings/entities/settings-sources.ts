@@ -0,0 +1,48 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { ShotTypes } from './shot-types'
+
+export type SettingsSource = 'driver' | 'file' | 'motion' | 'os'
+
+export const SETTINGS_SOURCES: SettingsSource[] = [
+  'driver',
+  'file',
+  'motion',
+  'os',
+]
+
+export interface DriverSettings {
+  focus: number
+  focusMaximum: number
+  focusMinimum: number
+}
+
+export interface MotionSettings {
+  // Focus as configured in Motion's video parameters, not yet adapted to
+  // the camera light. Null if Motion does not set it.
+  focus: number | null
+  pictureQuality: number
+  shotTypes: ShotTypes
+  threshold: number
+  thresholdMaximum: number
+  videoQuality: number
+}
+
+export interface OsSettings {
+  password: string
+  timeZone: string
+}
@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
+import { MovieEncodingSelection } from '../../movie-encoding/entities/movie-encoding-profile.entity'
 import TriggeringTime from '../../shared/entities/triggering-time'
 
 export class SettingsFromJsonFile {
@@ -51,11 +52,13 @@ type ShotType = 'pictures' | 'videos'
 export interface CameraSettings extends CameraSettingsFromJsonFile {
   isFocusEnabled: boolean
   isLightEnabled: boolean
+  isMovieEncodingProfileEnabled: boolean
   isPictureQualityEnabled: boolean
   isShotTypesEnabled: boolean
   focus: number
   focusMaximum: number
   focusMinimum: number
+  movieEncodingProfile: MovieEncodingSelection
   pictureQuality: number
   shotTypes: ShotType[]
   videoQuality: number
@@ -14,14 +14,14 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
 import { Logger } from '@nestjs/common'
+import {
+  CommandOutput,
+  PrivilegedHelperClient,
+} from '../../privileged-helper/privileged-helper-client'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
-
 export class AccessPointInteractor {
   static async setAccessPointNameOrPassword(
     name: string,
@@ -36,15 +36,22 @@ export class AccessPointInteractor {
       )
       return
     }
-    const currentWorkingDirectory = process.cwd()
-    let command = `sudo ${currentWorkingDirectory}/scripts/runtime/variscite/access-point/change-access-point-name-or-password.sh`
-    if (name) {
-      command += ` -n ${name}`
-    }
-    if (password) {
-      command += ` -p ${password}`
+    let output: CommandOutput
+    if (name && password) {
+      output = await PrivilegedHelperClient.run(
+        'set-access-point-name-and-password',
+        [name, password],
+      )
+    } else if (name) {
+      output = await PrivilegedHelperClient.run('set-access-point-name', [name])
+    } else if (password) {
+      output = await PrivilegedHelperClient.run('set-access-point-password', [
+        password,
+      ])
+    } else {
+      return
     }
-    const { stderr } = await exec(command)
+    const { stderr } = output
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
@@ -61,9 +68,9 @@ export class AccessPointInteractor {
       )
       return
     }
-    const currentWorkingDirectory = process.cwd()
-    const command = `sudo ${currentWorkingDirectory}/scripts/runtime/variscite/access-point/get-access-point-password.sh`
-    const { stdout, stderr } = await exec(command)
+    const { stdout, stderr } = await PrivilegedHelperClient.run(
+      'get-access-point-password',
+    )
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
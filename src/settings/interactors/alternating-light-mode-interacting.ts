@@ -14,19 +14,16 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { PrivilegedHelperClient } from '../../privileged-helper/privileged-helper-client'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
-
 export class AlternatingLightModeInteractor {
   static async setLights(deviceType: string): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const currentWorkingDirectory = process.cwd()
-    const { stderr } = await exec(
-      `sudo ${currentWorkingDirectory}/scripts/runtime/set-alternating-lights.sh ${deviceType}`,
+    const { stderr } = await PrivilegedHelperClient.run(
+      'set-alternating-lights',
+      [deviceType],
     )
     if (stderr) {
       throw new CommandExecutionException(stderr)
@@ -14,16 +14,13 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
 import { Logger } from '@nestjs/common'
 import { DateTime } from 'luxon'
+import { PrivilegedHelperClient } from '../../privileged-helper/privileged-helper-client'
 import TriggeringTime from '../../shared/entities/triggering-time'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
-
 const WITTY_PI_END_YEARS_FROM_NOW = 10
 
 export class SleepInteractor {
@@ -32,15 +29,14 @@ export class SleepInteractor {
     logger: Logger,
   ): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const currentWorkingDirectory = process.cwd()
     const wakingUpDateTime = DateTime.fromISO(wakingUpDateTimeIso)
     const wakingUpDateTimeString = wakingUpDateTime.toFormat(
       'dd LLL yyyy HH:mm:ss',
     )
     logger.log(`Waking up time: ${wakingUpDateTimeString}`)
-    const { stderr } = await exec(
-      `sudo ${currentWorkingDirectory}/scripts/runtime/variscite/rtc/sleep_until "${wakingUpDateTimeString}"`,
-    )
+    const { stderr } = await PrivilegedHelperClient.run('sleep-until', [
+      wakingUpDateTimeString,
+    ])
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
@@ -51,10 +47,9 @@ export class SleepInteractor {
     wakingUpTime: TriggeringTime,
   ): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const currentWorkingDirectory = process.cwd()
     if (!sleepingTime || !wakingUpTime) {
-      const { stderr } = await exec(
-        `sudo ${currentWorkingDirectory}/scripts/runtime/raspberry-pi/working-hours/remove-working-hours-schedule.sh`,
+      const { stderr } = await PrivilegedHelperClient.run(
+        'remove-working-hours-schedule',
       )
       if (stderr) {
         throw new CommandExecutionException(stderr)
@@ -92,8 +87,9 @@ export class SleepInteractor {
     if (difference_to_24_h_minutes) {
       offValue += ` M${difference_to_24_h_minutes}`
     }
-    const { stderr } = await exec(
-      `sudo ${currentWorkingDirectory}/scripts/runtime/raspberry-pi/working-hours/create-working-hours-schedule.sh "${beginValue}" "${endValue}" "${onValue}" "${offValue}"`,
+    const { stderr } = await PrivilegedHelperClient.run(
+      'create-working-hours-schedule',
+      [beginValue, endValue, onValue, offValue],
     )
     if (stderr) {
       throw new CommandExecutionException(stderr)
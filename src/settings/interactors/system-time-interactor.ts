@@ -14,16 +14,17 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
 import { Logger } from '@nestjs/common'
 import { DateTime } from 'luxon'
+import { exec } from '../../metrics/measured-exec'
+import {
+  CommandOutput,
+  PrivilegedHelperClient,
+} from '../../privileged-helper/privileged-helper-client'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 import { DateConverter } from '../date-converter'
 
-const exec = promisify(execSync)
-
 export class SystemTimeInteractor {
   static async getSystemTimeInIso8601Format(): Promise<string> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
@@ -45,33 +46,33 @@ export class SystemTimeInteractor {
   ): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
     const systemTimeTransformed = DateConverter.convertIsoToYMDHMSFormat(time)
-    const { stderr } = await exec(
-      `sudo timedatectl set-time "${systemTimeTransformed}"`,
-    )
+    const { stderr } = await PrivilegedHelperClient.run('set-system-time', [
+      systemTimeTransformed,
+    ])
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
 
-    let rtcSettingPathAndCommand = 'scripts/runtime/'
+    let rtcOutput: CommandOutput
     if (deviceType === 'RaspberryPi') {
-      rtcSettingPathAndCommand += 'raspberry-pi/write-system-time-to-rtc.sh'
+      rtcOutput = await PrivilegedHelperClient.run(
+        'write-system-time-to-rtc-raspberry-pi',
+      )
     } else if (deviceType === 'Variscite') {
       const dateTime = DateTime.fromISO(time)
       const settingRtcTimeString = dateTime.toFormat('ccc dd LLL yyyy HH:mm:ss')
       logger.log(`Setting RTC time: ${settingRtcTimeString}`)
-      rtcSettingPathAndCommand += `variscite/rtc/set_time "${settingRtcTimeString}"`
+      rtcOutput = await PrivilegedHelperClient.run('set-rtc-time-variscite', [
+        settingRtcTimeString,
+      ])
     } else {
       logger.error(
         `No script for setting RTC time for device type ${deviceType} configured.`,
       )
       return Promise.resolve()
     }
-    const currentWorkingDirectory = process.cwd()
-    const { stderr: rtcStderr } = await exec(
-      `sudo ${currentWorkingDirectory}/${rtcSettingPathAndCommand}`,
-    )
-    if (rtcStderr) {
-      throw new CommandExecutionException(rtcStderr)
+    if (rtcOutput.stderr) {
+      throw new CommandExecutionException(rtcOutput.stderr)
     }
   }
 
@@ -89,7 +90,9 @@ export class SystemTimeInteractor {
 
   static async setTimeZone(timeZone: string): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(`sudo timedatectl set-timezone "${timeZone}"`)
+    const { stderr } = await PrivilegedHelperClient.run('set-time-zone', [
+      timeZone,
+    ])
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
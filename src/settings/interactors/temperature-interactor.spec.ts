@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, rm, writeFile } from 'fs/promises'
+import path from 'path'
+import { TemperatureInteractor } from './temperature-interactor'
+
+describe(TemperatureInteractor.name, () => {
+  const TEST_FOLDER = 'src/settings/interactors/test-temperature-interactor'
+  const VALID_OUTPUT =
+    '72 01 4b 46 7f ff 0e 10 57 : crc=57 YES\n' +
+    '72 01 4b 46 7f ff 0e 10 57 t=23125\n'
+  const FAILED_CRC_OUTPUT =
+    '72 01 4b 46 7f ff 0e 10 57 : crc=00 NO\n' +
+    '72 01 4b 46 7f ff 0e 10 57 t=85000\n'
+
+  async function writeSensorOutput(folderName: string, output: string) {
+    await mkdir(path.join(TEST_FOLDER, folderName))
+    await writeFile(path.join(TEST_FOLDER, folderName, 'w1_slave'), output)
+  }
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+  })
+
+  describe(TemperatureInteractor.parseSensorOutput.name, () => {
+    it('converts millidegrees to degrees', () => {
+      expect(TemperatureInteractor.parseSensorOutput(VALID_OUTPUT)).toBe(23.13)
+    })
+
+    it('parses negative temperatures', () => {
+      const output = VALID_OUTPUT.replace('t=23125', 't=-4500')
+      expect(TemperatureInteractor.parseSensorOutput(output)).toBe(-4.5)
+    })
+
+    it('returns NaN when the CRC check failed', () => {
+      expect(
+        TemperatureInteractor.parseSensorOutput(FAILED_CRC_OUTPUT),
+      ).toBeNaN()
+    })
+  })
+
+  describe(TemperatureInteractor.getCurrentTemperature.name, () => {
+    it('reads the first sensor giving a valid reading', async () => {
+      await writeSensorOutput('28-000000000001', FAILED_CRC_OUTPUT)
+      await writeSensorOutput('28-000000000002', VALID_OUTPUT)
+      await mkdir(path.join(TEST_FOLDER, 'w1_bus_master1'))
+      const temperature =
+        await TemperatureInteractor.getCurrentTemperature(TEST_FOLDER)
+      expect(temperature).toBe(23.13)
+    })
+
+    it('resolves to NaN without any sensor', async () => {
+      const temperature =
+        await TemperatureInteractor.getCurrentTemperature(TEST_FOLDER)
+      expect(temperature).toBeNaN()
+    })
+  })
+
+  afterEach(async () => {
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
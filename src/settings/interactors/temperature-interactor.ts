@@ -14,25 +14,69 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
-import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
+import { readdir, readFile } from 'fs/promises'
+import path from 'path'
+import { MetricsRegistry } from '../../metrics/metrics-registry'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
+const MILLIDEGREES_PER_DEGREE = 1000
+const SENSOR_FOLDER_PREFIX = '28-'
+const W1_DEVICES_FOLDER_PATH = '/sys/bus/w1/devices'
 
 export class TemperatureInteractor {
-  static async getCurrentTemperature(): Promise<number> {
+  /**
+   * Reads the first connected DS18B20 sensor straight from sysfs, the same way
+   * the read_air_temp helper does, without spawning a process.
+   * Resolves to NaN when no sensor gives a valid reading.
+   */
+  static async getCurrentTemperature(
+    devicesFolderPath = W1_DEVICES_FOLDER_PATH,
+  ): Promise<number> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const currentWorkingDirectory = process.cwd()
-    const { stdout, stderr } = await exec(
-      `${currentWorkingDirectory}/scripts/runtime/raspberry-pi/air-temperature/read_air_temp`,
+    return MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'readAirTemperature'],
+      async () => {
+        const folderNames = (await readdir(devicesFolderPath)).filter(
+          (folderName) => folderName.startsWith(SENSOR_FOLDER_PREFIX),
+        )
+        for (const folderName of folderNames.sort()) {
+          let output: string
+          try {
+            output = await readFile(
+              path.join(devicesFolderPath, folderName, 'w1_slave'),
+              { encoding: 'utf8' },
+            )
+          } catch {
+            continue
+          }
+          const temperature = TemperatureInteractor.parseSensorOutput(output)
+          if (!Number.isNaN(temperature)) {
+            return temperature
+          }
+        }
+        return NaN
+      },
     )
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
+  }
+
+  /**
+   * The first line of w1_slave ends with YES when the CRC check passed, the
+   * second one holds the temperature in millidegrees after "t=".
+   */
+  static parseSensorOutput(output: string): number {
+    const [checkLine, valueLine] = output.split('\n')
+    if (!checkLine?.includes('YES') || !valueLine) {
+      return NaN
+    }
+    const valueIndex = valueLine.indexOf('t=')
+    if (valueIndex < 0) {
+      return NaN
+    }
+    const millidegrees = parseInt(valueLine.substring(valueIndex + 2), 10)
+    if (Number.isNaN(millidegrees)) {
+      return NaN
     }
-    const line = stdout.trim()
-    const value = parseFloat(line)
-    return value
+    return Math.round((millidegrees / MILLIDEGREES_PER_DEGREE) * 100) / 100
   }
 }
@@ -14,14 +14,11 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { PrivilegedHelperClient } from '../../privileged-helper/privileged-helper-client'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 import { FocusValueOutOfRange } from '../exceptions/FocusValueOutOfRange'
 
-const exec = promisify(execSync)
-
 interface FocusDetails {
   default?: number
   min?: number
@@ -32,12 +29,22 @@ interface FocusDetails {
 export class VideoDeviceInteractor {
   static async getFocus(devicePath: string): Promise<FocusDetails> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const command = `sudo v4l2-ctl -d ${devicePath} -l | grep focus_absolute`
-    const { stdout, stderr } = await exec(command)
+    const { stdout, stderr } = await PrivilegedHelperClient.run(
+      'get-camera-controls',
+      [devicePath],
+    )
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
-    const line = stdout.trim()
+    const line = stdout
+      .split('\n')
+      .find((controlLine) => controlLine.includes('focus_absolute'))
+      ?.trim()
+    if (!line) {
+      throw new CommandExecutionException(
+        `No focus control found for ${devicePath}.`,
+      )
+    }
     const controlMapping = line.split(': ')
     const focusMappings = controlMapping[1].split(' ')
     const focusMappingsAsObject: FocusDetails = {}
@@ -58,9 +65,10 @@ export class VideoDeviceInteractor {
         `Focus value ${focus} not between ${currentFocus.min} and ${currentFocus.max}!`,
       )
     }
-    const currentWorkingDirectory = process.cwd()
-    const command = `sudo ${currentWorkingDirectory}/scripts/runtime/raspberry-pi/set-camera-focus.sh ${devicePath} ${focus}`
-    const { stderr } = await exec(command)
+    const { stderr } = await PrivilegedHelperClient.run('set-camera-focus', [
+      devicePath,
+      `${focus}`,
+    ])
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
@@ -14,7 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { mkdir, rm } from 'fs/promises'
+import { mkdir, rm, writeFile } from 'fs/promises'
 import { SettingsFromJsonFile } from './entities/settings'
 import {
   JSON_SETTINGS_WITH_NONE_SET,
@@ -119,6 +119,35 @@ describe(SettingsFileProvider.name, () => {
       expect(settingsRetrieved).toEqual(SETTINGS)
     })
 
+    it('updates an already read file in the cache', async () => {
+      await SettingsFileProvider.readSettingsFile(TEMPORARY_FILE_PATH)
+      const settings = {
+        ...JSON_SETTINGS_WITH_NONE_SET,
+        general: { deviceName: 'e' },
+      }
+      await SettingsFileProvider.writeSettingsToFile(
+        settings,
+        TEMPORARY_FILE_PATH,
+      )
+      await writeFile(TEMPORARY_FILE_PATH, '{}')
+      const settingsRetrieved =
+        await SettingsFileProvider.readSettingsFile(TEMPORARY_FILE_PATH)
+      expect(settingsRetrieved).toEqual(settings)
+      SettingsFileProvider.invalidateCache(TEMPORARY_FILE_PATH)
+      const settingsReread =
+        await SettingsFileProvider.readSettingsFile(TEMPORARY_FILE_PATH)
+      expect(settingsReread).toEqual(JSON_SETTINGS_WITH_NONE_SET)
+    })
+
+    it('returns a copy that can be changed without affecting the cache', async () => {
+      const settings =
+        await SettingsFileProvider.readSettingsFile(TEMPORARY_FILE_PATH)
+      settings.general.deviceName = 'f'
+      const settingsRetrieved =
+        await SettingsFileProvider.readSettingsFile(TEMPORARY_FILE_PATH)
+      expect(settingsRetrieved.general.deviceName).toBeUndefined()
+    })
+
     afterAll(async () => {
       rm(TEST_FOLDER_PATH, { recursive: true, force: true })
     })
@@ -32,8 +32,38 @@ export const JSON_SETTINGS_WITH_NONE_SET: SettingsFromJsonFile = {
 }
 
 export class SettingsFileProvider {
+  // Parsed content per file path; callers always get their own copy.
+  private static readonly cache = new Map<string, SettingsFromJsonFile>()
+
   static async readSettingsFile(
     filePath: string,
+  ): Promise<SettingsFromJsonFile> {
+    if (!this.cache.has(filePath)) {
+      this.cache.set(filePath, await this.readAndParseSettingsFile(filePath))
+    }
+    return structuredClone(this.cache.get(filePath))
+  }
+
+  static async writeSettingsToFile(
+    settings: SettingsFromJsonFile,
+    filePath: string,
+  ) {
+    const data = JSON.stringify(settings, null, JSON_INDENTATION_SPACES)
+    await writeFile(filePath, data)
+    if (this.cache.has(filePath)) {
+      this.cache.set(filePath, {
+        ...JSON_SETTINGS_WITH_NONE_SET,
+        ...JSON.parse(data),
+      })
+    }
+  }
+
+  static invalidateCache(filePath: string): void {
+    this.cache.delete(filePath)
+  }
+
+  private static async readAndParseSettingsFile(
+    filePath: string,
   ): Promise<SettingsFromJsonFile> {
     try {
       const buffer = await readFile(filePath)
@@ -51,12 +81,4 @@ export class SettingsFileProvider {
       return JSON_SETTINGS_WITH_NONE_SET
     }
   }
-
-  static async writeSettingsToFile(
-    settings: SettingsFromJsonFile,
-    filePath: string,
-  ) {
-    const data = JSON.stringify(settings, null, JSON_INDENTATION_SPACES)
-    await writeFile(filePath, data)
-  }
 }
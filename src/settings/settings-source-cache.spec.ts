@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { vi } from 'vitest'
+import { SettingsSourceCache } from './settings-source-cache'
+
+describe(SettingsSourceCache.name, () => {
+  describe(SettingsSourceCache.prototype.get.name, () => {
+    it('loads only once', async () => {
+      const load = vi.fn().mockResolvedValue(1)
+      const cache = new SettingsSourceCache(load)
+      const values = await Promise.all([cache.get(), cache.get()])
+      expect(values).toEqual([1, 1])
+      expect(await cache.get()).toBe(1)
+      expect(load).toHaveBeenCalledTimes(1)
+    })
+
+    it('does not cache an unavailable source', async () => {
+      const load = vi.fn().mockResolvedValueOnce(undefined).mockResolvedValue(2)
+      const cache = new SettingsSourceCache(load)
+      expect(await cache.get()).toBeUndefined()
+      expect(await cache.get()).toBe(2)
+      expect(load).toHaveBeenCalledTimes(2)
+    })
+  })
+
+  describe(SettingsSourceCache.prototype.update.name, () => {
+    it('changes the cached value', async () => {
+      const cache = new SettingsSourceCache(async () => ({ a: 1 }))
+      await cache.get()
+      cache.update((value) => {
+        value.a = 2
+      })
+      expect(await cache.get()).toEqual({ a: 2 })
+    })
+  })
+
+  describe(SettingsSourceCache.prototype.invalidate.name, () => {
+    it('reloads on the next read', async () => {
+      const load = vi.fn().mockResolvedValueOnce(1).mockResolvedValue(2)
+      const cache = new SettingsSourceCache(load)
+      await cache.get()
+      cache.invalidate()
+      expect(await cache.get()).toBe(2)
+    })
+  })
+})
@@ -0,0 +1,60 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * Holds the last known values of one settings source. Loading happens at most
+ * once at a time; a load returning undefined (source unavailable) is not
+ * cached so that the next read tries again.
+ */
+export class SettingsSourceCache<T> {
+  private value: T | undefined
+  private loading: Promise<T | undefined> | null = null
+  private generation = 0
+
+  constructor(private readonly load: () => Promise<T | undefined>) {}
+
+  async get(): Promise<T | undefined> {
+    if (this.value !== undefined) {
+      return this.value
+    }
+    if (!this.loading) {
+      const generation = this.generation
+      this.loading = this.load().finally(() => {
+        if (generation === this.generation) {
+          this.loading = null
+        }
+      })
+      const value = await this.loading
+      if (generation === this.generation) {
+        this.value = value
+      }
+      return value
+    }
+    return this.loading
+  }
+
+  update(updater: (value: T) => void): void {
+    if (this.value !== undefined) {
+      updater(this.value)
+    }
+  }
+
+  invalidate(): void {
+    this.generation++
+    this.value = undefined
+    this.loading = null
+  }
+}
@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
+import { BadRequestException } from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
 import { Test, TestingModule } from '@nestjs/testing'
 import { createResponse } from 'node-mocks-http'
@@ -21,6 +22,7 @@ import { vi } from 'vitest'
 import { MotionClientService } from '../motion-client.service'
 import { PropertiesService } from '../properties/properties.service'
 import { Settings } from './entities/settings'
+import { SettingsSource } from './entities/settings-sources'
 import { ShotTypes } from './entities/shot-types'
 import { SettingsController } from './settings.controller'
 import { SettingsService } from './settings.service'
@@ -43,9 +45,11 @@ describe('SettingsController', () => {
       focusMaximum: Number.MAX_SAFE_INTEGER,
       focusMinimum: Number.MIN_SAFE_INTEGER,
       isLightEnabled: true,
+      isMovieEncodingProfileEnabled: true,
       isPictureQualityEnabled: true,
       isShotTypesEnabled: true,
       light: 'visible',
+      movieEncodingProfile: 'auto',
       pictureQuality: 90,
       shotTypes: ['pictures', 'videos'],
       videoQuality: 60,
@@ -80,6 +84,7 @@ describe('SettingsController', () => {
     getAllSettings = async () => SETTINGS
     updateSettings = vi.fn()
     updateAllSettings = vi.fn()
+    invalidateSettingsSource = vi.fn()
     getSiteName = async () => SETTINGS.general.siteName
     setSiteName = vi.fn()
     getDeviceName = async () => SETTINGS.general.deviceName
@@ -125,6 +130,17 @@ describe('SettingsController', () => {
     expect(response).toEqual(SETTINGS)
   })
 
+  it('invalidates a settings source', () => {
+    controller.invalidateSettingsSource('motion')
+    expect(service.invalidateSettingsSource).toHaveBeenCalledWith('motion')
+  })
+
+  it('rejects an unknown settings source', () => {
+    expect(() =>
+      controller.invalidateSettingsSource('a' as SettingsSource),
+    ).toThrow(BadRequestException)
+  })
+
   it('sets settings', async () => {
     const settings = { general: { deviceName: 'd', siteName: 's' } }
     await controller.updateSettings(settings)
@@ -15,6 +15,7 @@
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
 import {
+  BadRequestException,
   Controller,
   Get,
   Body,
@@ -22,6 +23,8 @@ import {
   Patch,
   ForbiddenException,
   Res,
+  Delete,
+  Param,
 } from '@nestjs/common'
 import { Response } from 'express'
 import CoordinatesDto from './dto/coordinates.dto'
@@ -33,6 +36,7 @@ import { SiteNameDto } from './dto/site-name.dto'
 import { SystemTimeDto } from './dto/system-time.dto'
 import { TimeZoneDto } from './dto/time-zone.dto'
 import { Settings } from './entities/settings'
+import { SETTINGS_SOURCES, SettingsSource } from './entities/settings-sources'
 import { SettingsService } from './settings.service'
 
 @Controller('settings')
@@ -56,6 +60,16 @@ export class SettingsController {
     return this.settingsService.updateAllSettings(settings)
   }
 
+  @Delete('cache/:source')
+  invalidateSettingsSource(@Param('source') source: SettingsSource): void {
+    if (!SETTINGS_SOURCES.includes(source)) {
+      throw new BadRequestException(
+        `The settings source must be one of: ${SETTINGS_SOURCES.join(', ')}.`,
+      )
+    }
+    this.settingsService.invalidateSettingsSource(source)
+  }
+
   @Get('cameraLight')
   async getCameraLight(@Res() res: Response) {
     const light = await this.settingsService.getCameraLight()
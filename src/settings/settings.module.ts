@@ -16,7 +16,9 @@
  */
 import { forwardRef, Module } from '@nestjs/common'
 import { ConfigModule, ConfigService } from '@nestjs/config'
+import { EventLogModule } from '../event-log/event-log.module'
 import { MotionClientService } from '../motion-client.service'
+import { MovieEncodingModule } from '../movie-encoding/movie-encoding.module'
 import { PropertiesModule } from '../properties/properties.module'
 import { SettingsController } from './settings.controller'
 import { SettingsService } from './settings.service'
@@ -24,7 +26,12 @@ import { SettingsService } from './settings.service'
 @Module({
   controllers: [SettingsController],
   providers: [ConfigService, MotionClientService, SettingsService],
-  imports: [ConfigModule, forwardRef(() => PropertiesModule)],
+  imports: [
+    ConfigModule,
+    EventLogModule,
+    MovieEncodingModule,
+    forwardRef(() => PropertiesModule),
+  ],
   exports: [SettingsService],
 })
 export class SettingsModule {}
@@ -7,12 +7,14 @@ import {
   Settings,
   SettingsFromJsonFile,
 } from './entities/settings'
+import { SettingsSource } from './entities/settings-sources'
 import { ShotTypes } from './entities/shot-types'
 
 export interface ISettingsService {
   getAllSettings: () => Promise<Settings>
   updateSettings: (settings: PatchableSettings) => Promise<PatchableSettings>
   updateAllSettings: (settings: SettingsPutDto) => Promise<void>
+  invalidateSettingsSource: (source: SettingsSource) => void
   getCoordinates: () => Promise<CoordinatesDto>
   storeSettingsFileToShotsFolder: (
     settings: SettingsFromJsonFile,
@@ -34,6 +36,8 @@ export interface ISettingsService {
   getSleepingTime: () => Promise<TriggeringTime>
   getWakingUpTime: () => Promise<TriggeringTime>
   isTemperatureBelowThreshold(): Promise<boolean>
+  getTemperatureThreshold: () => Promise<number>
+  sampleTemperature: () => Promise<number>
   getLatitudeAndLongitude: () => Promise<{
     latitude: number
     longitude: number
@@ -41,6 +45,7 @@ export interface ISettingsService {
   getIsAlternatingLightModeEnabled: () => Promise<boolean>
   getUseSunriseAndSunsetTimes: () => Promise<boolean>
   setNextSunsetForSleepingAndSunriseForWakingUpOnRaspberryPi: () => Promise<void>
+  scheduleSleeping: () => Promise<void>
   sleepWhenItIsTime: () => Promise<void>
   doAlternatingLightModeChange: () => Promise<void>
 }
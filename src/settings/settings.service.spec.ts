@@ -24,16 +24,23 @@ import {
   MovieOutputValue,
   PictureOutputValue,
 } from '../motion-client.service.interface'
+import {
+  MotionConfigurationApplier,
+  MotionConfigurationTransaction,
+} from '../motion-configuration-transaction'
+import { MovieEncodingService } from '../movie-encoding/movie-encoding.service'
+import { IMovieEncodingService } from '../movie-encoding/movie-encoding.service.interface'
 import { PropertiesService } from '../properties/properties.service'
 import { IPropertiesService } from '../properties/properties.service.interface'
 import { SettingsPutDto } from './dto/settings.dto'
 import { PatchableSettings, Settings } from './entities/settings'
 import { AccessPointInteractor } from './interactors/access-point-interactor'
+import { SleepInteractor } from './interactors/sleep-interactor'
 import { SystemTimeInteractor } from './interactors/system-time-interactor'
 import { TemperatureInteractor } from './interactors/temperature-interactor'
 import { VideoDeviceInteractor } from './interactors/video-device-interactor'
 import { SettingsFileProvider } from './settings-file-provider'
-import { SettingsService } from './settings.service'
+import { SettingsService, ShotsFolderChange } from './settings.service'
 
 const SHOTS_FOLDER = '/a'
 
@@ -52,6 +59,14 @@ const mockConfigService = {
   },
 }
 
+const applyMotionConfigurationChanges = vi.fn<MotionConfigurationApplier>(
+  async (changes) =>
+    Array.from(changes.keys(), (option) => ({
+      option,
+      status: 'applied' as const,
+    })),
+)
+
 class MockMotionClientService implements Partial<IMotionClientService> {
   getHeight = async () => HEIGHT
   getWidth = async () => WIDTH
@@ -68,10 +83,18 @@ class MockMotionClientService implements Partial<IMotionClientService> {
   getThreshold = async () => TRIGGER_SENSITIVITY
   setThreshold = async () => {}
   getTargetDir = async () => SHOTS_FOLDER
+  setTargetDir = async () => {}
   getVideoDevice = async () => ''
   getVideoParams = async () =>
     '"Focus, Auto"=0,"Focus (absolute)"=200,Brightness=16'
   setVideoParams = async () => {}
+  beginConfigurationTransaction = () =>
+    new MotionConfigurationTransaction(applyMotionConfigurationChanges)
+}
+
+class MockMovieEncodingService implements Partial<IMovieEncodingService> {
+  getSelection = async () => 'auto'
+  select = vi.fn<IMovieEncodingService['select']>(async () => {})
 }
 
 class MockPropertiesService implements Partial<IPropertiesService> {
@@ -79,6 +102,7 @@ class MockPropertiesService implements Partial<IPropertiesService> {
 }
 
 describe('SettingsService', () => {
+  let movieEncodingService: MockMovieEncodingService
   let service: SettingsService
 
   beforeEach(async () => {
@@ -89,11 +113,13 @@ describe('SettingsService', () => {
           useValue: mockConfigService,
         },
         { provide: MotionClientService, useClass: MockMotionClientService },
+        { provide: MovieEncodingService, useClass: MockMovieEncodingService },
         { provide: PropertiesService, useClass: MockPropertiesService },
         SettingsService,
       ],
     }).compile()
 
+    movieEncodingService = module.get(MovieEncodingService)
     service = module.get<SettingsService>(SettingsService)
   })
 
@@ -155,9 +181,11 @@ describe('SettingsService', () => {
         focusMaximum: FOCUS_MAX,
         focusMinimum: FOCUS_MIN,
         isLightEnabled: true,
+        isMovieEncodingProfileEnabled: true,
         isPictureQualityEnabled: true,
         isShotTypesEnabled: true,
         light: CAMERA_LIGHT_TYPE,
+        movieEncodingProfile: 'auto',
         pictureQuality: 90,
         shotTypes: SHOT_TYPES,
         videoQuality: 60,
@@ -223,8 +251,83 @@ describe('SettingsService', () => {
 
     it('gets all settings', async () => {
       const settings = await service.getAllSettings()
-      expect(spyGetSystemTime).toHaveBeenCalled()
-      expect(settings).toStrictEqual(ALL_SETTINGS)
+      expect(spyGetSystemTime).not.toHaveBeenCalled()
+      expect(settings).toStrictEqual({
+        ...ALL_SETTINGS,
+        general: {
+          ...ALL_SETTINGS.general,
+          systemTime: expect.stringMatching(
+            /^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}Z$/,
+          ),
+        },
+      })
+    })
+
+    it('queries Motion, driver and OS only once for repeated reads', async () => {
+      await service.getAllSettings()
+      await service.getAllSettings()
+      expect(spyGetFocus).toHaveBeenCalledTimes(1)
+      expect(spyGetTimeZone).toHaveBeenCalledTimes(1)
+      expect(spyGetAccessPointPassword).toHaveBeenCalledTimes(1)
+    })
+
+    it('returns written values without querying Motion again', async () => {
+      await service.getAllSettings()
+      await service.updateSettings({ camera: { pictureQuality: 42 } })
+      const settings = await service.getAllSettings()
+      expect(settings.camera.pictureQuality).toBe(42)
+    })
+
+    it('selects the movie encoding profile', async () => {
+      await service.updateSettings({
+        camera: { movieEncodingProfile: 'compact' },
+      })
+      expect(movieEncodingService.select).toHaveBeenCalledWith('compact')
+    })
+
+    it('applies the Motion options of an update in one batch', async () => {
+      applyMotionConfigurationChanges.mockClear()
+      await service.updateSettings({
+        camera: { pictureQuality: 42, shotTypes: ['videos'], videoQuality: 43 },
+      })
+      expect(applyMotionConfigurationChanges).toHaveBeenCalledTimes(1)
+      expect(applyMotionConfigurationChanges).toHaveBeenCalledWith(
+        new Map([
+          ['picture_quality', '42'],
+          ['movie_quality', '43'],
+          ['picture_output', 'off'],
+          ['movie_output', 'on'],
+        ]),
+      )
+    })
+
+    it('caches the Motion options that were applied despite others failing', async () => {
+      await service.getAllSettings()
+      applyMotionConfigurationChanges.mockImplementationOnce(async (changes) =>
+        Array.from(changes.keys(), (option) => ({
+          option,
+          status:
+            option === 'picture_quality'
+              ? ('failed' as const)
+              : ('applied' as const),
+          error: option === 'picture_quality' ? new Error('a') : undefined,
+        })),
+      )
+      await expect(
+        service.updateSettings({
+          camera: { pictureQuality: 42, videoQuality: 43 },
+        }),
+      ).rejects.toThrow('a')
+      const settings = await service.getAllSettings()
+      expect(settings.camera.pictureQuality).toBe(90)
+      expect(settings.camera.videoQuality).toBe(43)
+    })
+
+    it('queries an invalidated source again', async () => {
+      await service.getAllSettings()
+      service.invalidateSettingsSource('os')
+      await service.getAllSettings()
+      expect(spyGetTimeZone).toHaveBeenCalledTimes(2)
     })
 
     it('updates all optional settings', async () => {
@@ -418,6 +521,16 @@ describe('SettingsService', () => {
       expect(shotsFolder).toBe(SHOTS_FOLDER)
     })
 
+    it('announces changes of the shots folder', async () => {
+      const changes: ShotsFolderChange[] = []
+      service.shotsFolderChanges$.subscribe((change) => changes.push(change))
+      await service.setShotsFolder(SHOTS_FOLDER)
+      await service.setShotsFolder('/media/b')
+      expect(changes).toEqual([
+        { previousFolderPath: SHOTS_FOLDER, folderPath: '/media/b' },
+      ])
+    })
+
     it('returns system time', async () => {
       const systemTime = await service.getSystemTime()
       expect(systemTime).toBe(SYSTEM_TIME)
@@ -501,7 +614,46 @@ describe('SettingsService', () => {
       spyReadSettingsFile.mockClear()
       spyWriteSettingsFile.mockClear()
       spySetSystemAndRtcTime.mockClear()
+      spyGetTimeZone.mockClear()
       spySetTimeZone.mockClear()
+      spyGetAccessPointPassword.mockClear()
+      spyGetFocus.mockClear()
+    })
+
+    describe('scheduleSleeping', () => {
+      let spyTriggerSleeping: Mock
+
+      beforeEach(() => {
+        vi.useFakeTimers()
+        vi.setSystemTime(new Date('2024-07-19T10:00:00'))
+        spyTriggerSleeping = vi
+          .spyOn(SleepInteractor, 'triggerSleeping')
+          .mockResolvedValue()
+      })
+
+      it('goes to sleep once the sleeping time is reached', async () => {
+        await service.scheduleSleeping()
+        await vi.advanceTimersByTimeAsync(11 * 60 * 1000)
+        expect(spyTriggerSleeping).not.toHaveBeenCalled()
+        await vi.advanceTimersByTimeAsync(60 * 1000)
+        expect(spyTriggerSleeping).toHaveBeenCalledTimes(1)
+        expect(spyTriggerSleeping.mock.calls[0][0]).toMatch(
+          /^2024-07-19T10:17:00\.000/,
+        )
+      })
+
+      it('does not go to sleep when the sleeping window has passed', async () => {
+        await service.scheduleSleeping()
+        vi.setSystemTime(new Date('2024-07-19T10:30:00'))
+        await vi.advanceTimersByTimeAsync(12 * 60 * 1000)
+        expect(spyTriggerSleeping).not.toHaveBeenCalled()
+      })
+
+      afterEach(() => {
+        service.onModuleDestroy()
+        spyTriggerSleeping.mockRestore()
+        vi.useRealTimers()
+      })
     })
 
     afterAll(() => {
@@ -20,13 +20,28 @@ import {
   Inject,
   Injectable,
   Logger,
+  OnModuleDestroy,
+  Optional,
 } from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
 import { Cron, CronExpression } from '@nestjs/schedule'
 import { DateTime } from 'luxon'
+import { ReplaySubject } from 'rxjs'
+import {
+  LIGHT_CHANGE_CODES,
+  SENSOR_SAMPLE_CODES,
+  SETTINGS_CHANGE_CODES,
+} from '../event-log/entities/logged-event.entity'
+import { EventLogService } from '../event-log/event-log.service'
 import { FileNamer } from '../files/file-namer'
 import { InitialisationInteractor } from '../initialisation-interactor'
 import { MotionClientService } from '../motion-client.service'
+import {
+  MotionConfigurationResult,
+  MotionConfigurationTransaction,
+} from '../motion-configuration-transaction'
+import { AUTOMATIC_MOVIE_ENCODING_SELECTION } from '../movie-encoding/movie-encoding-profiles'
+import { MovieEncodingService } from '../movie-encoding/movie-encoding.service'
 import { PropertiesService } from '../properties/properties.service'
 import TriggeringTime from '../shared/entities/triggering-time'
 import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
@@ -38,6 +53,12 @@ import {
   Settings,
   SettingsFromJsonFile,
 } from './entities/settings'
+import {
+  DriverSettings,
+  MotionSettings,
+  OsSettings,
+  SettingsSource,
+} from './entities/settings-sources'
 import { ShotTypes } from './entities/shot-types'
 import { UndefinedPathException } from './exceptions/UndefinedPathException'
 import { AccessPointInteractor } from './interactors/access-point-interactor'
@@ -49,6 +70,7 @@ import { VideoDeviceInteractor } from './interactors/video-device-interactor'
 import { MotionTextAssembler } from './motion-text-assembler'
 import { MotionVideoParametersWorker } from './motion-video-parameters-worker'
 import { SettingsFileProvider } from './settings-file-provider'
+import { SettingsSourceCache } from './settings-source-cache'
 import { ISettingsService } from './settings.service.interface'
 import { TriggeringTimeHelper } from './triggering-time-helper'
 
@@ -56,73 +78,94 @@ const MOTION_FOCUS_DIFFERENCE_VISIBLE_INFRARED_LIGHTS = 150
 const MOTION_VIDEO_PARAMS_FOCUS_KEY = 'Focus (absolute)'
 const RASPBERRY_PI_FOCUS_DEVICE_PATH = '/dev/v4l-subdev1'
 const SETTINGS_FILE_PATH = 'settings.json'
-const SLEEPING_CRON_JOB_NAME = 'sleepingCronJob'
+/**
+ * Tolerance for a sleeping timer firing early, e.g. after a clock adjustment
+ */
+const SLEEPING_TIMER_TOLERANCE_MINUTES = 1
+/**
+ * Temperature is sampled more often than that for gating detection, but the
+ * event log only keeps one sample per interval.
+ */
+const TEMPERATURE_SAMPLE_RECORDING_INTERVAL_MS = 5 * 60 * 1000
 const ALTERNATING_LIGHT_MODE_JOB_NAME = 'alternatingLightModeCronJob'
 
+interface SleepingWindow {
+  sleepingDateTime: DateTime
+  wakingUpDateTime: DateTime
+}
+
+export interface ShotsFolderChange {
+  previousFolderPath: string
+  folderPath: string
+}
+
 @Injectable()
-export class SettingsService implements ISettingsService {
+export class SettingsService implements ISettingsService, OnModuleDestroy {
   private readonly deviceType: string
   private readonly isFixedFocus: boolean
   private readonly logger = new Logger(SettingsService.name)
+  private readonly driverSettings = new SettingsSourceCache<DriverSettings>(
+    () => this.loadDriverSettings(),
+  )
+  private readonly motionSettings = new SettingsSourceCache<MotionSettings>(
+    () => this.loadMotionSettings(),
+  )
+  private readonly osSettings = new SettingsSourceCache<OsSettings>(() =>
+    this.loadOsSettings(),
+  )
+  private nextSleepingWindow?: SleepingWindow
+  private sleepingTimer?: NodeJS.Timeout
+  private temperatureSampleRecordedAtMs?: number
+  // Replays the latest change, as the shots folder is set at boot before the
+  // modules are initialised.
+  readonly shotsFolderChanges$ = new ReplaySubject<ShotsFolderChange>(1)
 
   constructor(
     private readonly configService: ConfigService,
     private readonly motionClientService: MotionClientService,
     @Inject(forwardRef(() => PropertiesService))
     private readonly propertiesService: PropertiesService,
+    @Optional() private readonly eventLogService?: EventLogService,
+    @Optional() private readonly movieEncodingService?: MovieEncodingService,
   ) {
     this.deviceType = this.configService.get<string>('deviceType')
     this.isFixedFocus = this.configService.get<boolean>('isFixedFocus')
   }
 
+  onModuleDestroy(): void {
+    clearTimeout(this.sleepingTimer)
+  }
+
   async getAllSettings(): Promise<Settings> {
-    const settingsFromFile =
-      await SettingsFileProvider.readSettingsFile(SETTINGS_FILE_PATH)
+    const [
+      settingsFromFile,
+      driverSettings,
+      motionSettings,
+      osSettings,
+      movieEncodingSelection,
+    ] = await Promise.all([
+      SettingsFileProvider.readSettingsFile(SETTINGS_FILE_PATH),
+      this.driverSettings.get(),
+      this.motionSettings.get(),
+      this.osSettings.get(),
+      this.movieEncodingService?.getSelection(),
+    ])
 
     const isRaspberryPi = this.deviceType === 'RaspberryPi'
 
-    const password = await this.getAccessPointPassword()
-    const systemTime = await this.getSystemTime()
-    const timeZone = await this.getTimeZone()
-
-    let shotTypes: ShotTypes = new Set()
     let focus = 0
     let focusMaximum = Number.MAX_SAFE_INTEGER
     let focusMinimum = Number.MIN_SAFE_INTEGER
-    let pictureQuality = 0
-    let threshold = 1
-    let thresholdMaximum = Number.MAX_SAFE_INTEGER
-    let videoQuality = 0
-
-    try {
-      if (!this.isFixedFocus) {
-        const focusValues = await this.getFocusFromDriver()
-        focusMaximum = focusValues.max
-        focusMinimum = focusValues.min
-        if (isRaspberryPi) {
-          focus = focusValues.value
-        } else {
-          focus = await this.getFocusFromMotionAdaptedToCameraLight(
-            settingsFromFile.camera.light,
-          )
-        }
-      }
-
-      pictureQuality = await this.motionClientService.getPictureQuality()
-      threshold = await this.motionClientService.getThreshold()
-      videoQuality = await this.motionClientService.getMovieQuality()
-
-      shotTypes = await this.getShotTypes()
-
-      const height = await this.motionClientService.getHeight()
-      const width = await this.motionClientService.getWidth()
-      thresholdMaximum = height * width
-    } catch (error) {
-      if (error.config && error.config.url) {
-        this.logger.error(`Could not connect to ${error.config.url}`)
-      }
-      if (error.code !== 'ECONNREFUSED') {
-        throw error
+    if (!this.isFixedFocus && driverSettings) {
+      focusMaximum = driverSettings.focusMaximum
+      focusMinimum = driverSettings.focusMinimum
+      if (isRaspberryPi) {
+        focus = driverSettings.focus
+      } else if (motionSettings) {
+        focus = this.adaptFocusFromMotionToCameraLight(
+          motionSettings.focus,
+          settingsFromFile.camera.light,
+        )
       }
     }
 
@@ -132,13 +175,17 @@ export class SettingsService implements ISettingsService {
         isFocusEnabled: !this.isFixedFocus,
         focus,
         isLightEnabled: !isRaspberryPi,
+        // Only Motion's pipe to ffmpeg on Variscite uses the profiles.
+        isMovieEncodingProfileEnabled: !isRaspberryPi,
         isPictureQualityEnabled: !isRaspberryPi,
         isShotTypesEnabled: !isRaspberryPi,
         focusMaximum,
         focusMinimum,
-        pictureQuality,
-        shotTypes: Array.from(shotTypes),
-        videoQuality,
+        movieEncodingProfile:
+          movieEncodingSelection ?? AUTOMATIC_MOVIE_ENCODING_SELECTION,
+        pictureQuality: motionSettings?.pictureQuality ?? 0,
+        shotTypes: Array.from(motionSettings?.shotTypes ?? []),
+        videoQuality: motionSettings?.videoQuality ?? 0,
       },
       general: {
         deviceName: undefined,
@@ -148,9 +195,9 @@ export class SettingsService implements ISettingsService {
         longitude: undefined,
         siteName: undefined,
         ...settingsFromFile.general,
-        password,
-        systemTime,
-        timeZone,
+        password: osSettings.password,
+        systemTime: this.getSystemTimeFromClock(),
+        timeZone: osSettings.timeZone,
       },
       triggering: {
         sleepingTime: undefined,
@@ -160,12 +207,111 @@ export class SettingsService implements ISettingsService {
         ...settingsFromFile.triggering,
         isLightEnabled: !isRaspberryPi,
         isTemperatureThresholdEnabled: isRaspberryPi,
-        threshold,
-        thresholdMaximum,
+        threshold: motionSettings?.threshold ?? 1,
+        thresholdMaximum:
+          motionSettings?.thresholdMaximum ?? Number.MAX_SAFE_INTEGER,
       },
     }
   }
 
+  invalidateSettingsSource(source: SettingsSource): void {
+    this.logger.log(`Invalidating cached ${source} settings...`)
+    switch (source) {
+      case 'driver':
+        this.driverSettings.invalidate()
+        break
+      case 'file':
+        SettingsFileProvider.invalidateCache(SETTINGS_FILE_PATH)
+        break
+      case 'motion':
+        this.motionSettings.invalidate()
+        break
+      case 'os':
+        this.osSettings.invalidate()
+        break
+    }
+  }
+
+  private async loadDriverSettings(): Promise<DriverSettings | undefined> {
+    if (this.isFixedFocus) {
+      return {
+        focus: 0,
+        focusMaximum: Number.MAX_SAFE_INTEGER,
+        focusMinimum: Number.MIN_SAFE_INTEGER,
+      }
+    }
+    try {
+      const focusValues = await this.getFocusFromDriver()
+      return {
+        focus: focusValues.value,
+        focusMaximum: focusValues.max,
+        focusMinimum: focusValues.min,
+      }
+    } catch (error) {
+      return this.handleUnavailableMotion(error)
+    }
+  }
+
+  private async loadMotionSettings(): Promise<MotionSettings | undefined> {
+    const isFocusInMotion =
+      !this.isFixedFocus && this.deviceType !== 'RaspberryPi'
+    try {
+      const [
+        focus,
+        pictureQuality,
+        threshold,
+        videoQuality,
+        shotTypes,
+        height,
+        width,
+      ] = await Promise.all([
+        isFocusInMotion ? this.getFocusFromMotion() : Promise.resolve(null),
+        this.motionClientService.getPictureQuality(),
+        this.motionClientService.getThreshold(),
+        this.motionClientService.getMovieQuality(),
+        this.queryShotTypesFromMotion(),
+        this.motionClientService.getHeight(),
+        this.motionClientService.getWidth(),
+      ])
+      return {
+        focus,
+        pictureQuality,
+        shotTypes,
+        threshold,
+        thresholdMaximum: height * width,
+        videoQuality,
+      }
+    } catch (error) {
+      return this.handleUnavailableMotion(error)
+    }
+  }
+
+  private async loadOsSettings(): Promise<OsSettings> {
+    const [password, timeZone] = await Promise.all([
+      this.getAccessPointPassword(),
+      this.queryTimeZone(),
+    ])
+    return {
+      password,
+      timeZone,
+    }
+  }
+
+  private handleUnavailableMotion(error): undefined {
+    if (error.config && error.config.url) {
+      this.logger.error(`Could not connect to ${error.config.url}`)
+    }
+    if (error.code !== 'ECONNREFUSED') {
+      throw error
+    }
+    return undefined
+  }
+
+  private getSystemTimeFromClock(): string {
+    // Same format as reported by timedatectl, without milliseconds.
+    return new Date().toISOString().replace(/\.\d{3}Z$/, 'Z')
+  }
+
   async updateSettings(
     settings: PatchableSettings,
   ): Promise<PatchableSettings> {
@@ -273,9 +419,8 @@ export class SettingsService implements ISettingsService {
       }
 
       if ('threshold' in settings.triggering) {
-        const height = await this.motionClientService.getHeight()
-        const width = await this.motionClientService.getWidth()
-        if (settings.triggering.threshold > height * width) {
+        const thresholdMaximum = await this.getThresholdMaximum()
+        if (settings.triggering.threshold > thresholdMaximum) {
           throw new BadRequestException(
             'The threshold must be smaller or equal to the resolution.',
           )
@@ -284,6 +429,9 @@ export class SettingsService implements ISettingsService {
     }
 
     let isAtLeastOneJsonSettingUpdated = false
+    const motionTransaction =
+      this.motionClientService.beginConfigurationTransaction()
+    let focusInMotion: number | undefined
 
     const cameraSettingsMerged = settingsReadFromFile.camera
     if ('camera' in settings) {
@@ -310,7 +458,8 @@ export class SettingsService implements ISettingsService {
         if (this.deviceType === 'RaspberryPi') {
           await this.setFocusInDriver(settings.camera.focus)
         } else {
-          await this.setFocusInMotionAdaptedToCameraLight(
+          focusInMotion = await this.stageFocusInMotionAdaptedToCameraLight(
+            motionTransaction,
             settings.camera.focus,
             cameraSettingsMerged.light,
           )
@@ -318,36 +467,20 @@ export class SettingsService implements ISettingsService {
       }
 
       if ('pictureQuality' in settings.camera) {
-        await this.motionClientService.setPictureQuality(
-          settings.camera.pictureQuality,
-        )
+        motionTransaction.setPictureQuality(settings.camera.pictureQuality)
       }
       if ('videoQuality' in settings.camera) {
-        await this.motionClientService.setMovieQuality(
-          settings.camera.videoQuality,
-        )
+        motionTransaction.setMovieQuality(settings.camera.videoQuality)
       }
 
       if ('shotTypes' in settings.camera) {
-        try {
-          if (settings.camera.shotTypes.includes('pictures')) {
-            await this.motionClientService.setPictureOutput('best')
-          } else {
-            await this.motionClientService.setPictureOutput('off')
-          }
-          if (settings.camera.shotTypes.includes('videos')) {
-            await this.motionClientService.setMovieOutput('on')
-          } else {
-            await this.motionClientService.setMovieOutput('off')
-          }
-        } catch (error) {
-          if (error.config && error.config.url) {
-            this.logger.error(`Could not connect to ${error.config.url}`)
-          }
-          if (error.code !== 'ECONNREFUSED') {
-            throw error
-          }
-        }
+        this.stageShotTypes(motionTransaction, settings.camera.shotTypes)
+      }
+
+      if ('movieEncodingProfile' in settings.camera) {
+        await this.movieEncodingService?.select(
+          settings.camera.movieEncodingProfile,
+        )
       }
     }
 
@@ -359,6 +492,7 @@ export class SettingsService implements ISettingsService {
 
       if ('timeZone' in settings.general) {
         await SystemTimeInteractor.setTimeZone(settings.general.timeZone)
+        this.updateCachedTimeZone(settings.general.timeZone)
       }
 
       const newGeneralSettings: Partial<SettingsFromJsonFile['general']> = {}
@@ -408,7 +542,7 @@ export class SettingsService implements ISettingsService {
           generalSettingsMerged.deviceName,
           timeZone,
         )
-        await this.motionClientService.setFilename(filename)
+        motionTransaction.setFilename(filename)
 
         if (
           'deviceName' in settings.general ||
@@ -418,7 +552,7 @@ export class SettingsService implements ISettingsService {
             generalSettingsMerged.siteName,
             generalSettingsMerged.deviceName,
           )
-          await this.motionClientService.setLeftTextOnImage(imageText)
+          motionTransaction.setLeftTextOnImage(imageText)
         }
       }
 
@@ -477,20 +611,46 @@ export class SettingsService implements ISettingsService {
       this.setNextSunsetForSleepingAndSunriseForWakingUpOnRaspberryPi()
 
       if ('threshold' in settings.triggering) {
-        try {
-          await this.motionClientService.setThreshold(
-            settings.triggering.threshold,
-          )
-        } catch (error) {
-          if (error.config && error.config.url) {
-            this.logger.error(`Could not connect to ${error.config.url}`)
+        motionTransaction.setThreshold(settings.triggering.threshold)
+      }
+    }
+
+    await this.commitMotionConfiguration(
+      motionTransaction,
+      (motionSettings, appliedOptions) => {
+        if (focusInMotion !== undefined && appliedOptions.has('video_params')) {
+          motionSettings.focus = focusInMotion
+        }
+        if ('camera' in settings) {
+          if (
+            'pictureQuality' in settings.camera &&
+            appliedOptions.has('picture_quality')
+          ) {
+            motionSettings.pictureQuality = settings.camera.pictureQuality
+          }
+          if (
+            'shotTypes' in settings.camera &&
+            appliedOptions.has('picture_output') &&
+            appliedOptions.has('movie_output')
+          ) {
+            motionSettings.shotTypes = new Set(settings.camera.shotTypes)
           }
-          if (error.code !== 'ECONNREFUSED') {
-            throw error
+          if (
+            'videoQuality' in settings.camera &&
+            appliedOptions.has('movie_quality')
+          ) {
+            motionSettings.videoQuality = settings.camera.videoQuality
           }
         }
-      }
-    }
+        if (
+          'triggering' in settings &&
+          'threshold' in settings.triggering &&
+          appliedOptions.has('threshold')
+        ) {
+          motionSettings.threshold = settings.triggering.threshold
+        }
+      },
+    )
 
     if (isAtLeastOneJsonSettingUpdated) {
       const settingsToUpdate = {
@@ -543,8 +703,18 @@ export class SettingsService implements ISettingsService {
           throw error
         }
       }
+      this.eventLogService?.record('lightChange', {
+        code: LIGHT_CHANGE_CODES[lightType],
+      })
     }
 
+    if ('general' in settings || 'triggering' in settings) {
+      await this.scheduleSleeping()
+    }
+
+    this.eventLogService?.record('settingsChange', {
+      code: this.getSettingsChangeCode(settings),
+    })
     return settings
   }
 
@@ -586,9 +756,8 @@ export class SettingsService implements ISettingsService {
     }
 
     if ('threshold' in settings.triggering) {
-      const height = await this.motionClientService.getHeight()
-      const width = await this.motionClientService.getWidth()
-      if (settings.triggering.threshold > height * width) {
+      const thresholdMaximum = await this.getThresholdMaximum()
+      if (settings.triggering.threshold > thresholdMaximum) {
         throw new BadRequestException(
           'The threshold must be smaller or equal to the resolution.',
         )
@@ -612,57 +781,42 @@ export class SettingsService implements ISettingsService {
     await this.setSystemTime(settings.general.systemTime)
 
     await SystemTimeInteractor.setTimeZone(settings.general.timeZone)
+    this.updateCachedTimeZone(settings.general.timeZone)
 
+    const motionTransaction =
+      this.motionClientService.beginConfigurationTransaction()
     if ('shotTypes' in settings.camera) {
-      try {
-        if (settings.camera.shotTypes.includes('pictures')) {
-          await this.motionClientService.setPictureOutput('best')
-        } else {
-          await this.motionClientService.setPictureOutput('off')
-        }
-        if (settings.camera.shotTypes.includes('videos')) {
-          await this.motionClientService.setMovieOutput('on')
-        } else {
-          await this.motionClientService.setMovieOutput('off')
-        }
-      } catch (error) {
-        if (error.config && error.config.url) {
-          this.logger.error(`Could not connect to ${error.config.url}`)
-        }
-        if (error.code !== 'ECONNREFUSED') {
-          throw error
-        }
-      }
+      this.stageShotTypes(motionTransaction, settings.camera.shotTypes)
     }
 
+    let focusInMotion: number | undefined
     try {
       if (!this.isFixedFocus) {
         if (isRaspberryPi) {
           await this.setFocusInDriver(settings.camera.focus)
         } else {
-          await this.setFocusInMotionAdaptedToCameraLight(
+          focusInMotion = await this.stageFocusInMotionAdaptedToCameraLight(
+            motionTransaction,
             settings.camera.focus,
             settings.camera.light,
           )
         }
       }
+    } catch (error) {
+      this.handleUnavailableMotion(error)
+    }
 
-      await this.motionClientService.setPictureQuality(
-        settings.camera.pictureQuality,
+    if (settings.camera.movieEncodingProfile !== undefined) {
+      await this.movieEncodingService?.select(
+        settings.camera.movieEncodingProfile,
       )
-      await this.motionClientService.setMovieQuality(
-        settings.camera.videoQuality,
-      )
-      await this.motionClientService.setThreshold(settings.triggering.threshold)
-    } catch (error) {
-      if (error.config && error.config.url) {
-        this.logger.error(`Could not connect to ${error.config.url}`)
-      }
-      if (error.code !== 'ECONNREFUSED') {
-        throw error
-      }
     }
 
+    motionTransaction
+      .setPictureQuality(settings.camera.pictureQuality)
+      .setMovieQuality(settings.camera.videoQuality)
+      .setThreshold(settings.triggering.threshold)
+
     if (this.deviceType === 'RaspberryPi') {
       this.configureWittyPiSchedule(
         settings.triggering.sleepingTime,
@@ -706,13 +860,35 @@ export class SettingsService implements ISettingsService {
       settings.general.deviceName,
       settings.general.timeZone,
     )
-    await this.motionClientService.setFilename(filename)
-
     const imageText = MotionTextAssembler.createImageText(
       settings.general.siteName,
       settings.general.deviceName,
     )
-    await this.motionClientService.setLeftTextOnImage(imageText)
+    motionTransaction.setFilename(filename).setLeftTextOnImage(imageText)
+    await this.commitMotionConfiguration(
+      motionTransaction,
+      (motionSettings, appliedOptions) => {
+        if (focusInMotion !== undefined && appliedOptions.has('video_params')) {
+          motionSettings.focus = focusInMotion
+        }
+        if (
+          'shotTypes' in settings.camera &&
+          appliedOptions.has('picture_output') &&
+          appliedOptions.has('movie_output')
+        ) {
+          motionSettings.shotTypes = new Set(settings.camera.shotTypes)
+        }
+        if (appliedOptions.has('picture_quality')) {
+          motionSettings.pictureQuality = settings.camera.pictureQuality
+        }
+        if (appliedOptions.has('movie_quality')) {
+          motionSettings.videoQuality = settings.camera.videoQuality
+        }
+        if (appliedOptions.has('threshold')) {
+          motionSettings.threshold = settings.triggering.threshold
+        }
+      },
+    )
 
     await SystemTimeInteractor.setTimeZone(settings.general.timeZone)
 
@@ -738,7 +914,24 @@ export class SettingsService implements ISettingsService {
           throw error
         }
       }
+      this.eventLogService?.record('lightChange', {
+        code: LIGHT_CHANGE_CODES[settings.triggering.light],
+      })
     }
+
+    await this.scheduleSleeping()
+
+    this.eventLogService?.record('settingsChange', {
+      code: this.getSettingsChangeCode(settings),
+    })
+  }
+
+  private getSettingsChangeCode(
+    settings: PatchableSettings | SettingsPutDto,
+  ): number {
+    return Object.entries(SETTINGS_CHANGE_CODES)
+      .filter(([group]) => group in settings)
+      .reduce((code, [, groupCode]) => code | groupCode, 0)
   }
 
   private async getAccessPointPassword(): Promise<string> {
@@ -781,9 +974,7 @@ export class SettingsService implements ISettingsService {
     }
   }
 
-  private async getFocusFromMotionAdaptedToCameraLight(
-    light: LightType,
-  ): Promise<number> {
+  private async getFocusFromMotion(): Promise<number | null> {
     const videoParametersString =
       await this.motionClientService.getVideoParams()
     const videoParameters = MotionVideoParametersWorker.convertStringToObject(
@@ -795,9 +986,18 @@ export class SettingsService implements ISettingsService {
         MOTION_VIDEO_PARAMS_FOCUS_KEY,
       )
     ) {
+      return null
+    }
+    return videoParameters[MOTION_VIDEO_PARAMS_FOCUS_KEY]
+  }
+
+  private adaptFocusFromMotionToCameraLight(
+    focus: number | null,
+    light: LightType,
+  ): number {
+    if (focus === null) {
       return 0
     }
-    const focus = videoParameters[MOTION_VIDEO_PARAMS_FOCUS_KEY]
     let focusAdaptedToLight = focus
     if (light === 'infrared') {
       focusAdaptedToLight += MOTION_FOCUS_DIFFERENCE_VISIBLE_INFRARED_LIGHTS
@@ -805,10 +1005,15 @@ export class SettingsService implements ISettingsService {
     return focusAdaptedToLight
   }
 
-  private async setFocusInMotionAdaptedToCameraLight(
+  /**
+   * Adds the focus to the given Motion transaction and returns the value that
+   * Motion is going to use.
+   */
+  private async stageFocusInMotionAdaptedToCameraLight(
+    motionTransaction: MotionConfigurationTransaction,
     focus: number,
     light: LightType,
-  ) {
+  ): Promise<number> {
     let focusAdaptedToLight = focus
     if (light === 'infrared') {
       focusAdaptedToLight -= MOTION_FOCUS_DIFFERENCE_VISIBLE_INFRARED_LIGHTS
@@ -821,7 +1026,54 @@ export class SettingsService implements ISettingsService {
     videoParameters[MOTION_VIDEO_PARAMS_FOCUS_KEY] = focusAdaptedToLight
     const newVideoParametersString =
       MotionVideoParametersWorker.convertObjectToString(videoParameters)
-    await this.motionClientService.setVideoParams(newVideoParametersString)
+    motionTransaction.setVideoParams(newVideoParametersString)
+    return focusAdaptedToLight
+  }
+
+  private stageShotTypes(
+    motionTransaction: MotionConfigurationTransaction,
+    shotTypes: Settings['camera']['shotTypes'],
+  ): void {
+    motionTransaction
+      .setPictureOutput(shotTypes.includes('pictures') ? 'best' : 'off')
+      .setMovieOutput(shotTypes.includes('videos') ? 'on' : 'off')
+  }
+
+  /**
+   * Applies the collected Motion changes with a single configuration write and
+   * lets the cache take over the options that are in effect, before failures
+   * of the others are raised. An unreachable Motion is tolerated as for
+   * reading.
+   */
+  private async commitMotionConfiguration(
+    motionTransaction: MotionConfigurationTransaction,
+    updateCache: (
+      motionSettings: MotionSettings,
+      appliedOptions: ReadonlySet<string>,
+    ) => void,
+  ): Promise<void> {
+    let results: MotionConfigurationResult[]
+    try {
+      results = await motionTransaction.commit()
+    } catch (error) {
+      this.handleUnavailableMotion(error)
+      return
+    }
+    const appliedOptions = new Set(
+      results
+        .filter((result) => result.status !== 'failed')
+        .map((result) => result.option),
+    )
+    if (appliedOptions.size > 0) {
+      this.motionSettings.update((motionSettings) =>
+        updateCache(motionSettings, appliedOptions),
+      )
+    }
+    for (const result of results) {
+      if (result.status === 'failed') {
+        this.handleUnavailableMotion(result.error)
+      }
+    }
   }
 
   private async getFocusFromDriver() {
@@ -851,7 +1103,11 @@ export class SettingsService implements ISettingsService {
       if (!(error instanceof CommandUnavailableOnWindowsException)) {
         throw error
       }
+      return
     }
+    this.driverSettings.update((driverSettings) => {
+      driverSettings.focus = focus
+    })
   }
 
   async storeSettingsFileToShotsFolder(
@@ -877,12 +1133,22 @@ export class SettingsService implements ISettingsService {
   }
 
   async getShotTypes(): Promise<ShotTypes> {
+    const motionSettings = await this.motionSettings.get()
+    if (motionSettings) {
+      return new Set(motionSettings.shotTypes)
+    }
+    return this.queryShotTypesFromMotion()
+  }
+
+  private async queryShotTypesFromMotion(): Promise<ShotTypes> {
     const shotTypes: ShotTypes = new Set()
-    const pictureOutput = await this.motionClientService.getPictureOutput()
+    const [pictureOutput, movieOutput] = await Promise.all([
+      this.motionClientService.getPictureOutput(),
+      this.motionClientService.getMovieOutput(),
+    ])
     if (pictureOutput === 'best') {
       shotTypes.add('pictures')
     }
-    const movieOutput = await this.motionClientService.getMovieOutput()
     if (movieOutput === 'on') {
       shotTypes.add('videos')
     }
@@ -906,12 +1172,16 @@ export class SettingsService implements ISettingsService {
       settings.general.deviceName,
       timeZone,
     )
-    await this.motionClientService.setFilename(filename)
     const imageText = MotionTextAssembler.createImageText(
       siteName,
       settings.general.deviceName,
     )
-    await this.motionClientService.setLeftTextOnImage(imageText)
+    const results = await this.motionClientService
+      .beginConfigurationTransaction()
+      .setFilename(filename)
+      .setLeftTextOnImage(imageText)
+      .commit()
+    MotionConfigurationTransaction.throwOnFailure(results)
   }
 
   async getDeviceName(): Promise<string> {
@@ -932,13 +1202,16 @@ export class SettingsService implements ISettingsService {
       deviceName,
       timeZone,
     )
-    await this.motionClientService.setFilename(filename)
-
     const imageText = MotionTextAssembler.createImageText(
       settings.general.siteName,
       deviceName,
     )
-    await this.motionClientService.setLeftTextOnImage(imageText)
+    const results = await this.motionClientService
+      .beginConfigurationTransaction()
+      .setFilename(filename)
+      .setLeftTextOnImage(imageText)
+      .commit()
+    MotionConfigurationTransaction.throwOnFailure(results)
 
     await this.setAccessPointNameOrPassword(deviceName)
   }
@@ -959,7 +1232,31 @@ export class SettingsService implements ISettingsService {
       if (!(error instanceof CommandUnavailableOnWindowsException)) {
         throw error
       }
+      return
+    }
+    if (password !== undefined) {
+      this.osSettings.update((osSettings) => {
+        osSettings.password = password
+      })
+    }
+  }
+
+  private async getThresholdMaximum(): Promise<number> {
+    const motionSettings = await this.motionSettings.get()
+    if (motionSettings) {
+      return motionSettings.thresholdMaximum
     }
+    const [height, width] = await Promise.all([
+      this.motionClientService.getHeight(),
+      this.motionClientService.getWidth(),
+    ])
+    return height * width
+  }
+
+  private updateCachedTimeZone(timeZone: string): void {
+    this.osSettings.update((osSettings) => {
+      osSettings.timeZone = timeZone
+    })
   }
 
   async getSystemTime(): Promise<string> {
@@ -986,9 +1283,15 @@ export class SettingsService implements ISettingsService {
         throw error
       }
     }
+    await this.scheduleSleeping()
   }
 
   async getTimeZone(): Promise<string> {
+    const osSettings = await this.osSettings.get()
+    return osSettings.timeZone
+  }
+
+  private async queryTimeZone(): Promise<string> {
     try {
       const timeZone = await SystemTimeInteractor.getTimeZone()
       return timeZone
@@ -1015,6 +1318,7 @@ export class SettingsService implements ISettingsService {
         throw error
       }
     }
+    this.updateCachedTimeZone(timeZone)
     const settings =
       await SettingsFileProvider.readSettingsFile(SETTINGS_FILE_PATH)
     const filename = MotionTextAssembler.createFilename(
@@ -1023,6 +1327,7 @@ export class SettingsService implements ISettingsService {
       timeZone,
     )
     await this.motionClientService.setFilename(filename)
+    await this.scheduleSleeping()
   }
 
   async getShotsFolder(): Promise<string> {
@@ -1035,7 +1340,11 @@ export class SettingsService implements ISettingsService {
       this.logger.warn('The path to set as shots folder is not defined.')
       throw new UndefinedPathException()
     }
+    const previousFolderPath = await this.motionClientService.getTargetDir()
     await this.motionClientService.setTargetDir(path)
+    if (previousFolderPath !== path) {
+      this.shotsFolderChanges$.next({ previousFolderPath, folderPath: path })
+    }
   }
 
   async getCameraLight(): Promise<LightType> {
@@ -1063,12 +1372,34 @@ export class SettingsService implements ISettingsService {
   }
 
   async isTemperatureBelowThreshold(): Promise<boolean> {
+    const threshold = await this.getTemperatureThreshold()
+    const currentTemperature = await this.sampleTemperature()
+    return currentTemperature < threshold
+  }
+
+  async getTemperatureThreshold(): Promise<number> {
     const settings =
       await SettingsFileProvider.readSettingsFile(SETTINGS_FILE_PATH)
-    const threshold = settings.triggering.temperatureThreshold
+    return settings.triggering.temperatureThreshold
+  }
+
+  async sampleTemperature(): Promise<number> {
     const currentTemperature =
       await TemperatureInteractor.getCurrentTemperature()
-    return currentTemperature < threshold
+    const nowMs = Date.now()
+    if (
+      !Number.isNaN(currentTemperature) &&
+      (this.temperatureSampleRecordedAtMs === undefined ||
+        nowMs - this.temperatureSampleRecordedAtMs >=
+          TEMPERATURE_SAMPLE_RECORDING_INTERVAL_MS)
+    ) {
+      this.temperatureSampleRecordedAtMs = nowMs
+      this.eventLogService?.record('sensorSample', {
+        code: SENSOR_SAMPLE_CODES.temperature,
+        value: currentTemperature,
+      })
+    }
+    return currentTemperature
   }
 
   async getLatitudeAndLongitude(): Promise<{
@@ -1122,63 +1453,100 @@ export class SettingsService implements ISettingsService {
     }
   }
 
-  @Cron(CronExpression.EVERY_MINUTE, { name: SLEEPING_CRON_JOB_NAME })
-  async sleepWhenItIsTime() {
-    this.logger.log('Cron job to go to sleep when it is time triggered...')
+  async scheduleSleeping(): Promise<void> {
+    clearTimeout(this.sleepingTimer)
+    this.sleepingTimer = undefined
+    this.nextSleepingWindow = undefined
     if (this.deviceType === 'RaspberryPi') {
-      this.logger.log('Exiting cron job as device type does not need it.')
       return
     }
 
+    try {
+      const now = DateTime.now()
+      let sleepingWindow = await this.getSleepingWindow(now)
+      if (sleepingWindow && sleepingWindow.sleepingDateTime <= now) {
+        sleepingWindow = await this.getSleepingWindow(now.plus({ days: 1 }))
+      }
+      if (!sleepingWindow) {
+        return
+      }
+      this.logger.log(
+        `Scheduling sleeping at ${sleepingWindow.sleepingDateTime.toISO()} and waking up at ${sleepingWindow.wakingUpDateTime.toISO()}...`,
+      )
+      this.nextSleepingWindow = sleepingWindow
+      this.sleepingTimer = setTimeout(
+        () => this.sleepWhenItIsTime(),
+        sleepingWindow.sleepingDateTime.diff(now).toMillis(),
+      )
+      this.sleepingTimer.unref()
+    } catch (error) {
+      this.logger.error(
+        `The sleeping could not be scheduled: ${error.name}: ${error.message}`,
+        error.stack,
+      )
+    }
+  }
+
+  private async getSleepingWindow(
+    day: DateTime,
+  ): Promise<SleepingWindow | undefined> {
     const useSunriseAndSunsetTimes = await this.getUseSunriseAndSunsetTimes()
     let sleepingTime: TriggeringTime
     let wakingUpTime: TriggeringTime
     if (useSunriseAndSunsetTimes) {
       const sunsetAndSunrise =
-        await this.propertiesService.getNextSunsetAndSunrise()
+        await this.propertiesService.getNextSunsetAndSunrise(day.toJSDate())
       sleepingTime = sunsetAndSunrise.sunset
       wakingUpTime = sunsetAndSunrise.sunrise
-      this.logger.log(`Using next sunset and sunrise times.`)
     } else {
       sleepingTime = await this.getSleepingTime()
       wakingUpTime = await this.getWakingUpTime()
-      this.logger.log(`Using manually set sleeping and waking up times.`)
     }
     if (!sleepingTime || !wakingUpTime) {
-      this.logger.log(
-        'Sleeping or waking up time not defined. Exiting cron job.',
-      )
-      return
+      this.logger.log('Sleeping or waking up time not defined.')
+      return undefined
     }
-    const sleepingTimeString =
-      TriggeringTimeHelper.convertToString(sleepingTime)
-    const wakingUpString = TriggeringTimeHelper.convertToString(wakingUpTime)
-    this.logger.log(
-      `Setting sleeping time ${sleepingTimeString} and waking up time ${wakingUpString}...`,
-    )
     if (TriggeringTimeHelper.areTimesEqual(wakingUpTime, sleepingTime)) {
       this.logger.error(
-        'The waking up time cannot be the same as the sleeping time. Exiting cron job',
+        'The waking up time cannot be the same as the sleeping time.',
       )
+      return undefined
+    }
+
+    const sleepingDateTime = TriggeringTimeHelper.atDay(day, sleepingTime)
+    let wakingUpDateTime = TriggeringTimeHelper.atDay(day, wakingUpTime)
+    if (wakingUpDateTime <= sleepingDateTime) {
+      wakingUpDateTime = wakingUpDateTime.plus({ days: 1 })
+    }
+    return { sleepingDateTime, wakingUpDateTime }
+  }
+
+  async sleepWhenItIsTime() {
+    this.logger.log('Timer to go to sleep when it is time triggered...')
+    const sleepingWindow = this.nextSleepingWindow
+    this.nextSleepingWindow = undefined
+    if (!sleepingWindow) {
       return
     }
 
-    const now = new Date()
+    const now = DateTime.now()
     if (
-      sleepingTime.hour === now.getHours() &&
-      sleepingTime.minute === now.getMinutes()
+      now <
+      sleepingWindow.sleepingDateTime.minus({
+        minutes: SLEEPING_TIMER_TOLERANCE_MINUTES,
+      })
     ) {
+      this.logger.log('It is not yet time to sleep.')
+    } else if (now >= sleepingWindow.wakingUpDateTime) {
+      this.logger.warn('The sleeping window has already passed.')
+    } else {
       this.logger.log('It is time to sleep. Good night!')
-      let wakingUpDateTime = DateTime.now().set({
-        hour: wakingUpTime.hour,
-        minute: wakingUpTime.minute,
+      this.eventLogService?.record('sleep', {
+        value: sleepingWindow.wakingUpDateTime.toMillis(),
       })
-      if (TriggeringTimeHelper.isFirstTimeEarlier(wakingUpTime, sleepingTime)) {
-        wakingUpDateTime = wakingUpDateTime.plus({ days: 1 })
-      }
       try {
         await SleepInteractor.triggerSleeping(
-          wakingUpDateTime.toISO(),
+          sleepingWindow.wakingUpDateTime.toISO(),
           this.logger,
         )
       } catch (error) {
@@ -1186,9 +1554,8 @@ export class SettingsService implements ISettingsService {
           throw error
         }
       }
-    } else {
-      this.logger.log('It is not yet time to sleep.')
     }
+    await this.scheduleSleeping()
   }
 
   @Cron(CronExpression.EVERY_DAY_AT_NOON, {
@@ -1207,6 +1574,9 @@ export class SettingsService implements ISettingsService {
           throw error
         }
       }
+      this.eventLogService?.record('lightChange', {
+        code: LIGHT_CHANGE_CODES.alternation,
+      })
     } else {
       this.logger.log('Alternating light mode is disabled. Nothing to do.')
     }
@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
+import { DateTime } from 'luxon'
 import { TriggeringTimeHelper } from './triggering-time-helper'
 
 describe(TriggeringTimeHelper.name, () => {
@@ -46,6 +47,17 @@ describe(TriggeringTimeHelper.name, () => {
     })
   })
 
+  describe(TriggeringTimeHelper.atDay.name, () => {
+    it('returns the time on the given day', () => {
+      const day = DateTime.fromISO('2024-07-19T10:42:13.456')
+      expect(
+        TriggeringTimeHelper.atDay(day, { hour: 21, minute: 33 }).toISO({
+          includeOffset: false,
+        }),
+      ).toBe('2024-07-19T21:33:00.000')
+    })
+  })
+
   describe(TriggeringTimeHelper.convertToString.name, () => {
     it('returns a time without padding', () => {
       expect(
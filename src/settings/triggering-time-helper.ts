@@ -14,6 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
+import { DateTime } from 'luxon'
 import TriggeringTime from '../shared/entities/triggering-time'
 
 export class TriggeringTimeHelper {
@@ -27,6 +28,15 @@ export class TriggeringTimeHelper {
     )
   }
 
+  static atDay(day: DateTime, time: TriggeringTime): DateTime {
+    return day.set({
+      hour: time.hour,
+      minute: time.minute,
+      second: 0,
+      millisecond: 0,
+    })
+  }
+
   static convertToString(time: TriggeringTime) {
     return (
       time.hour.toString().padStart(2, '0') +
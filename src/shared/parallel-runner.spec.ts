@@ -0,0 +1,47 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { ParallelRunner } from './parallel-runner'
+
+describe(ParallelRunner.name, () => {
+  describe(ParallelRunner.run, () => {
+    it('returns results in input order', async () => {
+      const items = [30, 10, 20]
+      const results = await ParallelRunner.run(items, 2, async (item) => {
+        await new Promise((r) => setTimeout(r, item))
+        return item * 2
+      })
+      expect(results).toEqual([60, 20, 40])
+    })
+
+    it('never exceeds the concurrency limit', async () => {
+      let running = 0
+      let maximumRunning = 0
+      await ParallelRunner.run(new Array(10).fill(0), 3, async () => {
+        running++
+        maximumRunning = Math.max(maximumRunning, running)
+        await new Promise((r) => setTimeout(r, 5))
+        running--
+      })
+      expect(maximumRunning).toBe(3)
+    })
+
+    it('resolves on empty input', async () => {
+      const results = await ParallelRunner.run([], 4, async () => 1)
+      expect(results).toEqual([])
+    })
+  })
+})
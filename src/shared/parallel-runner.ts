@@ -0,0 +1,35 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+export class ParallelRunner {
+  static async run<T, R>(
+    items: T[],
+    concurrency: number,
+    task: (item: T) => Promise<R>,
+  ): Promise<R[]> {
+    const results: R[] = new Array(items.length)
+    let nextIndex = 0
+    const worker = async () => {
+      while (nextIndex < items.length) {
+        const index = nextIndex++
+        results[index] = await task(items[index])
+      }
+    }
+    const workerCount = Math.max(1, Math.min(concurrency, items.length))
+    await Promise.all(Array.from({ length: workerCount }, worker))
+    return results
+  }
+}
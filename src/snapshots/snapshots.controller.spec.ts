@@ -20,6 +20,7 @@ import { ConfigService } from '@nestjs/config'
 import { Test, TestingModule } from '@nestjs/testing'
 import { vi } from 'vitest'
 import { FilesService } from '../files/files.service'
+import { ShotIndex } from '../files/shot-index'
 import { MotionClientService } from '../motion-client.service'
 import { PropertiesService } from '../properties/properties.service'
 import { SettingsService } from '../settings/settings.service'
@@ -50,6 +51,7 @@ describe(SnapshotsController.name, () => {
         MotionClientService,
         PropertiesService,
         SettingsService,
+        ShotIndex,
         { provide: SnapshotsService, useClass: MockSnapshotsService },
       ],
     }).compile()
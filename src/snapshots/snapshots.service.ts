@@ -17,6 +17,7 @@
 import { Injectable, Logger } from '@nestjs/common'
 import { ConfigService } from '@nestjs/config'
 import { FilesService } from '../files/files.service'
+import { MetricsRegistry } from '../metrics/metrics-registry'
 import { MotionClientService } from '../motion-client.service'
 import { FileSystemInteractor } from './file-system-interactor'
 import { ISnapshotsService } from './snapshots.service.interface'
@@ -46,10 +47,12 @@ export class SnapshotsService implements ISnapshotsService {
     await new Promise((resolve) => setTimeout(resolve, waitingTimeMs))
 
     const fileFolderPath = await this.motionClientService.getTargetDir()
-    const filename =
-      await FileSystemInteractor.getNameOfMostRecentlyModifiedFile(
-        fileFolderPath,
-      )
+    const filename = await MetricsRegistry.measure(
+      'dependency',
+      ['fs', 'findNewestShot'],
+      () =>
+        FileSystemInteractor.getNameOfMostRecentlyModifiedFile(fileFolderPath),
+    )
     return this.filesService.getStreamableFile(filename)
   }
 }
@@ -14,7 +14,10 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-export interface StorageUsageDto {
-  capacityKb: number
-  usedPercentage: number
+import { StorageSpaceDto } from './storage-space.dto'
+
+export interface StorageUsageDto extends StorageSpaceDto {
+  writeRateKbPerSecond: number | null
+  secondsUntilFull: number | null
+  secondsUntilMotionPause: number | null
 }
@@ -0,0 +1,35 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { StorageUsageInteractor } from './storage-usage-interactor'
+
+describe(StorageUsageInteractor.name, () => {
+  describe(StorageUsageInteractor.getStorageUsage.name, () => {
+    it('reads the usage of the file system containing the path', async () => {
+      const usage = await StorageUsageInteractor.getStorageUsage('src')
+      expect(usage.capacityKb).toBeGreaterThan(0)
+      expect(usage.availableKb).toBeLessThanOrEqual(usage.capacityKb)
+      expect(usage.usedPercentage).toBeGreaterThanOrEqual(0)
+      expect(usage.usedPercentage).toBeLessThanOrEqual(100)
+    })
+
+    it('rejects a non-existing path', async () => {
+      await expect(
+        StorageUsageInteractor.getStorageUsage('src/non-existing'),
+      ).rejects.toMatchObject({ code: 'ENOENT' })
+    })
+  })
+})
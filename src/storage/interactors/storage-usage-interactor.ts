@@ -14,38 +14,27 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
-import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
-import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
-import { StorageUsageDto } from '../dto/storage-usage.dto'
+import { statfs } from 'fs/promises'
+import { StorageSpaceDto } from '../dto/storage-space.dto'
 import { NumberUtils } from '../number-utils'
 
-const exec = promisify(execSync)
-
-const EXTERNAL_STORAGE_DEVICE_PATH_PREFIX = '/media/'
-const ROOT_DEVICE_PATH = '/dev/root'
+const BYTES_PER_KB = 1024
 
 export class StorageUsageInteractor {
-  static async getStorageUsage(path: string): Promise<StorageUsageDto> {
-    CommandUnavailableOnWindowsException.throwIfOnWindows()
-    let pathToFilterBy = path
-    if (!path.startsWith(EXTERNAL_STORAGE_DEVICE_PATH_PREFIX)) {
-      pathToFilterBy = ROOT_DEVICE_PATH
-    }
-    const { stdout, stderr } = await exec(`df -Pkl | grep ${pathToFilterBy}`)
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
-    }
-    const parts = stdout.split(/\s+/)
-    const usedKb = parseInt(parts[2])
-    const availableKb = parseInt(parts[3])
+  static async getStorageUsage(path: string): Promise<StorageSpaceDto> {
+    const stats = await statfs(path)
+    const kbPerBlock = stats.bsize / BYTES_PER_KB
+    // Same semantics as df: blocks reserved for root count neither as used
+    // nor as available.
+    const usedKb = Math.round((stats.blocks - stats.bfree) * kbPerBlock)
+    const availableKb = Math.round(stats.bavail * kbPerBlock)
     const capacityKb = usedKb + availableKb
-    const usedPercentage = NumberUtils.roundNumberByDigits(
-      (usedKb / capacityKb) * 100,
-      2,
-    )
+    const usedPercentage =
+      capacityKb > 0
+        ? NumberUtils.roundNumberByDigits((usedKb / capacityKb) * 100, 2)
+        : 0
     return {
+      availableKb,
       capacityKb,
       usedPercentage,
     }
@@ -0,0 +1,81 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { StorageUsageSampler } from './storage-usage-sampler'
+
+describe(StorageUsageSampler.name, () => {
+  describe(StorageUsageSampler.prototype.getWriteRateKbPerSecond.name, () => {
+    it('returns null with less than two samples', () => {
+      const sampler = new StorageUsageSampler()
+      sampler.addSample('/a', 100, 0)
+      expect(sampler.getWriteRateKbPerSecond()).toBeNull()
+    })
+
+    it('derives the rate from decreasing free space', () => {
+      const sampler = new StorageUsageSampler()
+      sampler.addSample('/a', 1000, 0)
+      sampler.addSample('/a', 900, 10000)
+      sampler.addSample('/a', 800, 20000)
+      expect(sampler.getWriteRateKbPerSecond()).toBe(10)
+    })
+
+    it('ignores freed space', () => {
+      const sampler = new StorageUsageSampler()
+      sampler.addSample('/a', 1000, 0)
+      sampler.addSample('/a', 900, 10000)
+      sampler.addSample('/a', 5000, 20000)
+      expect(sampler.getWriteRateKbPerSecond()).toBe(5)
+    })
+
+    it('drops the oldest samples', () => {
+      const sampler = new StorageUsageSampler(2)
+      sampler.addSample('/a', 1000, 0)
+      sampler.addSample('/a', 1000, 10000)
+      sampler.addSample('/a', 900, 20000)
+      expect(sampler.getWriteRateKbPerSecond()).toBe(10)
+    })
+
+    it('skips samples closer than the minimum spacing', () => {
+      const sampler = new StorageUsageSampler(3, 60000)
+      sampler.addSample('/a', 1000, 0)
+      sampler.addSample('/a', 500, 10000)
+      sampler.addSample('/a', 400, 60000)
+      expect(sampler.getWriteRateKbPerSecond()).toBe(10)
+    })
+
+    it('restarts the history when the device path changes', () => {
+      const sampler = new StorageUsageSampler()
+      sampler.addSample('/a', 1000, 0)
+      sampler.addSample('/b', 900, 10000)
+      expect(sampler.getWriteRateKbPerSecond()).toBeNull()
+    })
+  })
+
+  describe(StorageUsageSampler.projectSecondsUntil.name, () => {
+    it('returns null without a write rate', () => {
+      expect(StorageUsageSampler.projectSecondsUntil(100, null)).toBeNull()
+      expect(StorageUsageSampler.projectSecondsUntil(100, 0)).toBeNull()
+    })
+
+    it('projects the remaining time', () => {
+      expect(StorageUsageSampler.projectSecondsUntil(100, 4)).toBe(25)
+    })
+
+    it('does not return negative times', () => {
+      expect(StorageUsageSampler.projectSecondsUntil(-100, 4)).toBe(0)
+    })
+  })
+})
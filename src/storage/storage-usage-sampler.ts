@@ -0,0 +1,89 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+const DEFAULT_MAXIMUM_SAMPLE_COUNT = 60
+
+interface StorageSample {
+  timeMilliseconds: number
+  availableKb: number
+}
+
+export class StorageUsageSampler {
+  private samples: StorageSample[] = []
+  private devicePath: string
+
+  constructor(
+    private readonly maximumSampleCount = DEFAULT_MAXIMUM_SAMPLE_COUNT,
+    private readonly minimumSampleSpacingMilliseconds = 0,
+  ) {}
+
+  addSample(
+    devicePath: string,
+    availableKb: number,
+    timeMilliseconds = Date.now(),
+  ): void {
+    if (devicePath !== this.devicePath) {
+      this.devicePath = devicePath
+      this.samples = []
+    }
+    const lastSample = this.samples[this.samples.length - 1]
+    if (
+      lastSample &&
+      timeMilliseconds - lastSample.timeMilliseconds <
+        this.minimumSampleSpacingMilliseconds
+    ) {
+      return
+    }
+    this.samples.push({ timeMilliseconds, availableKb })
+    if (this.samples.length > this.maximumSampleCount) {
+      this.samples.shift()
+    }
+  }
+
+  // Only decreasing free space is summed up so that deleting files does not
+  // distort the rate at which Motion fills the storage.
+  getWriteRateKbPerSecond(): number | null {
+    if (this.samples.length < 2) {
+      return null
+    }
+    let writtenKb = 0
+    for (let i = 1; i < this.samples.length; i++) {
+      const freedKb =
+        this.samples[i].availableKb - this.samples[i - 1].availableKb
+      if (freedKb < 0) {
+        writtenKb -= freedKb
+      }
+    }
+    const durationSeconds =
+      (this.samples[this.samples.length - 1].timeMilliseconds -
+        this.samples[0].timeMilliseconds) /
+      1000
+    if (durationSeconds <= 0) {
+      return null
+    }
+    return writtenKb / durationSeconds
+  }
+
+  static projectSecondsUntil(
+    remainingKb: number,
+    writeRateKbPerSecond: number | null,
+  ): number | null {
+    if (!writeRateKbPerSecond || writeRateKbPerSecond <= 0) {
+      return null
+    }
+    return Math.max(0, Math.round(remainingKb / writeRateKbPerSecond))
+  }
+}
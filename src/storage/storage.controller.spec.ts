@@ -28,8 +28,12 @@ describe(StorageController.name, () => {
   }
 
   const STORAGE_USAGE: StorageUsageDto = {
+    availableKb: 1,
     capacityKb: 1,
     usedPercentage: 2,
+    writeRateKbPerSecond: null,
+    secondsUntilFull: null,
+    secondsUntilMotionPause: null,
   }
 
   class MockStorageService implements Partial<IStorageService> {
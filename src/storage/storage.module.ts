@@ -16,12 +16,14 @@
  */
 import { Module } from '@nestjs/common'
 import { MotionClientService } from '../motion-client.service'
+import { NotificationsModule } from '../notifications/notifications.module'
 import { StorageController } from './storage.controller'
 import { StorageService } from './storage.service'
 
 @Module({
   controllers: [StorageController],
   providers: [MotionClientService, StorageService],
+  imports: [NotificationsModule],
   exports: [StorageService],
 })
 export class StorageModule {}
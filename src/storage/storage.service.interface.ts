@@ -4,5 +4,6 @@ import { StorageUsageDto } from './dto/storage-usage.dto'
 export interface IStorageService {
   getStorageStatus: () => Promise<StorageStatusDto>
   getStorageUsage: () => Promise<StorageUsageDto>
+  sampleStorageUsage: () => Promise<void>
   isDiskSpaceUsageAboveThreshold: () => Promise<boolean>
 }
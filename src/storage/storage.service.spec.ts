@@ -18,7 +18,8 @@ import { Test, TestingModule } from '@nestjs/testing'
 import { vi } from 'vitest'
 import { MotionClientService } from '../motion-client.service'
 import { IMotionClientService } from '../motion-client.service.interface'
-import { StorageUsageDto } from './dto/storage-usage.dto'
+import { NotificationsService } from '../notifications/notifications.service'
+import { StorageSpaceDto } from './dto/storage-space.dto'
 import { FileSystemInteractor } from './interactors/file-system-interactor'
 import { StorageUsageInteractor } from './interactors/storage-usage-interactor'
 import { StorageService } from './storage.service'
@@ -26,7 +27,8 @@ import { StorageService } from './storage.service'
 const FILES_FOLDER_PATH = 'src/files/fixtures/'
 
 describe(StorageService.name, () => {
-  const STORAGE_USAGE: StorageUsageDto = {
+  const STORAGE_SPACE: StorageSpaceDto = {
+    availableKb: 1,
     capacityKb: 1,
     usedPercentage: 2,
   }
@@ -36,16 +38,20 @@ describe(StorageService.name, () => {
   }
 
   let service: StorageService
+  let notificationsService: NotificationsService
 
   beforeEach(async () => {
     const module: TestingModule = await Test.createTestingModule({
       providers: [
         { provide: MotionClientService, useClass: MockMotionClientService },
+        NotificationsService,
         StorageService,
       ],
     }).compile()
 
     service = module.get<StorageService>(StorageService)
+    notificationsService =
+      module.get<NotificationsService>(NotificationsService)
   })
 
   it('should be defined', () => {
@@ -134,10 +140,83 @@ describe(StorageService.name, () => {
       const spyGetStorageUsage = vi
         .spyOn(StorageUsageInteractor, 'getStorageUsage')
         .mockImplementation(() => {
-          return Promise.resolve(STORAGE_USAGE)
+          return Promise.resolve(STORAGE_SPACE)
         })
       const response = await service.getStorageUsage()
-      expect(response).toEqual(STORAGE_USAGE)
+      expect(response).toEqual({
+        ...STORAGE_SPACE,
+        writeRateKbPerSecond: null,
+        secondsUntilFull: null,
+        secondsUntilMotionPause: null,
+      })
+      spyGetStorageUsage.mockRestore()
+    })
+
+    it('projects the time until full from sampled write rates', async () => {
+      const now = Date.now()
+      const spyNow = vi.spyOn(Date, 'now')
+      const spyGetStorageUsage = vi.spyOn(
+        StorageUsageInteractor,
+        'getStorageUsage',
+      )
+      spyNow.mockReturnValue(now)
+      spyGetStorageUsage.mockResolvedValue({
+        availableKb: 10000,
+        capacityKb: 100000,
+        usedPercentage: 90,
+      })
+      await service.sampleStorageUsage()
+      spyNow.mockReturnValue(now + 60000)
+      spyGetStorageUsage.mockResolvedValue({
+        availableKb: 9400,
+        capacityKb: 100000,
+        usedPercentage: 90.6,
+      })
+      await service.sampleStorageUsage()
+      const response = await service.getStorageUsage()
+      expect(response.writeRateKbPerSecond).toBe(10)
+      expect(response.secondsUntilFull).toBe(940)
+      expect(response.secondsUntilMotionPause).toBe(440)
+      spyGetStorageUsage.mockRestore()
+      spyNow.mockRestore()
+    })
+
+    it('notifies when the usage crosses a threshold', async () => {
+      const spyPublish = vi.spyOn(notificationsService, 'publish')
+      const spyGetStorageUsage = vi.spyOn(
+        StorageUsageInteractor,
+        'getStorageUsage',
+      )
+      for (const usedPercentage of [79, 85, 96, 89]) {
+        spyGetStorageUsage.mockResolvedValue({
+          availableKb: 1,
+          capacityKb: 1,
+          usedPercentage,
+        })
+        await service.sampleStorageUsage()
+      }
+      expect(spyPublish.mock.calls).toEqual([
+        [
+          'storageThresholdCrossed',
+          { thresholdPercentage: 80, usedPercentage: 85, isAbove: true },
+        ],
+        [
+          'storageThresholdCrossed',
+          { thresholdPercentage: 90, usedPercentage: 96, isAbove: true },
+        ],
+        [
+          'storageThresholdCrossed',
+          { thresholdPercentage: 95, usedPercentage: 96, isAbove: true },
+        ],
+        [
+          'storageThresholdCrossed',
+          { thresholdPercentage: 90, usedPercentage: 89, isAbove: false },
+        ],
+        [
+          'storageThresholdCrossed',
+          { thresholdPercentage: 95, usedPercentage: 89, isAbove: false },
+        ],
+      ])
       spyGetStorageUsage.mockRestore()
     })
   })
@@ -148,6 +227,7 @@ describe(StorageService.name, () => {
         .spyOn(StorageUsageInteractor, 'getStorageUsage')
         .mockImplementation(() => {
           return Promise.resolve({
+            availableKb: 0,
             capacityKb: 1,
             usedPercentage: 96,
           })
@@ -162,6 +242,7 @@ describe(StorageService.name, () => {
         .spyOn(StorageUsageInteractor, 'getStorageUsage')
         .mockImplementation(() => {
           return Promise.resolve({
+            availableKb: 0,
             capacityKb: 1,
             usedPercentage: 94,
           })
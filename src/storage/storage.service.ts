@@ -14,24 +14,46 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { Injectable, Logger } from '@nestjs/common'
+import { Injectable, Logger, Optional } from '@nestjs/common'
+import { Cron } from '@nestjs/schedule'
+import { Subject } from 'rxjs'
+import { MetricsRegistry } from '../metrics/metrics-registry'
 import { MotionClientService } from '../motion-client.service'
-import { CommandUnavailableOnWindowsException } from '../shared/exceptions/CommandUnavailableOnWindowsException'
+import { NotificationsService } from '../notifications/notifications.service'
+import { StorageSpaceDto } from './dto/storage-space.dto'
 import { StorageStatusDto } from './dto/storage-status.dto'
 import { StorageUsageDto } from './dto/storage-usage.dto'
 import { FileSystemInteractor } from './interactors/file-system-interactor'
 import { StorageUsageInteractor } from './interactors/storage-usage-interactor'
+import { StorageUsageSampler } from './storage-usage-sampler'
 import { IStorageService } from './storage.service.interface'
 
-const MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE = 95
+export const MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE = 95
+const NOTIFIED_USAGE_THRESHOLD_PERCENTAGES = [
+  80,
+  90,
+  MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE,
+]
 const STORAGE_MOUNT_PATH = '/media'
+// Usage is sampled more often to react quickly, but the write rate is derived
+// from samples spread over one hour.
+const WRITE_RATE_SAMPLE_SPACING_MILLISECONDS = 60000
 const WRITE_PERMISSION_MASK = 2
 
 @Injectable()
 export class StorageService implements IStorageService {
+  readonly usageSampled$ = new Subject<StorageSpaceDto>()
   private readonly logger = new Logger(StorageService.name)
+  private readonly storageUsageSampler = new StorageUsageSampler(
+    undefined,
+    WRITE_RATE_SAMPLE_SPACING_MILLISECONDS,
+  )
+  private lastSampledUsedPercentage: number | null = null
 
-  constructor(private readonly motionClientService: MotionClientService) {}
+  constructor(
+    private readonly motionClientService: MotionClientService,
+    @Optional() private readonly notificationsService?: NotificationsService,
+  ) {}
 
   async getStorageStatus(): Promise<StorageStatusDto> {
     const devicePath = await this.motionClientService.getTargetDir()
@@ -61,8 +83,11 @@ export class StorageService implements IStorageService {
       ) {
         let subdirectories: string[] = []
         try {
-          subdirectories =
-            await FileSystemInteractor.getSubdirectories(STORAGE_MOUNT_PATH)
+          subdirectories = await MetricsRegistry.measure(
+            'dependency',
+            ['fs', 'listMountPoints'],
+            () => FileSystemInteractor.getSubdirectories(STORAGE_MOUNT_PATH),
+          )
         } catch (error) {
           Logger.warn(error)
         }
@@ -89,17 +114,60 @@ export class StorageService implements IStorageService {
 
   async getStorageUsage(): Promise<StorageUsageDto> {
     const devicePath = await this.motionClientService.getTargetDir()
+    const space = await StorageUsageInteractor.getStorageUsage(devicePath)
+    const writeRateKbPerSecond =
+      this.storageUsageSampler.getWriteRateKbPerSecond()
+    const motionPauseRemainingKb =
+      space.availableKb -
+      (space.capacityKb *
+        (100 - MOTION_PAUSE_DISK_SPACE_USAGE_THRESHOLD_PERCENTAGE)) /
+        100
+    return {
+      ...space,
+      writeRateKbPerSecond,
+      secondsUntilFull: StorageUsageSampler.projectSecondsUntil(
+        space.availableKb,
+        writeRateKbPerSecond,
+      ),
+      secondsUntilMotionPause: StorageUsageSampler.projectSecondsUntil(
+        motionPauseRemainingKb,
+        writeRateKbPerSecond,
+      ),
+    }
+  }
+
+  @Cron('*/10 * * * * *') // every 10 seconds
+  async sampleStorageUsage(): Promise<void> {
+    let devicePath: string
+    let space: StorageSpaceDto
     try {
-      const usage = StorageUsageInteractor.getStorageUsage(devicePath)
-      return usage
+      devicePath = await this.motionClientService.getTargetDir()
+      space = await StorageUsageInteractor.getStorageUsage(devicePath)
     } catch (error) {
-      if (error instanceof CommandUnavailableOnWindowsException) {
-        return {
-          capacityKb: 0,
-          usedPercentage: 0,
-        }
+      this.logger.warn(`Storage usage could not be sampled: ${error.message}`)
+      return
+    }
+    this.storageUsageSampler.addSample(devicePath, space.availableKb)
+    this.notifyCrossedThresholds(space.usedPercentage)
+    this.usageSampled$.next(space)
+  }
+
+  private notifyCrossedThresholds(usedPercentage: number): void {
+    const previousUsedPercentage = this.lastSampledUsedPercentage
+    this.lastSampledUsedPercentage = usedPercentage
+    if (previousUsedPercentage === null) {
+      return
+    }
+    for (const thresholdPercentage of NOTIFIED_USAGE_THRESHOLD_PERCENTAGES) {
+      const wasAbove = previousUsedPercentage > thresholdPercentage
+      const isAbove = usedPercentage > thresholdPercentage
+      if (wasAbove !== isAbove) {
+        this.notificationsService?.publish('storageThresholdCrossed', {
+          thresholdPercentage,
+          usedPercentage,
+          isAbove,
+        })
       }
-      throw error
     }
   }
 
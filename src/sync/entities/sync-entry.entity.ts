@@ -0,0 +1,35 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+export type SyncEntryType = 'created' | 'deleted'
+
+/**
+ * One change of the shots folder. A shot that changed after it was created,
+ * e.g. a movie that was still being written, is created again with a new
+ * sequence number.
+ */
+export class SyncEntry {
+  sequence: number
+  type: SyncEntryType
+  name: string
+  sizeBytes?: number
+  modificationTime?: Date
+}
+
+export class SyncManifestEntry extends SyncEntry {
+  // CRC32C of the content, only for created shots that could be read.
+  checksum?: string
+}
@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { appendFile, readFile, rename, rm, writeFile } from 'fs/promises'
+import { SyncEntry } from './entities/sync-entry.entity'
+
+const TEMPORARY_FILE_SUFFIX = '.tmp'
+
+interface SyncHeaderLine {
+  id?: string
+  horizon: number
+}
+
+export interface SyncJournalContent {
+  // Missing for a journal that has not been written yet.
+  id?: string
+  horizon: number
+  entries: SyncEntry[]
+}
+
+export class SyncJournalFileProvider {
+  static async readJournal(filePath: string): Promise<SyncJournalContent> {
+    let data: string
+    try {
+      data = (await readFile(filePath)).toString()
+    } catch (err) {
+      if (err.code !== 'ENOENT') {
+        throw err
+      }
+      return { horizon: 0, entries: [] }
+    }
+    let id: string | undefined
+    let horizon = 0
+    const entries: SyncEntry[] = []
+    for (const line of data.split('\n')) {
+      if (!line) {
+        continue
+      }
+      try {
+        const parsed: SyncEntry | SyncHeaderLine = JSON.parse(line)
+        if ('horizon' in parsed) {
+          id = parsed.id
+          horizon = parsed.horizon
+        } else {
+          entries.push(this.parseEntry(parsed))
+        }
+      } catch {
+        // A line cut off by a power loss only loses that change.
+      }
+    }
+    return { id, horizon, entries }
+  }
+
+  static async appendEntries(
+    entries: SyncEntry[],
+    filePath: string,
+  ): Promise<void> {
+    if (entries.length === 0) {
+      return
+    }
+    const lines = entries.map((entry) => JSON.stringify(entry) + '\n')
+    await appendFile(filePath, lines.join(''))
+  }
+
+  static async writeJournal(
+    content: SyncJournalContent,
+    filePath: string,
+  ): Promise<void> {
+    const headerLine: SyncHeaderLine = {
+      id: content.id,
+      horizon: content.horizon,
+    }
+    const lines = [headerLine, ...content.entries].map(
+      (line) => JSON.stringify(line) + '\n',
+    )
+    const temporaryFilePath = filePath + TEMPORARY_FILE_SUFFIX
+    try {
+      await writeFile(temporaryFilePath, lines.join(''))
+      await rename(temporaryFilePath, filePath)
+    } catch (err) {
+      await rm(temporaryFilePath, { force: true })
+      throw err
+    }
+  }
+
+  private static parseEntry(entry: SyncEntry): SyncEntry {
+    if (typeof entry.sequence !== 'number' || typeof entry.name !== 'string') {
+      throw new Error('Invalid sync journal entry')
+    }
+    return entry.modificationTime
+      ? { ...entry, modificationTime: new Date(entry.modificationTime) }
+      : entry
+  }
+}
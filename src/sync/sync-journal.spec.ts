@@ -0,0 +1,163 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, readFile, rm } from 'fs/promises'
+import path from 'path'
+import { IndexedShot } from '../files/entities/indexed-shot.entity'
+import { SyncJournal } from './sync-journal'
+
+function createShot(name: string, sizeBytes = 10, time = 1000): IndexedShot {
+  return { name, sizeBytes, creationTime: new Date(time) }
+}
+
+describe(SyncJournal.name, () => {
+  const TEST_FOLDER = 'src/sync/test-sync-journal'
+  const FILE_PATH = path.join(TEST_FOLDER, 'sync-journal.jsonl')
+
+  let journal: SyncJournal
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+    journal = new SyncJournal(FILE_PATH)
+  })
+
+  it('starts empty without a file', async () => {
+    expect(await journal.getChanges(undefined, 10)).toEqual({
+      cursor: expect.stringMatching(/^[0-9a-f]{16}-0$/),
+      latestSequence: 0,
+      hasMore: false,
+      isReset: false,
+      entries: [],
+    })
+  })
+
+  it('journals new shots in the given order', async () => {
+    await journal.update([createShot('a.jpg'), createShot('b.mp4', 20, 2000)])
+    const changes = await journal.getChanges(undefined, 10)
+    expect(changes.entries).toEqual([
+      {
+        sequence: 1,
+        type: 'created',
+        name: 'a.jpg',
+        sizeBytes: 10,
+        modificationTime: new Date(1000),
+      },
+      {
+        sequence: 2,
+        type: 'created',
+        name: 'b.mp4',
+        sizeBytes: 20,
+        modificationTime: new Date(2000),
+      },
+    ])
+    expect(changes.cursor).toBe(journal.formatCursor(2))
+  })
+
+  it('journals nothing for unchanged shots', async () => {
+    await journal.update([createShot('a.jpg')])
+    expect(await journal.update([createShot('a.jpg')])).toEqual([])
+  })
+
+  it('returns only the latest entry of a changed shot', async () => {
+    await journal.update([createShot('a.mp4'), createShot('b.jpg')])
+    await journal.update([createShot('a.mp4', 50, 1500), createShot('b.jpg')])
+    const changes = await journal.getChanges(undefined, 10)
+    expect(changes.entries.map((entry) => entry.name)).toEqual([
+      'b.jpg',
+      'a.mp4',
+    ])
+    expect(changes.entries[1]).toMatchObject({ sequence: 3, sizeBytes: 50 })
+  })
+
+  it('journals deletions and leaves them out after a reset', async () => {
+    await journal.update([createShot('a.jpg'), createShot('b.jpg')])
+    await journal.update([createShot('b.jpg')])
+    expect(
+      (await journal.getChanges(journal.formatCursor(2), 10)).entries,
+    ).toEqual([{ sequence: 3, type: 'deleted', name: 'a.jpg' }])
+    const changes = await journal.getChanges(journal.formatCursor(99), 10)
+    expect(changes.isReset).toBe(true)
+    expect(changes.entries.map((entry) => entry.name)).toEqual(['b.jpg'])
+  })
+
+  it('pages through the changes', async () => {
+    await journal.update(['a', 'b', 'c'].map((name) => createShot(name)))
+    const firstPage = await journal.getChanges(undefined, 2)
+    expect(firstPage.entries.map((entry) => entry.name)).toEqual(['a', 'b'])
+    expect(firstPage).toMatchObject({
+      cursor: journal.formatCursor(2),
+      hasMore: true,
+    })
+    const secondPage = await journal.getChanges(firstPage.cursor, 2)
+    expect(secondPage.entries.map((entry) => entry.name)).toEqual(['c'])
+    expect(secondPage).toMatchObject({
+      cursor: journal.formatCursor(3),
+      hasMore: false,
+    })
+  })
+
+  it('continues the sequence across restarts', async () => {
+    await journal.update([createShot('a.jpg')])
+    const restartedJournal = new SyncJournal(FILE_PATH)
+    await restartedJournal.update([createShot('a.jpg'), createShot('b.jpg')])
+    const changes = await restartedJournal.getChanges(
+      journal.formatCursor(1),
+      10,
+    )
+    expect(changes.entries).toEqual([
+      expect.objectContaining({ sequence: 2, name: 'b.jpg' }),
+    ])
+  })
+
+  it('resets cursors into a journal that was lost', async () => {
+    await journal.update([createShot('a.jpg'), createShot('b.jpg')])
+    const { cursor } = await journal.getChanges(undefined, 10)
+    await rm(FILE_PATH)
+    const newJournal = new SyncJournal(FILE_PATH)
+    await newJournal.update([createShot('b.jpg'), createShot('c.jpg')])
+    const changes = await newJournal.getChanges(cursor, 10)
+    expect(changes.isReset).toBe(true)
+    expect(changes.entries.map((entry) => entry.name)).toEqual([
+      'b.jpg',
+      'c.jpg',
+    ])
+  })
+
+  it('rewrites the file once most entries are superseded', async () => {
+    for (let size = 1; size <= 3; size++) {
+      await journal.update([createShot('a.mp4', size)])
+    }
+    const lines = (await readFile(FILE_PATH, 'utf8')).trim().split('\n')
+    expect(lines.map((line) => JSON.parse(line))).toEqual([
+      { id: expect.stringMatching(/^[0-9a-f]{16}$/), horizon: 0 },
+      expect.objectContaining({ sequence: 3, sizeBytes: 3 }),
+    ])
+    const restartedJournal = new SyncJournal(FILE_PATH)
+    await restartedJournal.update([createShot('b.jpg')])
+    const changes = await restartedJournal.getChanges(
+      journal.formatCursor(3),
+      10,
+    )
+    expect(changes.entries).toEqual([
+      expect.objectContaining({ sequence: 4, name: 'b.jpg' }),
+      { sequence: 5, type: 'deleted', name: 'a.mp4' },
+    ])
+  })
+
+  afterEach(async () => {
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
@@ -0,0 +1,260 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { randomBytes } from 'crypto'
+import { IndexedShot } from '../files/entities/indexed-shot.entity'
+import { SyncEntry } from './entities/sync-entry.entity'
+import { SyncManifest } from './entities/sync-manifest.entity'
+import { SyncJournalFileProvider } from './sync-journal-file-provider'
+
+// Deletions older than these are forgotten, which resets older cursors.
+const MAXIMUM_TOMBSTONE_COUNT = 10000
+const ID_BYTE_COUNT = 8
+
+/**
+ * Append-only journal of the shots created and deleted, numbered by a
+ * sequence that only ever grows. Clients remember the cursor they last
+ * received and ask for the changes after it. A cursor combines the sequence
+ * with the id of the journal, so that cursors into a journal that was lost
+ * are recognised instead of being read in the sequence of a new one.
+ *
+ * The journal follows the shots by comparing them with the latest entry of
+ * each name, so that shots changed while the backend was not running or
+ * while Motion wrote to another folder are picked up as well.
+ */
+export class SyncJournal {
+  private loading: Promise<void> | null = null
+  private id = ''
+  private horizon = 0
+  private nextSequence = 1
+  // All entries in sequence order, including superseded ones.
+  private entries: SyncEntry[] = []
+  private readonly latestEntries = new Map<string, SyncEntry>()
+  private supersededCount = 0
+  private tombstoneCount = 0
+  private pendingUpdate: Promise<unknown> = Promise.resolve()
+
+  constructor(private readonly filePath: string) {}
+
+  /**
+   * Journals the differences to the given shots and returns the new entries.
+   */
+  async update(shots: IndexedShot[]): Promise<SyncEntry[]> {
+    const result = this.pendingUpdate.then(() => this.applyShots(shots))
+    this.pendingUpdate = result.catch(() => undefined)
+    return result
+  }
+
+  /**
+   * Returns the latest entry of each shot changed after the given cursor, or
+   * since the start without one.
+   */
+  async getChanges(
+    since: string | undefined,
+    limit: number,
+  ): Promise<SyncManifest> {
+    await this.pendingUpdate
+    await this.load()
+    const latestSequence = this.nextSequence - 1
+    const sinceSequence = since === undefined ? 0 : this.parseCursor(since)
+    const isReset =
+      sinceSequence === null ||
+      sinceSequence < this.horizon ||
+      sinceSequence > latestSequence
+    const entries: SyncEntry[] = []
+    // One more than asked for tells whether there are more.
+    for (
+      let index = this.findFirstIndexAfter(isReset ? 0 : sinceSequence);
+      index < this.entries.length && entries.length <= limit;
+      index++
+    ) {
+      const entry = this.entries[index]
+      const isLatest = this.latestEntries.get(entry.name) === entry
+      if (isLatest && !(isReset && entry.type === 'deleted')) {
+        entries.push(entry)
+      }
+    }
+    const hasMore = entries.length > limit
+    if (hasMore) {
+      entries.pop()
+    }
+    return {
+      cursor: this.formatCursor(
+        hasMore ? entries[entries.length - 1].sequence : latestSequence,
+      ),
+      latestSequence,
+      hasMore,
+      isReset,
+      entries,
+    }
+  }
+
+  formatCursor(sequence: number): string {
+    return `${this.id}-${sequence}`
+  }
+
+  /**
+   * Returns the sequence of a cursor into this journal, or null otherwise.
+   * Only valid once the changes have been asked for.
+   */
+  parseCursor(cursor: string): number | null {
+    const [id, sequence] = cursor.split('-')
+    if (id !== this.id || !/^\d+$/.test(sequence ?? '')) {
+      return null
+    }
+    return parseInt(sequence)
+  }
+
+  private async load(): Promise<void> {
+    if (!this.loading) {
+      this.loading = this.readJournal().catch((error) => {
+        this.loading = null
+        throw error
+      })
+    }
+    return this.loading
+  }
+
+  private async readJournal(): Promise<void> {
+    const content = await SyncJournalFileProvider.readJournal(this.filePath)
+    this.horizon = content.horizon
+    this.nextSequence = content.horizon + 1
+    this.entries = []
+    this.latestEntries.clear()
+    this.supersededCount = 0
+    this.tombstoneCount = 0
+    for (const entry of content.entries) {
+      this.append(entry)
+    }
+    this.id = content.id
+    if (!this.id) {
+      this.id = randomBytes(ID_BYTE_COUNT).toString('hex')
+      await SyncJournalFileProvider.writeJournal(
+        { id: this.id, horizon: this.horizon, entries: this.entries },
+        this.filePath,
+      )
+    }
+  }
+
+  private async applyShots(shots: IndexedShot[]): Promise<SyncEntry[]> {
+    await this.load()
+    const names = new Set<string>()
+    const newEntries: SyncEntry[] = []
+    for (const shot of shots) {
+      names.add(shot.name)
+      const latestEntry = this.latestEntries.get(shot.name)
+      if (
+        !latestEntry ||
+        latestEntry.type === 'deleted' ||
+        latestEntry.sizeBytes !== shot.sizeBytes ||
+        latestEntry.modificationTime.getTime() !== shot.creationTime.getTime()
+      ) {
+        newEntries.push(
+          this.add({
+            type: 'created',
+            name: shot.name,
+            sizeBytes: shot.sizeBytes,
+            modificationTime: shot.creationTime,
+          }),
+        )
+      }
+    }
+    for (const entry of [...this.latestEntries.values()]) {
+      if (entry.type === 'created' && !names.has(entry.name)) {
+        newEntries.push(this.add({ type: 'deleted', name: entry.name }))
+      }
+    }
+    try {
+      await SyncJournalFileProvider.appendEntries(newEntries, this.filePath)
+      if (
+        this.supersededCount > this.latestEntries.size ||
+        this.tombstoneCount > 2 * MAXIMUM_TOMBSTONE_COUNT
+      ) {
+        await this.compact()
+      }
+    } catch (error) {
+      // Never hands out sequences that are not persisted.
+      this.loading = null
+      throw error
+    }
+    return newEntries
+  }
+
+  private add(entry: Omit<SyncEntry, 'sequence'>): SyncEntry {
+    const sequencedEntry = { sequence: this.nextSequence, ...entry }
+    this.append(sequencedEntry)
+    return sequencedEntry
+  }
+
+  private append(entry: SyncEntry): void {
+    const latestEntry = this.latestEntries.get(entry.name)
+    if (latestEntry) {
+      this.supersededCount++
+      if (latestEntry.type === 'deleted') {
+        this.tombstoneCount--
+      }
+    }
+    if (entry.type === 'deleted') {
+      this.tombstoneCount++
+    }
+    this.latestEntries.set(entry.name, entry)
+    this.entries.push(entry)
+    this.nextSequence = Math.max(this.nextSequence, entry.sequence + 1)
+  }
+
+  /**
+   * Keeps only the latest entry of each shot and the most recent deletions.
+   */
+  private async compact(): Promise<void> {
+    const latestEntries = this.entries.filter(
+      (entry) => this.latestEntries.get(entry.name) === entry,
+    )
+    const tombstones = latestEntries.filter((entry) => entry.type === 'deleted')
+    const expiredTombstones = new Set(
+      tombstones.slice(
+        0,
+        Math.max(0, tombstones.length - MAXIMUM_TOMBSTONE_COUNT),
+      ),
+    )
+    for (const tombstone of expiredTombstones) {
+      this.latestEntries.delete(tombstone.name)
+      this.horizon = Math.max(this.horizon, tombstone.sequence)
+    }
+    this.entries = latestEntries.filter(
+      (entry) => !expiredTombstones.has(entry),
+    )
+    this.supersededCount = 0
+    this.tombstoneCount -= expiredTombstones.size
+    await SyncJournalFileProvider.writeJournal(
+      { id: this.id, horizon: this.horizon, entries: this.entries },
+      this.filePath,
+    )
+  }
+
+  private findFirstIndexAfter(sequence: number): number {
+    let low = 0
+    let high = this.entries.length
+    while (low < high) {
+      const middle = (low + high) >>> 1
+      if (this.entries[middle].sequence <= sequence) {
+        low = middle + 1
+      } else {
+        high = middle
+      }
+    }
+    return low
+  }
+}
@@ -0,0 +1,105 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { PassThrough } from 'stream'
+import { BadRequestException } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { vi } from 'vitest'
+import { SyncController } from './sync.controller'
+import { SyncService } from './sync.service'
+import { ISyncService } from './sync.service.interface'
+
+const MANIFEST = {
+  cursor: '0123456789abcdef-1',
+  latestSequence: 1,
+  hasMore: false,
+  isReset: false,
+  entries: [],
+}
+
+describe(SyncController.name, () => {
+  class MockSyncService implements Partial<ISyncService> {
+    getManifest = vi.fn(() => Promise.resolve(MANIFEST))
+    getArchive = vi.fn(() =>
+      Promise.resolve({
+        contentType: 'application/x-tar',
+        filename: 'sync-0-7.tar',
+        cursor: '0123456789abcdef-7',
+        stream: new PassThrough(),
+      }),
+    )
+  }
+
+  let controller: SyncController
+  let service: SyncService
+
+  beforeEach(async () => {
+    const module: TestingModule = await Test.createTestingModule({
+      controllers: [SyncController],
+      providers: [{ provide: SyncService, useClass: MockSyncService }],
+    }).compile()
+
+    controller = module.get<SyncController>(SyncController)
+    service = module.get<SyncService>(SyncService)
+  })
+
+  it('should be defined', () => {
+    expect(controller).toBeDefined()
+  })
+
+  describe(SyncController.prototype.getManifest.name, () => {
+    it('asks for the changes since the cursor', async () => {
+      expect(await controller.getManifest('0123456789abcdef-5', 100)).toEqual(
+        MANIFEST,
+      )
+      expect(service.getManifest).toHaveBeenCalledWith(
+        '0123456789abcdef-5',
+        100,
+      )
+    })
+
+    it('rejects limits out of range', () => {
+      expect(() => controller.getManifest(undefined, 0)).toThrow(
+        BadRequestException,
+      )
+      expect(() => controller.getManifest(undefined, 10001)).toThrow(
+        BadRequestException,
+      )
+    })
+  })
+
+  describe(SyncController.prototype.downloadArchive.name, () => {
+    it('asks for the archive and sets the cursor header', async () => {
+      const mockResponse = {
+        set: vi.fn(),
+      }
+      await controller.downloadArchive(
+        '0123456789abcdef-5',
+        '0123456789abcdef-7',
+        mockResponse,
+      )
+      expect(service.getArchive).toHaveBeenCalledWith(
+        '0123456789abcdef-5',
+        '0123456789abcdef-7',
+      )
+      expect(mockResponse.set).toHaveBeenCalledWith({
+        'Content-Type': 'application/x-tar',
+        'Content-Disposition': 'attachment; filename="sync-0-7.tar"',
+        'X-Sync-Cursor': '0123456789abcdef-7',
+      })
+    })
+  })
+})
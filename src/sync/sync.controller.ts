@@ -0,0 +1,63 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import {
+  BadRequestException,
+  Controller,
+  DefaultValuePipe,
+  Get,
+  ParseIntPipe,
+  Query,
+  Res,
+  StreamableFile,
+} from '@nestjs/common'
+import { SyncManifest } from './entities/sync-manifest.entity'
+import { SyncService } from './sync.service'
+
+const DEFAULT_MANIFEST_LIMIT = 1000
+const MAXIMUM_MANIFEST_LIMIT = 10000
+
+@Controller('sync')
+export class SyncController {
+  constructor(private readonly syncService: SyncService) {}
+
+  @Get('manifest')
+  getManifest(
+    @Query('since') since: string | undefined,
+    @Query('limit', new DefaultValuePipe(DEFAULT_MANIFEST_LIMIT), ParseIntPipe)
+    limit: number,
+  ): Promise<SyncManifest> {
+    if (limit < 1 || limit > MAXIMUM_MANIFEST_LIMIT) {
+      throw new BadRequestException()
+    }
+    return this.syncService.getManifest(since, limit)
+  }
+
+  @Get('archive')
+  async downloadArchive(
+    @Query('since') since: string | undefined,
+    @Query('until') until: string | undefined,
+    @Res({ passthrough: true }) res,
+  ) {
+    const archive = await this.syncService.getArchive(since, until)
+    res.set({
+      'Content-Type': archive.contentType,
+      'Content-Disposition': 'attachment; filename="' + archive.filename + '"',
+      'X-Sync-Cursor': archive.cursor,
+    })
+    return new StreamableFile(archive.stream)
+  }
+}
@@ -0,0 +1,10 @@
+import { SyncArchive } from './entities/sync-archive.entity'
+import { SyncManifest } from './entities/sync-manifest.entity'
+
+export interface ISyncService {
+  getManifest: (
+    since: string | undefined,
+    limit: number,
+  ) => Promise<SyncManifest>
+  getArchive: (since?: string, until?: string) => Promise<SyncArchive>
+}
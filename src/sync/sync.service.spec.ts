@@ -0,0 +1,169 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, rm, writeFile } from 'fs/promises'
+import path from 'path'
+import { Test, TestingModule } from '@nestjs/testing'
+import { Subject } from 'rxjs'
+import { vi } from 'vitest'
+import { ChecksumInteractor } from '../files/checksum-interactor'
+import { IndexedShot } from '../files/entities/indexed-shot.entity'
+import { FilesService } from '../files/files.service'
+import { IFilesService } from '../files/files.service.interface'
+import { ShotIndex, ShotIndexChange } from '../files/shot-index'
+import { MotionClientService } from '../motion-client.service'
+import { IMotionClientService } from '../motion-client.service.interface'
+import { SyncJournalFileProvider } from './sync-journal-file-provider'
+import { SyncService } from './sync.service'
+
+const TEST_FOLDER = 'src/sync/test-sync-service'
+const JOURNAL_ID = '0123456789abcdef'
+
+describe(SyncService.name, () => {
+  let shots: IndexedShot[]
+
+  class MockMotionClientService implements Partial<IMotionClientService> {
+    getTargetDir = vi.fn(() => Promise.resolve(TEST_FOLDER))
+  }
+
+  class MockFilesService implements Partial<IFilesService> {
+    getChecksums = vi.fn(() =>
+      Promise.resolve(new Map([['a.jpg', 'e3069283']])),
+    )
+  }
+
+  class MockShotIndex implements Partial<ShotIndex> {
+    changes$ = new Subject<ShotIndexChange>()
+    ensureUpToDate = vi.fn(() => Promise.resolve())
+    getShotsOldestFirst = vi.fn(() => Promise.resolve([...shots]))
+  }
+
+  let service: SyncService
+  let shotIndex: ShotIndex
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+    await writeFile(path.join(TEST_FOLDER, 'a.jpg'), 'a')
+    await writeFile(path.join(TEST_FOLDER, 'b.mp4'), 'bb')
+    shots = [
+      { name: 'a.jpg', sizeBytes: 1, creationTime: new Date(1000) },
+      { name: 'b.mp4', sizeBytes: 2, creationTime: new Date(2000) },
+    ]
+    vi.spyOn(SyncJournalFileProvider, 'readJournal').mockResolvedValue({
+      id: JOURNAL_ID,
+      horizon: 0,
+      entries: [],
+    })
+    vi.spyOn(SyncJournalFileProvider, 'appendEntries').mockResolvedValue()
+    vi.spyOn(SyncJournalFileProvider, 'writeJournal').mockResolvedValue()
+    vi.spyOn(ChecksumInteractor, 'computeChecksums').mockImplementation(
+      async (filePaths) =>
+        new Map(
+          filePaths
+            .filter((filePath) => filePath.endsWith('b.mp4'))
+            .map((filePath): [string, string] => [filePath, '5fb6e21b']),
+        ),
+    )
+
+    const module: TestingModule = await Test.createTestingModule({
+      providers: [
+        { provide: MotionClientService, useClass: MockMotionClientService },
+        { provide: FilesService, useClass: MockFilesService },
+        { provide: ShotIndex, useClass: MockShotIndex },
+        SyncService,
+      ],
+    }).compile()
+
+    service = module.get<SyncService>(SyncService)
+    shotIndex = module.get<ShotIndex>(ShotIndex)
+    service.onModuleInit()
+  })
+
+  describe(SyncService.prototype.getManifest.name, () => {
+    it('lists the shots with their checksums', async () => {
+      const manifest = await service.getManifest(undefined, 10)
+      expect(manifest).toMatchObject({
+        cursor: `${JOURNAL_ID}-2`,
+        latestSequence: 2,
+        hasMore: false,
+        isReset: false,
+      })
+      expect(manifest.entries).toEqual([
+        {
+          sequence: 1,
+          type: 'created',
+          name: 'a.jpg',
+          sizeBytes: 1,
+          modificationTime: new Date(1000),
+          checksum: 'e3069283',
+        },
+        expect.objectContaining({ sequence: 2, checksum: '5fb6e21b' }),
+      ])
+    })
+
+    it('reads back only the shots saved without a checksum', async () => {
+      await service.getManifest(undefined, 10)
+      await service.getManifest(undefined, 10)
+      expect(ChecksumInteractor.computeChecksums).toHaveBeenCalledTimes(1)
+      expect(ChecksumInteractor.computeChecksums).toHaveBeenCalledWith([
+        path.join(TEST_FOLDER, 'b.mp4'),
+      ])
+    })
+
+    it('compares the shots with the journal only after changes', async () => {
+      await service.getManifest(undefined, 10)
+      const { cursor } = await service.getManifest(undefined, 10)
+      expect(shotIndex.getShotsOldestFirst).toHaveBeenCalledTimes(1)
+      shots.shift()
+      shotIndex.changes$.next({ type: 'deleted', name: 'a.jpg' })
+      const manifest = await service.getManifest(cursor, 10)
+      expect(manifest.entries).toEqual([
+        { sequence: 3, type: 'deleted', name: 'a.jpg' },
+      ])
+    })
+
+    it('leaves out the checksum of a shot deleted meanwhile', async () => {
+      vi.mocked(ChecksumInteractor.computeChecksums).mockResolvedValue(
+        new Map(),
+      )
+      const manifest = await service.getManifest(undefined, 10)
+      expect(manifest.entries[1].checksum).toBeUndefined()
+    })
+  })
+
+  describe(SyncService.prototype.getArchive.name, () => {
+    it('streams the created shots up to the given cursor', async () => {
+      const archive = await service.getArchive(undefined, `${JOURNAL_ID}-1`)
+      const chunks: Buffer[] = []
+      for await (const chunk of archive.stream) {
+        chunks.push(chunk)
+      }
+      const data = Buffer.concat(chunks)
+      expect(archive).toMatchObject({
+        contentType: 'application/x-tar',
+        filename: 'sync-0-1.tar',
+        cursor: `${JOURNAL_ID}-1`,
+      })
+      expect(data.subarray(0, 5).toString()).toBe('a.jpg')
+      expect(data.includes('b.mp4')).toBe(false)
+    })
+  })
+
+  afterEach(async () => {
+    vi.restoreAllMocks()
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
@@ -0,0 +1,213 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import path from 'path'
+import {
+  Injectable,
+  Logger,
+  OnModuleDestroy,
+  OnModuleInit,
+} from '@nestjs/common'
+import archiver from 'archiver'
+import { Subscription } from 'rxjs'
+import { ChecksumInteractor } from '../files/checksum-interactor'
+import { FilesService } from '../files/files.service'
+import { ShotIndex } from '../files/shot-index'
+import { MotionClientService } from '../motion-client.service'
+import { SyncArchive } from './entities/sync-archive.entity'
+import { SyncEntry, SyncManifestEntry } from './entities/sync-entry.entity'
+import { SyncManifest } from './entities/sync-manifest.entity'
+import { SyncJournal } from './sync-journal'
+import { ISyncService } from './sync.service.interface'
+
+const JOURNAL_FILE_PATH = 'sync-journal.jsonl'
+const CHECKSUM_BATCH_SIZE = 16
+// Leaves most of the card bandwidth to capture while checksumming.
+const MAXIMUM_CHECKSUM_BYTES_PER_SECOND = 4 * 1024 * 1024
+const MAXIMUM_CACHED_CHECKSUM_COUNT = 10000
+const ARCHIVE_CONTENT_TYPE = 'application/x-tar'
+
+@Injectable()
+export class SyncService
+  implements ISyncService, OnModuleInit, OnModuleDestroy
+{
+  private readonly logger = new Logger(SyncService.name)
+  private readonly journal = new SyncJournal(JOURNAL_FILE_PATH)
+  // Of shots saved without a checksum, by sequence, as each sequence stands
+  // for one version of a shot.
+  private readonly computedChecksums = new Map<number, string>()
+  private isStale = true
+  private subscription: Subscription | null = null
+
+  constructor(
+    private readonly motionClientService: MotionClientService,
+    private readonly filesService: FilesService,
+    private readonly shotIndex: ShotIndex,
+  ) {}
+
+  onModuleInit() {
+    this.subscription = this.shotIndex.changes$.subscribe(() => {
+      this.isStale = true
+    })
+  }
+
+  onModuleDestroy() {
+    this.subscription?.unsubscribe()
+  }
+
+  async getManifest(
+    since: string | undefined,
+    limit: number,
+  ): Promise<SyncManifest> {
+    const manifest = await this.getChanges(since, limit)
+    const checksums = await this.getChecksums(manifest.entries)
+    const entries = manifest.entries.map(
+      (entry): SyncManifestEntry =>
+        entry.type === 'created'
+          ? { ...entry, checksum: checksums.get(entry.sequence) }
+          : entry,
+    )
+    return { ...manifest, entries }
+  }
+
+  /**
+   * Streams the shots created after the given cursor as one tar archive in
+   * sequence order, so that an interrupted download can be resumed after the
+   * last complete shot. Shots created after the given end are left out, so
+   * that a resumed download stays within the manifest it started from.
+   */
+  async getArchive(since?: string, until?: string): Promise<SyncArchive> {
+    const changes = await this.getChanges(since, Number.MAX_SAFE_INTEGER)
+    const sinceSequence =
+      changes.isReset || since === undefined
+        ? 0
+        : this.journal.parseCursor(since)
+    // An end in a journal that was lost is as unknown as the start.
+    const untilSequence =
+      until === undefined ? null : this.journal.parseCursor(until)
+    const lastSequence =
+      untilSequence === null
+        ? changes.latestSequence
+        : Math.min(untilSequence, changes.latestSequence)
+    const folderPath = await this.motionClientService.getTargetDir()
+    const archive = archiver('tar')
+    archive.on('warning', (error) => {
+      this.logger.warn(`Archiving changes: ${error.message}`)
+    })
+    archive.on('error', (error) => {
+      this.logger.error(`Archiving changes failed: ${error.message}`)
+    })
+    for (const entry of changes.entries) {
+      if (entry.type === 'created' && entry.sequence <= lastSequence) {
+        archive.file(path.join(folderPath, entry.name), {
+          name: entry.name,
+          date: entry.modificationTime,
+        })
+      }
+    }
+    // Resolves only once the archive has been read completely.
+    archive.finalize().catch(() => undefined)
+    return {
+      contentType: ARCHIVE_CONTENT_TYPE,
+      filename: `sync-${sinceSequence}-${lastSequence}.tar`,
+      cursor: this.journal.formatCursor(lastSequence),
+      stream: archive,
+    }
+  }
+
+  private async getChanges(
+    since: string | undefined,
+    limit: number,
+  ): Promise<SyncManifest> {
+    await this.shotIndex.ensureUpToDate()
+    // Changes seen while the journal is updated make it stale again.
+    while (this.isStale) {
+      this.isStale = false
+      try {
+        await this.journal.update(await this.shotIndex.getShotsOldestFirst())
+      } catch (error) {
+        this.isStale = true
+        throw error
+      }
+    }
+    return this.journal.getChanges(since, limit)
+  }
+
+  /**
+   * Returns the CRC32C of the created shots by sequence. The one recorded when
+   * a shot was saved is used if any, so that only older shots are read back,
+   * as slowly as for integrity verification.
+   */
+  private async getChecksums(
+    entries: SyncEntry[],
+  ): Promise<Map<number, string>> {
+    const recordedChecksums = await this.filesService.getChecksums()
+    const checksums = new Map<number, string>()
+    const uncheckedEntries: SyncEntry[] = []
+    for (const entry of entries) {
+      if (entry.type !== 'created') {
+        continue
+      }
+      const checksum =
+        recordedChecksums.get(entry.name) ??
+        this.computedChecksums.get(entry.sequence)
+      if (checksum) {
+        checksums.set(entry.sequence, checksum)
+      } else {
+        uncheckedEntries.push(entry)
+      }
+    }
+    if (uncheckedEntries.length === 0) {
+      return checksums
+    }
+    const folderPath = await this.motionClientService.getTargetDir()
+    for (let i = 0; i < uncheckedEntries.length; i += CHECKSUM_BATCH_SIZE) {
+      const batch = uncheckedEntries.slice(i, i + CHECKSUM_BATCH_SIZE)
+      const batchStartTime = Date.now()
+      const computedChecksums = await ChecksumInteractor.computeChecksums(
+        batch.map((entry) => path.join(folderPath, entry.name)),
+      )
+      for (const entry of batch) {
+        // Shots deleted meanwhile are journaled on the next request.
+        const checksum = computedChecksums.get(
+          path.join(folderPath, entry.name),
+        )
+        if (checksum) {
+          checksums.set(entry.sequence, checksum)
+          this.cacheChecksum(entry.sequence, checksum)
+        }
+      }
+      const batchSizeBytes = batch.reduce(
+        (sum, entry) => sum + entry.sizeBytes,
+        0,
+      )
+      const minimumDurationMs =
+        (batchSizeBytes / MAXIMUM_CHECKSUM_BYTES_PER_SECOND) * 1000
+      const waitingTimeMs = minimumDurationMs - (Date.now() - batchStartTime)
+      if (waitingTimeMs > 0) {
+        await new Promise((resolve) => setTimeout(resolve, waitingTimeMs))
+      }
+    }
+    return checksums
+  }
+
+  private cacheChecksum(sequence: number, checksum: string): void {
+    if (this.computedChecksums.size >= MAXIMUM_CACHED_CHECKSUM_COUNT) {
+      this.computedChecksums.delete(this.computedChecksums.keys().next().value)
+    }
+    this.computedChecksums.set(sequence, checksum)
+  }
+}
@@ -16,4 +16,8 @@
  */
 export interface UpgradeStatusDto {
   inProgress: boolean
+  /**
+   * Fraction of the upgrade archive processed, while it is being extracted
+   */
+  extractionProgress?: number
 }
@@ -31,8 +31,6 @@ describe(FileSystemInteractor.name, () => {
   const FIXTURES_FOLDER = 'src/upgrades/fixtures'
   const TEST_FOLDER = 'src/upgrades/test-file-handler'
 
-  const itIfNotWindows = () => (process.platform !== 'win32' ? it : it.skip)
-
   beforeEach(async () => {
     await mkdir(TEST_FOLDER)
   })
@@ -122,23 +120,6 @@ describe(FileSystemInteractor.name, () => {
     })
   })
 
-  describe('extractZipArchive', () => {
-    describe('when an archive is given', () => {
-      itIfNotWindows()('unpacks it', async () => {
-        const archiveFilePath = path.join(
-          FIXTURES_FOLDER,
-          'archive-with-text-file.zip',
-        )
-        await FileSystemInteractor.extractZipArchive(
-          archiveFilePath,
-          TEST_FOLDER,
-        )
-        const filenames = await readdir(TEST_FOLDER)
-        expect(filenames).toContain('a.txt')
-      })
-    })
-  })
-
   describe('deleteFile', () => {
     describe('when a file exists', () => {
       it('deletes this file', async () => {
@@ -153,61 +134,6 @@ describe(FileSystemInteractor.name, () => {
     })
   })
 
-  describe('verifyChecksums', () => {
-    describe('when the checksums are invalid', () => {
-      itIfNotWindows()('throws an exception', async () => {
-        const destinationChecksumsFilename = 'checksums.sha256'
-        const originalChecksumsFilePath = path.join(
-          FIXTURES_FOLDER,
-          'checksums-invalid.sha256',
-        )
-        const destinationChecksumsFilePath = path.join(
-          TEST_FOLDER,
-          destinationChecksumsFilename,
-        )
-        await cp(originalChecksumsFilePath, destinationChecksumsFilePath)
-        const scriptFilename = 'upgrade.sh'
-        const originalScriptFilePath = path.join(
-          FIXTURES_FOLDER,
-          scriptFilename,
-        )
-        const destinationScriptFilePath = path.join(TEST_FOLDER, scriptFilename)
-        await cp(originalScriptFilePath, destinationScriptFilePath)
-        await expect(
-          FileSystemInteractor.verifyChecksums(
-            destinationChecksumsFilename,
-            TEST_FOLDER,
-          ),
-        ).rejects.toThrow()
-      })
-    })
-
-    describe('when the checksums are valid', () => {
-      itIfNotWindows()('does not throw an exception', async () => {
-        const checksumsFilename = 'checksums.sha256'
-        const originalChecksumsFilePath = path.join(
-          FIXTURES_FOLDER,
-          checksumsFilename,
-        )
-        const destinationChecksumsFilePath = path.join(
-          TEST_FOLDER,
-          checksumsFilename,
-        )
-        await cp(originalChecksumsFilePath, destinationChecksumsFilePath)
-        const scriptFilename = 'upgrade.sh'
-        const originalScriptFilePath = path.join(
-          FIXTURES_FOLDER,
-          scriptFilename,
-        )
-        const destinationScriptFilePath = path.join(TEST_FOLDER, scriptFilename)
-        await cp(originalScriptFilePath, destinationScriptFilePath)
-        await expect(
-          FileSystemInteractor.verifyChecksums(checksumsFilename, TEST_FOLDER),
-        ).resolves.not.toThrow()
-      })
-    })
-  })
-
   describe('writeFile', () => {
     describe('when a file is written', () => {
       it('create a file with the given name and content', async () => {
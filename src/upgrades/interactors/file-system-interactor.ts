@@ -14,14 +14,8 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
 import { access, constants, readdir, rm, writeFile } from 'fs/promises'
 import path from 'path'
-import { promisify } from 'util'
-import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
-import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
-
-const exec = promisify(execSync)
 
 export class FileSystemInteractor {
   static async checkWhetherFileExists(filePath: string): Promise<void> {
@@ -47,30 +41,6 @@ export class FileSystemInteractor {
     }
   }
 
-  static async extractZipArchive(
-    filePath: string,
-    outputFolderPath: string,
-  ): Promise<void> {
-    CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(`unzip -o ${filePath} -d ${outputFolderPath}`)
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
-    }
-  }
-
-  static async verifyChecksums(
-    checksumFilename: string,
-    workingFolderPath: string,
-  ): Promise<void> {
-    CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(
-      `cd ${workingFolderPath} && sha256sum -c ${checksumFilename}`,
-    )
-    if (stderr) {
-      throw new CommandExecutionException(stderr)
-    }
-  }
-
   static async writeFile(filePath: string, content: string) {
     await writeFile(filePath, content)
   }
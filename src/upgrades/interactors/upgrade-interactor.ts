@@ -14,19 +14,14 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { exec as execSync } from 'child_process'
-import { promisify } from 'util'
+import { PrivilegedHelperClient } from '../../privileged-helper/privileged-helper-client'
 import { CommandExecutionException } from '../../shared/exceptions/CommandExecutionException'
 import { CommandUnavailableOnWindowsException } from '../../shared/exceptions/CommandUnavailableOnWindowsException'
 
-const exec = promisify(execSync)
-
-const UPGRADE_SCRIPT_PATH = 'scripts/runtime/upgrade.sh'
-
 export class UpgradeInteractor {
   static async triggerUpgrade(): Promise<void> {
     CommandUnavailableOnWindowsException.throwIfOnWindows()
-    const { stderr } = await exec(`sudo ${UPGRADE_SCRIPT_PATH}`)
+    const { stderr } = await PrivilegedHelperClient.run('trigger-upgrade')
     if (stderr) {
       throw new CommandExecutionException(stderr)
     }
@@ -48,6 +48,16 @@ describe(FileSystemInteractor.name, () => {
     })
   })
 
+  describe('when the flag is unset', () => {
+    it('returns false on the check', async () => {
+      const flagHandler = new UpgradeFileFlagHandler(TEST_FOLDER)
+      await flagHandler.setFlag()
+      await flagHandler.unsetFlag()
+      const result = await flagHandler.isFlagSet()
+      expect(result).toBeFalsy()
+    })
+  })
+
   afterEach(async () => {
     await rm(TEST_FOLDER, { recursive: true, force: true })
   })
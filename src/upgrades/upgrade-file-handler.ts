@@ -39,4 +39,8 @@ export class UpgradeFileFlagHandler {
   async setFlag(): Promise<void> {
     await FileSystemInteractor.writeFile(this.flagFilePath, FLAG_FILE_CONTENT)
   }
+
+  async unsetFlag(): Promise<void> {
+    await FileSystemInteractor.deleteFile(this.flagFilePath)
+  }
 }
@@ -33,6 +33,7 @@ export class UpgradesController {
     const inProgress = await this.upgradesService.isUpgradeInProgress()
     return {
       inProgress,
+      extractionProgress: this.upgradesService.getExtractionProgress(),
     }
   }
 
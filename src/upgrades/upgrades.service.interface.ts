@@ -1,6 +1,7 @@
 import { UpgradeFileCheckResultDto } from './dto/upgrade-file-check-result.dto'
 
 export interface IUpgradesService {
+  getExtractionProgress: () => number | undefined
   isUpgradeInProgress: () => Promise<boolean>
   performUpgrade: () => Promise<void>
   verifyUpgradeFile: () => Promise<UpgradeFileCheckResultDto>
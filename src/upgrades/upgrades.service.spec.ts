@@ -217,6 +217,15 @@ describe(UpgradesService.name, () => {
     })
   })
 
+  describe(UpgradesService.prototype.performUpgrade.name, () => {
+    describe('when the upgrade archive does not exist', () => {
+      it('does not leave the upgrade flagged as in progress', async () => {
+        await expect(service.performUpgrade()).rejects.toThrow()
+        expect(await service.isUpgradeInProgress()).toBe(false)
+      })
+    })
+  })
+
   afterEach(async () => {
     await rm(DATA_FOLDER, { recursive: true, force: true })
   })
@@ -18,17 +18,25 @@ import path from 'path'
 import { Injectable, Logger } from '@nestjs/common'
 import { MotionClientService } from '../motion-client.service'
 import { UpgradeFileCheckResultDto } from './dto/upgrade-file-check-result.dto'
+import { ChecksumMismatchException } from './exceptions/ChecksumMismatchException'
 import { FileSystemInteractor } from './interactors/file-system-interactor'
 import { UpgradeInteractor } from './interactors/upgrade-interactor'
 import { UpgradeFileFlagHandler } from './upgrade-file-handler'
+import {
+  ExtractionProgress,
+  VerifiedArchiveExtractor,
+} from './verified-archive-extractor'
+import { ZipArchiveReader } from './zip-archive-reader'
 
 const EXTRACTION_FOLDER_PATH = 'temp/upgrade'
 const PACKAGED_CHECKSUM_FILENAME = 'checksums.sha256'
 const PACKAGED_SCRIPT_FILENAME = 'upgrade.sh'
+const PROGRESS_LOGGING_STEP_PERCENT = 10
 const UPGRADE_FILENAME = 'App4Cam-upgrade.zip'
 
 @Injectable()
 export class UpgradesService {
+  private extractionProgress?: ExtractionProgress
   private flagHandler = new UpgradeFileFlagHandler('')
   private readonly logger = new Logger(UpgradesService.name)
 
@@ -38,14 +46,29 @@ export class UpgradesService {
     return this.flagHandler.isFlagSet()
   }
 
+  getExtractionProgress(): number | undefined {
+    if (!this.extractionProgress) {
+      return undefined
+    }
+    const { processedBytes, totalBytes } = this.extractionProgress
+    return totalBytes > 0 ? processedBytes / totalBytes : 1
+  }
+
   async performUpgrade(): Promise<void> {
     await this.flagHandler.setFlag()
-    const devicePath = await this.motionClientService.getTargetDir()
-    const upgradeFilePath = path.join(devicePath, UPGRADE_FILENAME)
-    await FileSystemInteractor.extractZipArchive(
-      upgradeFilePath,
-      EXTRACTION_FOLDER_PATH,
-    )
+    let reader: ZipArchiveReader | undefined
+    try {
+      const devicePath = await this.motionClientService.getTargetDir()
+      const upgradeFilePath = path.join(devicePath, UPGRADE_FILENAME)
+      reader = await ZipArchiveReader.open(upgradeFilePath)
+      await this.extractAndVerify(reader, EXTRACTION_FOLDER_PATH)
+    } catch (error) {
+      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
+      await this.flagHandler.unsetFlag()
+      throw error
+    } finally {
+      await reader?.close()
+    }
     await UpgradeInteractor.triggerUpgrade()
     // Unsetting the flag and emptying the tempy folder needs to be done by the
     // upgrade script as the server might be shut down.
@@ -72,88 +95,81 @@ export class UpgradesService {
       )
     }
 
+    let reader: ZipArchiveReader
     try {
-      await FileSystemInteractor.extractZipArchive(
-        upgradeFilePath,
-        EXTRACTION_FOLDER_PATH,
-      )
+      reader = await ZipArchiveReader.open(upgradeFilePath)
     } catch (error) {
-      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
       return this.logAndCreateNegativeUpgradeFileCheckResult(
         'The upgrade archive could not be extracted.',
         error,
       )
     }
 
-    const upgradeScriptPath = path.join(
-      EXTRACTION_FOLDER_PATH,
-      PACKAGED_SCRIPT_FILENAME,
-    )
-    try {
-      await FileSystemInteractor.checkWhetherFileExists(upgradeScriptPath)
-    } catch (error) {
-      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
-      return this.logAndCreateNegativeUpgradeFileCheckResult(
-        'The upgrade script does not exist.',
-        error,
-      )
-    }
     try {
-      await FileSystemInteractor.checkWhetherFileIsReadable(upgradeScriptPath)
+      if (!reader.findEntry(PACKAGED_SCRIPT_FILENAME)) {
+        return this.logAndCreateNegativeUpgradeFileCheckResult(
+          'The upgrade script does not exist.',
+        )
+      }
+      if (!reader.findEntry(PACKAGED_CHECKSUM_FILENAME)) {
+        return this.logAndCreateNegativeUpgradeFileCheckResult(
+          'The checksum file does not exist.',
+        )
+      }
+      // Verifying only streams the entries through the hash, so nothing is
+      // written to the extraction folder.
+      await this.extractAndVerify(reader)
     } catch (error) {
-      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
+      if (error instanceof ChecksumMismatchException) {
+        return this.logAndCreateNegativeUpgradeFileCheckResult(
+          'Not all checksums are valid.',
+          error,
+        )
+      }
       return this.logAndCreateNegativeUpgradeFileCheckResult(
-        'The upgrade script is not readable.',
+        'The upgrade archive could not be extracted.',
         error,
       )
+    } finally {
+      await reader.close()
     }
 
-    const checksumFilePath = path.join(
-      EXTRACTION_FOLDER_PATH,
-      PACKAGED_CHECKSUM_FILENAME,
-    )
-    try {
-      await FileSystemInteractor.checkWhetherFileExists(checksumFilePath)
-    } catch (error) {
-      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
-      return this.logAndCreateNegativeUpgradeFileCheckResult(
-        'The checksum file does not exist.',
-        error,
-      )
-    }
-    try {
-      await FileSystemInteractor.checkWhetherFileIsReadable(checksumFilePath)
-    } catch (error) {
-      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
-      return this.logAndCreateNegativeUpgradeFileCheckResult(
-        'The checksum file is not readable.',
-        error,
-      )
+    return {
+      isOkay: true,
+      message: '',
     }
+  }
+
+  private async extractAndVerify(
+    reader: ZipArchiveReader,
+    outputFolderPath?: string,
+  ): Promise<void> {
+    let loggedPercent = 0
     try {
-      await FileSystemInteractor.verifyChecksums(
+      await VerifiedArchiveExtractor.extract(
+        reader,
         PACKAGED_CHECKSUM_FILENAME,
-        EXTRACTION_FOLDER_PATH,
-      )
-    } catch (error) {
-      await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
-      return this.logAndCreateNegativeUpgradeFileCheckResult(
-        'Not all checksums are valid.',
-        error,
+        {
+          outputFolderPath,
+          onProgress: (progress) => {
+            this.extractionProgress = progress
+            const percent = Math.floor(this.getExtractionProgress() * 100)
+            if (percent >= loggedPercent + PROGRESS_LOGGING_STEP_PERCENT) {
+              loggedPercent = percent
+              this.logger.log(`Upgrade archive processed to ${percent}%.`)
+            }
+          },
+        },
       )
-    }
-
-    await FileSystemInteractor.emptyFolder(EXTRACTION_FOLDER_PATH)
-    return {
-      isOkay: true,
-      message: '',
+    } finally {
+      this.extractionProgress = undefined
     }
   }
 
   private logAndCreateNegativeUpgradeFileCheckResult(
     message: string,
     // eslint-disable-next-line @typescript-eslint/no-explicit-any
-    error: any,
+    error?: any,
   ): UpgradeFileCheckResultDto {
     this.logger.error(message, error)
     return {
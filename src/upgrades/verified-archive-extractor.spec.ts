@@ -0,0 +1,202 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { mkdir, readdir, readFile, readlink, rm } from 'fs/promises'
+import path from 'path'
+import { ChecksumMismatchException } from './exceptions/ChecksumMismatchException'
+import { UnsafeArchiveEntryException } from './exceptions/UnsafeArchiveEntryException'
+import {
+  ExtractionProgress,
+  VerifiedArchiveExtractor,
+} from './verified-archive-extractor'
+import { ZipArchiveReader } from './zip-archive-reader'
+
+describe(VerifiedArchiveExtractor.name, () => {
+  const CHECKSUM_FILENAME = 'checksums.sha256'
+  const FIXTURES_FOLDER = 'src/upgrades/fixtures'
+  const TEST_FOLDER = 'src/upgrades/test-verified-archive-extractor'
+
+  let reader: ZipArchiveReader
+
+  beforeEach(async () => {
+    await mkdir(TEST_FOLDER)
+  })
+
+  describe(VerifiedArchiveExtractor.extract.name, () => {
+    describe('when all checksums are valid', () => {
+      beforeEach(async () => {
+        reader = await ZipArchiveReader.open(
+          path.join(
+            FIXTURES_FOLDER,
+            'archive-with-script-and-valid-checksums.zip',
+          ),
+        )
+      })
+
+      it('extracts all files', async () => {
+        await VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+          outputFolderPath: TEST_FOLDER,
+        })
+        const folderContents = await readdir(TEST_FOLDER)
+        expect(folderContents.sort()).toEqual([CHECKSUM_FILENAME, 'upgrade.sh'])
+        const script = await readFile(path.join(TEST_FOLDER, 'upgrade.sh'))
+        const originalScript = await readFile(
+          path.join(FIXTURES_FOLDER, 'upgrade.sh'),
+        )
+        expect(script).toEqual(originalScript)
+      })
+
+      it('reports the progress up to the total size', async () => {
+        const progresses: ExtractionProgress[] = []
+        await VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+          outputFolderPath: TEST_FOLDER,
+          onProgress: (progress) => progresses.push({ ...progress }),
+        })
+        expect(progresses.at(-1)).toEqual({
+          processedBytes: 104,
+          totalBytes: 104,
+        })
+      })
+
+      it('writes nothing when only verifying', async () => {
+        await VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME)
+        const folderContents = await readdir(TEST_FOLDER)
+        expect(folderContents).toHaveLength(0)
+      })
+    })
+
+    describe('when a checksum is invalid', () => {
+      beforeEach(async () => {
+        reader = await ZipArchiveReader.open(
+          path.join(
+            FIXTURES_FOLDER,
+            'archive-with-script-and-invalid-checksums.zip',
+          ),
+        )
+      })
+
+      it('throws an exception', async () => {
+        await expect(
+          VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+            outputFolderPath: TEST_FOLDER,
+          }),
+        ).rejects.toThrow(ChecksumMismatchException)
+      })
+
+      it('does not leave the unverified file behind', async () => {
+        await VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+          outputFolderPath: TEST_FOLDER,
+        }).catch(() => {})
+        const folderContents = await readdir(TEST_FOLDER)
+        expect(folderContents).toEqual([CHECKSUM_FILENAME])
+      })
+    })
+
+    describe('when an entry points outside of the extraction folder', () => {
+      beforeEach(async () => {
+        reader = await ZipArchiveReader.open(
+          path.join(FIXTURES_FOLDER, 'archive-with-path-traversal.zip'),
+        )
+      })
+
+      it('throws an exception', async () => {
+        await expect(
+          VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+            outputFolderPath: TEST_FOLDER,
+          }),
+        ).rejects.toThrow(UnsafeArchiveEntryException)
+      })
+    })
+
+    describe('when an entry is a symbolic link', () => {
+      beforeEach(async () => {
+        reader = await ZipArchiveReader.open(
+          path.join(FIXTURES_FOLDER, 'archive-with-symbolic-link.zip'),
+        )
+      })
+
+      it('recreates the link', async () => {
+        await VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+          outputFolderPath: TEST_FOLDER,
+        })
+        const target = await readlink(path.join(TEST_FOLDER, 'run.sh'))
+        expect(target).toBe('upgrade.sh')
+      })
+    })
+
+    describe('when a symbolic link points outside of the folder', () => {
+      beforeEach(async () => {
+        reader = await ZipArchiveReader.open(
+          path.join(FIXTURES_FOLDER, 'archive-with-outside-symbolic-link.zip'),
+        )
+      })
+
+      it('throws an exception', async () => {
+        await expect(
+          VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+            outputFolderPath: TEST_FOLDER,
+          }),
+        ).rejects.toThrow(UnsafeArchiveEntryException)
+      })
+    })
+
+    describe('when an entry goes through a symbolic link', () => {
+      beforeEach(async () => {
+        reader = await ZipArchiveReader.open(
+          path.join(FIXTURES_FOLDER, 'archive-with-chained-symbolic-links.zip'),
+        )
+      })
+
+      it('throws an exception', async () => {
+        await expect(
+          VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME, {
+            outputFolderPath: TEST_FOLDER,
+          }),
+        ).rejects.toThrow(UnsafeArchiveEntryException)
+      })
+
+      it('throws an exception when only verifying', async () => {
+        await expect(
+          VerifiedArchiveExtractor.extract(reader, CHECKSUM_FILENAME),
+        ).rejects.toThrow(UnsafeArchiveEntryException)
+      })
+    })
+
+    afterEach(async () => {
+      await reader.close()
+    })
+  })
+
+  describe(VerifiedArchiveExtractor.parseChecksums.name, () => {
+    it('normalises the file paths', () => {
+      const checksum = 'a'.repeat(64)
+      expect(
+        VerifiedArchiveExtractor.parseChecksums(
+          `${checksum}  ./a.txt\n${checksum} *b/c.txt\n`,
+        ),
+      ).toEqual(
+        new Map([
+          ['a.txt', checksum],
+          ['b/c.txt', checksum],
+        ]),
+      )
+    })
+  })
+
+  afterEach(async () => {
+    await rm(TEST_FOLDER, { recursive: true, force: true })
+  })
+})
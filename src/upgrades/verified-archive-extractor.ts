@@ -0,0 +1,267 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { createHash } from 'crypto'
+import { createWriteStream } from 'fs'
+import { chmod, mkdir, rename, rm, symlink } from 'fs/promises'
+import path from 'path'
+import { Transform, Writable } from 'stream'
+import { pipeline } from 'stream/promises'
+import { ChecksumMismatchException } from './exceptions/ChecksumMismatchException'
+import { UnsafeArchiveEntryException } from './exceptions/UnsafeArchiveEntryException'
+import { ZipArchiveEntry, ZipArchiveReader } from './zip-archive-reader'
+
+const CHECKSUM_LINE_REGEX = /^([0-9a-fA-F]{64}) [ *](.+)$/
+const PARTIAL_FILE_SUFFIX = '.part'
+
+export interface ExtractionProgress {
+  processedBytes: number
+  totalBytes: number
+}
+
+export interface ExtractionOptions {
+  /**
+   * Folder to extract to, or undefined to only verify the checksums
+   */
+  outputFolderPath?: string
+  onProgress?: (progress: ExtractionProgress) => void
+}
+
+/**
+ * Extracts a ZIP archive in a single pass, hashing every entry listed in the
+ * packaged checksum file while it is written. A file only gets its final name
+ * once its checksum has been verified, and the first mismatch aborts.
+ */
+export class VerifiedArchiveExtractor {
+  static async extract(
+    reader: ZipArchiveReader,
+    checksumFilename: string,
+    { outputFolderPath, onProgress }: ExtractionOptions = {},
+  ): Promise<void> {
+    const checksumEntry = reader.findEntry(checksumFilename)
+    const expectedChecksums = checksumEntry
+      ? VerifiedArchiveExtractor.parseChecksums(
+          (await reader.readEntry(checksumEntry)).toString(),
+        )
+      : new Map<string, string>()
+
+    const fileEntries = reader.entries.filter((entry) => !entry.isDirectory)
+    const entryNames = new Set(
+      fileEntries.map((entry) =>
+        VerifiedArchiveExtractor.getSafeRelativePath(entry.name),
+      ),
+    )
+    for (const name of expectedChecksums.keys()) {
+      if (!entryNames.has(name)) {
+        throw new ChecksumMismatchException(
+          `The file '${name}' listed in the checksum file is missing.`,
+        )
+      }
+    }
+
+    const progress: ExtractionProgress = {
+      processedBytes: 0,
+      totalBytes: fileEntries.reduce(
+        (total, entry) => total + entry.uncompressedSize,
+        0,
+      ),
+    }
+    const symbolicLinkPaths = new Set<string>()
+    for (const entry of fileEntries) {
+      await VerifiedArchiveExtractor.extractEntry(
+        reader,
+        entry,
+        outputFolderPath,
+        expectedChecksums,
+        symbolicLinkPaths,
+        (chunkLength) => {
+          progress.processedBytes += chunkLength
+          onProgress?.(progress)
+        },
+      )
+    }
+  }
+
+  static parseChecksums(content: string): Map<string, string> {
+    const checksums = new Map<string, string>()
+    for (const line of content.split('\n')) {
+      const match = line.trim().match(CHECKSUM_LINE_REGEX)
+      if (match) {
+        checksums.set(
+          VerifiedArchiveExtractor.getSafeRelativePath(match[2]),
+          match[1].toLowerCase(),
+        )
+      }
+    }
+    return checksums
+  }
+
+  static getSafeRelativePath(name: string): string {
+    const relativePath = path.posix.normalize(name.replaceAll('\\', '/'))
+    if (
+      path.posix.isAbsolute(relativePath) ||
+      relativePath === '..' ||
+      relativePath.startsWith('../')
+    ) {
+      throw new UnsafeArchiveEntryException(
+        `The entry '${name}' points outside of the extraction folder.`,
+      )
+    }
+    return relativePath
+  }
+
+  private static async extractEntry(
+    reader: ZipArchiveReader,
+    entry: ZipArchiveEntry,
+    outputFolderPath: string | undefined,
+    expectedChecksums: Map<string, string>,
+    symbolicLinkPaths: Set<string>,
+    onChunk: (chunkLength: number) => void,
+  ): Promise<void> {
+    const relativePath = VerifiedArchiveExtractor.getSafeRelativePath(
+      entry.name,
+    )
+    if (
+      VerifiedArchiveExtractor.isLeavingFolder(relativePath, symbolicLinkPaths)
+    ) {
+      throw new UnsafeArchiveEntryException(
+        `The entry '${entry.name}' goes through a symbolic link.`,
+      )
+    }
+    if (entry.isSymbolicLink) {
+      await VerifiedArchiveExtractor.extractSymbolicLink(
+        reader,
+        entry,
+        relativePath,
+        outputFolderPath,
+        symbolicLinkPaths,
+      )
+      symbolicLinkPaths.add(relativePath)
+      onChunk(entry.uncompressedSize)
+      return
+    }
+    // The file replaces any link extracted at the same path before.
+    symbolicLinkPaths.delete(relativePath)
+    const hash = createHash('sha256')
+    const hashing = new Transform({
+      transform(chunk: Buffer, _encoding, callback) {
+        hash.update(chunk)
+        onChunk(chunk.length)
+        callback(null, chunk)
+      },
+    })
+    const verifyChecksum = () => {
+      const expectedChecksum = expectedChecksums.get(relativePath)
+      const checksum = hash.digest('hex')
+      if (expectedChecksum && checksum !== expectedChecksum) {
+        throw new ChecksumMismatchException(
+          `The checksum of '${relativePath}' is ${checksum} instead of ${expectedChecksum}.`,
+        )
+      }
+    }
+
+    if (outputFolderPath === undefined) {
+      const discarding = new Writable({
+        write(_chunk, _encoding, callback) {
+          callback()
+        },
+      })
+      await pipeline(await reader.openEntryStream(entry), hashing, discarding)
+      verifyChecksum()
+      return
+    }
+
+    const filePath = path.join(outputFolderPath, relativePath)
+    const partialFilePath = filePath + PARTIAL_FILE_SUFFIX
+    await mkdir(path.dirname(filePath), { recursive: true })
+    try {
+      await pipeline(
+        await reader.openEntryStream(entry),
+        hashing,
+        createWriteStream(partialFilePath),
+      )
+      verifyChecksum()
+    } catch (error) {
+      await rm(partialFilePath, { force: true })
+      throw error
+    }
+    await rename(partialFilePath, filePath)
+    if (entry.unixMode) {
+      await chmod(filePath, entry.unixMode)
+    }
+  }
+
+  /**
+   * Recreates a symbolic link like unzip, as long as it points into the
+   * extraction folder. Its checksum is not verified, as sha256sum hashes the
+   * file it points to, which is verified as an entry of its own.
+   */
+  private static async extractSymbolicLink(
+    reader: ZipArchiveReader,
+    entry: ZipArchiveEntry,
+    relativePath: string,
+    outputFolderPath: string | undefined,
+    symbolicLinkPaths: Set<string>,
+  ): Promise<void> {
+    const targetPath = (await reader.readEntry(entry)).toString()
+    if (
+      path.posix.isAbsolute(targetPath) ||
+      VerifiedArchiveExtractor.isLeavingFolder(
+        path.posix.dirname(relativePath) + '/' + targetPath,
+        symbolicLinkPaths,
+      )
+    ) {
+      throw new UnsafeArchiveEntryException(
+        `The link '${entry.name}' points outside of the extraction folder.`,
+      )
+    }
+    if (outputFolderPath === undefined) {
+      return
+    }
+    const filePath = path.join(outputFolderPath, relativePath)
+    await mkdir(path.dirname(filePath), { recursive: true })
+    await rm(filePath, { force: true })
+    await symlink(targetPath, filePath)
+  }
+
+  /**
+   * Resolves the path relative to the extraction folder segment by segment.
+   * Normalising it is not enough once links exist, as a link extracted before
+   * may lead anywhere, so going through one counts as leaving the folder too.
+   * Only the last segment may be a link, which the entry then replaces or
+   * points to.
+   */
+  private static isLeavingFolder(
+    relativePath: string,
+    symbolicLinkPaths: Set<string>,
+  ): boolean {
+    const segments: string[] = []
+    for (const segment of relativePath.split('/')) {
+      if (symbolicLinkPaths.has(segments.join('/'))) {
+        return true
+      }
+      if (segment === '..') {
+        if (segments.length === 0) {
+          return true
+        }
+        segments.pop()
+      } else if (segment && segment !== '.') {
+        segments.push(segment)
+      }
+    }
+    return false
+  }
+}
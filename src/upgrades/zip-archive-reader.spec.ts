@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import path from 'path'
+import { ZipArchiveReader } from './zip-archive-reader'
+
+describe(ZipArchiveReader.name, () => {
+  const FIXTURES_FOLDER = 'src/upgrades/fixtures'
+  const VALID_ARCHIVE_PATH = path.join(
+    FIXTURES_FOLDER,
+    'archive-with-script-and-valid-checksums.zip',
+  )
+
+  describe(ZipArchiveReader.open.name, () => {
+    it('lists the entries of the archive', async () => {
+      const reader = await ZipArchiveReader.open(VALID_ARCHIVE_PATH)
+      expect(reader.entries.map((entry) => entry.name)).toEqual([
+        'checksums.sha256',
+        'upgrade.sh',
+      ])
+      await reader.close()
+    })
+
+    it('tells symbolic links from files', async () => {
+      const reader = await ZipArchiveReader.open(
+        path.join(FIXTURES_FOLDER, 'archive-with-symbolic-link.zip'),
+      )
+      expect(
+        reader.entries.map((entry) => [entry.name, entry.isSymbolicLink]),
+      ).toEqual([
+        ['upgrade.sh', false],
+        ['run.sh', true],
+      ])
+      await reader.close()
+    })
+
+    it('throws an exception when the file is not an archive', async () => {
+      await expect(
+        ZipArchiveReader.open(path.join(FIXTURES_FOLDER, 'a.txt')),
+      ).rejects.toThrow()
+    })
+  })
+
+  describe(ZipArchiveReader.prototype.readEntry.name, () => {
+    it('reads a stored entry', async () => {
+      const reader = await ZipArchiveReader.open(
+        path.join(FIXTURES_FOLDER, 'archive-with-text-file.zip'),
+      )
+      const content = await reader.readEntry(reader.findEntry('a.txt'))
+      expect(content.toString()).toBe('aaa\n')
+      await reader.close()
+    })
+
+    it('reads a deflated entry', async () => {
+      const reader = await ZipArchiveReader.open(VALID_ARCHIVE_PATH)
+      const content = await reader.readEntry(
+        reader.findEntry('checksums.sha256'),
+      )
+      expect(content.toString()).toMatch(/^[0-9a-f]{64} {2}\.\/upgrade\.sh\n$/)
+      await reader.close()
+    })
+  })
+})
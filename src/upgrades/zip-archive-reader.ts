@@ -0,0 +1,207 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { FileHandle, open } from 'fs/promises'
+import { Readable } from 'stream'
+import { createInflateRaw } from 'zlib'
+
+const CENTRAL_DIRECTORY_HEADER_SIGNATURE = 0x02014b50
+const CENTRAL_DIRECTORY_HEADER_LENGTH = 46
+const END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50
+const END_OF_CENTRAL_DIRECTORY_LENGTH = 22
+const LOCAL_FILE_HEADER_SIGNATURE = 0x04034b50
+const LOCAL_FILE_HEADER_LENGTH = 30
+const MAXIMUM_COMMENT_LENGTH = 0xffff
+const UNIX_HOST_SYSTEM = 3
+const UNIX_FILE_TYPE_MASK = 0o170000
+const UNIX_SYMBOLIC_LINK_TYPE = 0o120000
+const ZIP64_MARKER = 0xffffffff
+const ENCRYPTED_FLAG = 0x1
+const COMPRESSION_METHOD_STORED = 0
+const COMPRESSION_METHOD_DEFLATED = 8
+
+export interface ZipArchiveEntry {
+  name: string
+  compressionMethod: number
+  compressedSize: number
+  uncompressedSize: number
+  localHeaderOffset: number
+  isDirectory: boolean
+  // The content of a symbolic link is the path it points to.
+  isSymbolicLink: boolean
+  unixMode?: number
+}
+
+/**
+ * Minimal ZIP reader which locates the entries through the central directory
+ * and streams their decompressed contents straight from the archive, without
+ * extracting it first.
+ */
+export class ZipArchiveReader {
+  private constructor(
+    private readonly fileHandle: FileHandle,
+    readonly entries: ZipArchiveEntry[],
+  ) {}
+
+  static async open(filePath: string): Promise<ZipArchiveReader> {
+    const fileHandle = await open(filePath, 'r')
+    try {
+      const entries = await ZipArchiveReader.readCentralDirectory(fileHandle)
+      return new ZipArchiveReader(fileHandle, entries)
+    } catch (error) {
+      await fileHandle.close()
+      throw error
+    }
+  }
+
+  findEntry(name: string): ZipArchiveEntry | undefined {
+    return this.entries.find((entry) => entry.name === name)
+  }
+
+  async openEntryStream(entry: ZipArchiveEntry): Promise<Readable> {
+    const header = Buffer.alloc(LOCAL_FILE_HEADER_LENGTH)
+    await this.fileHandle.read(
+      header,
+      0,
+      LOCAL_FILE_HEADER_LENGTH,
+      entry.localHeaderOffset,
+    )
+    if (header.readUInt32LE(0) !== LOCAL_FILE_HEADER_SIGNATURE) {
+      throw new Error(`Invalid local file header of entry '${entry.name}'.`)
+    }
+    const dataOffset =
+      entry.localHeaderOffset +
+      LOCAL_FILE_HEADER_LENGTH +
+      header.readUInt16LE(26) +
+      header.readUInt16LE(28)
+
+    if (entry.compressedSize === 0) {
+      return Readable.from([])
+    }
+    const compressedStream = this.fileHandle.createReadStream({
+      autoClose: false,
+      start: dataOffset,
+      end: dataOffset + entry.compressedSize - 1,
+    })
+    if (entry.compressionMethod === COMPRESSION_METHOD_STORED) {
+      return compressedStream
+    }
+    const inflater = createInflateRaw()
+    compressedStream.on('error', (error) => inflater.destroy(error))
+    return compressedStream.pipe(inflater)
+  }
+
+  async readEntry(entry: ZipArchiveEntry): Promise<Buffer> {
+    const chunks: Buffer[] = []
+    for await (const chunk of await this.openEntryStream(entry)) {
+      chunks.push(chunk)
+    }
+    return Buffer.concat(chunks)
+  }
+
+  async close(): Promise<void> {
+    await this.fileHandle.close()
+  }
+
+  private static async readCentralDirectory(
+    fileHandle: FileHandle,
+  ): Promise<ZipArchiveEntry[]> {
+    const { size } = await fileHandle.stat()
+    const tailLength = Math.min(
+      size,
+      END_OF_CENTRAL_DIRECTORY_LENGTH + MAXIMUM_COMMENT_LENGTH,
+    )
+    const tail = Buffer.alloc(tailLength)
+    await fileHandle.read(tail, 0, tailLength, size - tailLength)
+
+    let endOffset = tailLength - END_OF_CENTRAL_DIRECTORY_LENGTH
+    while (
+      endOffset >= 0 &&
+      tail.readUInt32LE(endOffset) !== END_OF_CENTRAL_DIRECTORY_SIGNATURE
+    ) {
+      endOffset--
+    }
+    if (endOffset < 0) {
+      throw new Error('No end of central directory record found.')
+    }
+    const entryCount = tail.readUInt16LE(endOffset + 10)
+    const directorySize = tail.readUInt32LE(endOffset + 12)
+    const directoryOffset = tail.readUInt32LE(endOffset + 16)
+    if (directoryOffset === ZIP64_MARKER || directorySize === ZIP64_MARKER) {
+      throw new Error('ZIP64 archives are not supported.')
+    }
+
+    const directory = Buffer.alloc(directorySize)
+    await fileHandle.read(directory, 0, directorySize, directoryOffset)
+
+    const entries: ZipArchiveEntry[] = []
+    let offset = 0
+    for (let i = 0; i < entryCount; i++) {
+      if (
+        offset + CENTRAL_DIRECTORY_HEADER_LENGTH > directory.length ||
+        directory.readUInt32LE(offset) !== CENTRAL_DIRECTORY_HEADER_SIGNATURE
+      ) {
+        throw new Error('Invalid central directory.')
+      }
+      const hostSystem = directory.readUInt8(offset + 5)
+      const flags = directory.readUInt16LE(offset + 8)
+      const compressionMethod = directory.readUInt16LE(offset + 10)
+      const compressedSize = directory.readUInt32LE(offset + 20)
+      const uncompressedSize = directory.readUInt32LE(offset + 24)
+      const nameLength = directory.readUInt16LE(offset + 28)
+      const extraLength = directory.readUInt16LE(offset + 30)
+      const commentLength = directory.readUInt16LE(offset + 32)
+      const externalAttributes = directory.readUInt32LE(offset + 38)
+      const localHeaderOffset = directory.readUInt32LE(offset + 42)
+      const nameStart = offset + CENTRAL_DIRECTORY_HEADER_LENGTH
+      const name = directory.toString('utf8', nameStart, nameStart + nameLength)
+      if (flags & ENCRYPTED_FLAG) {
+        throw new Error(`The entry '${name}' is encrypted.`)
+      }
+      if (
+        compressedSize === ZIP64_MARKER ||
+        uncompressedSize === ZIP64_MARKER ||
+        localHeaderOffset === ZIP64_MARKER
+      ) {
+        throw new Error('ZIP64 archives are not supported.')
+      }
+      if (
+        compressionMethod !== COMPRESSION_METHOD_STORED &&
+        compressionMethod !== COMPRESSION_METHOD_DEFLATED
+      ) {
+        throw new Error(
+          `The compression method ${compressionMethod} of entry '${name}' is not supported.`,
+        )
+      }
+      const unixAttributes =
+        hostSystem === UNIX_HOST_SYSTEM ? externalAttributes >>> 16 : undefined
+      entries.push({
+        name,
+        compressionMethod,
+        compressedSize,
+        uncompressedSize,
+        localHeaderOffset,
+        isDirectory: name.endsWith('/'),
+        isSymbolicLink:
+          (unixAttributes & UNIX_FILE_TYPE_MASK) === UNIX_SYMBOLIC_LINK_TYPE,
+        unixMode:
+          unixAttributes === undefined ? undefined : unixAttributes & 0o777,
+      })
+      offset = nameStart + nameLength + extraLength + commentLength
+    }
+    return entries
+  }
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { INestApplication, ValidationPipe } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import request from 'supertest'
+import { vi } from 'vitest'
+import { AppModule } from '../../src/app.module'
+import { LoggedEvent } from '../../src/event-log/entities/logged-event.entity'
+import { EventLogService } from '../../src/event-log/event-log.service'
+import { IEventLogService } from '../../src/event-log/event-log.service.interface'
+
+describe('EventLogController (e2e)', () => {
+  const EVENT: LoggedEvent = {
+    time: new Date('2024-01-01T00:00:00Z'),
+    type: 'boot',
+    code: 0,
+    value: 12.5,
+    secondaryValue: 0,
+  }
+
+  class MockEventLogService implements Partial<IEventLogService> {
+    record = vi.fn()
+    getEvents = vi.fn(() => Promise.resolve([EVENT]))
+  }
+
+  let app: INestApplication
+
+  beforeEach(async () => {
+    const moduleFixture: TestingModule = await Test.createTestingModule({
+      imports: [AppModule],
+    })
+      .overrideProvider(EventLogService)
+      .useClass(MockEventLogService)
+      .compile()
+
+    app = moduleFixture.createNestApplication()
+    app.useGlobalPipes(new ValidationPipe())
+    await app.init()
+  })
+
+  describe('/event-log/events', () => {
+    it('(GET)', () => {
+      return request(app.getHttpServer())
+        .get('/event-log/events?from=2024-01-01T00:00:00Z&types=boot')
+        .expect('Content-Type', /json/)
+        .expect(200, [{ ...EVENT, time: EVENT.time.toISOString() }])
+    })
+
+    it('(GET) with an invalid time', () => {
+      return request(app.getHttpServer())
+        .get('/event-log/events?from=yesterday')
+        .expect(400)
+    })
+
+    it('(POST)', () => {
+      return request(app.getHttpServer())
+        .post('/event-log/events')
+        .send({ type: 'triggerStart' })
+        .expect(201)
+    })
+
+    it('(POST) with an unknown type', () => {
+      return request(app.getHttpServer())
+        .post('/event-log/events')
+        .send({ type: 'nap' })
+        .expect(400)
+    })
+  })
+
+  afterEach(() => {
+    app.close()
+  })
+})
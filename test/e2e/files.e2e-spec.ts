@@ -40,9 +40,11 @@ describe('FilesController (e2e)', () => {
         focusMinimum: 0,
         isFocusEnabled: false,
         isLightEnabled: false,
+        isMovieEncodingProfileEnabled: false,
         isPictureQualityEnabled: false,
         isShotTypesEnabled: false,
         light: 'visible' as const,
+        movieEncodingProfile: 'auto',
         pictureQuality: 0,
         shotTypes: [],
         videoQuality: 0,
@@ -170,6 +172,32 @@ describe('FilesController (e2e)', () => {
       .expect(403)
   })
 
+  it('/files/deletion-jobs (POST) and /files/deletion-jobs/:id (GET)', async () => {
+    const filenames = ['to-delete-by-job-1.txt', 'to-delete-by-job-2.txt']
+    for (const filename of filenames) {
+      await writeFile(FILES_FOLDER_PATH + filename, 'bla')
+    }
+    const startResponse = await request(app.getHttpServer())
+      .post('/files/deletion-jobs')
+      .send({ filenames })
+      .expect(201)
+      .expect('Content-Type', /json/)
+    const jobUrl = '/files/deletion-jobs/' + startResponse.body.id
+    let job = startResponse.body
+    while (!job.isFinished) {
+      await new Promise((r) => setTimeout(r, 10))
+      job = (await request(app.getHttpServer()).get(jobUrl).expect(200)).body
+    }
+    expect(job.totalCount).toBe(2)
+    expect(job.deletedCount).toBe(2)
+  })
+
+  it('/files/deletion-jobs/:id (GET) unknown', () => {
+    return request(app.getHttpServer())
+      .get('/files/deletion-jobs/unknown')
+      .expect(404)
+  })
+
   it('/files/:id (GET)', async () => {
     const filename = 'a.txt'
     const filePath = FILES_FOLDER_PATH + filename
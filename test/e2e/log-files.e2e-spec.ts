@@ -14,7 +14,7 @@
  * You should have received a copy of the GNU General Public License
  * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
  */
-import { rm, writeFile } from 'fs/promises'
+import { Readable } from 'stream'
 import { INestApplication, ValidationPipe } from '@nestjs/common'
 import { Test, TestingModule } from '@nestjs/testing'
 import request from 'supertest'
@@ -23,23 +23,18 @@ import { AppModule } from '../../src/app.module'
 import { LogFileInteractor } from '../../src/log-files/log-file-interactor'
 
 describe('LogFilesController (e2e)', () => {
-  const APP_LOG_FILE_PATH = 'temp/logs/app.log'
-  const MOTION_LOG_FILE_PATH = 'temp/logs/motion.log'
-
   let app: INestApplication
 
-  let spyWriteAppLogFileToDisk: Mock
-  let spyWriteMotionLogFileToDisk: Mock
+  let spyGetAppLogStream: Mock
+  let spyGetMotionLogStream: Mock
 
-  beforeAll(async () => {
-    spyWriteAppLogFileToDisk = vi
-      .spyOn(LogFileInteractor, 'writeAppLogFileToDisk')
-      .mockResolvedValue()
-    await writeFile(APP_LOG_FILE_PATH, 'b')
-    spyWriteMotionLogFileToDisk = vi
-      .spyOn(LogFileInteractor, 'writeMotionLogFileToDisk')
-      .mockResolvedValue()
-    await writeFile(MOTION_LOG_FILE_PATH, 'c')
+  beforeAll(() => {
+    spyGetAppLogStream = vi
+      .spyOn(LogFileInteractor, 'getAppLogStream')
+      .mockImplementation(() => Promise.resolve(Readable.from(['b'])))
+    spyGetMotionLogStream = vi
+      .spyOn(LogFileInteractor, 'getMotionLogStream')
+      .mockImplementation(() => Promise.resolve(Readable.from(['c'])))
   })
 
   beforeEach(async () => {
@@ -61,6 +56,21 @@ describe('LogFilesController (e2e)', () => {
       .responseType('blob')
   })
 
+  it('/log-files/app?gzip=true', () => {
+    return request(app.getHttpServer())
+      .get('/log-files/app?gzip=true')
+      .expect(200)
+      .expect('Content-Type', /application\/gzip/)
+      .expect('Content-Disposition', `attachment; filename="app.log.gz"`)
+      .responseType('blob')
+  })
+
+  it('/log-files/app with an invalid priority', () => {
+    return request(app.getHttpServer())
+      .get('/log-files/app?priority=loud')
+      .expect(400)
+  })
+
   it('/log-files/motion', () => {
     return request(app.getHttpServer())
       .get('/log-files/motion')
@@ -74,10 +84,8 @@ describe('LogFilesController (e2e)', () => {
     app.close()
   })
 
-  afterAll(async () => {
-    spyWriteAppLogFileToDisk.mockRestore()
-    spyWriteMotionLogFileToDisk.mockRestore()
-    await rm(APP_LOG_FILE_PATH)
-    await rm(MOTION_LOG_FILE_PATH)
+  afterAll(() => {
+    spyGetAppLogStream.mockRestore()
+    spyGetMotionLogStream.mockRestore()
   })
 })
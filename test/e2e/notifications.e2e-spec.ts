@@ -0,0 +1,73 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { get, IncomingHttpHeaders } from 'http'
+import { AddressInfo } from 'net'
+import { INestApplication } from '@nestjs/common'
+import { Test, TestingModule } from '@nestjs/testing'
+import { AppModule } from '../../src/app.module'
+import { NotificationsService } from '../../src/notifications/notifications.service'
+
+describe('NotificationsController (e2e)', () => {
+  let app: INestApplication
+
+  beforeEach(async () => {
+    const moduleFixture: TestingModule = await Test.createTestingModule({
+      imports: [AppModule],
+    }).compile()
+
+    app = moduleFixture.createNestApplication()
+    await app.listen(0)
+  })
+
+  // The stream never ends, so it is closed after the first event.
+  function readFirstEvent(
+    lastEventId: string,
+  ): Promise<{ headers: IncomingHttpHeaders; text: string }> {
+    const { port } = app.getHttpServer().address() as AddressInfo
+    return new Promise((resolve, reject) => {
+      const request = get(
+        {
+          port,
+          path: '/notifications',
+          headers: { 'Last-Event-ID': lastEventId },
+        },
+        (response) => {
+          let text = ''
+          response.on('data', (chunk) => {
+            text += chunk
+            if (text.includes('\n\n')) {
+              request.destroy()
+              resolve({ headers: response.headers, text })
+            }
+          })
+        },
+      )
+      request.on('error', reject)
+    })
+  }
+
+  it('/notifications (GET) asks to resync for an unknown ID', async () => {
+    app.get(NotificationsService).publish('shotDeleted', { name: 'a.jpg' })
+    const { headers, text } = await readFirstEvent('unknown-0')
+    expect(headers['content-type']).toMatch(/text\/event-stream/)
+    expect(text).toMatch(/event: resync\n/)
+  })
+
+  afterEach(() => {
+    app.close()
+  })
+})
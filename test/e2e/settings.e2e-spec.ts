@@ -26,6 +26,7 @@ import {
   MovieOutputValue,
   PictureOutputValue,
 } from '../../src/motion-client.service.interface'
+import { MotionConfigurationTransaction } from '../../src/motion-configuration-transaction'
 import { SystemTimeZonesInteractor } from '../../src/properties/interactors/system-time-zones-interactor'
 import {
   CameraSettingsPutDto,
@@ -66,6 +67,13 @@ class MockMotionClientService implements Partial<IMotionClientService> {
   getVideoParams = async () =>
     '"Focus, Auto"=0,"Focus (absolute)"=200,Brightness=16'
   setVideoParams = async () => {}
+  beginConfigurationTransaction = () =>
+    new MotionConfigurationTransaction(async (changes) =>
+      Array.from(changes.keys(), (option) => ({
+        option,
+        status: 'applied' as const,
+      })),
+    )
 }
 
 describe('SettingsController (e2e)', () => {
@@ -120,9 +128,11 @@ describe('SettingsController (e2e)', () => {
       focusMaximum: FOCUS_MAX,
       focusMinimum: FOCUS_MIN,
       isLightEnabled: true,
+      isMovieEncodingProfileEnabled: true,
       isPictureQualityEnabled: true,
       isShotTypesEnabled: true,
       light: CAMERA_LIGHT,
+      movieEncodingProfile: 'auto',
       pictureQuality: PICTURE_QUALITY,
       shotTypes: SHOT_TYPES,
       videoQuality: MOVIE_QUALITY,
@@ -206,11 +216,34 @@ describe('SettingsController (e2e)', () => {
 
   describe('/settings', () => {
     describe('/ (GET)', () => {
-      it('returns all settings', () => {
-        return request(app.getHttpServer())
+      it('returns all settings', async () => {
+        const response = await request(app.getHttpServer())
           .get('/settings')
           .expect('Content-Type', /json/)
-          .expect(200, ALL_SETTINGS)
+          .expect(200)
+        expect(response.body).toEqual({
+          ...ALL_SETTINGS,
+          general: {
+            ...ALL_SETTINGS.general,
+            systemTime: expect.stringMatching(
+              /^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}Z$/,
+            ),
+          },
+        })
+      })
+    })
+
+    describe('/cache/:source (DELETE)', () => {
+      it('returns success on a known source', () => {
+        return request(app.getHttpServer())
+          .delete('/settings/cache/motion')
+          .expect(200)
+      })
+
+      it('returns bad request on an unknown source', () => {
+        return request(app.getHttpServer())
+          .delete('/settings/cache/a')
+          .expect(400)
       })
     })
 
@@ -22,6 +22,7 @@ import { AppModule } from '../../src/app.module'
 import { MotionClientService } from '../../src/motion-client.service'
 import { IMotionClientService } from '../../src/motion-client.service.interface'
 import { StorageStatusDto } from '../../src/storage/dto/storage-status.dto'
+import { StorageSpaceDto } from '../../src/storage/dto/storage-space.dto'
 import { StorageUsageDto } from '../../src/storage/dto/storage-usage.dto'
 import { StorageUsageInteractor } from '../../src/storage/interactors/storage-usage-interactor'
 
@@ -31,10 +32,17 @@ describe('StorageController (e2e)', () => {
     isAvailable: true,
     message: `The path ${FILES_FOLDER_PATH} is accessible and writable.`,
   }
-  const USAGE: StorageUsageDto = {
+  const SPACE: StorageSpaceDto = {
+    availableKb: 1,
     capacityKb: 1,
     usedPercentage: 2,
   }
+  const USAGE: StorageUsageDto = {
+    ...SPACE,
+    writeRateKbPerSecond: null,
+    secondsUntilFull: null,
+    secondsUntilMotionPause: null,
+  }
 
   class MockMotionClientService implements Partial<IMotionClientService> {
     getTargetDir = async () => FILES_FOLDER_PATH
@@ -46,7 +54,7 @@ describe('StorageController (e2e)', () => {
   beforeAll(() => {
     spyGetStorageUsage = vi
       .spyOn(StorageUsageInteractor, 'getStorageUsage')
-      .mockResolvedValue(USAGE)
+      .mockResolvedValue(SPACE)
   })
 
   beforeEach(async () => {
@@ -0,0 +1,57 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { MetricsRegistry } from '../../src/metrics/metrics-registry'
+import { MotionClientService } from '../../src/motion-client.service'
+import { FakeMotionServer } from './fake-motion-server'
+
+const ITERATIONS = parseInt(process.env.ITERATIONS ?? '200')
+const LATENCY_MS = parseInt(process.env.LATENCY_MS ?? '2')
+
+// The Motion client always talks to port 8080, so nothing else may use it.
+async function runBenchmark() {
+  const server = new FakeMotionServer({ latencyMs: LATENCY_MS })
+  await server.start()
+  const client = new MotionClientService()
+
+  const start = performance.now()
+  for (let i = 0; i < ITERATIONS; i++) {
+    await Promise.all([
+      client.getHeight(),
+      client.getMovieOutput(),
+      client.getMovieQuality(),
+      client.getPictureOutput(),
+      client.getPictureQuality(),
+      client.getThreshold(),
+      client.getWidth(),
+    ])
+    await client.setFilename('benchmark')
+    await client.isDetectionStatusActive()
+  }
+  const elapsedMs = performance.now() - start
+
+  await server.stop()
+  console.log(
+    `${ITERATIONS} iterations with ${LATENCY_MS} ms server latency ` +
+      `took ${elapsedMs.toFixed(0)} ms`,
+  )
+  const motionMetrics = MetricsRegistry.render()
+    .split('\n')
+    .filter((line) => line.includes('dependency="motion"'))
+  console.log(motionMetrics.join('\n'))
+}
+
+runBenchmark()
@@ -0,0 +1,157 @@
+/**
+ * Copyright (C) since 2022 Luxembourg Institute of Science and Technology
+ *
+ * App4Cam is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * App4Cam is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with App4Cam.  If not, see <https://www.gnu.org/licenses/>.
+ */
+import { readFileSync } from 'fs'
+import { createServer, IncomingMessage, Server, ServerResponse } from 'http'
+import { AddressInfo } from 'net'
+import path from 'path'
+
+const DEFAULT_CONFIG_FILE_PATH = path.join(
+  __dirname,
+  '../../motion/config/NewtCAM/motion.conf',
+)
+const DEFAULT_PORT = 8080
+
+export interface FakeMotionServerOptions {
+  configFilePath?: string
+  latencyMs?: number
+}
+
+/**
+ * Imitates the text web control API of Motion, so that the Motion client
+ * can be exercised without a camera.
+ */
+export class FakeMotionServer {
+  private readonly configuration: Map<string, string>
+  private readonly latencyMs: number
+  private readonly server: Server
+  private isDetectionActive = true
+
+  constructor(options: FakeMotionServerOptions = {}) {
+    this.configuration = FakeMotionServer.readConfigurationFile(
+      options.configFilePath ?? DEFAULT_CONFIG_FILE_PATH,
+    )
+    this.latencyMs = options.latencyMs ?? 0
+    this.server = createServer((request, response) => {
+      setTimeout(() => this.handleRequest(request, response), this.latencyMs)
+    })
+  }
+
+  static readConfigurationFile(filePath: string): Map<string, string> {
+    const configuration = new Map<string, string>()
+    const lines = readFileSync(filePath, { encoding: 'utf8' }).split('\n')
+    for (const line of lines) {
+      const trimmedLine = line.trim()
+      if (!trimmedLine || /^[#;]/.test(trimmedLine)) {
+        continue
+      }
+      const separatorPosition = trimmedLine.indexOf(' ')
+      if (separatorPosition === -1) {
+        continue
+      }
+      configuration.set(
+        trimmedLine.substring(0, separatorPosition),
+        trimmedLine.substring(separatorPosition + 1).trim(),
+      )
+    }
+    return configuration
+  }
+
+  getConfigurationOption(name: string): string {
+    return this.configuration.get(name)
+  }
+
+  async start(port = DEFAULT_PORT): Promise<number> {
+    await new Promise<void>((resolve, reject) => {
+      this.server.once('error', reject)
+      this.server.listen(port, '127.0.0.1', resolve)
+    })
+    return (this.server.address() as AddressInfo).port
+  }
+
+  async stop(): Promise<void> {
+    this.server.closeAllConnections()
+    await new Promise<void>((resolve) => this.server.close(() => resolve()))
+  }
+
+  private handleRequest(request: IncomingMessage, response: ServerResponse) {
+    const url = new URL(request.url, 'http://127.0.0.1')
+    const body = this.getResponseBody(url)
+    if (body === undefined) {
+      response.writeHead(404).end()
+      return
+    }
+    response.writeHead(200, { 'Content-Type': 'text/plain' }).end(body)
+  }
+
+  private getResponseBody(url: URL): string | undefined {
+    switch (url.pathname) {
+      case '/0/config/list': {
+        const lines = Array.from(
+          this.configuration,
+          ([name, value]) => `  ${name} = ${value}`,
+        )
+        return ['Camera 0', ...lines].join('\n') + '\n'
+      }
+      case '/0/config/get': {
+        const name = url.searchParams.get('query')
+        if (!this.configuration.has(name)) {
+          return undefined
+        }
+        return `Camera 0 ${name} = ${this.configuration.get(name)} Done\n`
+      }
+      case '/0/config/set': {
+        const [name, value] = Array.from(url.searchParams)[0] ?? []
+        if (!name) {
+          return undefined
+        }
+        this.configuration.set(name, value)
+        return `Camera 0 ${name} = ${value} Done\n`
+      }
+      case '/action/config/write':
+      case '/0/action/config/write':
+        return 'Camera 0 write Done\n'
+      case '/0/action/snapshot':
+        return 'Camera 0 snapshot Done\n'
+      case '/0/detection/connection':
+        return 'Camera 0\nCamera 0 Connection OK\n'
+      case '/0/detection/pause':
+        this.isDetectionActive = false
+        return 'Camera 0 Detection paused\nDone\n'
+      case '/0/detection/start':
+        this.isDetectionActive = true
+        return 'Camera 0 Detection resumed\nDone\n'
+      case '/0/detection/status':
+        return `Camera 0 Detection status ${
+          this.isDetectionActive ? 'ACTIVE' : 'PAUSE'
+        }\n`
+      default:
+        return undefined
+    }
+  }
+}
+
+if (require.main === module) {
+  const port = parseInt(process.env.PORT ?? `${DEFAULT_PORT}`)
+  const latencyMs = parseInt(process.env.LATENCY_MS ?? '0')
+  const server = new FakeMotionServer({
+    configFilePath: process.argv[2],
+    latencyMs,
+  })
+  server.start(port).then((listeningPort) => {
+    console.log(`Fake Motion listening on http://127.0.0.1:${listeningPort}/`)
+  })
+}
@@ -17,8 +17,10 @@
 import { http, HttpResponse } from 'msw'
 
 const ALLOWED_GET_CONFIG_OPTIONS = [
+  'framerate',
   'height',
   'log_file',
+  'mask_file',
   'movie_output',
   'movie_quality',
   'picture_output',
@@ -30,6 +32,7 @@ const ALLOWED_GET_CONFIG_OPTIONS = [
   'width',
 ]
 const ALLOWED_SET_CONFIG_OPTIONS = [
+  'mask_file',
   'movie_filename',
   'movie_output',
   'movie_quality',
@@ -43,6 +46,27 @@ const ALLOWED_SET_CONFIG_OPTIONS = [
   'video_params',
 ]
 
+const getConfigOptionValue = (option: string) => {
+  switch (option) {
+    // Make sure to add new options to the allow list above too.
+    case 'log_file':
+      return '/a/b.log'
+    case 'mask_file':
+      return '/a/b.pgm'
+    case 'movie_output':
+    case 'picture_output':
+      return 'on'
+    case 'target_dir':
+      return '/a/b/c'
+    case 'video_device':
+      return '/dev/video0'
+    case 'video_params':
+      return '"Focus, Auto"=0, "Focus (absolute)"=200, Brightness=16'
+    default:
+      return '1'
+  }
+}
+
 const baseUrl = (path: string) =>
   new URL(path, 'http://127.0.0.1:8080').toString()
 
@@ -52,6 +76,11 @@ export const handlers = [
     () => new HttpResponse(null, { status: 200 }),
   ),
 
+  http.get(
+    baseUrl('0/action/restart'),
+    () => new HttpResponse(null, { status: 200 }),
+  ),
+
   http.get(
     baseUrl('0/action/snapshot'),
     () => new HttpResponse(null, { status: 200 }),
@@ -67,29 +96,16 @@ export const handlers = [
       return new HttpResponse(null, { status: 404 })
     }
 
-    let body
-    switch (queryParameterValues[0]) {
-      // Make sure to add new options to the allow list above too.
-      case 'log_file':
-        body = `Camera 0 ${queryParameterValues[0]} = /a/b.log Done`
-        break
-      case 'movie_output':
-      case 'picture_output':
-        body = `Camera 0 ${queryParameterValues[0]} = on Done`
-        break
-      case 'target_dir':
-        body = `Camera 0 ${queryParameterValues[0]} = /a/b/c Done`
-        break
-      case 'video_device':
-        body = `Camera 0 ${queryParameterValues[0]} = /dev/video0 Done`
-        break
-      case 'video_params':
-        body = `Camera 0 ${queryParameterValues[0]} = "Focus, Auto"=0, "Focus (absolute)"=200, Brightness=16 Done `
-        break
-      default:
-        body = `Camera 0 ${queryParameterValues[0]} = 1 Done`
-        break
-    }
+    const option = queryParameterValues[0]
+    const body = `Camera 0 ${option} = ${getConfigOptionValue(option)} Done`
+    return new HttpResponse(body, { status: 200 })
+  }),
+
+  http.get(baseUrl('0/config/list'), () => {
+    const lines = ALLOWED_GET_CONFIG_OPTIONS.map(
+      (option) => `  ${option} = ${getConfigOptionValue(option)}`,
+    )
+    const body = ['Camera 0', ...lines].join('\n') + '\n'
     return new HttpResponse(body, { status: 200 })
   }),
 